@@ -0,0 +1,116 @@
+// Benchmark da montagem de uploads em ConvertImageFormat/ResizeImage.
+//
+// Compara o caminho antigo (chunk_data() -> std::string -> std::vector<char>
+// -> std::string da resposta) com o ChunkAssembler + swap na resposta.
+// Os chunks são obtidos por ParseFromString, como o gRPC faz ao ler do
+// socket, então o custo de parse é igual nas duas variantes.
+//
+// Contador bytes_copied: bytes copiados por requisição fora do parse,
+// incluindo o que cada realocação do buffer move. BM_ChunkAssemblerReserved
+// manda ProcessingOptions.total_size no header, como os clientes do repo.
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "proto/file_processor.pb.h"
+#include "src/chunk_io.h"
+
+using file_processor::FileChunk;
+
+namespace {
+
+constexpr size_t kWireChunk = 64 * 1024;  // mesmo CHUNK_SIZE do cliente Python
+
+// Serializa um upload de payload_size bytes do jeito que o cliente envia.
+std::vector<std::string> MakeUpload(size_t payload_size, bool total_size = false) {
+    std::vector<std::string> wire;
+    FileChunk first;
+    first.set_file_name("photo.jpg");
+    if (total_size) {
+        first.mutable_options()->set_total_size(static_cast<int64_t>(payload_size));
+    }
+    wire.push_back(first.SerializeAsString());
+    std::string payload(kWireChunk, 'x');
+    for (size_t sent = 0; sent < payload_size; sent += kWireChunk) {
+        FileChunk chunk;
+        chunk.set_chunk_data(payload.data(), std::min(kWireChunk, payload_size - sent));
+        wire.push_back(chunk.SerializeAsString());
+    }
+    FileChunk last;
+    last.set_is_last(true);
+    wire.push_back(last.SerializeAsString());
+    return wire;
+}
+
+void BM_LegacyAssembly(benchmark::State& state) {
+    std::vector<std::string> wire = MakeUpload(state.range(0));
+    size_t copied = 0;
+    for (auto _ : state) {
+        FileChunk chunk;
+        std::vector<char> image_data;
+        std::string filename;
+        for (const std::string& message : wire) {
+            chunk.ParseFromString(message);
+            if (filename.empty()) {
+                filename = chunk.file_name();
+            }
+            std::string chunk_data = chunk.chunk_data();
+            copied += chunk_data.size();
+            image_data.insert(image_data.end(), chunk_data.begin(), chunk_data.end());
+            copied += chunk_data.size();
+            if (chunk.is_last()) {
+                break;
+            }
+        }
+        std::string converted_data(image_data.begin(), image_data.end());
+        copied += converted_data.size();
+
+        FileChunk response_chunk;
+        response_chunk.set_chunk_data(converted_data);
+        copied += converted_data.size();
+        benchmark::DoNotOptimize(response_chunk);
+    }
+    state.counters["bytes_copied"] = benchmark::Counter(copied, benchmark::Counter::kAvgIterations);
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void BM_ChunkAssembler(benchmark::State& state, bool total_size) {
+    std::vector<std::string> wire = MakeUpload(state.range(0), total_size);
+    size_t copied = 0;
+    for (auto _ : state) {
+        FileChunk chunk;
+        ChunkAssembler assembler;
+        for (const std::string& message : wire) {
+            chunk.ParseFromString(message);
+            if (assembler.Add(&chunk)) {
+                break;
+            }
+        }
+        copied += assembler.bytes_copied();
+        std::string data = assembler.Release();
+
+        FileChunk response_chunk;
+        response_chunk.mutable_chunk_data()->swap(data);
+        benchmark::DoNotOptimize(response_chunk);
+    }
+    state.counters["bytes_copied"] = benchmark::Counter(copied, benchmark::Counter::kAvgIterations);
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+BENCHMARK(BM_LegacyAssembly)->Arg(1 << 20)->Arg(16 << 20)->Arg(50 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ChunkAssembler, Growing, false)
+    ->Arg(1 << 20)
+    ->Arg(16 << 20)
+    ->Arg(50 << 20)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ChunkAssembler, Reserved, true)
+    ->Arg(1 << 20)
+    ->Arg(16 << 20)
+    ->Arg(50 << 20)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
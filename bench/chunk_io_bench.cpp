@@ -0,0 +1,235 @@
+// Micro-benchmarks dos caminhos de recepção e envio de chunks.
+//
+// Recepção (upload montado a partir de FileChunks já parseados, como o
+// gRPC entrega):
+//   - LegacyAppend: full_content.append(chunk.chunk_data()) do ConvertToTXT antigo;
+//   - LegacyVectorInsert: std::string -> std::vector<char> do ConvertImageFormat antigo;
+//   - ChunkAssembler / ChunkAssemblerHashed: caminho atual, sem e com o
+//     digest do cache.
+// Envio (resultado dividido em FileChunks e serializado, como o Write faz):
+//   - LegacySubstr: data.substr(i, chunk) por mensagem;
+//   - WriteChunked: caminho atual (chunk reutilizado, swap se couber).
+//
+// Argumentos: tamanho do arquivo e tamanho do chunk. Contadores:
+// bytes_per_second e allocs (alocações por operação, contadas por um
+// operator new substituído neste binário).
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "proto/file_processor.pb.h"
+#include "src/chunk_io.h"
+
+using file_processor::FileChunk;
+
+namespace {
+
+std::atomic<size_t> allocations{0};
+
+}  // namespace
+
+// noinline: com o malloc/free visíveis o GCC acusa um falso
+// -Wmismatched-new-delete.
+__attribute__((noinline)) void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+// Conta as alocações feitas dentro do loop de medição.
+class AllocationCounter {
+public:
+    AllocationCounter() : start_(allocations.load(std::memory_order_relaxed)) {}
+
+    void Report(benchmark::State& state) const {
+        size_t count = allocations.load(std::memory_order_relaxed) - start_;
+        state.counters["allocs"] = benchmark::Counter(static_cast<double>(count), benchmark::Counter::kAvgIterations);
+    }
+
+private:
+    size_t start_;
+};
+
+// Upload de payload_size bytes em chunks de chunk_size, já parseados.
+std::vector<FileChunk> MakeUpload(size_t payload_size, size_t chunk_size) {
+    std::vector<FileChunk> chunks;
+    FileChunk first;
+    first.set_file_name("photo.jpg");
+    chunks.push_back(first);
+    std::string payload(chunk_size, 'x');
+    for (size_t sent = 0; sent < payload_size; sent += chunk_size) {
+        FileChunk chunk;
+        chunk.set_chunk_data(payload.data(), std::min(chunk_size, payload_size - sent));
+        chunk.set_is_last(sent + chunk_size >= payload_size);
+        chunks.push_back(chunk);
+    }
+    return chunks;
+}
+
+void SetThroughput(benchmark::State& state) {
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+// Os chunks parseados pelo gRPC são descartados depois de lidos: a cópia
+// fica fora do tempo medido, como o parse real.
+template <typename Receive>
+void RunReceive(benchmark::State& state, Receive receive) {
+    const std::vector<FileChunk> wire = MakeUpload(state.range(0), state.range(1));
+    AllocationCounter counter;
+    size_t copy_allocations = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        size_t before = allocations.load(std::memory_order_relaxed);
+        std::vector<FileChunk> chunks = wire;
+        copy_allocations += allocations.load(std::memory_order_relaxed) - before;
+        state.ResumeTiming();
+        receive(&chunks);
+    }
+    // Só as alocações do caminho medido contam.
+    allocations.fetch_sub(copy_allocations, std::memory_order_relaxed);
+    counter.Report(state);
+    SetThroughput(state);
+}
+
+void BM_ReceiveLegacyAppend(benchmark::State& state) {
+    RunReceive(state, [](std::vector<FileChunk>* chunks) {
+        std::string full_content;
+        for (const FileChunk& chunk : *chunks) {
+            full_content.append(chunk.chunk_data());
+            if (chunk.is_last()) {
+                break;
+            }
+        }
+        benchmark::DoNotOptimize(full_content);
+    });
+}
+
+void BM_ReceiveLegacyVectorInsert(benchmark::State& state) {
+    RunReceive(state, [](std::vector<FileChunk>* chunks) {
+        std::vector<char> image_data;
+        for (const FileChunk& chunk : *chunks) {
+            std::string chunk_data = chunk.chunk_data();
+            image_data.insert(image_data.end(), chunk_data.begin(), chunk_data.end());
+            if (chunk.is_last()) {
+                break;
+            }
+        }
+        std::string data(image_data.begin(), image_data.end());
+        benchmark::DoNotOptimize(data);
+    });
+}
+
+void BM_ReceiveChunkAssembler(benchmark::State& state) {
+    RunReceive(state, [](std::vector<FileChunk>* chunks) {
+        ChunkAssembler assembler;
+        for (FileChunk& chunk : *chunks) {
+            if (assembler.Add(&chunk)) {
+                break;
+            }
+        }
+        std::string data = assembler.Release();
+        benchmark::DoNotOptimize(data);
+    });
+}
+
+void BM_ReceiveChunkAssemblerHashed(benchmark::State& state) {
+    RunReceive(state, [](std::vector<FileChunk>* chunks) {
+        ChunkAssembler assembler(0, true);
+        for (FileChunk& chunk : *chunks) {
+            if (assembler.Add(&chunk)) {
+                break;
+            }
+        }
+        UploadedFile upload = assembler.TakeUpload();
+        benchmark::DoNotOptimize(upload);
+    });
+}
+
+// "Write": serializa a mensagem num buffer reutilizado, como o gRPC faz
+// ao montar o frame.
+template <typename Send>
+void RunSend(benchmark::State& state, Send send) {
+    const std::string result(state.range(0), 'r');
+    const size_t chunk_size = state.range(1);
+    std::string wire;
+    wire.reserve(chunk_size + 64);
+    auto write = [&wire](const FileChunk& chunk) {
+        chunk.SerializeToString(&wire);
+        benchmark::DoNotOptimize(wire.data());
+        return true;
+    };
+    AllocationCounter counter;
+    size_t copy_allocations = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        size_t before = allocations.load(std::memory_order_relaxed);
+        std::string data = result;
+        copy_allocations += allocations.load(std::memory_order_relaxed) - before;
+        state.ResumeTiming();
+        send(&data, chunk_size, write);
+    }
+    allocations.fetch_sub(copy_allocations, std::memory_order_relaxed);
+    counter.Report(state);
+    SetThroughput(state);
+}
+
+void BM_SendLegacySubstr(benchmark::State& state) {
+    RunSend(state, [](std::string* data, size_t chunk_size, const std::function<bool(const FileChunk&)>& write) {
+        for (size_t i = 0; i < data->size(); i += chunk_size) {
+            FileChunk response_chunk;
+            response_chunk.set_file_name("result.bin");
+            response_chunk.set_chunk_data(data->substr(i, chunk_size));
+            response_chunk.set_is_last(i + chunk_size >= data->size());
+            write(response_chunk);
+        }
+    });
+}
+
+void BM_SendWriteChunked(benchmark::State& state) {
+    RunSend(state, [](std::string* data, size_t chunk_size, const std::function<bool(const FileChunk&)>& write) {
+        WriteChunked(data, "result.bin", chunk_size, write);
+    });
+}
+
+// Arquivo de 64 KiB a 16 MiB; chunk de 4 KiB (loop antigo) a 1 MiB.
+void ChunkArgs(benchmark::internal::Benchmark* benchmark) {
+    benchmark->ArgNames({"bytes", "chunk"});
+    for (int64_t bytes : {64 << 10, 1 << 20, 16 << 20}) {
+        for (int64_t chunk : {4 << 10, 64 << 10, 1 << 20}) {
+            if (chunk <= bytes) {
+                benchmark->Args({bytes, chunk});
+            }
+        }
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_ReceiveLegacyAppend)->Apply(ChunkArgs)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ReceiveLegacyVectorInsert)->Apply(ChunkArgs)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ReceiveChunkAssembler)->Apply(ChunkArgs)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ReceiveChunkAssemblerHashed)->Apply(ChunkArgs)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SendLegacySubstr)->Apply(ChunkArgs)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SendWriteChunked)->Apply(ChunkArgs)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
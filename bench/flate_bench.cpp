@@ -0,0 +1,196 @@
+// Benchmark do codec Flate em processo (flate.h): zlib x libdeflate.
+//
+// Comprime e descomprime cada amostra do corpus em vários níveis, com cada
+// backend compilado. Amostras sintéticas:
+//   content = content streams de páginas de texto (operadores e strings);
+//   image   = pixels RGB sem compressão, gradiente com ruído (o que uma
+//             image XObject sem filtro ou o IDAT de uma foto carrega);
+//   png     = as mesmas linhas já com o filtro Up do PNG.
+// Arquivos passados na linha de comando entram como amostras extras: de um
+// PDF vêm os streams FlateDecode já decodificados, de outro arquivo os bytes
+// como estão. Contadores: MB_per_s (da amostra descomprimida, nos dois
+// sentidos) e ratio (comprimido / original).
+//
+//   flate_bench [flags do Google Benchmark] [arquivo ...]
+
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "src/flate.h"
+#include "src/pdf_document.h"
+
+namespace {
+
+constexpr size_t kSampleBytes = 8 << 20;
+constexpr int kImageWidth = 1024;
+const int kLevels[] = {1, 6, 9, 12};
+
+struct Sample {
+    std::string name;
+    std::string data;
+};
+
+std::string ContentSample() {
+    std::string out;
+    for (int line = 0; out.size() < kSampleBytes; ++line) {
+        out += "BT /F" + std::to_string(1 + line % 3) + " 10 Tf 1 0 0 1 72 " + std::to_string(720 - (line % 60) * 12) +
+               " Tm [(Linha ) -250 (" + std::to_string(line) + ") -250 (do relat\\363rio mensal)] TJ ET\n";
+        if (line % 60 == 59) {
+            out += "q 0.5 w 72 36 m 540 36 l S Q\n";
+        }
+    }
+    return out;
+}
+
+std::string ImageSample() {
+    const size_t stride = kImageWidth * 3;
+    std::string out(kSampleBytes / stride * stride, '\0');
+    unsigned state = 2463534242u;
+    for (size_t p = 0; p < out.size(); p += 3) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        const size_t x = (p / 3) % kImageWidth;
+        const size_t y = (p / 3) / kImageWidth;
+        out[p] = static_cast<char>((x / 4 + (state & 0x7)) & 0xFF);
+        out[p + 1] = static_cast<char>((y / 4 + (state >> 3 & 0x7)) & 0xFF);
+        out[p + 2] = static_cast<char>(((x + y) / 8) & 0xFF);
+    }
+    return out;
+}
+
+// Linhas de ImageSample com o filtro Up (byte do filtro + diferenças).
+std::string PngRowsSample(const std::string& image) {
+    const size_t stride = kImageWidth * 3;
+    std::string out;
+    out.reserve(image.size() + image.size() / stride);
+    for (size_t row = 0; row < image.size(); row += stride) {
+        out += '\x02';
+        for (size_t i = 0; i < stride; ++i) {
+            const char up = row > 0 ? image[row - stride + i] : 0;
+            out += static_cast<char>(image[row + i] - up);
+        }
+    }
+    return out;
+}
+
+// Streams FlateDecode de um PDF, decodificados; os bytes do arquivo se não
+// for um PDF legível.
+std::string FileSample(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    PdfDocument document(contents.data(), contents.size());
+    std::string error;
+    if (!document.Open(&error)) {
+        return contents;
+    }
+    std::string out;
+    for (int num = 1; num < document.object_limit(); ++num) {
+        PdfObject object = document.GetObject(num);
+        const PdfObject* filter = object.is(PdfObject::Type::kStream) ? object.Get("Filter") : nullptr;
+        std::string decoded;
+        if (filter != nullptr && filter->IsName("FlateDecode") && document.DecodeStream(object, &decoded, &error)) {
+            out += decoded;
+        }
+    }
+    return out.empty() ? contents : out;
+}
+
+std::vector<FlateBackend> Backends() {
+    std::vector<FlateBackend> backends;
+    for (FlateBackend backend : {FlateBackend::kZlib, FlateBackend::kLibdeflate}) {
+        if (FlateBackendAvailable(backend)) {
+            backends.push_back(backend);
+        }
+    }
+    return backends;
+}
+
+void SetCounters(benchmark::State& state, size_t original, size_t compressed) {
+    state.counters["MB_per_s"] =
+        benchmark::Counter(static_cast<double>(original) * state.iterations() / 1e6, benchmark::Counter::kIsRate);
+    state.counters["ratio"] = static_cast<double>(compressed) / static_cast<double>(original);
+}
+
+void BM_Compress(benchmark::State& state, FlateBackend backend, int level, const std::string& data) {
+    SetFlateBackend(backend);
+    std::string out, error;
+    for (auto _ : state) {
+        if (!FlateCompress(data.data(), data.size(), level, &out, &error)) {
+            state.SkipWithError(error.c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    if (state.iterations() > 0) {
+        SetCounters(state, data.size(), out.size());
+    }
+}
+
+// A entrada é comprimida uma vez pelo zlib no nível dado: os dois backends
+// descomprimem os mesmos bytes. Com hint, o tamanho da saída é passado
+// (como o /DL de um stream PDF); sem ele, a libdeflate tenta com a
+// estimativa e, se não couber, o zlib termina.
+void BM_Decompress(benchmark::State& state, FlateBackend backend, int level, bool with_hint,
+                   const std::string& data) {
+    const size_t hint = with_hint ? data.size() : 0;
+    SetFlateBackend(FlateBackend::kZlib);
+    std::string compressed, out, error;
+    if (!FlateCompress(data.data(), data.size(), level, &compressed, &error)) {
+        state.SkipWithError(error.c_str());
+        return;
+    }
+    SetFlateBackend(backend);
+    for (auto _ : state) {
+        if (!FlateDecompress(compressed.data(), compressed.size(), data.size(), &out, &error, hint)) {
+            state.SkipWithError(error.c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    if (state.iterations() > 0) {
+        SetCounters(state, data.size(), compressed.size());
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    // O que sobra depois das flags do Google Benchmark são os arquivos.
+    std::vector<Sample> samples;
+    samples.push_back({"content", ContentSample()});
+    samples.push_back({"image", ImageSample()});
+    samples.push_back({"png", PngRowsSample(samples.back().data)});
+    for (int i = 1; i < argc; ++i) {
+        samples.push_back({argv[i], FileSample(argv[i])});
+    }
+
+    for (const Sample& sample : samples) {
+        for (FlateBackend backend : Backends()) {
+            for (int level : kLevels) {
+                const std::string suffix = "/" + sample.name + "/" + FlateBackendName(backend) + "/level:" +
+                                           std::to_string(level);
+                benchmark::RegisterBenchmark(("BM_Compress" + suffix).c_str(), BM_Compress, backend, level,
+                                             std::cref(sample.data))
+                    ->Unit(benchmark::kMillisecond);
+            }
+            for (bool with_hint : {false, true}) {
+                const std::string name = "BM_Decompress/" + sample.name + "/" + FlateBackendName(backend) +
+                                         (with_hint ? "/hint" : "/no_hint");
+                benchmark::RegisterBenchmark(name.c_str(), BM_Decompress, backend, kDefaultFlateLevel, with_hint,
+                                             std::cref(sample.data))
+                    ->Unit(benchmark::kMillisecond);
+            }
+        }
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,218 @@
+// Benchmark do ResizeImage em processo (ImageResizer) contra o convert do
+// ImageMagick usado pelo modo pipeline.
+//
+// BM_Resize mede só o kernel sobre pixels já decodificados, variando filtro,
+// conjunto de instruções e threads; BM_NativePnm e BM_ConvertPnm fazem o
+// caminho completo (decodificar, redimensionar, codificar) sobre o mesmo PPM,
+// para comparar com o subprocesso. BM_NativeJpeg faz o mesmo com uma foto
+// de 24 MP em JPEG, com e sem shrink-on-load (escala do DCT). O contador
+// MPix/s conta os pixels de origem. Sem convert no PATH, BM_ConvertPnm é
+// pulado; sem libjpeg, BM_NativeJpeg.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "src/image_codec.h"
+#include "src/image_resize.h"
+#include "src/subprocess.h"
+#include "src/tool_commands.h"
+
+namespace {
+
+constexpr int kSourceWidth = 3000;
+constexpr int kSourceHeight = 2000;
+constexpr int kBoxWidth = 800;
+constexpr int kBoxHeight = 600;
+
+// Gradiente com ruído: nem uniforme (que favorece caches) nem só ruído.
+const Image& SourceImage() {
+    static const Image image = [] {
+        Image result;
+        result.width = kSourceWidth;
+        result.height = kSourceHeight;
+        result.channels = 3;
+        result.pixels.resize(result.stride() * result.height);
+        std::mt19937 rng(42);
+        for (int y = 0; y < result.height; ++y) {
+            uint8_t* row = result.row(y);
+            for (int x = 0; x < result.width; ++x) {
+                int noise = static_cast<int>(rng() % 32);
+                row[3 * x] = static_cast<uint8_t>((x * 255 / result.width + noise) & 0xFF);
+                row[3 * x + 1] = static_cast<uint8_t>((y * 255 / result.height + noise) & 0xFF);
+                row[3 * x + 2] = static_cast<uint8_t>(((x + y) * 127 / result.width + noise) & 0xFF);
+            }
+        }
+        return result;
+    }();
+    return image;
+}
+
+const std::string& SourcePnm() {
+    static const std::string pnm = [] {
+        std::string out, error;
+        EncodeImage(SourceImage(), ImageFormat::kPnm, EncodeOptions(), &out, &error);
+        return out;
+    }();
+    return pnm;
+}
+
+// Foto de 24 MP (6000x4000) com o mesmo padrão de SourceImage.
+const std::string& SourceJpeg() {
+    static const std::string jpeg = [] {
+        const Image& base = SourceImage();
+        Image large;
+        large.width = 6000;
+        large.height = 4000;
+        large.channels = 3;
+        large.pixels.resize(large.stride() * large.height);
+        for (int y = 0; y < large.height; ++y) {
+            const uint8_t* src = base.row(y * base.height / large.height);
+            uint8_t* dst = large.row(y);
+            for (int x = 0; x < large.width; ++x) {
+                std::copy_n(src + 3 * (x * base.width / large.width), 3, dst + 3 * x);
+            }
+        }
+        std::string out, error;
+        EncodeOptions encode;
+        encode.quality = 90;
+        EncodeImage(large, ImageFormat::kJpeg, encode, &out, &error);
+        return out;
+    }();
+    return jpeg;
+}
+
+void SetPixelRate(benchmark::State& state, double source_pixels = double{kSourceWidth} * kSourceHeight) {
+    state.counters["MPix/s"] =
+        benchmark::Counter(source_pixels * state.iterations() / 1e6, benchmark::Counter::kIsRate);
+}
+
+void BM_Resize(benchmark::State& state) {
+    ImageResizer::Options options;
+    options.filter = static_cast<ResizeFilter>(state.range(0));
+    options.isa = static_cast<ResizeIsa>(state.range(1));
+    options.threads = static_cast<int>(state.range(2));
+    ImageResizer resizer(options);
+    if (resizer.isa() != options.isa) {
+        state.SkipWithError((std::string(ResizeIsaName(options.isa)) + " não suportado nesta CPU").c_str());
+        return;
+    }
+    int width = 0, height = 0;
+    FitWithin(kSourceWidth, kSourceHeight, kBoxWidth, kBoxHeight, &width, &height);
+    Image resized;
+    for (auto _ : state) {
+        std::string error;
+        if (!resizer.Resize(SourceImage(), width, height, &resized, &error)) {
+            state.SkipWithError(error.c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(resized.pixels.data());
+    }
+    state.SetLabel(std::string(ResizeFilterName(options.filter)) + "/" + ResizeIsaName(options.isa));
+    SetPixelRate(state);
+}
+
+void ResizeArguments(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"filter", "isa", "threads"});
+    for (ResizeFilter filter : {ResizeFilter::kBox, ResizeFilter::kBilinear, ResizeFilter::kLanczos3}) {
+        for (ResizeIsa isa : {ResizeIsa::kScalar, ResizeIsa::kSse41, ResizeIsa::kAvx2}) {
+            bench->Args({static_cast<int>(filter), static_cast<int>(isa), 1});
+        }
+    }
+    int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int threads = 2; threads <= cores; threads *= 2) {
+        bench->Args({static_cast<int>(ResizeFilter::kLanczos3), static_cast<int>(ResizeIsa::kAuto), threads});
+    }
+}
+
+void BM_NativePnm(benchmark::State& state) {
+    ImageResizer::Options options;
+    options.threads = static_cast<int>(state.range(0));
+    ImageResizer resizer(options);
+    for (auto _ : state) {
+        Image source, resized;
+        std::string out, error;
+        int width = 0, height = 0;
+        bool ok = DecodeImage(SourcePnm(), &source, &error);
+        if (ok) {
+            FitWithin(source.width, source.height, kBoxWidth, kBoxHeight, &width, &height);
+            ok = resizer.Resize(source, width, height, &resized, &error) &&
+                 EncodeImage(resized, ImageFormat::kPnm, EncodeOptions(), &out, &error);
+        }
+        if (!ok) {
+            state.SkipWithError(error.c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    SetPixelRate(state);
+}
+
+// O mesmo caminho de FileOperations::ResizeNative.
+void BM_NativeJpeg(benchmark::State& state) {
+    if (!ImageFormatSupported(ImageFormat::kJpeg)) {
+        state.SkipWithError("compilado sem libjpeg");
+        return;
+    }
+    const bool shrink = state.range(0) != 0;
+    ImageResizer resizer{ImageResizer::Options()};
+    const std::string& input = SourceJpeg();
+    int source_width = 0, source_height = 0, width = 0, height = 0;
+    ReadImageSize(input, &source_width, &source_height);
+    FitWithin(source_width, source_height, kBoxWidth, kBoxHeight, &width, &height);
+    DecodeOptions decode;
+    if (shrink) {
+        decode.min_width = 2 * width;
+        decode.min_height = 2 * height;
+    }
+    EncodeOptions encode;
+    encode.quality = 85;
+    size_t decoded_pixels = 0;
+    for (auto _ : state) {
+        Image source, resized;
+        std::string out, error;
+        bool ok = DecodeImage(input, &source, &error, decode) &&
+                  resizer.Resize(source, width, height, &resized, &error) &&
+                  EncodeImage(resized, ImageFormat::kJpeg, encode, &out, &error);
+        if (!ok) {
+            state.SkipWithError(error.c_str());
+            break;
+        }
+        decoded_pixels = static_cast<size_t>(source.width) * source.height;
+        benchmark::DoNotOptimize(out.data());
+    }
+    SetPixelRate(state, static_cast<double>(source_width) * source_height);
+    state.counters["decoded_MPix"] = static_cast<double>(decoded_pixels) / 1e6;
+}
+
+void BM_ConvertPnm(benchmark::State& state) {
+    if (!ProgramInPath("convert")) {
+        state.SkipWithError("convert (ImageMagick) não encontrado no PATH");
+        return;
+    }
+    const std::vector<std::string> argv = {
+        "convert", "ppm:-", "-filter", "Lanczos", "-resize",
+        std::to_string(kBoxWidth) + "x" + std::to_string(kBoxHeight), "ppm:-"};
+    for (auto _ : state) {
+        std::string out, error;
+        if (!RunSubprocess(argv, SourcePnm(), &out, &error)) {
+            state.SkipWithError(error.c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    SetPixelRate(state);
+}
+
+}  // namespace
+
+BENCHMARK(BM_Resize)->Apply(ResizeArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_NativePnm)->ArgName("threads")->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_NativeJpeg)->ArgName("shrink")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ConvertPnm)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,586 @@
+// Gerador de carga ponta a ponta para o FileProcessor.
+//
+// Dispara as quatro RPCs contra um servidor em execução e relata vazão e
+// percentis de latência por RPC. Dois modos:
+//
+//   - malha aberta (--rate=R): as requisições têm horários de chegada
+//     planejados (uniformes ou Poisson); a latência é medida a partir do
+//     horário planejado, não do envio, o que corrige a omissão coordenada
+//     (um servidor lento não "adia" as requisições que deveria ter recebido).
+//     A latência só de serviço (do envio à resposta) sai em separado;
+//   - malha fechada (--rate=0): cada uma das --concurrency threads envia a
+//     próxima requisição assim que a anterior termina.
+//
+// Os arquivos vêm de --corpus=DIR (.pdf para CompressPDF/ConvertToTXT,
+// imagens para as demais) ou são gerados conforme --sizes.
+//
+// Exemplo:
+//   loadgen --target=localhost:50051 --mix=compress:2,resize:1 --rate=50
+//           --concurrency=16 --duration=30 --sizes=lognormal:200k:1
+
+#include <dirent.h>
+
+#include <grpcpp/grpcpp.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench/synthetic_pdf.h"
+#include "proto/file_processor.grpc.pb.h"
+#include "proto/file_processor.pb.h"
+#include "src/metrics.h"
+
+using file_processor::FileChunk;
+using file_processor::FileProcessor;
+using file_processor::FileRequest;
+using file_processor::FileResponse;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr size_t kRpcs = static_cast<size_t>(Rpc::kCount);
+
+struct LoadgenOptions {
+    std::string target = "localhost:50051";
+    // Peso de cada RPC no sorteio.
+    double weights[kRpcs] = {1, 1, 1, 1};
+    int concurrency = 8;
+    double rate = 0;  // requisições/s; 0 = malha fechada
+    bool poisson = true;
+    double duration_seconds = 10;
+    double warmup_seconds = 1;
+    std::string corpus_dir;
+    std::string sizes = "fixed:256k";
+    size_t chunk_size = 64 * 1024;
+    int response_chunk_size = 0;  // chunk_size_hint; 0 = padrão do servidor
+    int deadline_ms = 0;
+    unsigned seed = 1;
+};
+
+std::string Usage(const char* program) {
+    return std::string("Uso: ") + program + " [flags]\n" +
+           "  --target=HOST:PORTA        servidor (padrão localhost:50051)\n"
+           "  --mix=RPC:PESO,...         compress, totxt, convert, resize (padrão: todas com peso 1)\n"
+           "  --concurrency=N            requisições simultâneas / threads (padrão 8)\n"
+           "  --rate=R                   requisições/s em malha aberta (0 = malha fechada)\n"
+           "  --arrival=poisson|uniform  intervalos entre chegadas na malha aberta\n"
+           "  --duration=S               duração da medição em segundos (padrão 10)\n"
+           "  --warmup=S                 segundos iniciais descartados (padrão 1)\n"
+           "  --corpus=DIR               PDFs e imagens de amostra (senão, arquivos sintéticos)\n"
+           "  --sizes=DIST               tamanhos sintéticos: fixed:N, uniform:MIN:MAX ou\n"
+           "                             lognormal:MEDIANA:SIGMA (sufixos k/m)\n"
+           "  --chunk-size=BYTES         tamanho dos chunks de upload (padrão 64k)\n"
+           "  --response-chunk-size=BYTES\n"
+           "                             chunk_size_hint pedido ao servidor\n"
+           "  --deadline-ms=N            deadline por requisição (0 = sem)\n"
+           "  --seed=N                   semente do sorteio\n";
+}
+
+bool ParseSize(const std::string& text, double* out) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    double value = std::strtod(text.c_str(), &end);
+    std::string suffix(end);
+    if (suffix == "k" || suffix == "K") {
+        value *= 1024;
+    } else if (suffix == "m" || suffix == "M") {
+        value *= 1024 * 1024;
+    } else if (!suffix.empty()) {
+        return false;
+    }
+    *out = value;
+    return value >= 0;
+}
+
+std::vector<std::string> Split(const std::string& text, char separator) {
+    std::vector<std::string> parts;
+    size_t start = 0;
+    for (;;) {
+        size_t end = text.find(separator, start);
+        parts.push_back(text.substr(start, end - start));
+        if (end == std::string::npos) {
+            return parts;
+        }
+        start = end + 1;
+    }
+}
+
+bool ParseMix(const std::string& text, LoadgenOptions* options) {
+    static const char* const kNames[] = {"compress", "totxt", "convert", "resize"};
+    std::fill(std::begin(options->weights), std::end(options->weights), 0.0);
+    for (const std::string& item : Split(text, ',')) {
+        std::vector<std::string> fields = Split(item, ':');
+        double weight = 1;
+        if (fields.size() > 2 || (fields.size() == 2 && !ParseSize(fields[1], &weight))) {
+            return false;
+        }
+        auto it = std::find(std::begin(kNames), std::end(kNames), fields[0]);
+        if (it == std::end(kNames)) {
+            return false;
+        }
+        options->weights[it - std::begin(kNames)] = weight;
+    }
+    return std::any_of(std::begin(options->weights), std::end(options->weights), [](double w) { return w > 0; });
+}
+
+bool ParseOptions(int argc, char** argv, LoadgenOptions* options, std::string* error) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        if (arg.rfind("--", 0) != 0 || eq == std::string::npos) {
+            *error = "Argumento inválido: " + arg;
+            return false;
+        }
+        std::string name = arg.substr(2, eq - 2);
+        std::string value = arg.substr(eq + 1);
+        double number = 0;
+        bool ok = true;
+        if (name == "target") {
+            options->target = value;
+        } else if (name == "mix") {
+            ok = ParseMix(value, options);
+        } else if (name == "concurrency") {
+            ok = ParseSize(value, &number) && number >= 1;
+            options->concurrency = static_cast<int>(number);
+        } else if (name == "rate") {
+            ok = ParseSize(value, &options->rate);
+        } else if (name == "arrival") {
+            ok = value == "poisson" || value == "uniform";
+            options->poisson = value == "poisson";
+        } else if (name == "duration") {
+            ok = ParseSize(value, &options->duration_seconds) && options->duration_seconds > 0;
+        } else if (name == "warmup") {
+            ok = ParseSize(value, &options->warmup_seconds);
+        } else if (name == "corpus") {
+            options->corpus_dir = value;
+        } else if (name == "sizes") {
+            options->sizes = value;
+        } else if (name == "chunk-size") {
+            ok = ParseSize(value, &number) && number >= 1;
+            options->chunk_size = static_cast<size_t>(number);
+        } else if (name == "response-chunk-size") {
+            ok = ParseSize(value, &number);
+            options->response_chunk_size = static_cast<int>(number);
+        } else if (name == "deadline-ms") {
+            ok = ParseSize(value, &number);
+            options->deadline_ms = static_cast<int>(number);
+        } else if (name == "seed") {
+            ok = ParseSize(value, &number);
+            options->seed = static_cast<unsigned>(number);
+        } else {
+            *error = "Flag desconhecida: --" + name;
+            return false;
+        }
+        if (!ok) {
+            *error = "Valor inválido para --" + name + ": " + value;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Distribuição dos tamanhos dos arquivos sintéticos.
+class SizeDistribution {
+public:
+    bool Parse(const std::string& text, std::string* error) {
+        std::vector<std::string> fields = Split(text, ':');
+        bool ok = false;
+        if (fields[0] == "fixed" && fields.size() == 2) {
+            ok = ParseSize(fields[1], &a_);
+            b_ = a_;
+        } else if (fields[0] == "uniform" && fields.size() == 3) {
+            ok = ParseSize(fields[1], &a_) && ParseSize(fields[2], &b_) && a_ <= b_;
+        } else if (fields[0] == "lognormal" && fields.size() == 3) {
+            lognormal_ = true;
+            ok = ParseSize(fields[1], &a_) && ParseSize(fields[2], &b_) && a_ > 0;
+        }
+        if (!ok) {
+            *error = "Distribuição de tamanhos inválida: " + text;
+        }
+        return ok;
+    }
+
+    size_t Sample(std::mt19937_64* rng) const {
+        double size;
+        if (lognormal_) {
+            size = std::lognormal_distribution<double>(std::log(a_), b_)(*rng);
+        } else {
+            size = std::uniform_real_distribution<double>(a_, b_)(*rng);
+        }
+        return static_cast<size_t>(std::max(1024.0, size));
+    }
+
+private:
+    bool lognormal_ = false;
+    double a_ = 0;  // fixed/uniform: mínimo; lognormal: mediana
+    double b_ = 0;  // fixed/uniform: máximo; lognormal: sigma
+};
+
+struct Sample {
+    std::string name;
+    std::string data;
+};
+
+// Arquivos usados nas requisições, por tipo.
+struct Corpus {
+    std::vector<Sample> pdfs;
+    std::vector<Sample> images;
+};
+
+bool EndsWith(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool LoadCorpus(const std::string& dir, Corpus* corpus, std::string* error) {
+    DIR* handle = opendir(dir.c_str());
+    if (handle == nullptr) {
+        *error = "Não foi possível abrir " + dir;
+        return false;
+    }
+    static const char* const kImageExtensions[] = {".jpg", ".jpeg", ".png", ".gif", ".bmp", ".webp", ".ppm", ".tif"};
+    while (dirent* entry = readdir(handle)) {
+        std::string name = entry->d_name;
+        std::string lower = name;
+        std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+        std::vector<Sample>* target = nullptr;
+        if (EndsWith(lower, ".pdf")) {
+            target = &corpus->pdfs;
+        } else if (std::any_of(std::begin(kImageExtensions), std::end(kImageExtensions),
+                               [&](const char* ext) { return EndsWith(lower, ext); })) {
+            target = &corpus->images;
+        } else {
+            continue;
+        }
+        std::ifstream file(dir + "/" + name, std::ios::binary);
+        target->push_back(Sample{name, std::string(std::istreambuf_iterator<char>(file), {})});
+    }
+    closedir(handle);
+    return true;
+}
+
+// PPM (P6) com ruído, com cerca de size bytes; convert lê o formato.
+std::string MakeSyntheticImage(size_t size, std::mt19937_64* rng) {
+    int side = std::max(16, static_cast<int>(std::sqrt(static_cast<double>(size) / 3)));
+    std::string image = "P6\n" + std::to_string(side) + " " + std::to_string(side) + "\n255\n";
+    size_t header = image.size();
+    image.resize(header + static_cast<size_t>(side) * side * 3);
+    for (size_t i = header; i < image.size(); i += 8) {
+        uint64_t noise = (*rng)();
+        std::copy_n(reinterpret_cast<const char*>(&noise), std::min<size_t>(8, image.size() - i), &image[i]);
+    }
+    return image;
+}
+
+// Quantos arquivos sintéticos gerar de cada tipo.
+constexpr int kSyntheticSamples = 16;
+
+void MakeSyntheticCorpus(const SizeDistribution& sizes, std::mt19937_64* rng, Corpus* corpus) {
+    // Cada página de MakeSyntheticPdf com imagem de 200x200 tem ~120 KB.
+    constexpr size_t kPageBytes = 200 * 200 * 3;
+    for (int i = 0; i < kSyntheticSamples; ++i) {
+        size_t pdf_size = sizes.Sample(rng);
+        int pages = std::max(1, static_cast<int>(pdf_size / kPageBytes));
+        int side = pages == 1 ? std::max(16, static_cast<int>(std::sqrt(pdf_size / 3.0))) : 200;
+        corpus->pdfs.push_back(Sample{"loadgen_" + std::to_string(i) + ".pdf", MakeSyntheticPdf(pages, side)});
+        corpus->images.push_back(
+            Sample{"loadgen_" + std::to_string(i) + ".ppm", MakeSyntheticImage(sizes.Sample(rng), rng)});
+    }
+}
+
+// Resultados de uma RPC.
+struct RpcStats {
+    LatencyHistogram latency;  // desde o horário planejado (corrigida)
+    LatencyHistogram service;  // desde o envio
+    std::atomic<uint64_t> status[17] = {};
+    std::atomic<uint64_t> bytes_sent{0};
+    std::atomic<uint64_t> bytes_received{0};
+};
+
+// Próxima requisição: o que enviar e quando deveria ter saído.
+struct Slot {
+    Rpc rpc;
+    const Sample* sample;
+    Clock::time_point intended;
+};
+
+class Scheduler {
+public:
+    Scheduler(const LoadgenOptions& options, const Corpus& corpus, Clock::time_point start)
+        : options_(options), corpus_(corpus), rng_(options.seed), next_(start),
+          end_(start + ToDuration(options.warmup_seconds + options.duration_seconds)),
+          pick_rpc_(std::begin(options.weights), std::end(options.weights)) {}
+
+    // false quando o teste acabou.
+    bool Next(Slot* slot) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (options_.rate > 0) {
+            slot->intended = next_;
+            double gap = options_.poisson ? std::exponential_distribution<double>(options_.rate)(rng_)
+                                          : 1.0 / options_.rate;
+            next_ += ToDuration(gap);
+        } else {
+            slot->intended = Clock::now();
+        }
+        if (slot->intended >= end_) {
+            return false;
+        }
+        slot->rpc = static_cast<Rpc>(pick_rpc_(rng_));
+        const std::vector<Sample>& samples =
+            slot->rpc == Rpc::kCompressPDF || slot->rpc == Rpc::kConvertToTXT ? corpus_.pdfs : corpus_.images;
+        slot->sample = &samples[std::uniform_int_distribution<size_t>(0, samples.size() - 1)(rng_)];
+        return true;
+    }
+
+    static Clock::duration ToDuration(double seconds) {
+        return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    }
+
+private:
+    const LoadgenOptions& options_;
+    const Corpus& corpus_;
+    std::mutex mutex_;
+    std::mt19937_64 rng_;
+    Clock::time_point next_;
+    const Clock::time_point end_;
+    std::discrete_distribution<int> pick_rpc_;
+};
+
+class LoadClient {
+public:
+    LoadClient(const LoadgenOptions& options, std::shared_ptr<grpc::Channel> channel)
+        : options_(options), stub_(FileProcessor::NewStub(channel)) {}
+
+    // Executa uma requisição; retorna o status e soma bytes enviados/recebidos.
+    grpc::Status Call(Rpc rpc, const Sample& sample, size_t* sent, size_t* received) {
+        grpc::ClientContext context;
+        if (options_.deadline_ms > 0) {
+            context.set_deadline(std::chrono::system_clock::now() + std::chrono::milliseconds(options_.deadline_ms));
+        }
+        file_processor::ProcessingOptions processing;
+        processing.set_chunk_size_hint(options_.response_chunk_size);
+        if (rpc == Rpc::kConvertImageFormat) {
+            processing.set_output_format("png");
+        } else if (rpc == Rpc::kResizeImage) {
+            processing.set_width(320);
+            processing.set_height(240);
+        }
+
+        *sent = sample.data.size();
+        if (rpc == Rpc::kCompressPDF) {
+            FileRequest request;
+            request.set_file_name(sample.name);
+            request.set_file_content(sample.data);
+            *request.mutable_options() = processing;
+            FileResponse response;
+            grpc::Status status = stub_->CompressPDF(&context, request, &response);
+            *received = response.file_content().size();
+            return status;
+        }
+
+        std::unique_ptr<grpc::ClientReaderWriter<FileChunk, FileChunk>> stream;
+        if (rpc == Rpc::kConvertToTXT) {
+            stream = stub_->ConvertToTXT(&context);
+        } else if (rpc == Rpc::kConvertImageFormat) {
+            stream = stub_->ConvertImageFormat(&context);
+        } else {
+            stream = stub_->ResizeImage(&context);
+        }
+
+        // Upload e download em paralelo, como no modo pipeline do servidor.
+        *received = 0;
+        std::thread reader([&] {
+            FileChunk reply;
+            while (stream->Read(&reply)) {
+                *received += reply.chunk_data().size();
+            }
+        });
+        FileChunk chunk;
+        chunk.set_file_name(sample.name);
+        *chunk.mutable_options() = processing;
+        chunk.mutable_options()->set_total_size(static_cast<int64_t>(sample.data.size()));
+        bool alive = stream->Write(chunk);
+        chunk.Clear();
+        for (size_t offset = 0; alive && offset < sample.data.size(); offset += options_.chunk_size) {
+            chunk.set_chunk_data(sample.data.data() + offset,
+                                 std::min(options_.chunk_size, sample.data.size() - offset));
+            chunk.set_is_last(offset + options_.chunk_size >= sample.data.size());
+            alive = stream->Write(chunk);
+        }
+        stream->WritesDone();
+        reader.join();
+        return stream->Finish();
+    }
+
+private:
+    const LoadgenOptions& options_;
+    std::unique_ptr<FileProcessor::Stub> stub_;
+};
+
+void PrintReport(const RpcStats* stats, double seconds, bool open_loop) {
+    std::printf("\n%-19s %8s %7s %9s %8s %9s %9s %9s %9s %9s\n", "RPC", "reqs", "erros", "req/s", "MB/s",
+                "p50 ms", "p90 ms", "p99 ms", "p99.9 ms", "max ms");
+    auto print_row = [&](const char* name, const LatencyHistogram::Snapshot& latency, uint64_t errors,
+                         uint64_t bytes) {
+        uint64_t max_micros = 0;
+        for (int i = LatencyHistogram::kBuckets - 1; i >= 0; --i) {
+            if (latency.counts[i] > 0) {
+                max_micros = LatencyHistogram::BucketUpperBound(i);
+                break;
+            }
+        }
+        std::printf("%-19s %8llu %7llu %9.1f %8.2f %9.2f %9.2f %9.2f %9.2f %9.2f\n", name,
+                    static_cast<unsigned long long>(latency.count), static_cast<unsigned long long>(errors),
+                    latency.count / seconds, bytes / seconds / (1024 * 1024), latency.ValueAtQuantile(0.5) / 1e3,
+                    latency.ValueAtQuantile(0.9) / 1e3, latency.ValueAtQuantile(0.99) / 1e3,
+                    latency.ValueAtQuantile(0.999) / 1e3, max_micros / 1e3);
+    };
+
+    LatencyHistogram::Snapshot total;
+    uint64_t total_errors = 0;
+    uint64_t total_bytes = 0;
+    for (size_t r = 0; r < kRpcs; ++r) {
+        LatencyHistogram::Snapshot latency = stats[r].latency.Take();
+        if (latency.count == 0) {
+            continue;
+        }
+        uint64_t errors = 0;
+        for (size_t c = 1; c < 17; ++c) {
+            errors += stats[r].status[c].load();
+        }
+        uint64_t bytes = stats[r].bytes_sent.load() + stats[r].bytes_received.load();
+        print_row(RpcName(static_cast<Rpc>(r)), latency, errors, bytes);
+        for (int i = 0; i < LatencyHistogram::kBuckets; ++i) {
+            total.counts[i] += latency.counts[i];
+        }
+        total.count += latency.count;
+        total_errors += errors;
+        total_bytes += bytes;
+    }
+    print_row("total", total, total_errors, total_bytes);
+
+    if (open_loop) {
+        std::printf("\nLatência de serviço (do envio à resposta, sem a espera por uma thread livre):\n");
+        for (size_t r = 0; r < kRpcs; ++r) {
+            LatencyHistogram::Snapshot service = stats[r].service.Take();
+            if (service.count > 0) {
+                std::printf("%-19s p50 %.2f ms  p99 %.2f ms\n", RpcName(static_cast<Rpc>(r)),
+                            service.ValueAtQuantile(0.5) / 1e3, service.ValueAtQuantile(0.99) / 1e3);
+            }
+        }
+    }
+
+    for (size_t r = 0; r < kRpcs; ++r) {
+        for (size_t c = 1; c < 17; ++c) {
+            uint64_t count = stats[r].status[c].load();
+            if (count > 0) {
+                std::printf("%s: %llu x %s\n", RpcName(static_cast<Rpc>(r)), static_cast<unsigned long long>(count),
+                            StatusCodeName(static_cast<grpc::StatusCode>(c)));
+            }
+        }
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    LoadgenOptions options;
+    std::string error;
+    SizeDistribution sizes;
+    if (!ParseOptions(argc, argv, &options, &error) || !sizes.Parse(options.sizes, &error)) {
+        std::cerr << error << "\n" << Usage(argv[0]);
+        return 1;
+    }
+
+    std::mt19937_64 rng(options.seed);
+    Corpus corpus;
+    if (!options.corpus_dir.empty() && !LoadCorpus(options.corpus_dir, &corpus, &error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    // Tipos ausentes no corpus são completados com arquivos sintéticos.
+    if (corpus.pdfs.empty() || corpus.images.empty()) {
+        Corpus synthetic;
+        MakeSyntheticCorpus(sizes, &rng, &synthetic);
+        if (corpus.pdfs.empty()) {
+            corpus.pdfs = std::move(synthetic.pdfs);
+        }
+        if (corpus.images.empty()) {
+            corpus.images = std::move(synthetic.images);
+        }
+    }
+
+    // Canais separados espalham as threads por várias conexões HTTP/2.
+    constexpr int kThreadsPerChannel = 4;
+    std::vector<std::shared_ptr<grpc::Channel>> channels;
+    for (int i = 0; i < (options.concurrency + kThreadsPerChannel - 1) / kThreadsPerChannel; ++i) {
+        grpc::ChannelArguments arguments;
+        arguments.SetInt("loadgen.channel", i);  // evita o compartilhamento do subchannel
+        arguments.SetMaxReceiveMessageSize(-1);
+        arguments.SetMaxSendMessageSize(-1);
+        channels.push_back(grpc::CreateCustomChannel(options.target, grpc::InsecureChannelCredentials(), arguments));
+    }
+
+    char mode[64] = "malha fechada";
+    if (options.rate > 0) {
+        std::snprintf(mode, sizeof(mode), "malha aberta a %g req/s (%s)", options.rate,
+                      options.poisson ? "Poisson" : "uniforme");
+    }
+    std::printf("Alvo %s, %d threads, %s, %g s (+%g s de aquecimento), %zu PDFs e %zu imagens\n",
+                options.target.c_str(), options.concurrency, mode, options.duration_seconds,
+                options.warmup_seconds, corpus.pdfs.size(), corpus.images.size());
+
+    RpcStats stats[kRpcs];
+    const Clock::time_point start = Clock::now();
+    const Clock::time_point measure_from = start + Scheduler::ToDuration(options.warmup_seconds);
+    Scheduler scheduler(options, corpus, start);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < options.concurrency; ++i) {
+        threads.emplace_back([&, i] {
+            LoadClient client(options, channels[i / kThreadsPerChannel]);
+            Slot slot;
+            while (scheduler.Next(&slot)) {
+                std::this_thread::sleep_until(slot.intended);
+                Clock::time_point sent_at = Clock::now();
+                size_t sent = 0;
+                size_t received = 0;
+                grpc::Status status = client.Call(slot.rpc, *slot.sample, &sent, &received);
+                Clock::time_point done = Clock::now();
+                if (slot.intended < measure_from) {
+                    continue;
+                }
+                RpcStats& rpc_stats = stats[static_cast<size_t>(slot.rpc)];
+                auto micros = [](Clock::duration d) {
+                    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(d).count());
+                };
+                rpc_stats.latency.Record(micros(done - slot.intended));
+                rpc_stats.service.Record(micros(done - sent_at));
+                rpc_stats.status[std::min<size_t>(status.error_code(), 16)]++;
+                rpc_stats.bytes_sent += sent;
+                rpc_stats.bytes_received += received;
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    double measured = std::chrono::duration<double>(Clock::now() - measure_from).count();
+    PrintReport(stats, measured, options.rate > 0);
+    return 0;
+}
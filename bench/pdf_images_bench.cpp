@@ -0,0 +1,149 @@
+// Benchmark da recompressão de imagens em processo (--native-pdf-images).
+//
+// PDF sintético com uma imagem RGB sem compressão de 1200x1200 por página,
+// desenhada a ~170 dpi: com /screen, cada imagem é reamostrada para 72 dpi e
+// recodificada em JPEG. Varia o número de páginas e de threads; threads = 1
+// serve de base para o contador speedup. BM_Ghostscript comprime a mesma
+// entrada com um processo gs (pulado sem gs no PATH).
+
+#include <benchmark/benchmark.h>
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench/synthetic_pdf.h"
+#include "src/native_pdf_compressor.h"
+#include "src/tool_commands.h"
+
+namespace {
+
+constexpr int kImageSide = 1200;
+
+// Tempo médio por documento com threads = 1, por número de páginas.
+std::map<int, double> single_thread_seconds;
+
+// Fallback que falha: o benchmark só mede documentos reescritos em processo.
+class NoFallback final : public PdfCompressor {
+public:
+    bool Compress(const std::string&, const std::string&, const PdfCompressSettings&, std::string* error) override {
+        *error = "documento não foi reescrito em processo";
+        return false;
+    }
+    const char* Name() const override { return "none"; }
+    bool SupportsPipe() const override { return true; }
+    bool CompressPipe(const std::string&, const PdfCompressSettings&, std::string*, std::string* error) override {
+        *error = "documento não foi reescrito em processo";
+        return false;
+    }
+};
+
+PdfCompressSettings ScreenSettings() {
+    PdfCompressSettings settings;
+    settings.pdf_settings = "/screen";
+    return settings;
+}
+
+void SetCounters(benchmark::State& state, int pages, size_t input_bytes, size_t output_bytes) {
+    state.counters["pages_per_s"] =
+        benchmark::Counter(static_cast<double>(pages) * state.iterations(), benchmark::Counter::kIsRate);
+    state.counters["ratio"] = static_cast<double>(output_bytes) / static_cast<double>(input_bytes);
+    state.counters["cores"] = std::thread::hardware_concurrency();
+}
+
+void BM_NativeImages(benchmark::State& state) {
+    const int pages = static_cast<int>(state.range(0));
+    const int threads = static_cast<int>(state.range(1));
+    const std::string input = MakeSyntheticPdf(pages, kImageSide);
+
+    NativePdfCompressor::Options options;
+    options.threads = threads;
+    NativePdfCompressor compressor(std::make_unique<NoFallback>(), options);
+
+    std::string output;
+    for (auto _ : state) {
+        std::string error;
+        if (!compressor.CompressPipe(input, ScreenSettings(), &output, &error)) {
+            state.SkipWithError(error.c_str());
+            break;
+        }
+    }
+    if (state.iterations() > 0) {
+        SetCounters(state, pages, input.size(), output.size());
+    }
+}
+
+void BM_Ghostscript(benchmark::State& state) {
+    if (!ProgramInPath("gs")) {
+        state.SkipWithError("gs não encontrado no PATH");
+        return;
+    }
+    const int pages = static_cast<int>(state.range(0));
+    const std::string input = MakeSyntheticPdf(pages, kImageSide);
+    GhostscriptProcessCompressor compressor;
+
+    std::string output;
+    for (auto _ : state) {
+        std::string error;
+        if (!compressor.CompressPipe(input, ScreenSettings(), &output, &error)) {
+            state.SkipWithError(error.c_str());
+            break;
+        }
+    }
+    if (state.iterations() > 0) {
+        SetCounters(state, pages, input.size(), output.size());
+    }
+}
+
+// Acrescenta o contador speedup (tempo com threads = 1 / tempo do caso). Os
+// casos de um mesmo número de páginas rodam em ordem crescente de threads.
+class SpeedupReporter : public benchmark::ConsoleReporter {
+public:
+    void ReportRuns(const std::vector<Run>& runs) override {
+        std::vector<Run> copy = runs;
+        for (Run& run : copy) {
+            if (run.error_occurred || run.iterations == 0) {
+                continue;
+            }
+            double seconds = run.real_accumulated_time / run.iterations;
+            int pages = 0, threads = 0;
+            if (std::sscanf(run.run_name.args.c_str(), "pages:%d/threads:%d", &pages, &threads) != 2) {
+                continue;
+            }
+            if (threads == 1) {
+                single_thread_seconds[pages] = seconds;
+            }
+            auto base = single_thread_seconds.find(pages);
+            if (base != single_thread_seconds.end() && seconds > 0) {
+                run.counters["speedup"] = base->second / seconds;
+            }
+        }
+        ConsoleReporter::ReportRuns(copy);
+    }
+};
+
+}  // namespace
+
+BENCHMARK(BM_NativeImages)
+    ->ArgNames({"pages", "threads"})
+    ->ArgsProduct({{16, 64}, {1, 2, 4, 8}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_Ghostscript)->ArgNames({"pages"})->Arg(16)->Arg(64)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    SpeedupReporter reporter;
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+    benchmark::Shutdown();
+    return 0;
+}
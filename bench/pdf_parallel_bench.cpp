@@ -0,0 +1,112 @@
+// Benchmark da compressão paralela por páginas (--parallel-pdf).
+//
+// Varia o número de páginas e de workers; workers = 1 é a passada única
+// (o ParallelPdfCompressor delega ao motor original) e serve de base para o
+// contador speedup. Precisa do gs no PATH; sem ele os casos são pulados.
+
+#include <benchmark/benchmark.h>
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench/synthetic_pdf.h"
+#include "src/parallel_pdf_compressor.h"
+#include "src/tool_commands.h"
+
+namespace {
+
+// Tempo médio por compressão com workers = 1, por número de páginas.
+std::map<int, double> single_pass_seconds;
+
+std::string WriteInput(int pages) {
+    std::string path = "/tmp/pdf_parallel_bench_" + std::to_string(getpid()) + "_" + std::to_string(pages) + ".pdf";
+    std::ofstream(path, std::ios::binary) << MakeSyntheticPdf(pages);
+    return path;
+}
+
+void BM_ParallelCompress(benchmark::State& state) {
+    if (!ProgramInPath("gs")) {
+        state.SkipWithError("gs não encontrado no PATH");
+        return;
+    }
+    const int pages = static_cast<int>(state.range(0));
+    const int workers = static_cast<int>(state.range(1));
+    const std::string input = WriteInput(pages);
+    const std::string output = input + ".out";
+
+    ParallelPdfCompressor::Options options;
+    options.min_pages = 2;
+    options.workers = workers;
+    ParallelPdfCompressor compressor(std::make_unique<GhostscriptProcessCompressor>(), options);
+
+    for (auto _ : state) {
+        std::string error;
+        if (!compressor.Compress(input, output, PdfCompressSettings(), &error)) {
+            state.SkipWithError(error.c_str());
+            break;
+        }
+    }
+    unlink(input.c_str());
+    unlink(output.c_str());
+    if (state.iterations() == 0) {
+        return;
+    }
+
+    // O relógio de parede inclui os processos gs filhos (UseRealTime).
+    state.counters["pages_per_s"] =
+        benchmark::Counter(static_cast<double>(pages) * state.iterations(), benchmark::Counter::kIsRate);
+    state.counters["cores"] = std::thread::hardware_concurrency();
+}
+
+// Acrescenta o contador speedup (tempo com workers = 1 / tempo do caso). Os
+// casos de um mesmo número de páginas rodam em ordem crescente de workers.
+class SpeedupReporter : public benchmark::ConsoleReporter {
+public:
+    void ReportRuns(const std::vector<Run>& runs) override {
+        std::vector<Run> copy = runs;
+        for (Run& run : copy) {
+            if (run.error_occurred || run.iterations == 0) {
+                continue;
+            }
+            double seconds = run.real_accumulated_time / run.iterations;
+            int pages = 0, workers = 0;
+            if (std::sscanf(run.run_name.args.c_str(), "pages:%d/workers:%d", &pages, &workers) != 2) {
+                continue;
+            }
+            if (workers == 1) {
+                single_pass_seconds[pages] = seconds;
+            }
+            auto base = single_pass_seconds.find(pages);
+            if (base != single_pass_seconds.end() && seconds > 0) {
+                run.counters["speedup"] = base->second / seconds;
+            }
+        }
+        ConsoleReporter::ReportRuns(copy);
+    }
+};
+
+}  // namespace
+
+BENCHMARK(BM_ParallelCompress)
+    ->ArgNames({"pages", "workers"})
+    ->ArgsProduct({{8, 32, 128}, {1, 2, 4, 8}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    SpeedupReporter reporter;
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+    benchmark::Shutdown();
+    return 0;
+}
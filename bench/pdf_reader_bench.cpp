@@ -0,0 +1,134 @@
+// Benchmark do leitor de PDF em processo (PdfDocument) em arquivos grandes.
+//
+// Mede o tempo até o número de páginas e a memória residente que a leitura
+// acrescenta, num PDF sintético de centenas de MB (uma imagem sem compressão
+// por página). Modos:
+//   0 = mmap do arquivo, xref preguiçosa, /Count da raiz (CountPages);
+//   1 = arquivo lido para a memória antes de abrir (o que um leitor que
+//       copia a entrada paga);
+//   2 = mmap e árvore de páginas inteira (pages(), como na extração de texto);
+//   3 = subprocesso gs (o CountPages anterior; pulado sem gs no PATH).
+// Contadores de memória, crescimento do RSS com o documento aberto:
+// anon_MB é a memória privada (o que a leitura aloca) e mapped_MB as páginas
+// do arquivo mapeadas. O arquivo acabou de ser escrito e está no page cache
+// em folios grandes, então cada objeto tocado mapeia o folio inteiro e
+// mapped_MB sai maior que com o cache frio.
+
+#include <benchmark/benchmark.h>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+
+#include "bench/synthetic_pdf.h"
+#include "src/pdf_document.h"
+#include "src/subprocess.h"
+#include "src/tool_commands.h"
+
+namespace {
+
+const char* const kModeNames[] = {"mmap+count", "read+count", "mmap+pages", "gs"};
+
+std::string WriteInput(int pages) {
+    std::string path = "/tmp/pdf_reader_bench_" + std::to_string(getpid()) + "_" + std::to_string(pages) + ".pdf";
+    std::ofstream(path, std::ios::binary) << MakeSyntheticPdf(pages);
+    return path;
+}
+
+// Memória residente do processo em bytes.
+struct Resident {
+    double anon = 0;  // privada (heap): o que o leitor aloca
+    double file = 0;  // páginas de arquivo mapeadas (page cache compartilhado)
+};
+
+Resident ReadResident() {
+    Resident resident;
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        double kb = 0;
+        if (std::sscanf(line.c_str(), "RssAnon: %lf", &kb) == 1) {
+            resident.anon = kb * 1024;
+        } else if (std::sscanf(line.c_str(), "RssFile: %lf", &kb) == 1) {
+            resident.file = kb * 1024;
+        }
+    }
+    return resident;
+}
+
+// Número de páginas pelo modo; resident recebe o RSS com o documento aberto.
+int CountPages(int mode, const std::string& path, Resident* resident, std::string* error) {
+    if (mode == 3) {
+        std::string output;
+        if (!RunSubprocess(GhostscriptPageCountCommand(path), std::string(), &output, error)) {
+            return -1;
+        }
+        *resident = ReadResident();
+        return std::atoi(output.c_str());
+    }
+    std::string data;
+    if (mode == 1) {
+        std::ifstream in(path, std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    auto document = mode == 1 ? std::make_unique<PdfDocument>(data.data(), data.size())
+                              : std::make_unique<PdfDocument>(path);
+    if (!document->Open(error)) {
+        return -1;
+    }
+    int pages = mode == 2 ? static_cast<int>(document->pages().size()) : document->page_count();
+    *resident = ReadResident();
+    return pages;
+}
+
+void BM_PageCount(benchmark::State& state) {
+    const int pages = static_cast<int>(state.range(0));
+    const int mode = static_cast<int>(state.range(1));
+    state.SetLabel(kModeNames[mode]);
+    if (mode == 3 && !ProgramInPath("gs")) {
+        state.SkipWithError("gs não encontrado no PATH");
+        return;
+    }
+    const std::string input = WriteInput(pages);
+
+    Resident growth;
+    for (auto _ : state) {
+        std::string error;
+        Resident before = ReadResident();
+        Resident after;
+        int counted = CountPages(mode, input, &after, &error);
+        if (counted != pages) {
+            state.SkipWithError(counted < 0 ? error.c_str() : "contagem de páginas errada");
+            break;
+        }
+        growth.anon = std::max(growth.anon, after.anon - before.anon);
+        growth.file = std::max(growth.file, after.file - before.file);
+    }
+    std::ifstream in(input, std::ios::binary | std::ios::ate);
+    state.counters["file_MB"] = static_cast<double>(in.tellg()) / (1024 * 1024);
+    state.counters["anon_MB"] = growth.anon / (1024 * 1024);
+    state.counters["mapped_MB"] = growth.file / (1024 * 1024);
+    unlink(input.c_str());
+}
+
+void PageCountArguments(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"pages", "mode"});
+    // ~140 MB e ~570 MB com imagens de 400x400 RGB.
+    for (int pages : {300, 1200}) {
+        for (int mode = 0; mode < 4; ++mode) {
+            bench->Args({pages, mode});
+        }
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_PageCount)->Apply(PageCountArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
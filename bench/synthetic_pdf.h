@@ -0,0 +1,81 @@
+#pragma once
+
+// Gerador de PDFs sintéticos para os benchmarks.
+//
+// Cada página tem uma imagem RGB sem compressão (image_side x image_side) e
+// uma linha de texto, o que dá ao gs trabalho real de reamostragem e
+// recompressão por página.
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+inline std::string MakeSyntheticPdf(int pages, int image_side = 400) {
+    std::string pdf = "%PDF-1.4\n%\xE2\xE3\xCF\xD3\n";
+    std::vector<size_t> offsets;  // offsets[i] = posição do objeto i + 1
+
+    auto begin_object = [&](int number) {
+        offsets.resize(std::max<size_t>(offsets.size(), number));
+        offsets[number - 1] = pdf.size();
+        pdf += std::to_string(number) + " 0 obj\n";
+    };
+
+    // 1: Catalog, 2: Pages, 3: fonte; página i usa 4 + 3i (Page),
+    // 5 + 3i (conteúdo) e 6 + 3i (imagem).
+    begin_object(1);
+    pdf += "<< /Type /Catalog /Pages 2 0 R >>\nendobj\n";
+    begin_object(2);
+    pdf += "<< /Type /Pages /Count " + std::to_string(pages) + " /Kids [";
+    for (int i = 0; i < pages; ++i) {
+        pdf += " " + std::to_string(4 + 3 * i) + " 0 R";
+    }
+    pdf += " ] >>\nendobj\n";
+    begin_object(3);
+    pdf += "<< /Type /Font /Subtype /Type1 /BaseFont /Helvetica >>\nendobj\n";
+
+    const size_t image_bytes = static_cast<size_t>(image_side) * image_side * 3;
+    std::string image(image_bytes, '\0');
+    for (int i = 0; i < pages; ++i) {
+        int page = 4 + 3 * i;
+        begin_object(page);
+        pdf += "<< /Type /Page /Parent 2 0 R /MediaBox [0 0 612 792] /Contents " + std::to_string(page + 1) +
+               " 0 R /Resources << /Font << /F1 3 0 R >> /XObject << /Im1 " + std::to_string(page + 2) +
+               " 0 R >> >> >>\nendobj\n";
+
+        std::string content = "q 500 0 0 500 56 200 cm /Im1 Do Q\nBT /F1 24 Tf 72 720 Td (Pagina " +
+                              std::to_string(i + 1) + ") Tj ET\n";
+        begin_object(page + 1);
+        pdf += "<< /Length " + std::to_string(content.size()) + " >>\nstream\n" + content + "endstream\nendobj\n";
+
+        // Gradiente com ruído determinístico, diferente em cada página.
+        unsigned state = 2463534242u + i;
+        for (size_t p = 0; p < image_bytes; p += 3) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            size_t x = (p / 3) % image_side;
+            size_t y = (p / 3) / image_side;
+            image[p] = static_cast<char>((x + i * 16) & 0xFF);
+            image[p + 1] = static_cast<char>((y + (state & 0x1F)) & 0xFF);
+            image[p + 2] = static_cast<char>((x + y) & 0xFF);
+        }
+        begin_object(page + 2);
+        pdf += "<< /Type /XObject /Subtype /Image /Width " + std::to_string(image_side) + " /Height " +
+               std::to_string(image_side) + " /ColorSpace /DeviceRGB /BitsPerComponent 8 /Length " +
+               std::to_string(image_bytes) + " >>\nstream\n";
+        pdf += image;
+        pdf += "\nendstream\nendobj\n";
+    }
+
+    size_t xref_offset = pdf.size();
+    pdf += "xref\n0 " + std::to_string(offsets.size() + 1) + "\n0000000000 65535 f \n";
+    char entry[32];
+    for (size_t offset : offsets) {
+        std::snprintf(entry, sizeof(entry), "%010zu 00000 n \n", offset);
+        pdf += entry;
+    }
+    pdf += "trailer\n<< /Size " + std::to_string(offsets.size() + 1) + " /Root 1 0 R >>\nstartxref\n" +
+           std::to_string(xref_offset) + "\n%%EOF\n";
+    return pdf;
+}
@@ -7,8 +7,17 @@ import sys
 import os
 
 CHUNK_SIZE = 64 * 1024  # 64KB
+# Tamanho pedido ao servidor para os chunks de resposta (chunk_size_hint)
+RESPONSE_CHUNK_SIZE = 1024 * 1024  # 1MB
 
-def compress_pdf(stub, input_file, output_file):
+PDF_PRESETS = {
+    "screen": file_processor_pb2.PDF_PRESET_SCREEN,
+    "ebook": file_processor_pb2.PDF_PRESET_EBOOK,
+    "printer": file_processor_pb2.PDF_PRESET_PRINTER,
+    "prepress": file_processor_pb2.PDF_PRESET_PREPRESS,
+}
+
+def compress_pdf(stub, input_file, output_file, preset=None):
     """Compress PDF - RPC unário"""
     print(f"📦 Comprimindo PDF: {input_file} -> {output_file}")
     
@@ -20,6 +29,8 @@ def compress_pdf(stub, input_file, output_file):
             file_name=os.path.basename(input_file),
             file_content=file_content
         )
+        if preset:
+            request.options.pdf_preset = PDF_PRESETS[preset]
         
         response = stub.CompressPDF(request)
         
@@ -38,18 +49,11 @@ def compress_pdf(stub, input_file, output_file):
 
 def file_chunk_iterator(file_path, **params):
     """Gerador de chunks para streaming"""
-    base_name = os.path.basename(file_path)
-    
-    # Primeiro chunk com metadados
+    # Primeiro chunk com o nome e as opções da requisição
     first_chunk = file_processor_pb2.FileChunk()
-    
-    # Construir nome do arquivo com parâmetros se for resize ou conversão
-    if 'width' in params and 'height' in params:
-        first_chunk.file_name = f"{base_name}|{params['width']}|{params['height']}"
-    elif 'format' in params:
-        first_chunk.file_name = f"{base_name}|{params['format']}"
-    else:
-        first_chunk.file_name = base_name
+    first_chunk.file_name = os.path.basename(file_path)
+    first_chunk.options.CopyFrom(file_processor_pb2.ProcessingOptions(
+        chunk_size_hint=RESPONSE_CHUNK_SIZE, total_size=os.path.getsize(file_path), **params))
     
     yield first_chunk
     
@@ -87,13 +91,13 @@ def convert_to_txt(stub, input_file, output_file):
     except Exception as e:
         print(f"❌ Erro na conversão para TXT: {e}")
 
-def convert_image_format(stub, input_file, output_file, out_format):
+def convert_image_format(stub, input_file, output_file, out_format, quality=0):
     """Convert image format - streaming bidirecional"""
     print(f"🖼️ Convertendo imagem: {input_file} -> {output_file} ({out_format.upper()})")
     
     try:
         response_stream = stub.ConvertImageFormat(
-            file_chunk_iterator(input_file, format=out_format)
+            file_chunk_iterator(input_file, output_format=out_format, quality=quality)
         )
         
         with open(output_file, "wb") as f:
@@ -106,13 +110,13 @@ def convert_image_format(stub, input_file, output_file, out_format):
     except Exception as e:
         print(f"❌ Erro na conversão de imagem: {e}")
 
-def resize_image(stub, input_file, output_file, width, height):
+def resize_image(stub, input_file, output_file, width, height, quality=0):
     """Resize image - streaming bidirecional"""
     print(f"📐 Redimensionando imagem: {input_file} -> {output_file} ({width}x{height})")
     
     try:
         response_stream = stub.ResizeImage(
-            file_chunk_iterator(input_file, width=width, height=height)
+            file_chunk_iterator(input_file, width=width, height=height, quality=quality)
         )
         
         with open(output_file, "wb") as f:
@@ -129,10 +133,10 @@ def print_usage():
     print("🚀 Cliente File Processor gRPC")
     print("=" * 40)
     print("Uso:")
-    print("  python client.py compress input.pdf output.pdf")
+    print("  python client.py compress input.pdf output.pdf [screen|ebook|printer|prepress]")
     print("  python client.py totxt input.pdf output.txt")
-    print("  python client.py convertimg input.jpg output.png png")
-    print("  python client.py resize input.jpg output.jpg 800 600")
+    print("  python client.py convertimg input.jpg output.png png [qualidade]")
+    print("  python client.py resize input.jpg output.jpg 800 600 [qualidade]")
     print("\nExemplos:")
     print("  python client.py compress document.pdf compressed.pdf")
     print("  python client.py totxt document.pdf output.txt")
@@ -166,7 +170,11 @@ def main():
             sys.exit(1)
 
         if cmd == "compress":
-            compress_pdf(stub, input_file, output_file)
+            preset = sys.argv[4] if len(sys.argv) > 4 else None
+            if preset and preset not in PDF_PRESETS:
+                print(f"❌ Preset inválido: {preset} (use {', '.join(PDF_PRESETS)})")
+                sys.exit(1)
+            compress_pdf(stub, input_file, output_file, preset)
         elif cmd == "totxt":
             convert_to_txt(stub, input_file, output_file)
         elif cmd == "convertimg":
@@ -174,14 +182,16 @@ def main():
                 print("❌ Precisa informar o formato de saída (ex: png, jpg)")
                 sys.exit(1)
             out_format = sys.argv[4]
-            convert_image_format(stub, input_file, output_file, out_format)
+            quality = int(sys.argv[5]) if len(sys.argv) > 5 else 0
+            convert_image_format(stub, input_file, output_file, out_format, quality)
         elif cmd == "resize":
             if len(sys.argv) < 6:
                 print("❌ Precisa informar width e height")
                 sys.exit(1)
             width = int(sys.argv[4])
             height = int(sys.argv[5])
-            resize_image(stub, input_file, output_file, width, height)
+            quality = int(sys.argv[6]) if len(sys.argv) > 6 else 0
+            resize_image(stub, input_file, output_file, width, height, quality)
         else:
             print_usage()
             sys.exit(1)
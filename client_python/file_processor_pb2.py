@@ -24,19 +24,23 @@ _sym_db = _symbol_database.Default()
 
 
 
-DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\x14\x66ile_processor.proto\x12\x0e\x66ile_processor\"6\n\x0b\x46ileRequest\x12\x11\n\tfile_name\x18\x01 \x01(\t\x12\x14\n\x0c\x66ile_content\x18\x02 \x01(\x0c\"`\n\x0c\x46ileResponse\x12\x0f\n\x07success\x18\x01 \x01(\x08\x12\x16\n\x0estatus_message\x18\x02 \x01(\t\x12\x11\n\tfile_name\x18\x03 \x01(\t\x12\x14\n\x0c\x66ile_content\x18\x04 \x01(\x0c\"C\n\tFileChunk\x12\x11\n\tfile_name\x18\x01 \x01(\t\x12\x12\n\nchunk_data\x18\x02 \x01(\x0c\x12\x0f\n\x07is_last\x18\x03 \x01(\x08\x32\xbc\x02\n\rFileProcessor\x12H\n\x0b\x43ompressPDF\x12\x1b.file_processor.FileRequest\x1a\x1c.file_processor.FileResponse\x12H\n\x0c\x43onvertToTXT\x12\x19.file_processor.FileChunk\x1a\x19.file_processor.FileChunk(\x01\x30\x01\x12N\n\x12\x43onvertImageFormat\x12\x19.file_processor.FileChunk\x1a\x19.file_processor.FileChunk(\x01\x30\x01\x12G\n\x0bResizeImage\x12\x19.file_processor.FileChunk\x1a\x19.file_processor.FileChunk(\x01\x30\x01\x62\x06proto3')
+DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\x14\x66ile_processor.proto\x12\x0e\x66ile_processor\"\xd1\x01\n\x11ProcessingOptions\x12\x15\n\routput_format\x18\x01 \x01(\t\x12\r\n\x05width\x18\x02 \x01(\x05\x12\x0e\n\x06height\x18\x03 \x01(\x05\x12\x0f\n\x07quality\x18\x04 \x01(\x05\x12-\n\npdf_preset\x18\x05 \x01(\x0e\x32\x19.file_processor.PdfPreset\x12\x17\n\x0f\x63hunk_size_hint\x18\x06 \x01(\x05\x12\x19\n\x11\x63ompression_level\x18\x07 \x01(\x05\x12\x12\n\ntotal_size\x18\x08 \x01(\x03\"j\n\x0b\x46ileRequest\x12\x11\n\tfile_name\x18\x01 \x01(\t\x12\x14\n\x0c\x66ile_content\x18\x02 \x01(\x0c\x12\x32\n\x07options\x18\x03 \x01(\x0b\x32!.file_processor.ProcessingOptions\"`\n\x0c\x46ileResponse\x12\x0f\n\x07success\x18\x01 \x01(\x08\x12\x16\n\x0estatus_message\x18\x02 \x01(\t\x12\x11\n\tfile_name\x18\x03 \x01(\t\x12\x14\n\x0c\x66ile_content\x18\x04 \x01(\x0c\"w\n\tFileChunk\x12\x11\n\tfile_name\x18\x01 \x01(\t\x12\x12\n\nchunk_data\x18\x02 \x01(\x0c\x12\x0f\n\x07is_last\x18\x03 \x01(\x08\x12\x32\n\x07options\x18\x04 \x01(\x0b\x32!.file_processor.ProcessingOptions*\x81\x01\n\tPdfPreset\x12\x16\n\x12PDF_PRESET_DEFAULT\x10\x00\x12\x15\n\x11PDF_PRESET_SCREEN\x10\x01\x12\x14\n\x10PDF_PRESET_EBOOK\x10\x02\x12\x16\n\x12PDF_PRESET_PRINTER\x10\x03\x12\x17\n\x13PDF_PRESET_PREPRESS\x10\x04\x32\xbc\x02\n\rFileProcessor\x12H\n\x0b\x43ompressPDF\x12\x1b.file_processor.FileRequest\x1a\x1c.file_processor.FileResponse\x12H\n\x0c\x43onvertToTXT\x12\x19.file_processor.FileChunk\x1a\x19.file_processor.FileChunk(\x01\x30\x01\x12N\n\x12\x43onvertImageFormat\x12\x19.file_processor.FileChunk\x1a\x19.file_processor.FileChunk(\x01\x30\x01\x12G\n\x0bResizeImage\x12\x19.file_processor.FileChunk\x1a\x19.file_processor.FileChunk(\x01\x30\x01\x62\x06proto3')
 
 _globals = globals()
 _builder.BuildMessageAndEnumDescriptors(DESCRIPTOR, _globals)
 _builder.BuildTopDescriptorsAndMessages(DESCRIPTOR, 'file_processor_pb2', _globals)
 if not _descriptor._USE_C_DESCRIPTORS:
   DESCRIPTOR._loaded_options = None
-  _globals['_FILEREQUEST']._serialized_start=40
-  _globals['_FILEREQUEST']._serialized_end=94
-  _globals['_FILERESPONSE']._serialized_start=96
-  _globals['_FILERESPONSE']._serialized_end=192
-  _globals['_FILECHUNK']._serialized_start=194
-  _globals['_FILECHUNK']._serialized_end=261
-  _globals['_FILEPROCESSOR']._serialized_start=264
-  _globals['_FILEPROCESSOR']._serialized_end=580
+  _globals['_PDFPRESET']._serialized_start=580
+  _globals['_PDFPRESET']._serialized_end=709
+  _globals['_PROCESSINGOPTIONS']._serialized_start=41
+  _globals['_PROCESSINGOPTIONS']._serialized_end=250
+  _globals['_FILEREQUEST']._serialized_start=252
+  _globals['_FILEREQUEST']._serialized_end=358
+  _globals['_FILERESPONSE']._serialized_start=360
+  _globals['_FILERESPONSE']._serialized_end=456
+  _globals['_FILECHUNK']._serialized_start=458
+  _globals['_FILECHUNK']._serialized_end=577
+  _globals['_FILEPROCESSOR']._serialized_start=712
+  _globals['_FILEPROCESSOR']._serialized_end=1028
 # @@protoc_insertion_point(module_scope)
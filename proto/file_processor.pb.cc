@@ -21,10 +21,31 @@ namespace _pb = ::PROTOBUF_NAMESPACE_ID;
 namespace _pbi = _pb::internal;
 
 namespace file_processor {
+PROTOBUF_CONSTEXPR ProcessingOptions::ProcessingOptions(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.output_format_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.width_)*/0
+  , /*decltype(_impl_.height_)*/0
+  , /*decltype(_impl_.quality_)*/0
+  , /*decltype(_impl_.pdf_preset_)*/0
+  , /*decltype(_impl_.chunk_size_hint_)*/0
+  , /*decltype(_impl_.compression_level_)*/0
+  , /*decltype(_impl_.total_size_)*/int64_t{0}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct ProcessingOptionsDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR ProcessingOptionsDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~ProcessingOptionsDefaultTypeInternal() {}
+  union {
+    ProcessingOptions _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 ProcessingOptionsDefaultTypeInternal _ProcessingOptions_default_instance_;
 PROTOBUF_CONSTEXPR FileRequest::FileRequest(
     ::_pbi::ConstantInitialized): _impl_{
     /*decltype(_impl_.file_name_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
   , /*decltype(_impl_.file_content_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.options_)*/nullptr
   , /*decltype(_impl_._cached_size_)*/{}} {}
 struct FileRequestDefaultTypeInternal {
   PROTOBUF_CONSTEXPR FileRequestDefaultTypeInternal()
@@ -55,6 +76,7 @@ PROTOBUF_CONSTEXPR FileChunk::FileChunk(
     ::_pbi::ConstantInitialized): _impl_{
     /*decltype(_impl_.file_name_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
   , /*decltype(_impl_.chunk_data_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.options_)*/nullptr
   , /*decltype(_impl_.is_last_)*/false
   , /*decltype(_impl_._cached_size_)*/{}} {}
 struct FileChunkDefaultTypeInternal {
@@ -67,11 +89,25 @@ struct FileChunkDefaultTypeInternal {
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 FileChunkDefaultTypeInternal _FileChunk_default_instance_;
 }  // namespace file_processor
-static ::_pb::Metadata file_level_metadata_file_5fprocessor_2eproto[3];
-static constexpr ::_pb::EnumDescriptor const** file_level_enum_descriptors_file_5fprocessor_2eproto = nullptr;
+static ::_pb::Metadata file_level_metadata_file_5fprocessor_2eproto[4];
+static const ::_pb::EnumDescriptor* file_level_enum_descriptors_file_5fprocessor_2eproto[1];
 static constexpr ::_pb::ServiceDescriptor const** file_level_service_descriptors_file_5fprocessor_2eproto = nullptr;
 
 const uint32_t TableStruct_file_5fprocessor_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::file_processor::ProcessingOptions, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::file_processor::ProcessingOptions, _impl_.output_format_),
+  PROTOBUF_FIELD_OFFSET(::file_processor::ProcessingOptions, _impl_.width_),
+  PROTOBUF_FIELD_OFFSET(::file_processor::ProcessingOptions, _impl_.height_),
+  PROTOBUF_FIELD_OFFSET(::file_processor::ProcessingOptions, _impl_.quality_),
+  PROTOBUF_FIELD_OFFSET(::file_processor::ProcessingOptions, _impl_.pdf_preset_),
+  PROTOBUF_FIELD_OFFSET(::file_processor::ProcessingOptions, _impl_.chunk_size_hint_),
+  PROTOBUF_FIELD_OFFSET(::file_processor::ProcessingOptions, _impl_.compression_level_),
+  PROTOBUF_FIELD_OFFSET(::file_processor::ProcessingOptions, _impl_.total_size_),
   ~0u,  // no _has_bits_
   PROTOBUF_FIELD_OFFSET(::file_processor::FileRequest, _internal_metadata_),
   ~0u,  // no _extensions_
@@ -80,6 +116,7 @@ const uint32_t TableStruct_file_5fprocessor_2eproto::offsets[] PROTOBUF_SECTION_
   ~0u,  // no _inlined_string_donated_
   PROTOBUF_FIELD_OFFSET(::file_processor::FileRequest, _impl_.file_name_),
   PROTOBUF_FIELD_OFFSET(::file_processor::FileRequest, _impl_.file_content_),
+  PROTOBUF_FIELD_OFFSET(::file_processor::FileRequest, _impl_.options_),
   ~0u,  // no _has_bits_
   PROTOBUF_FIELD_OFFSET(::file_processor::FileResponse, _internal_metadata_),
   ~0u,  // no _extensions_
@@ -99,41 +136,55 @@ const uint32_t TableStruct_file_5fprocessor_2eproto::offsets[] PROTOBUF_SECTION_
   PROTOBUF_FIELD_OFFSET(::file_processor::FileChunk, _impl_.file_name_),
   PROTOBUF_FIELD_OFFSET(::file_processor::FileChunk, _impl_.chunk_data_),
   PROTOBUF_FIELD_OFFSET(::file_processor::FileChunk, _impl_.is_last_),
+  PROTOBUF_FIELD_OFFSET(::file_processor::FileChunk, _impl_.options_),
 };
 static const ::_pbi::MigrationSchema schemas[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
-  { 0, -1, -1, sizeof(::file_processor::FileRequest)},
-  { 8, -1, -1, sizeof(::file_processor::FileResponse)},
-  { 18, -1, -1, sizeof(::file_processor::FileChunk)},
+  { 0, -1, -1, sizeof(::file_processor::ProcessingOptions)},
+  { 14, -1, -1, sizeof(::file_processor::FileRequest)},
+  { 23, -1, -1, sizeof(::file_processor::FileResponse)},
+  { 33, -1, -1, sizeof(::file_processor::FileChunk)},
 };
 
 static const ::_pb::Message* const file_default_instances[] = {
+  &::file_processor::_ProcessingOptions_default_instance_._instance,
   &::file_processor::_FileRequest_default_instance_._instance,
   &::file_processor::_FileResponse_default_instance_._instance,
   &::file_processor::_FileChunk_default_instance_._instance,
 };
 
 const char descriptor_table_protodef_file_5fprocessor_2eproto[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) =
-  "\n\024file_processor.proto\022\016file_processor\"6"
-  "\n\013FileRequest\022\021\n\tfile_name\030\001 \001(\t\022\024\n\014file"
-  "_content\030\002 \001(\014\"`\n\014FileResponse\022\017\n\007succes"
-  "s\030\001 \001(\010\022\026\n\016status_message\030\002 \001(\t\022\021\n\tfile_"
-  "name\030\003 \001(\t\022\024\n\014file_content\030\004 \001(\014\"C\n\tFile"
-  "Chunk\022\021\n\tfile_name\030\001 \001(\t\022\022\n\nchunk_data\030\002"
-  " \001(\014\022\017\n\007is_last\030\003 \001(\0102\274\002\n\rFileProcessor\022"
-  "H\n\013CompressPDF\022\033.file_processor.FileRequ"
-  "est\032\034.file_processor.FileResponse\022H\n\014Con"
-  "vertToTXT\022\031.file_processor.FileChunk\032\031.f"
-  "ile_processor.FileChunk(\0010\001\022N\n\022ConvertIm"
-  "ageFormat\022\031.file_processor.FileChunk\032\031.f"
-  "ile_processor.FileChunk(\0010\001\022G\n\013ResizeIma"
-  "ge\022\031.file_processor.FileChunk\032\031.file_pro"
-  "cessor.FileChunk(\0010\001b\006proto3"
+  "\n\024file_processor.proto\022\016file_processor\"\321"
+  "\001\n\021ProcessingOptions\022\025\n\routput_format\030\001 "
+  "\001(\t\022\r\n\005width\030\002 \001(\005\022\016\n\006height\030\003 \001(\005\022\017\n\007qu"
+  "ality\030\004 \001(\005\022-\n\npdf_preset\030\005 \001(\0162\031.file_p"
+  "rocessor.PdfPreset\022\027\n\017chunk_size_hint\030\006 "
+  "\001(\005\022\031\n\021compression_level\030\007 \001(\005\022\022\n\ntotal_"
+  "size\030\010 \001(\003\"j\n\013FileRequest\022\021\n\tfile_name\030\001"
+  " \001(\t\022\024\n\014file_content\030\002 \001(\014\0222\n\007options\030\003 "
+  "\001(\0132!.file_processor.ProcessingOptions\"`"
+  "\n\014FileResponse\022\017\n\007success\030\001 \001(\010\022\026\n\016statu"
+  "s_message\030\002 \001(\t\022\021\n\tfile_name\030\003 \001(\t\022\024\n\014fi"
+  "le_content\030\004 \001(\014\"w\n\tFileChunk\022\021\n\tfile_na"
+  "me\030\001 \001(\t\022\022\n\nchunk_data\030\002 \001(\014\022\017\n\007is_last\030"
+  "\003 \001(\010\0222\n\007options\030\004 \001(\0132!.file_processor."
+  "ProcessingOptions*\201\001\n\tPdfPreset\022\026\n\022PDF_P"
+  "RESET_DEFAULT\020\000\022\025\n\021PDF_PRESET_SCREEN\020\001\022\024"
+  "\n\020PDF_PRESET_EBOOK\020\002\022\026\n\022PDF_PRESET_PRINT"
+  "ER\020\003\022\027\n\023PDF_PRESET_PREPRESS\020\0042\274\002\n\rFilePr"
+  "ocessor\022H\n\013CompressPDF\022\033.file_processor."
+  "FileRequest\032\034.file_processor.FileRespons"
+  "e\022H\n\014ConvertToTXT\022\031.file_processor.FileC"
+  "hunk\032\031.file_processor.FileChunk(\0010\001\022N\n\022C"
+  "onvertImageFormat\022\031.file_processor.FileC"
+  "hunk\032\031.file_processor.FileChunk(\0010\001\022G\n\013R"
+  "esizeImage\022\031.file_processor.FileChunk\032\031."
+  "file_processor.FileChunk(\0010\001b\006proto3"
   ;
 static ::_pbi::once_flag descriptor_table_file_5fprocessor_2eproto_once;
 const ::_pbi::DescriptorTable descriptor_table_file_5fprocessor_2eproto = {
-    false, false, 588, descriptor_table_protodef_file_5fprocessor_2eproto,
+    false, false, 1036, descriptor_table_protodef_file_5fprocessor_2eproto,
     "file_processor.proto",
-    &descriptor_table_file_5fprocessor_2eproto_once, nullptr, 0, 3,
+    &descriptor_table_file_5fprocessor_2eproto_once, nullptr, 0, 4,
     schemas, file_default_instances, TableStruct_file_5fprocessor_2eproto::offsets,
     file_level_metadata_file_5fprocessor_2eproto, file_level_enum_descriptors_file_5fprocessor_2eproto,
     file_level_service_descriptors_file_5fprocessor_2eproto,
@@ -145,13 +196,421 @@ PROTOBUF_ATTRIBUTE_WEAK const ::_pbi::DescriptorTable* descriptor_table_file_5fp
 // Force running AddDescriptors() at dynamic initialization time.
 PROTOBUF_ATTRIBUTE_INIT_PRIORITY2 static ::_pbi::AddDescriptorsRunner dynamic_init_dummy_file_5fprocessor_2eproto(&descriptor_table_file_5fprocessor_2eproto);
 namespace file_processor {
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* PdfPreset_descriptor() {
+  ::PROTOBUF_NAMESPACE_ID::internal::AssignDescriptors(&descriptor_table_file_5fprocessor_2eproto);
+  return file_level_enum_descriptors_file_5fprocessor_2eproto[0];
+}
+bool PdfPreset_IsValid(int value) {
+  switch (value) {
+    case 0:
+    case 1:
+    case 2:
+    case 3:
+    case 4:
+      return true;
+    default:
+      return false;
+  }
+}
+
+
+// ===================================================================
+
+class ProcessingOptions::_Internal {
+ public:
+};
+
+ProcessingOptions::ProcessingOptions(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:file_processor.ProcessingOptions)
+}
+ProcessingOptions::ProcessingOptions(const ProcessingOptions& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  ProcessingOptions* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.output_format_){}
+    , decltype(_impl_.width_){}
+    , decltype(_impl_.height_){}
+    , decltype(_impl_.quality_){}
+    , decltype(_impl_.pdf_preset_){}
+    , decltype(_impl_.chunk_size_hint_){}
+    , decltype(_impl_.compression_level_){}
+    , decltype(_impl_.total_size_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.output_format_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.output_format_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_output_format().empty()) {
+    _this->_impl_.output_format_.Set(from._internal_output_format(), 
+      _this->GetArenaForAllocation());
+  }
+  ::memcpy(&_impl_.width_, &from._impl_.width_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.total_size_) -
+    reinterpret_cast<char*>(&_impl_.width_)) + sizeof(_impl_.total_size_));
+  // @@protoc_insertion_point(copy_constructor:file_processor.ProcessingOptions)
+}
+
+inline void ProcessingOptions::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.output_format_){}
+    , decltype(_impl_.width_){0}
+    , decltype(_impl_.height_){0}
+    , decltype(_impl_.quality_){0}
+    , decltype(_impl_.pdf_preset_){0}
+    , decltype(_impl_.chunk_size_hint_){0}
+    , decltype(_impl_.compression_level_){0}
+    , decltype(_impl_.total_size_){int64_t{0}}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.output_format_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.output_format_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+ProcessingOptions::~ProcessingOptions() {
+  // @@protoc_insertion_point(destructor:file_processor.ProcessingOptions)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void ProcessingOptions::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.output_format_.Destroy();
+}
+
+void ProcessingOptions::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void ProcessingOptions::Clear() {
+// @@protoc_insertion_point(message_clear_start:file_processor.ProcessingOptions)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.output_format_.ClearToEmpty();
+  ::memset(&_impl_.width_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&_impl_.total_size_) -
+      reinterpret_cast<char*>(&_impl_.width_)) + sizeof(_impl_.total_size_));
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* ProcessingOptions::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // string output_format = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          auto str = _internal_mutable_output_format();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "file_processor.ProcessingOptions.output_format"));
+        } else
+          goto handle_unusual;
+        continue;
+      // int32 width = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 16)) {
+          _impl_.width_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // int32 height = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 24)) {
+          _impl_.height_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // int32 quality = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 32)) {
+          _impl_.quality_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .file_processor.PdfPreset pdf_preset = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 40)) {
+          uint64_t val = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+          _internal_set_pdf_preset(static_cast<::file_processor::PdfPreset>(val));
+        } else
+          goto handle_unusual;
+        continue;
+      // int32 chunk_size_hint = 6;
+      case 6:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 48)) {
+          _impl_.chunk_size_hint_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // int32 compression_level = 7;
+      case 7:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 56)) {
+          _impl_.compression_level_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // int64 total_size = 8;
+      case 8:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 64)) {
+          _impl_.total_size_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* ProcessingOptions::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:file_processor.ProcessingOptions)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // string output_format = 1;
+  if (!this->_internal_output_format().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_output_format().data(), static_cast<int>(this->_internal_output_format().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "file_processor.ProcessingOptions.output_format");
+    target = stream->WriteStringMaybeAliased(
+        1, this->_internal_output_format(), target);
+  }
+
+  // int32 width = 2;
+  if (this->_internal_width() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt32ToArray(2, this->_internal_width(), target);
+  }
+
+  // int32 height = 3;
+  if (this->_internal_height() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt32ToArray(3, this->_internal_height(), target);
+  }
+
+  // int32 quality = 4;
+  if (this->_internal_quality() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt32ToArray(4, this->_internal_quality(), target);
+  }
+
+  // .file_processor.PdfPreset pdf_preset = 5;
+  if (this->_internal_pdf_preset() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+      5, this->_internal_pdf_preset(), target);
+  }
+
+  // int32 chunk_size_hint = 6;
+  if (this->_internal_chunk_size_hint() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt32ToArray(6, this->_internal_chunk_size_hint(), target);
+  }
+
+  // int32 compression_level = 7;
+  if (this->_internal_compression_level() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt32ToArray(7, this->_internal_compression_level(), target);
+  }
+
+  // int64 total_size = 8;
+  if (this->_internal_total_size() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt64ToArray(8, this->_internal_total_size(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:file_processor.ProcessingOptions)
+  return target;
+}
+
+size_t ProcessingOptions::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:file_processor.ProcessingOptions)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // string output_format = 1;
+  if (!this->_internal_output_format().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_output_format());
+  }
+
+  // int32 width = 2;
+  if (this->_internal_width() != 0) {
+    total_size += ::_pbi::WireFormatLite::Int32SizePlusOne(this->_internal_width());
+  }
+
+  // int32 height = 3;
+  if (this->_internal_height() != 0) {
+    total_size += ::_pbi::WireFormatLite::Int32SizePlusOne(this->_internal_height());
+  }
+
+  // int32 quality = 4;
+  if (this->_internal_quality() != 0) {
+    total_size += ::_pbi::WireFormatLite::Int32SizePlusOne(this->_internal_quality());
+  }
+
+  // .file_processor.PdfPreset pdf_preset = 5;
+  if (this->_internal_pdf_preset() != 0) {
+    total_size += 1 +
+      ::_pbi::WireFormatLite::EnumSize(this->_internal_pdf_preset());
+  }
+
+  // int32 chunk_size_hint = 6;
+  if (this->_internal_chunk_size_hint() != 0) {
+    total_size += ::_pbi::WireFormatLite::Int32SizePlusOne(this->_internal_chunk_size_hint());
+  }
+
+  // int32 compression_level = 7;
+  if (this->_internal_compression_level() != 0) {
+    total_size += ::_pbi::WireFormatLite::Int32SizePlusOne(this->_internal_compression_level());
+  }
+
+  // int64 total_size = 8;
+  if (this->_internal_total_size() != 0) {
+    total_size += ::_pbi::WireFormatLite::Int64SizePlusOne(this->_internal_total_size());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData ProcessingOptions::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    ProcessingOptions::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*ProcessingOptions::GetClassData() const { return &_class_data_; }
+
+
+void ProcessingOptions::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<ProcessingOptions*>(&to_msg);
+  auto& from = static_cast<const ProcessingOptions&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:file_processor.ProcessingOptions)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (!from._internal_output_format().empty()) {
+    _this->_internal_set_output_format(from._internal_output_format());
+  }
+  if (from._internal_width() != 0) {
+    _this->_internal_set_width(from._internal_width());
+  }
+  if (from._internal_height() != 0) {
+    _this->_internal_set_height(from._internal_height());
+  }
+  if (from._internal_quality() != 0) {
+    _this->_internal_set_quality(from._internal_quality());
+  }
+  if (from._internal_pdf_preset() != 0) {
+    _this->_internal_set_pdf_preset(from._internal_pdf_preset());
+  }
+  if (from._internal_chunk_size_hint() != 0) {
+    _this->_internal_set_chunk_size_hint(from._internal_chunk_size_hint());
+  }
+  if (from._internal_compression_level() != 0) {
+    _this->_internal_set_compression_level(from._internal_compression_level());
+  }
+  if (from._internal_total_size() != 0) {
+    _this->_internal_set_total_size(from._internal_total_size());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void ProcessingOptions::CopyFrom(const ProcessingOptions& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:file_processor.ProcessingOptions)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool ProcessingOptions::IsInitialized() const {
+  return true;
+}
+
+void ProcessingOptions::InternalSwap(ProcessingOptions* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.output_format_, lhs_arena,
+      &other->_impl_.output_format_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(ProcessingOptions, _impl_.total_size_)
+      + sizeof(ProcessingOptions::_impl_.total_size_)
+      - PROTOBUF_FIELD_OFFSET(ProcessingOptions, _impl_.width_)>(
+          reinterpret_cast<char*>(&_impl_.width_),
+          reinterpret_cast<char*>(&other->_impl_.width_));
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata ProcessingOptions::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_file_5fprocessor_2eproto_getter, &descriptor_table_file_5fprocessor_2eproto_once,
+      file_level_metadata_file_5fprocessor_2eproto[0]);
+}
 
 // ===================================================================
 
 class FileRequest::_Internal {
  public:
+  static const ::file_processor::ProcessingOptions& options(const FileRequest* msg);
 };
 
+const ::file_processor::ProcessingOptions&
+FileRequest::_Internal::options(const FileRequest* msg) {
+  return *msg->_impl_.options_;
+}
 FileRequest::FileRequest(::PROTOBUF_NAMESPACE_ID::Arena* arena,
                          bool is_message_owned)
   : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
@@ -164,6 +623,7 @@ FileRequest::FileRequest(const FileRequest& from)
   new (&_impl_) Impl_{
       decltype(_impl_.file_name_){}
     , decltype(_impl_.file_content_){}
+    , decltype(_impl_.options_){nullptr}
     , /*decltype(_impl_._cached_size_)*/{}};
 
   _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
@@ -183,6 +643,9 @@ FileRequest::FileRequest(const FileRequest& from)
     _this->_impl_.file_content_.Set(from._internal_file_content(), 
       _this->GetArenaForAllocation());
   }
+  if (from._internal_has_options()) {
+    _this->_impl_.options_ = new ::file_processor::ProcessingOptions(*from._impl_.options_);
+  }
   // @@protoc_insertion_point(copy_constructor:file_processor.FileRequest)
 }
 
@@ -193,6 +656,7 @@ inline void FileRequest::SharedCtor(
   new (&_impl_) Impl_{
       decltype(_impl_.file_name_){}
     , decltype(_impl_.file_content_){}
+    , decltype(_impl_.options_){nullptr}
     , /*decltype(_impl_._cached_size_)*/{}
   };
   _impl_.file_name_.InitDefault();
@@ -218,6 +682,7 @@ inline void FileRequest::SharedDtor() {
   GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
   _impl_.file_name_.Destroy();
   _impl_.file_content_.Destroy();
+  if (this != internal_default_instance()) delete _impl_.options_;
 }
 
 void FileRequest::SetCachedSize(int size) const {
@@ -232,6 +697,10 @@ void FileRequest::Clear() {
 
   _impl_.file_name_.ClearToEmpty();
   _impl_.file_content_.ClearToEmpty();
+  if (GetArenaForAllocation() == nullptr && _impl_.options_ != nullptr) {
+    delete _impl_.options_;
+  }
+  _impl_.options_ = nullptr;
   _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
 }
 
@@ -260,6 +729,14 @@ const char* FileRequest::_InternalParse(const char* ptr, ::_pbi::ParseContext* c
         } else
           goto handle_unusual;
         continue;
+      // .file_processor.ProcessingOptions options = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 26)) {
+          ptr = ctx->ParseMessage(_internal_mutable_options(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -305,6 +782,13 @@ uint8_t* FileRequest::_InternalSerialize(
         2, this->_internal_file_content(), target);
   }
 
+  // .file_processor.ProcessingOptions options = 3;
+  if (this->_internal_has_options()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(3, _Internal::options(this),
+        _Internal::options(this).GetCachedSize(), target, stream);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
         _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
@@ -335,6 +819,13 @@ size_t FileRequest::ByteSizeLong() const {
         this->_internal_file_content());
   }
 
+  // .file_processor.ProcessingOptions options = 3;
+  if (this->_internal_has_options()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+        *_impl_.options_);
+  }
+
   return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
 }
 
@@ -359,6 +850,10 @@ void FileRequest::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PR
   if (!from._internal_file_content().empty()) {
     _this->_internal_set_file_content(from._internal_file_content());
   }
+  if (from._internal_has_options()) {
+    _this->_internal_mutable_options()->::file_processor::ProcessingOptions::MergeFrom(
+        from._internal_options());
+  }
   _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
 }
 
@@ -386,12 +881,13 @@ void FileRequest::InternalSwap(FileRequest* other) {
       &_impl_.file_content_, lhs_arena,
       &other->_impl_.file_content_, rhs_arena
   );
+  swap(_impl_.options_, other->_impl_.options_);
 }
 
 ::PROTOBUF_NAMESPACE_ID::Metadata FileRequest::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_file_5fprocessor_2eproto_getter, &descriptor_table_file_5fprocessor_2eproto_once,
-      file_level_metadata_file_5fprocessor_2eproto[0]);
+      file_level_metadata_file_5fprocessor_2eproto[1]);
 }
 
 // ===================================================================
@@ -716,15 +1212,20 @@ void FileResponse::InternalSwap(FileResponse* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata FileResponse::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_file_5fprocessor_2eproto_getter, &descriptor_table_file_5fprocessor_2eproto_once,
-      file_level_metadata_file_5fprocessor_2eproto[1]);
+      file_level_metadata_file_5fprocessor_2eproto[2]);
 }
 
 // ===================================================================
 
 class FileChunk::_Internal {
  public:
+  static const ::file_processor::ProcessingOptions& options(const FileChunk* msg);
 };
 
+const ::file_processor::ProcessingOptions&
+FileChunk::_Internal::options(const FileChunk* msg) {
+  return *msg->_impl_.options_;
+}
 FileChunk::FileChunk(::PROTOBUF_NAMESPACE_ID::Arena* arena,
                          bool is_message_owned)
   : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
@@ -737,6 +1238,7 @@ FileChunk::FileChunk(const FileChunk& from)
   new (&_impl_) Impl_{
       decltype(_impl_.file_name_){}
     , decltype(_impl_.chunk_data_){}
+    , decltype(_impl_.options_){nullptr}
     , decltype(_impl_.is_last_){}
     , /*decltype(_impl_._cached_size_)*/{}};
 
@@ -757,6 +1259,9 @@ FileChunk::FileChunk(const FileChunk& from)
     _this->_impl_.chunk_data_.Set(from._internal_chunk_data(), 
       _this->GetArenaForAllocation());
   }
+  if (from._internal_has_options()) {
+    _this->_impl_.options_ = new ::file_processor::ProcessingOptions(*from._impl_.options_);
+  }
   _this->_impl_.is_last_ = from._impl_.is_last_;
   // @@protoc_insertion_point(copy_constructor:file_processor.FileChunk)
 }
@@ -768,6 +1273,7 @@ inline void FileChunk::SharedCtor(
   new (&_impl_) Impl_{
       decltype(_impl_.file_name_){}
     , decltype(_impl_.chunk_data_){}
+    , decltype(_impl_.options_){nullptr}
     , decltype(_impl_.is_last_){false}
     , /*decltype(_impl_._cached_size_)*/{}
   };
@@ -794,6 +1300,7 @@ inline void FileChunk::SharedDtor() {
   GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
   _impl_.file_name_.Destroy();
   _impl_.chunk_data_.Destroy();
+  if (this != internal_default_instance()) delete _impl_.options_;
 }
 
 void FileChunk::SetCachedSize(int size) const {
@@ -808,6 +1315,10 @@ void FileChunk::Clear() {
 
   _impl_.file_name_.ClearToEmpty();
   _impl_.chunk_data_.ClearToEmpty();
+  if (GetArenaForAllocation() == nullptr && _impl_.options_ != nullptr) {
+    delete _impl_.options_;
+  }
+  _impl_.options_ = nullptr;
   _impl_.is_last_ = false;
   _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
 }
@@ -845,6 +1356,14 @@ const char* FileChunk::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx
         } else
           goto handle_unusual;
         continue;
+      // .file_processor.ProcessingOptions options = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 34)) {
+          ptr = ctx->ParseMessage(_internal_mutable_options(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -896,6 +1415,13 @@ uint8_t* FileChunk::_InternalSerialize(
     target = ::_pbi::WireFormatLite::WriteBoolToArray(3, this->_internal_is_last(), target);
   }
 
+  // .file_processor.ProcessingOptions options = 4;
+  if (this->_internal_has_options()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(4, _Internal::options(this),
+        _Internal::options(this).GetCachedSize(), target, stream);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
         _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
@@ -926,6 +1452,13 @@ size_t FileChunk::ByteSizeLong() const {
         this->_internal_chunk_data());
   }
 
+  // .file_processor.ProcessingOptions options = 4;
+  if (this->_internal_has_options()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+        *_impl_.options_);
+  }
+
   // bool is_last = 3;
   if (this->_internal_is_last() != 0) {
     total_size += 1 + 1;
@@ -955,6 +1488,10 @@ void FileChunk::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROT
   if (!from._internal_chunk_data().empty()) {
     _this->_internal_set_chunk_data(from._internal_chunk_data());
   }
+  if (from._internal_has_options()) {
+    _this->_internal_mutable_options()->::file_processor::ProcessingOptions::MergeFrom(
+        from._internal_options());
+  }
   if (from._internal_is_last() != 0) {
     _this->_internal_set_is_last(from._internal_is_last());
   }
@@ -985,18 +1522,27 @@ void FileChunk::InternalSwap(FileChunk* other) {
       &_impl_.chunk_data_, lhs_arena,
       &other->_impl_.chunk_data_, rhs_arena
   );
-  swap(_impl_.is_last_, other->_impl_.is_last_);
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(FileChunk, _impl_.is_last_)
+      + sizeof(FileChunk::_impl_.is_last_)
+      - PROTOBUF_FIELD_OFFSET(FileChunk, _impl_.options_)>(
+          reinterpret_cast<char*>(&_impl_.options_),
+          reinterpret_cast<char*>(&other->_impl_.options_));
 }
 
 ::PROTOBUF_NAMESPACE_ID::Metadata FileChunk::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_file_5fprocessor_2eproto_getter, &descriptor_table_file_5fprocessor_2eproto_once,
-      file_level_metadata_file_5fprocessor_2eproto[2]);
+      file_level_metadata_file_5fprocessor_2eproto[3]);
 }
 
 // @@protoc_insertion_point(namespace_scope)
 }  // namespace file_processor
 PROTOBUF_NAMESPACE_OPEN
+template<> PROTOBUF_NOINLINE ::file_processor::ProcessingOptions*
+Arena::CreateMaybeMessage< ::file_processor::ProcessingOptions >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::file_processor::ProcessingOptions >(arena);
+}
 template<> PROTOBUF_NOINLINE ::file_processor::FileRequest*
 Arena::CreateMaybeMessage< ::file_processor::FileRequest >(Arena* arena) {
   return Arena::CreateMessageInternal< ::file_processor::FileRequest >(arena);
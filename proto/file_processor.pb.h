@@ -29,6 +29,7 @@
 #include <google/protobuf/message.h>
 #include <google/protobuf/repeated_field.h>  // IWYU pragma: export
 #include <google/protobuf/extension_set.h>  // IWYU pragma: export
+#include <google/protobuf/generated_enum_reflection.h>
 #include <google/protobuf/unknown_field_set.h>
 // @@protoc_insertion_point(includes)
 #include <google/protobuf/port_def.inc>
@@ -54,16 +55,278 @@ extern FileRequestDefaultTypeInternal _FileRequest_default_instance_;
 class FileResponse;
 struct FileResponseDefaultTypeInternal;
 extern FileResponseDefaultTypeInternal _FileResponse_default_instance_;
+class ProcessingOptions;
+struct ProcessingOptionsDefaultTypeInternal;
+extern ProcessingOptionsDefaultTypeInternal _ProcessingOptions_default_instance_;
 }  // namespace file_processor
 PROTOBUF_NAMESPACE_OPEN
 template<> ::file_processor::FileChunk* Arena::CreateMaybeMessage<::file_processor::FileChunk>(Arena*);
 template<> ::file_processor::FileRequest* Arena::CreateMaybeMessage<::file_processor::FileRequest>(Arena*);
 template<> ::file_processor::FileResponse* Arena::CreateMaybeMessage<::file_processor::FileResponse>(Arena*);
+template<> ::file_processor::ProcessingOptions* Arena::CreateMaybeMessage<::file_processor::ProcessingOptions>(Arena*);
 PROTOBUF_NAMESPACE_CLOSE
 namespace file_processor {
 
+enum PdfPreset : int {
+  PDF_PRESET_DEFAULT = 0,
+  PDF_PRESET_SCREEN = 1,
+  PDF_PRESET_EBOOK = 2,
+  PDF_PRESET_PRINTER = 3,
+  PDF_PRESET_PREPRESS = 4,
+  PdfPreset_INT_MIN_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::min(),
+  PdfPreset_INT_MAX_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::max()
+};
+bool PdfPreset_IsValid(int value);
+constexpr PdfPreset PdfPreset_MIN = PDF_PRESET_DEFAULT;
+constexpr PdfPreset PdfPreset_MAX = PDF_PRESET_PREPRESS;
+constexpr int PdfPreset_ARRAYSIZE = PdfPreset_MAX + 1;
+
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* PdfPreset_descriptor();
+template<typename T>
+inline const std::string& PdfPreset_Name(T enum_t_value) {
+  static_assert(::std::is_same<T, PdfPreset>::value ||
+    ::std::is_integral<T>::value,
+    "Incorrect type passed to function PdfPreset_Name.");
+  return ::PROTOBUF_NAMESPACE_ID::internal::NameOfEnum(
+    PdfPreset_descriptor(), enum_t_value);
+}
+inline bool PdfPreset_Parse(
+    ::PROTOBUF_NAMESPACE_ID::ConstStringParam name, PdfPreset* value) {
+  return ::PROTOBUF_NAMESPACE_ID::internal::ParseNamedEnum<PdfPreset>(
+    PdfPreset_descriptor(), name, value);
+}
 // ===================================================================
 
+class ProcessingOptions final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:file_processor.ProcessingOptions) */ {
+ public:
+  inline ProcessingOptions() : ProcessingOptions(nullptr) {}
+  ~ProcessingOptions() override;
+  explicit PROTOBUF_CONSTEXPR ProcessingOptions(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  ProcessingOptions(const ProcessingOptions& from);
+  ProcessingOptions(ProcessingOptions&& from) noexcept
+    : ProcessingOptions() {
+    *this = ::std::move(from);
+  }
+
+  inline ProcessingOptions& operator=(const ProcessingOptions& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline ProcessingOptions& operator=(ProcessingOptions&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const ProcessingOptions& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const ProcessingOptions* internal_default_instance() {
+    return reinterpret_cast<const ProcessingOptions*>(
+               &_ProcessingOptions_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    0;
+
+  friend void swap(ProcessingOptions& a, ProcessingOptions& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(ProcessingOptions* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(ProcessingOptions* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  ProcessingOptions* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<ProcessingOptions>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const ProcessingOptions& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const ProcessingOptions& from) {
+    ProcessingOptions::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(ProcessingOptions* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "file_processor.ProcessingOptions";
+  }
+  protected:
+  explicit ProcessingOptions(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kOutputFormatFieldNumber = 1,
+    kWidthFieldNumber = 2,
+    kHeightFieldNumber = 3,
+    kQualityFieldNumber = 4,
+    kPdfPresetFieldNumber = 5,
+    kChunkSizeHintFieldNumber = 6,
+    kCompressionLevelFieldNumber = 7,
+    kTotalSizeFieldNumber = 8,
+  };
+  // string output_format = 1;
+  void clear_output_format();
+  const std::string& output_format() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_output_format(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_output_format();
+  PROTOBUF_NODISCARD std::string* release_output_format();
+  void set_allocated_output_format(std::string* output_format);
+  private:
+  const std::string& _internal_output_format() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_output_format(const std::string& value);
+  std::string* _internal_mutable_output_format();
+  public:
+
+  // int32 width = 2;
+  void clear_width();
+  int32_t width() const;
+  void set_width(int32_t value);
+  private:
+  int32_t _internal_width() const;
+  void _internal_set_width(int32_t value);
+  public:
+
+  // int32 height = 3;
+  void clear_height();
+  int32_t height() const;
+  void set_height(int32_t value);
+  private:
+  int32_t _internal_height() const;
+  void _internal_set_height(int32_t value);
+  public:
+
+  // int32 quality = 4;
+  void clear_quality();
+  int32_t quality() const;
+  void set_quality(int32_t value);
+  private:
+  int32_t _internal_quality() const;
+  void _internal_set_quality(int32_t value);
+  public:
+
+  // .file_processor.PdfPreset pdf_preset = 5;
+  void clear_pdf_preset();
+  ::file_processor::PdfPreset pdf_preset() const;
+  void set_pdf_preset(::file_processor::PdfPreset value);
+  private:
+  ::file_processor::PdfPreset _internal_pdf_preset() const;
+  void _internal_set_pdf_preset(::file_processor::PdfPreset value);
+  public:
+
+  // int32 chunk_size_hint = 6;
+  void clear_chunk_size_hint();
+  int32_t chunk_size_hint() const;
+  void set_chunk_size_hint(int32_t value);
+  private:
+  int32_t _internal_chunk_size_hint() const;
+  void _internal_set_chunk_size_hint(int32_t value);
+  public:
+
+  // int32 compression_level = 7;
+  void clear_compression_level();
+  int32_t compression_level() const;
+  void set_compression_level(int32_t value);
+  private:
+  int32_t _internal_compression_level() const;
+  void _internal_set_compression_level(int32_t value);
+  public:
+
+  // int64 total_size = 8;
+  void clear_total_size();
+  int64_t total_size() const;
+  void set_total_size(int64_t value);
+  private:
+  int64_t _internal_total_size() const;
+  void _internal_set_total_size(int64_t value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:file_processor.ProcessingOptions)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr output_format_;
+    int32_t width_;
+    int32_t height_;
+    int32_t quality_;
+    int pdf_preset_;
+    int32_t chunk_size_hint_;
+    int32_t compression_level_;
+    int64_t total_size_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_file_5fprocessor_2eproto;
+};
+// -------------------------------------------------------------------
+
 class FileRequest final :
     public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:file_processor.FileRequest) */ {
  public:
@@ -112,7 +375,7 @@ class FileRequest final :
                &_FileRequest_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    0;
+    1;
 
   friend void swap(FileRequest& a, FileRequest& b) {
     a.Swap(&b);
@@ -187,6 +450,7 @@ class FileRequest final :
   enum : int {
     kFileNameFieldNumber = 1,
     kFileContentFieldNumber = 2,
+    kOptionsFieldNumber = 3,
   };
   // string file_name = 1;
   void clear_file_name();
@@ -216,6 +480,24 @@ class FileRequest final :
   std::string* _internal_mutable_file_content();
   public:
 
+  // .file_processor.ProcessingOptions options = 3;
+  bool has_options() const;
+  private:
+  bool _internal_has_options() const;
+  public:
+  void clear_options();
+  const ::file_processor::ProcessingOptions& options() const;
+  PROTOBUF_NODISCARD ::file_processor::ProcessingOptions* release_options();
+  ::file_processor::ProcessingOptions* mutable_options();
+  void set_allocated_options(::file_processor::ProcessingOptions* options);
+  private:
+  const ::file_processor::ProcessingOptions& _internal_options() const;
+  ::file_processor::ProcessingOptions* _internal_mutable_options();
+  public:
+  void unsafe_arena_set_allocated_options(
+      ::file_processor::ProcessingOptions* options);
+  ::file_processor::ProcessingOptions* unsafe_arena_release_options();
+
   // @@protoc_insertion_point(class_scope:file_processor.FileRequest)
  private:
   class _Internal;
@@ -226,6 +508,7 @@ class FileRequest final :
   struct Impl_ {
     ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr file_name_;
     ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr file_content_;
+    ::file_processor::ProcessingOptions* options_;
     mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
   };
   union { Impl_ _impl_; };
@@ -281,7 +564,7 @@ class FileResponse final :
                &_FileResponse_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    1;
+    2;
 
   friend void swap(FileResponse& a, FileResponse& b) {
     a.Swap(&b);
@@ -477,7 +760,7 @@ class FileChunk final :
                &_FileChunk_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    2;
+    3;
 
   friend void swap(FileChunk& a, FileChunk& b) {
     a.Swap(&b);
@@ -552,6 +835,7 @@ class FileChunk final :
   enum : int {
     kFileNameFieldNumber = 1,
     kChunkDataFieldNumber = 2,
+    kOptionsFieldNumber = 4,
     kIsLastFieldNumber = 3,
   };
   // string file_name = 1;
@@ -582,6 +866,24 @@ class FileChunk final :
   std::string* _internal_mutable_chunk_data();
   public:
 
+  // .file_processor.ProcessingOptions options = 4;
+  bool has_options() const;
+  private:
+  bool _internal_has_options() const;
+  public:
+  void clear_options();
+  const ::file_processor::ProcessingOptions& options() const;
+  PROTOBUF_NODISCARD ::file_processor::ProcessingOptions* release_options();
+  ::file_processor::ProcessingOptions* mutable_options();
+  void set_allocated_options(::file_processor::ProcessingOptions* options);
+  private:
+  const ::file_processor::ProcessingOptions& _internal_options() const;
+  ::file_processor::ProcessingOptions* _internal_mutable_options();
+  public:
+  void unsafe_arena_set_allocated_options(
+      ::file_processor::ProcessingOptions* options);
+  ::file_processor::ProcessingOptions* unsafe_arena_release_options();
+
   // bool is_last = 3;
   void clear_is_last();
   bool is_last() const;
@@ -601,6 +903,7 @@ class FileChunk final :
   struct Impl_ {
     ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr file_name_;
     ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr chunk_data_;
+    ::file_processor::ProcessingOptions* options_;
     bool is_last_;
     mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
   };
@@ -616,6 +919,200 @@ class FileChunk final :
   #pragma GCC diagnostic push
   #pragma GCC diagnostic ignored "-Wstrict-aliasing"
 #endif  // __GNUC__
+// ProcessingOptions
+
+// string output_format = 1;
+inline void ProcessingOptions::clear_output_format() {
+  _impl_.output_format_.ClearToEmpty();
+}
+inline const std::string& ProcessingOptions::output_format() const {
+  // @@protoc_insertion_point(field_get:file_processor.ProcessingOptions.output_format)
+  return _internal_output_format();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void ProcessingOptions::set_output_format(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.output_format_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:file_processor.ProcessingOptions.output_format)
+}
+inline std::string* ProcessingOptions::mutable_output_format() {
+  std::string* _s = _internal_mutable_output_format();
+  // @@protoc_insertion_point(field_mutable:file_processor.ProcessingOptions.output_format)
+  return _s;
+}
+inline const std::string& ProcessingOptions::_internal_output_format() const {
+  return _impl_.output_format_.Get();
+}
+inline void ProcessingOptions::_internal_set_output_format(const std::string& value) {
+  
+  _impl_.output_format_.Set(value, GetArenaForAllocation());
+}
+inline std::string* ProcessingOptions::_internal_mutable_output_format() {
+  
+  return _impl_.output_format_.Mutable(GetArenaForAllocation());
+}
+inline std::string* ProcessingOptions::release_output_format() {
+  // @@protoc_insertion_point(field_release:file_processor.ProcessingOptions.output_format)
+  return _impl_.output_format_.Release();
+}
+inline void ProcessingOptions::set_allocated_output_format(std::string* output_format) {
+  if (output_format != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.output_format_.SetAllocated(output_format, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.output_format_.IsDefault()) {
+    _impl_.output_format_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:file_processor.ProcessingOptions.output_format)
+}
+
+// int32 width = 2;
+inline void ProcessingOptions::clear_width() {
+  _impl_.width_ = 0;
+}
+inline int32_t ProcessingOptions::_internal_width() const {
+  return _impl_.width_;
+}
+inline int32_t ProcessingOptions::width() const {
+  // @@protoc_insertion_point(field_get:file_processor.ProcessingOptions.width)
+  return _internal_width();
+}
+inline void ProcessingOptions::_internal_set_width(int32_t value) {
+  
+  _impl_.width_ = value;
+}
+inline void ProcessingOptions::set_width(int32_t value) {
+  _internal_set_width(value);
+  // @@protoc_insertion_point(field_set:file_processor.ProcessingOptions.width)
+}
+
+// int32 height = 3;
+inline void ProcessingOptions::clear_height() {
+  _impl_.height_ = 0;
+}
+inline int32_t ProcessingOptions::_internal_height() const {
+  return _impl_.height_;
+}
+inline int32_t ProcessingOptions::height() const {
+  // @@protoc_insertion_point(field_get:file_processor.ProcessingOptions.height)
+  return _internal_height();
+}
+inline void ProcessingOptions::_internal_set_height(int32_t value) {
+  
+  _impl_.height_ = value;
+}
+inline void ProcessingOptions::set_height(int32_t value) {
+  _internal_set_height(value);
+  // @@protoc_insertion_point(field_set:file_processor.ProcessingOptions.height)
+}
+
+// int32 quality = 4;
+inline void ProcessingOptions::clear_quality() {
+  _impl_.quality_ = 0;
+}
+inline int32_t ProcessingOptions::_internal_quality() const {
+  return _impl_.quality_;
+}
+inline int32_t ProcessingOptions::quality() const {
+  // @@protoc_insertion_point(field_get:file_processor.ProcessingOptions.quality)
+  return _internal_quality();
+}
+inline void ProcessingOptions::_internal_set_quality(int32_t value) {
+  
+  _impl_.quality_ = value;
+}
+inline void ProcessingOptions::set_quality(int32_t value) {
+  _internal_set_quality(value);
+  // @@protoc_insertion_point(field_set:file_processor.ProcessingOptions.quality)
+}
+
+// .file_processor.PdfPreset pdf_preset = 5;
+inline void ProcessingOptions::clear_pdf_preset() {
+  _impl_.pdf_preset_ = 0;
+}
+inline ::file_processor::PdfPreset ProcessingOptions::_internal_pdf_preset() const {
+  return static_cast< ::file_processor::PdfPreset >(_impl_.pdf_preset_);
+}
+inline ::file_processor::PdfPreset ProcessingOptions::pdf_preset() const {
+  // @@protoc_insertion_point(field_get:file_processor.ProcessingOptions.pdf_preset)
+  return _internal_pdf_preset();
+}
+inline void ProcessingOptions::_internal_set_pdf_preset(::file_processor::PdfPreset value) {
+  
+  _impl_.pdf_preset_ = value;
+}
+inline void ProcessingOptions::set_pdf_preset(::file_processor::PdfPreset value) {
+  _internal_set_pdf_preset(value);
+  // @@protoc_insertion_point(field_set:file_processor.ProcessingOptions.pdf_preset)
+}
+
+// int32 chunk_size_hint = 6;
+inline void ProcessingOptions::clear_chunk_size_hint() {
+  _impl_.chunk_size_hint_ = 0;
+}
+inline int32_t ProcessingOptions::_internal_chunk_size_hint() const {
+  return _impl_.chunk_size_hint_;
+}
+inline int32_t ProcessingOptions::chunk_size_hint() const {
+  // @@protoc_insertion_point(field_get:file_processor.ProcessingOptions.chunk_size_hint)
+  return _internal_chunk_size_hint();
+}
+inline void ProcessingOptions::_internal_set_chunk_size_hint(int32_t value) {
+  
+  _impl_.chunk_size_hint_ = value;
+}
+inline void ProcessingOptions::set_chunk_size_hint(int32_t value) {
+  _internal_set_chunk_size_hint(value);
+  // @@protoc_insertion_point(field_set:file_processor.ProcessingOptions.chunk_size_hint)
+}
+
+// int32 compression_level = 7;
+inline void ProcessingOptions::clear_compression_level() {
+  _impl_.compression_level_ = 0;
+}
+inline int32_t ProcessingOptions::_internal_compression_level() const {
+  return _impl_.compression_level_;
+}
+inline int32_t ProcessingOptions::compression_level() const {
+  // @@protoc_insertion_point(field_get:file_processor.ProcessingOptions.compression_level)
+  return _internal_compression_level();
+}
+inline void ProcessingOptions::_internal_set_compression_level(int32_t value) {
+  
+  _impl_.compression_level_ = value;
+}
+inline void ProcessingOptions::set_compression_level(int32_t value) {
+  _internal_set_compression_level(value);
+  // @@protoc_insertion_point(field_set:file_processor.ProcessingOptions.compression_level)
+}
+
+// int64 total_size = 8;
+inline void ProcessingOptions::clear_total_size() {
+  _impl_.total_size_ = int64_t{0};
+}
+inline int64_t ProcessingOptions::_internal_total_size() const {
+  return _impl_.total_size_;
+}
+inline int64_t ProcessingOptions::total_size() const {
+  // @@protoc_insertion_point(field_get:file_processor.ProcessingOptions.total_size)
+  return _internal_total_size();
+}
+inline void ProcessingOptions::_internal_set_total_size(int64_t value) {
+  
+  _impl_.total_size_ = value;
+}
+inline void ProcessingOptions::set_total_size(int64_t value) {
+  _internal_set_total_size(value);
+  // @@protoc_insertion_point(field_set:file_processor.ProcessingOptions.total_size)
+}
+
+// -------------------------------------------------------------------
+
 // FileRequest
 
 // string file_name = 1;
@@ -718,6 +1215,96 @@ inline void FileRequest::set_allocated_file_content(std::string* file_content) {
   // @@protoc_insertion_point(field_set_allocated:file_processor.FileRequest.file_content)
 }
 
+// .file_processor.ProcessingOptions options = 3;
+inline bool FileRequest::_internal_has_options() const {
+  return this != internal_default_instance() && _impl_.options_ != nullptr;
+}
+inline bool FileRequest::has_options() const {
+  return _internal_has_options();
+}
+inline void FileRequest::clear_options() {
+  if (GetArenaForAllocation() == nullptr && _impl_.options_ != nullptr) {
+    delete _impl_.options_;
+  }
+  _impl_.options_ = nullptr;
+}
+inline const ::file_processor::ProcessingOptions& FileRequest::_internal_options() const {
+  const ::file_processor::ProcessingOptions* p = _impl_.options_;
+  return p != nullptr ? *p : reinterpret_cast<const ::file_processor::ProcessingOptions&>(
+      ::file_processor::_ProcessingOptions_default_instance_);
+}
+inline const ::file_processor::ProcessingOptions& FileRequest::options() const {
+  // @@protoc_insertion_point(field_get:file_processor.FileRequest.options)
+  return _internal_options();
+}
+inline void FileRequest::unsafe_arena_set_allocated_options(
+    ::file_processor::ProcessingOptions* options) {
+  if (GetArenaForAllocation() == nullptr) {
+    delete reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(_impl_.options_);
+  }
+  _impl_.options_ = options;
+  if (options) {
+    
+  } else {
+    
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:file_processor.FileRequest.options)
+}
+inline ::file_processor::ProcessingOptions* FileRequest::release_options() {
+  
+  ::file_processor::ProcessingOptions* temp = _impl_.options_;
+  _impl_.options_ = nullptr;
+#ifdef PROTOBUF_FORCE_COPY_IN_RELEASE
+  auto* old =  reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(temp);
+  temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  if (GetArenaForAllocation() == nullptr) { delete old; }
+#else  // PROTOBUF_FORCE_COPY_IN_RELEASE
+  if (GetArenaForAllocation() != nullptr) {
+    temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  }
+#endif  // !PROTOBUF_FORCE_COPY_IN_RELEASE
+  return temp;
+}
+inline ::file_processor::ProcessingOptions* FileRequest::unsafe_arena_release_options() {
+  // @@protoc_insertion_point(field_release:file_processor.FileRequest.options)
+  
+  ::file_processor::ProcessingOptions* temp = _impl_.options_;
+  _impl_.options_ = nullptr;
+  return temp;
+}
+inline ::file_processor::ProcessingOptions* FileRequest::_internal_mutable_options() {
+  
+  if (_impl_.options_ == nullptr) {
+    auto* p = CreateMaybeMessage<::file_processor::ProcessingOptions>(GetArenaForAllocation());
+    _impl_.options_ = p;
+  }
+  return _impl_.options_;
+}
+inline ::file_processor::ProcessingOptions* FileRequest::mutable_options() {
+  ::file_processor::ProcessingOptions* _msg = _internal_mutable_options();
+  // @@protoc_insertion_point(field_mutable:file_processor.FileRequest.options)
+  return _msg;
+}
+inline void FileRequest::set_allocated_options(::file_processor::ProcessingOptions* options) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  if (message_arena == nullptr) {
+    delete _impl_.options_;
+  }
+  if (options) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+        ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(options);
+    if (message_arena != submessage_arena) {
+      options = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, options, submessage_arena);
+    }
+    
+  } else {
+    
+  }
+  _impl_.options_ = options;
+  // @@protoc_insertion_point(field_set_allocated:file_processor.FileRequest.options)
+}
+
 // -------------------------------------------------------------------
 
 // FileResponse
@@ -1016,6 +1603,96 @@ inline void FileChunk::set_is_last(bool value) {
   // @@protoc_insertion_point(field_set:file_processor.FileChunk.is_last)
 }
 
+// .file_processor.ProcessingOptions options = 4;
+inline bool FileChunk::_internal_has_options() const {
+  return this != internal_default_instance() && _impl_.options_ != nullptr;
+}
+inline bool FileChunk::has_options() const {
+  return _internal_has_options();
+}
+inline void FileChunk::clear_options() {
+  if (GetArenaForAllocation() == nullptr && _impl_.options_ != nullptr) {
+    delete _impl_.options_;
+  }
+  _impl_.options_ = nullptr;
+}
+inline const ::file_processor::ProcessingOptions& FileChunk::_internal_options() const {
+  const ::file_processor::ProcessingOptions* p = _impl_.options_;
+  return p != nullptr ? *p : reinterpret_cast<const ::file_processor::ProcessingOptions&>(
+      ::file_processor::_ProcessingOptions_default_instance_);
+}
+inline const ::file_processor::ProcessingOptions& FileChunk::options() const {
+  // @@protoc_insertion_point(field_get:file_processor.FileChunk.options)
+  return _internal_options();
+}
+inline void FileChunk::unsafe_arena_set_allocated_options(
+    ::file_processor::ProcessingOptions* options) {
+  if (GetArenaForAllocation() == nullptr) {
+    delete reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(_impl_.options_);
+  }
+  _impl_.options_ = options;
+  if (options) {
+    
+  } else {
+    
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:file_processor.FileChunk.options)
+}
+inline ::file_processor::ProcessingOptions* FileChunk::release_options() {
+  
+  ::file_processor::ProcessingOptions* temp = _impl_.options_;
+  _impl_.options_ = nullptr;
+#ifdef PROTOBUF_FORCE_COPY_IN_RELEASE
+  auto* old =  reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(temp);
+  temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  if (GetArenaForAllocation() == nullptr) { delete old; }
+#else  // PROTOBUF_FORCE_COPY_IN_RELEASE
+  if (GetArenaForAllocation() != nullptr) {
+    temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  }
+#endif  // !PROTOBUF_FORCE_COPY_IN_RELEASE
+  return temp;
+}
+inline ::file_processor::ProcessingOptions* FileChunk::unsafe_arena_release_options() {
+  // @@protoc_insertion_point(field_release:file_processor.FileChunk.options)
+  
+  ::file_processor::ProcessingOptions* temp = _impl_.options_;
+  _impl_.options_ = nullptr;
+  return temp;
+}
+inline ::file_processor::ProcessingOptions* FileChunk::_internal_mutable_options() {
+  
+  if (_impl_.options_ == nullptr) {
+    auto* p = CreateMaybeMessage<::file_processor::ProcessingOptions>(GetArenaForAllocation());
+    _impl_.options_ = p;
+  }
+  return _impl_.options_;
+}
+inline ::file_processor::ProcessingOptions* FileChunk::mutable_options() {
+  ::file_processor::ProcessingOptions* _msg = _internal_mutable_options();
+  // @@protoc_insertion_point(field_mutable:file_processor.FileChunk.options)
+  return _msg;
+}
+inline void FileChunk::set_allocated_options(::file_processor::ProcessingOptions* options) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  if (message_arena == nullptr) {
+    delete _impl_.options_;
+  }
+  if (options) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+        ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(options);
+    if (message_arena != submessage_arena) {
+      options = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, options, submessage_arena);
+    }
+    
+  } else {
+    
+  }
+  _impl_.options_ = options;
+  // @@protoc_insertion_point(field_set_allocated:file_processor.FileChunk.options)
+}
+
 #ifdef __GNUC__
   #pragma GCC diagnostic pop
 #endif  // __GNUC__
@@ -1023,11 +1700,23 @@ inline void FileChunk::set_is_last(bool value) {
 
 // -------------------------------------------------------------------
 
+// -------------------------------------------------------------------
+
 
 // @@protoc_insertion_point(namespace_scope)
 
 }  // namespace file_processor
 
+PROTOBUF_NAMESPACE_OPEN
+
+template <> struct is_proto_enum< ::file_processor::PdfPreset> : ::std::true_type {};
+template <>
+inline const EnumDescriptor* GetEnumDescriptor< ::file_processor::PdfPreset>() {
+  return ::file_processor::PdfPreset_descriptor();
+}
+
+PROTOBUF_NAMESPACE_CLOSE
+
 // @@protoc_insertion_point(global_scope)
 
 #include <google/protobuf/port_undef.inc>
@@ -1,18 +1,32 @@
 #include <grpcpp/grpcpp.h>
 #include <grpcpp/server_context.h>
 #include <grpcpp/server_builder.h>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <string>
-#include <fstream>
-#include <vector>
-#include <cstdlib>
-#include <filesystem>
 
 // Inclua os headers gerados pelo protobuf
 #include "proto/file_processor.grpc.pb.h"
 #include "proto/file_processor.pb.h"
 
+#include "src/async_server.h"
+#include "src/chunk_io.h"
+#include "src/file_operations.h"
+#include "src/flate.h"
+#include "src/image_resize.h"
+#include "src/job_scheduler.h"
+#include "src/logging.h"
+#include "src/metrics.h"
+#include "src/metrics_server.h"
+#include "src/pdf_compressor.h"
+#include "src/pdf_text.h"
+#include "src/pipeline.h"
+#include "src/result_cache.h"
+#include "src/scratch_storage.h"
+#include "src/server_options.h"
+#include "src/tool_commands.h"
+
 using grpc::Server;
 using grpc::ServerBuilder;
 using grpc::ServerContext;
@@ -22,201 +36,274 @@ using grpc::Status;
 // Use o namespace gerado pelo protobuf
 using namespace file_processor;
 
-// Funções auxiliares para logging
-void LogSuccess(const std::string& method, const std::string& filename, const std::string& message) {
-    std::cout << "[SUCCESS][" << method << "] " << filename << ": " << message << std::endl;
+static RequestContext MakeRequestContext(ServerContext* context) {
+    RequestContext request_context;
+    request_context.is_cancelled = [context] { return context->IsCancelled(); };
+    request_context.deadline = SteadyDeadline(context->deadline());
+    return request_context;
 }
 
-void LogError(const std::string& method, const std::string& filename, const std::string& message) {
-    std::cerr << "[ERROR][" << method << "] " << filename << ": " << message << std::endl;
+// Lê todos os chunks do cliente para dentro de assembler.
+static void ReceiveChunks(ServerReaderWriter<FileChunk, FileChunk>* stream, ChunkAssembler* assembler) {
+    FileChunk chunk;
+    while (stream->Read(&chunk)) {
+        if (assembler->Add(&chunk)) {
+            break;
+        }
+    }
 }
 
+// Envia o resultado de uma RPC de streaming em FileChunks de no máximo
+// result->chunk_size bytes. O conteúdo de result é consumido.
+static void SendStreamResult(ServerReaderWriter<FileChunk, FileChunk>* stream, StreamResult* result) {
+    WriteChunked(&result->data, result->file_name, result->chunk_size,
+                 [stream](const FileChunk& chunk) { return stream->Write(chunk); });
+}
+
+// Serviço síncrono: cada RPC ocupa uma thread do gRPC do início ao fim.
 class FileProcessorServiceImpl final : public FileProcessor::Service {
 public:
+    FileProcessorServiceImpl(FileOperations* operations, JobScheduler* scheduler, const ServerOptions& options)
+        : operations_(operations),
+          scheduler_(scheduler),
+          response_chunk_size_(options.response_chunk_size),
+          pipeline_(options.pipeline),
+          native_txt_(options.native_txt) {}
+
     Status CompressPDF(ServerContext* context, const FileRequest* request, FileResponse* response) override {
-        std::string input_file_path = "/tmp/input_" + request->file_name();
-        std::string output_file_path = "/tmp/output_" + request->file_name();
-
-        // Salvar arquivo temporário
-        std::ofstream input_file(input_file_path, std::ios::binary);
-        if (!input_file) {
-            LogError("CompressPDF", request->file_name(), "Falha ao criar arquivo temporário de entrada.");
-            response->set_success(false);
-            response->set_status_message("Erro no servidor ao criar arquivo temporário.");
-            return Status(grpc::StatusCode::INTERNAL, "Erro ao criar arquivo temporário");
-        }
-        input_file.write(request->file_content().data(), request->file_content().size());
-        input_file.close();
-
-        // Comando Ghostscript para compressão
-        std::string command = "gs -sDEVICE=pdfwrite -dCompatibilityLevel=1.4 -dPDFSETTINGS=/ebook -dNOPAUSE -dQUIET -dBATCH -sOutputFile=" + output_file_path + " " + input_file_path;
-        
-        int gs_result = std::system(command.c_str());
-        
-        if (gs_result == 0) {
-            // Ler arquivo comprimido
-            std::ifstream output_file(output_file_path, std::ios::binary);
-            if (output_file) {
-                std::string compressed_content((std::istreambuf_iterator<char>(output_file)), 
-                                             std::istreambuf_iterator<char>());
-                output_file.close();
-                
-                response->set_success(true);
-                response->set_file_name("compressed_" + request->file_name());
-                response->set_file_content(compressed_content);
-                
-                LogSuccess("CompressPDF", request->file_name(), "Compressão PDF bem-sucedida.");
-                
-                // Limpar arquivos temporários
-                std::remove(input_file_path.c_str());
-                std::remove(output_file_path.c_str());
-                
-                return Status::OK;
-            } else {
-                LogError("CompressPDF", request->file_name(), "Falha ao abrir arquivo comprimido para envio.");
-                response->set_success(false);
-                response->set_status_message("Erro no servidor ao abrir arquivo comprimido.");
-                return Status(grpc::StatusCode::INTERNAL, "Erro ao abrir arquivo comprimido");
-            }
-        } else {
-            LogError("CompressPDF", request->file_name(), "Falha na compressão PDF. Código de retorno: " + std::to_string(gs_result));
-            response->set_success(false);
-            response->set_status_message("Falha ao comprimir PDF.");
-            return Status(grpc::StatusCode::INTERNAL, "Falha na compressão PDF");
-        }
+        RpcTracker tracker(Rpc::kCompressPDF);
+        GlobalMetrics().AddBytesIn(Rpc::kCompressPDF, request->file_content().size());
+        Status status = operations_->CompressPDF(MakeRequestContext(context), *request, response);
+        GlobalMetrics().AddBytesOut(Rpc::kCompressPDF, response->file_content().size());
+        return tracker.End(status);
     }
 
     Status ConvertToTXT(ServerContext* context,
                        ServerReaderWriter<FileChunk, FileChunk>* stream) override {
-        FileChunk chunk;
-        std::string full_content;
-        std::string filename;
-
-        // Receber dados do cliente
-        while (stream->Read(&chunk)) {
-            if (filename.empty()) {
-                filename = chunk.file_name();
-            }
-            full_content.append(chunk.chunk_data());
-            if (chunk.is_last()) {
-                break;
-            }
-        }
-
-        if (full_content.empty()) {
-            LogError("ConvertToTXT", filename, "Nenhum dado recebido");
-            return Status(grpc::StatusCode::INTERNAL, "Nenhum dado recebido");
+        RpcTracker tracker(Rpc::kConvertToTXT);
+        // Com a extração em processo não há ferramenta para o pipeline.
+        if (pipeline_ && !native_txt_) {
+            return tracker.End(RunPipeline(context, stream, Rpc::kConvertToTXT, [](const RequestParams& params) {
+                return PipelineCommand{PdfToTextPipeCommand(), params.name + ".txt"};
+            }));
         }
-
-        // Simular conversão para TXT
-        std::string txt_content = "Texto extraído do arquivo: " + filename + "\n\n";
-        txt_content += "[Conteúdo convertido para texto]\n";
-        
-        // Enviar resposta em chunks
-        size_t chunk_size = 4096;
-        for (size_t i = 0; i < txt_content.size(); i += chunk_size) {
-            FileChunk response_chunk;
-            response_chunk.set_file_name(filename + ".txt");
-            response_chunk.set_chunk_data(txt_content.substr(i, chunk_size));
-            response_chunk.set_is_last(i + chunk_size >= txt_content.size());
-            stream->Write(response_chunk);
-        }
-
-        LogSuccess("ConvertToTXT", filename, "Conversão para TXT bem-sucedida.");
-        return Status::OK;
+        return tracker.End(ProcessBuffered(context, stream, Rpc::kConvertToTXT, &FileOperations::ConvertToTXT));
     }
 
     Status ConvertImageFormat(ServerContext* context,
                             ServerReaderWriter<FileChunk, FileChunk>* stream) override {
-        FileChunk chunk;
-        std::vector<char> image_data;
-        std::string filename;
-
-        // Receber dados do cliente
-        while (stream->Read(&chunk)) {
-            if (filename.empty()) {
-                filename = chunk.file_name();
-            }
-            std::string chunk_data = chunk.chunk_data();
-            image_data.insert(image_data.end(), chunk_data.begin(), chunk_data.end());
-            if (chunk.is_last()) {
-                break;
-            }
+        RpcTracker tracker(Rpc::kConvertImageFormat);
+        if (pipeline_) {
+            return tracker.End(RunPipeline(context, stream, Rpc::kConvertImageFormat,
+                                           [](const RequestParams& params) {
+                return PipelineCommand{ConvertFormatPipeCommand(params.output_format, params.quality),
+                                       "converted_" + params.name + "." + params.output_format};
+            }));
         }
+        return tracker.End(
+            ProcessBuffered(context, stream, Rpc::kConvertImageFormat, &FileOperations::ConvertImageFormat));
+    }
 
-        if (image_data.empty()) {
-            LogError("ConvertImageFormat", filename, "Nenhum dado de imagem recebido");
-            return Status(grpc::StatusCode::INTERNAL, "Nenhum dado de imagem recebido");
+    Status ResizeImage(ServerContext* context,
+                      ServerReaderWriter<FileChunk, FileChunk>* stream) override {
+        RpcTracker tracker(Rpc::kResizeImage);
+        if (pipeline_) {
+            return tracker.End(RunPipeline(context, stream, Rpc::kResizeImage, [](const RequestParams& params) {
+                return PipelineCommand{ResizePipeCommand(params.width, params.height, params.quality),
+                                       "resized_" + params.name};
+            }));
         }
+        return tracker.End(ProcessBuffered(context, stream, Rpc::kResizeImage, &FileOperations::ResizeImage));
+    }
 
-        // Simular conversão de formato
-        std::string converted_data(image_data.begin(), image_data.end());
-        std::string new_filename = "converted_" + filename + ".png";
-
-        // Enviar resposta
-        FileChunk response_chunk;
-        response_chunk.set_file_name(new_filename);
-        response_chunk.set_chunk_data(converted_data);
-        response_chunk.set_is_last(true);
-        stream->Write(response_chunk);
+private:
+    using StreamOperation = Status (FileOperations::*)(const RequestContext&, UploadedFile, StreamResult*);
 
-        LogSuccess("ConvertImageFormat", filename, "Conversão de formato bem-sucedida.");
-        return Status::OK;
+    // Modo pipeline: a ferramenta só é iniciada com vaga no escalonador;
+    // até lá o upload fica parado no controle de fluxo do gRPC.
+    Status RunPipeline(ServerContext* context, ServerReaderWriter<FileChunk, FileChunk>* stream, Rpc rpc,
+                       const std::function<PipelineCommand(const RequestParams& params)>& make_command) {
+        JobScheduler::Slot slot;
+        if (scheduler_ != nullptr) {
+            // Tamanho desconhecido: o upload ainda não começou.
+            JobInfo job{rpc, 0, SteadyDeadline(context->deadline())};
+            Status admitted = scheduler_->Acquire(job, [context] { return context->IsCancelled(); }, &slot);
+            if (!admitted.ok()) {
+                LogError(RpcName(rpc), "", admitted.error_message());
+                return admitted;
+            }
+            slot.Start();
+        }
+        return RunStreamingPipeline(context, stream, RpcName(rpc), make_command, response_chunk_size_);
     }
 
-    Status ResizeImage(ServerContext* context,
-                      ServerReaderWriter<FileChunk, FileChunk>* stream) override {
-        FileChunk chunk;
-        std::vector<char> image_data;
-        std::string filename;
-
-        // Receber dados do cliente
-        while (stream->Read(&chunk)) {
-            if (filename.empty()) {
-                filename = chunk.file_name();
+    // Caminho sem pipeline: recebe o arquivo inteiro, converte e envia em chunks.
+    Status ProcessBuffered(ServerContext* context, ServerReaderWriter<FileChunk, FileChunk>* stream, Rpc rpc,
+                           StreamOperation operation) {
+        ChunkAssembler assembler(0, operations_->wants_content_digest(), operations_->max_upload_bytes());
+        {
+            StageTimer receive(rpc, Stage::kReceive);
+            ReceiveChunks(stream, &assembler);
+        }
+        if (!assembler.status().ok()) {
+            LogError(RpcName(rpc), assembler.filename(), assembler.status().error_message());
+            return assembler.status();
+        }
+        GlobalMetrics().AddBytesIn(rpc, assembler.size());
+
+        StreamResult result;
+        // O que a operação entregar antes do fim (ConvertToTXT: cada página)
+        // já sai em chunks sem is_last.
+        result.send_partial = [&](std::string piece) {
+            if (piece.empty()) {
+                return true;
             }
-            std::string chunk_data = chunk.chunk_data();
-            image_data.insert(image_data.end(), chunk_data.begin(), chunk_data.end());
-            if (chunk.is_last()) {
-                break;
+            if (result.chunk_size == 0) {
+                result.chunk_size = NegotiateChunkSize(*context, response_chunk_size_, result.chunk_size_hint);
             }
+            result.sent_bytes += piece.size();
+            return WriteChunked(&piece, result.file_name, result.chunk_size,
+                                [stream](const FileChunk& chunk) { return stream->Write(chunk); }, false);
+        };
+        Status status = (operations_->*operation)(MakeRequestContext(context), assembler.TakeUpload(), &result);
+        if (status.ok()) {
+            result.chunk_size = NegotiateChunkSize(*context, response_chunk_size_, result.chunk_size_hint);
+            GlobalMetrics().AddBytesOut(rpc, result.data.size());
+            result.data.erase(0, result.sent_bytes);
+            StageTimer send(rpc, Stage::kSend);
+            SendStreamResult(stream, &result);
         }
+        return status;
+    }
 
-        if (image_data.empty()) {
-            LogError("ResizeImage", filename, "Nenhum dado de imagem recebido");
-            return Status(grpc::StatusCode::INTERNAL, "Nenhum dado de imagem recebido");
-        }
+    FileOperations* operations_;
+    JobScheduler* scheduler_;
+    size_t response_chunk_size_;
+    bool pipeline_;
+    bool native_txt_;
+};
 
-        // Simular redimensionamento
-        std::string resized_data(image_data.begin(), image_data.end());
-        std::string new_filename = "resized_" + filename;
+void RunServer(const ServerOptions& options, PdfCompressor* pdf_compressor, ScratchStorage* scratch) {
+    std::unique_ptr<ResultCache> cache;
+    if (options.cache_memory_mb > 0) {
+        ResultCache::Options cache_options;
+        cache_options.memory_bytes = static_cast<size_t>(options.cache_memory_mb) << 20;
+        cache_options.disk_dir = options.cache_dir;
+        cache_options.disk_bytes = static_cast<size_t>(options.cache_disk_mb) << 20;
+        cache = std::make_unique<ResultCache>(cache_options);
+    }
+    std::unique_ptr<JobScheduler> scheduler;
+    if (options.admission) {
+        JobScheduler::Options scheduler_options;
+        scheduler_options.limits = options.admission_limits;
+        scheduler_options.max_queued = static_cast<size_t>(options.admission_queue);
+        scheduler_options.memory_budget_bytes = static_cast<size_t>(options.admission_memory_mb) << 20;
+        scheduler_options.large_job_seconds = options.sjf_large_job_ms / 1000.0;
+        scheduler = std::make_unique<JobScheduler>(scheduler_options);
+    }
+    std::unique_ptr<ImageResizer> resizer;
+    if (options.native_resize) {
+        ImageResizer::Options resizer_options;
+        resizer_options.filter = options.resize_filter;
+        resizer_options.threads = options.resize_threads;
+        resizer = std::make_unique<ImageResizer>(resizer_options);
+        std::cout << "Redimensionamento em processo: " << ResizeFilterName(resizer->filter()) << ", "
+                  << ResizeIsaName(resizer->isa()) << ", " << resizer->threads() << " threads" << std::endl;
+    }
+    std::unique_ptr<PdfTextExtractor> text_extractor;
+    if (options.native_txt) {
+        PdfTextExtractor::Options extractor_options;
+        extractor_options.threads = options.txt_threads;
+        text_extractor = std::make_unique<PdfTextExtractor>(extractor_options);
+        std::cout << "Extração de texto em processo: " << text_extractor->threads() << " threads" << std::endl;
+    }
+    FileOperations::Options operations_options;
+    operations_options.pipeline = options.pipeline;
+    operations_options.cache = cache.get();
+    operations_options.single_flight = options.single_flight;
+    operations_options.scheduler = scheduler.get();
+    operations_options.resizer = resizer.get();
+    operations_options.shrink_on_load = options.jpeg_shrink_on_load;
+    operations_options.text_extractor = text_extractor.get();
+    operations_options.pdf_precheck_min_savings = options.pdf_precheck_min_savings;
+    operations_options.max_upload_bytes = static_cast<size_t>(options.max_upload_mb) << 20;
+    FileOperations operations(pdf_compressor, scratch, operations_options);
 
-        // Enviar resposta
-        FileChunk response_chunk;
-        response_chunk.set_file_name(new_filename);
-        response_chunk.set_chunk_data(resized_data);
-        response_chunk.set_is_last(true);
-        stream->Write(response_chunk);
+    MetricsHttpServer metrics_server([&] {
+        std::string text;
+        GlobalMetrics().AppendPrometheus(&text);
+        if (cache) {
+            AppendResultCacheMetrics(cache->stats(), &text);
+        }
+        AppendSingleFlightMetrics(operations.single_flight_stats(), &text);
+        AppendPdfShortcutMetrics(operations.pdf_shortcut_stats(), &text);
+        AppendScratchMetrics(scratch->stats(), &text);
+        if (scheduler) {
+            AppendSchedulerMetrics(scheduler->stats(), &text);
+        }
+        AppendProcessMetrics(&text);
+        return text;
+    });
+    if (options.metrics_port > 0) {
+        std::string error;
+        if (!metrics_server.Start(options.metrics_port, &error)) {
+            std::cerr << "Falha ao abrir endpoint de métricas: " << error << std::endl;
+        } else {
+            std::cout << "Métricas em http://127.0.0.1:" << options.metrics_port << "/metrics" << std::endl;
+        }
+    }
 
-        LogSuccess("ResizeImage", filename, "Redimensionamento de imagem bem-sucedido.");
-        return Status::OK;
+    if (options.async) {
+        AsyncFileProcessorServer async_server(options, &operations, scheduler.get());
+        async_server.Run();
+        return;
     }
-};
 
-void RunServer() {
-    std::string server_address("0.0.0.0:50051");
-    FileProcessorServiceImpl service;
+    const std::string& server_address = options.address;
+    FileProcessorServiceImpl service(&operations, scheduler.get(), options);
 
     ServerBuilder builder;
     builder.AddListeningPort(server_address, grpc::InsecureServerCredentials());
     builder.RegisterService(&service);
 
     std::unique_ptr<Server> server(builder.BuildAndStart());
-    std::cout << "Servidor ouvindo em " << server_address << std::endl;
+    std::cout << "Servidor ouvindo em " << server_address
+              << " (motor PDF: " << pdf_compressor->Name() << ")" << std::endl;
     server->Wait();
 }
 
 int main(int argc, char** argv) {
-    RunServer();
+    ServerOptions options;
+    std::string error;
+    if (!ParseServerOptions(argc, argv, &options, &error)) {
+        std::cerr << error << "\n" << ServerUsage(argv[0]);
+        return 1;
+    }
+
+    LoggerOptions logger_options;
+    logger_options.ring_capacity = static_cast<size_t>(options.log_buffer);
+    logger_options.overflow = options.log_overflow;
+    logger_options.file_path = options.log_file;
+    InitLogging(logger_options);
+
+    if (!SetFlateBackend(options.flate_backend)) {
+        std::cerr << "Backend Flate não disponível nesta compilação: " << FlateBackendName(options.flate_backend)
+                  << std::endl;
+        return 1;
+    }
+    std::cout << "Codec Flate: " << FlateBackendName(ActiveFlateBackend()) << std::endl;
+
+    ScratchStorage::Options scratch_options;
+    scratch_options.memory_threshold = static_cast<size_t>(options.scratch_memory_mb) << 20;
+    scratch_options.spill_dir = options.scratch_dir;
+    ScratchStorage scratch(scratch_options);
+
+    std::unique_ptr<PdfCompressor> pdf_compressor = CreatePdfCompressor(options, &scratch, &error);
+    if (!pdf_compressor) {
+        std::cerr << "Falha ao iniciar motor de PDF: " << error << std::endl;
+        return 1;
+    }
+
+    RunServer(options, pdf_compressor.get(), &scratch);
     return 0;
-}
\ No newline at end of file
+}
@@ -6,8 +6,8 @@
 #include <grpcpp/grpcpp.h>
 #include "file_processor.grpc.pb.h"
 #include "file_processor.pb.h"
+#include "src/logging.h"
 
-#include <chrono>
 #include <ctime>
 #include <fstream>
 #include <iostream>
@@ -17,6 +17,8 @@
 #include <thread>
 #include <vector>
 #include <cstdio> // remove
+#include <cstdlib> // mkstemp
+#include <unistd.h> // close
 
 using grpc::Server;
 using grpc::ServerBuilder;
@@ -31,39 +33,39 @@ using file_processor::FileChunk;
 using file_processor::FileMeta;
 using file_processor::StatusResponse;
 
-// Funções auxiliares para logging:
+// Funções auxiliares para logging: o logger assíncrono (src/logging.h)
+// formata o timestamp e grava em server.log e no console fora da thread do handler.
 static void WriteLog(const std::string& level, const std::string& service,
                      const std::string& file_name, const std::string& message) {
-    auto now = std::chrono::system_clock::now();
-    std::time_t now_c = std::chrono::system_clock::to_time_t(now);
-    char buf[64];
-    std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", std::localtime(&now_c));
-    std::ofstream log("server.log", std::ios::app);
-    if (log.is_open()) {
-        log << "[" << buf << "] " << level << " - Service: " << service
-            << ", File: " << file_name << ", Message: " << message << std::endl;
-        log.close();
+    LogLevel log_level = LogLevel::kInfo;
+    if (level == "ERROR") {
+        log_level = LogLevel::kError;
+    } else if (level == "SUCCESS") {
+        log_level = LogLevel::kSuccess;
     }
-    // também imprimir no console (ajuda em testes)
-    std::cerr << "[" << buf << "] " << level << " - Service: " << service
-              << ", File: " << file_name << ", Message: " << message << std::endl;
+    LogEvent(log_level, service, file_name, message);
 }
 
 // Lê todo stream do cliente e salva em arquivo temporário.
-// Retorna caminho do arquivo salvo (ex: /tmp/input_<id>_<nome>)
+// Retorna caminho do arquivo salvo (ex: /tmp/grpc_upload_Ab3xZ9)
 // Em caso de erro retorna string vazia.
 static std::string ReceiveFileFromStream(ServerReaderWriter<DownloadResponse, UploadRequest>* stream,
                                          std::string& out_file_name) {
-    // criar arquivo temporário
-    std::string tmp_prefix = "/tmp/grpc_upload_";
-    // gerar id simples pela hora
-    auto now = std::chrono::system_clock::now();
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
-    std::string tmp_path = tmp_prefix + std::to_string(ms) + "_" + out_file_name;
+    // criar arquivo temporário com nome único (mkstemp): dois uploads no
+    // mesmo milissegundo ou com o mesmo nome não colidem, e o nome do
+    // cliente não entra no caminho nem na linha de comando
+    std::string tmp_path = "/tmp/grpc_upload_XXXXXX";
+    int fd = mkstemp(&tmp_path[0]);
+    if (fd < 0) {
+        WriteLog("ERROR", "ReceiveFileFromStream", out_file_name, "Falha ao criar arquivo temporário.");
+        return "";
+    }
+    close(fd);
 
     std::ofstream ofs(tmp_path, std::ios::binary);
     if (!ofs.is_open()) {
         WriteLog("ERROR", "ReceiveFileFromStream", out_file_name, "Falha ao criar arquivo temporário.");
+        std::remove(tmp_path.c_str());
         return "";
     }
 
@@ -403,6 +405,9 @@ int main(int argc, char** argv) {
     // comentário do aluno: porta padrão 50051; argumento opcional: endereço
     std::string address = "0.0.0.0:50051";
     if (argc > 1) address = argv[1];
+    LoggerOptions logger_options;
+    logger_options.file_path = "server.log";
+    InitLogging(logger_options);
     RunServer(address);
     return 0;
 }
@@ -0,0 +1,62 @@
+#include "src/abort_stats.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+// Peso da execução mais recente na média.
+constexpr double kEwmaAlpha = 0.2;
+
+struct State {
+    std::mutex mutex;
+    std::unordered_map<std::string, double> ewma_cpu_seconds;
+    AbortStats stats;
+};
+
+State& GetState() {
+    static State* state = new State();
+    return *state;
+}
+
+}  // namespace
+
+void RecordToolRun(const std::string& tool, double cpu_seconds) {
+    State& state = GetState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    auto it = state.ewma_cpu_seconds.find(tool);
+    if (it == state.ewma_cpu_seconds.end()) {
+        state.ewma_cpu_seconds.emplace(tool, cpu_seconds);
+    } else {
+        it->second += kEwmaAlpha * (cpu_seconds - it->second);
+    }
+}
+
+double RecordToolAbort(const std::string& tool, double cpu_seconds_used) {
+    State& state = GetState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    double saved = 0;
+    auto it = state.ewma_cpu_seconds.find(tool);
+    if (it != state.ewma_cpu_seconds.end()) {
+        saved = std::max(0.0, it->second - cpu_seconds_used);
+    }
+    state.stats.aborted++;
+    state.stats.cpu_seconds_saved += saved;
+    return saved;
+}
+
+AbortStats GetAbortStats() {
+    State& state = GetState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.stats;
+}
+
+std::string AbortLogMessage() {
+    AbortStats stats = GetAbortStats();
+    char totals[96];
+    std::snprintf(totals, sizeof(totals), "%llu abortadas, %.1f s de CPU economizados",
+                  static_cast<unsigned long long>(stats.aborted), stats.cpu_seconds_saved);
+    return std::string("Requisição cancelada; conversão interrompida (acumulado: ") + totals + ").";
+}
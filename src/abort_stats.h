@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Contabilidade das conversões abortadas por cancelamento ou deadline.
+//
+// Para cada ferramenta ("gs", "convert", "gsapi"...) é mantida uma média
+// móvel exponencial do tempo de CPU das execuções completas. Ao abortar uma
+// execução, a economia estimada é essa média menos o CPU que a execução já
+// tinha gasto (nunca negativa; zero enquanto não há histórico).
+// Thread-safe.
+
+struct AbortStats {
+    uint64_t aborted = 0;
+    double cpu_seconds_saved = 0;
+};
+
+// Execução completa de tool que gastou cpu_seconds.
+void RecordToolRun(const std::string& tool, double cpu_seconds);
+
+// Execução de tool abortada depois de gastar cpu_seconds_used. Retorna a
+// economia estimada desta execução.
+double RecordToolAbort(const std::string& tool, double cpu_seconds_used);
+
+AbortStats GetAbortStats();
+
+// Mensagem de log de uma requisição abortada, com os totais acumulados.
+std::string AbortLogMessage();
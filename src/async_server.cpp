@@ -0,0 +1,530 @@
+#include "src/async_server.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+
+#include "src/chunk_io.h"
+#include "src/logging.h"
+#include "src/metrics.h"
+
+using grpc::ServerAsyncReaderWriter;
+using grpc::ServerAsyncResponseWriter;
+using grpc::ServerCompletionQueue;
+using grpc::ServerContext;
+using grpc::Status;
+using file_processor::FileChunk;
+using file_processor::FileProcessor;
+using file_processor::FileRequest;
+using file_processor::FileResponse;
+
+// Admissão e execução dos jobs. Com escalonador, a vaga vem primeiro
+// (JobScheduler::AcquireAsync): quem passa do limite da sua RPC espera na
+// fila do escalonador, sem ocupar thread, e o executor só recebe jobs que já
+// têm vaga — uma rajada de CompressPDF não prende os workers enquanto
+// ResizeImage e ConvertToTXT têm vagas livres. Jobs pequenos vão para a
+// faixa própria enquanto ela tem thread livre; o resto (e o excesso de
+// pequenos) vai para o executor principal, ordenado pelo prazo (deadline do
+// cliente ou custo estimado com envelhecimento). Acertos de cache e
+// requisições que esperaram uma execução idêntica (FileOperations::PreAdmit)
+// não pegam vaga: não esperam atrás dos jobs de verdade nem são recusadas
+// pela carga deles.
+class AsyncJobExecutor {
+public:
+    // Recebe a vaga do job (nullptr sem escalonador), a repassar a
+    // FileOperations no RequestContext.
+    using Task = std::function<void(JobScheduler::Slot* slot)>;
+
+    AsyncJobExecutor(ThreadPool* main, ThreadPool* small, JobScheduler* scheduler)
+        : main_(main), small_(small), scheduler_(scheduler) {}
+
+    // Executa task quando houver vaga e thread. on_reject recebe, no lugar
+    // de task, a recusa do escalonador (ver JobScheduler::Acquire) ou
+    // RESOURCE_EXHAUSTED com a fila do executor cheia. Um dos dois é chamado
+    // exatamente uma vez, possivelmente antes de Submit retornar. Com
+    // needs_slot false, task vai direto ao executor, sem vaga.
+    void Submit(const JobInfo& job, bool needs_slot, std::function<bool()> is_cancelled, Task task,
+                std::function<void(const Status&)> on_reject) {
+        auto arrived = std::chrono::steady_clock::now();
+        if (scheduler_ == nullptr) {
+            if (!main_->TrySubmit(Timed(job.rpc, nullptr, std::move(task)))) {
+                on_reject(Overloaded());
+            }
+            return;
+        }
+        if (!needs_slot) {
+            // Custo desprezível: prazo de quem acabou de chegar.
+            auto due = JobScheduler::Due(job, 0, arrived);
+            if ((small_ == nullptr || small_->idle() == 0 || !small_->TrySubmit(Timed(job.rpc, nullptr, task), due)) &&
+                !main_->TrySubmit(Timed(job.rpc, nullptr, task), due)) {
+                on_reject(Overloaded());
+            }
+            return;
+        }
+        scheduler_->AcquireAsync(
+            job, std::move(is_cancelled),
+            [this, job, arrived, task = std::move(task), on_reject = std::move(on_reject)](
+                Status status, JobScheduler::Slot slot) {
+                if (!status.ok()) {
+                    LogError(RpcName(job.rpc), "", status.error_message());
+                    on_reject(status);
+                    return;
+                }
+                auto held = std::make_shared<JobScheduler::Slot>(std::move(slot));
+                auto due = JobScheduler::Due(job, scheduler_->EstimateSeconds(job), arrived);
+                if (small_ != nullptr && !held->large() && small_->idle() > 0 &&
+                    small_->TrySubmit(Timed(job.rpc, held, task), due)) {
+                    return;
+                }
+                if (!main_->TrySubmit(Timed(job.rpc, held, task), due)) {
+                    held->Release();
+                    on_reject(Overloaded());
+                }
+            });
+    }
+
+private:
+    static Status Overloaded() { return Status(grpc::StatusCode::RESOURCE_EXHAUSTED, "Servidor sobrecarregado"); }
+
+    // Envolve task para medir a espera na fila do executor; a vaga vive até
+    // a tarefa terminar (FileOperations a libera antes, ao fim da conversão).
+    static std::function<void()> Timed(Rpc rpc, std::shared_ptr<JobScheduler::Slot> slot, Task task) {
+        auto submitted = std::chrono::steady_clock::now();
+        return [rpc, submitted, slot = std::move(slot), task = std::move(task)] {
+            GlobalMetrics().RecordStage(rpc, Stage::kQueueWait, std::chrono::steady_clock::now() - submitted);
+            task(slot.get());
+        };
+    }
+
+    ThreadPool* main_;
+    ThreadPool* small_;
+    JobScheduler* scheduler_;
+};
+
+namespace {
+
+// Tag na completion queue.
+class CallData {
+public:
+    virtual ~CallData() = default;
+    // ok: resultado da operação que acabou de completar.
+    virtual void Proceed(bool ok) = 0;
+};
+
+// Base das RPCs assíncronas. O próprio objeto é a tag das operações da
+// chamada (no máximo uma pendente por vez); uma segunda tag recebe o aviso
+// de término do AsyncNotifyWhenDone, que diz se o cliente cancelou ou o
+// deadline expirou. Os dois eventos chegam pela mesma completion queue, e o
+// objeto só é apagado depois de ambos.
+class AsyncCall : public CallData {
+protected:
+    AsyncCall() : done_tag_(this) { ctx_.AsyncNotifyWhenDone(&done_tag_); }
+
+    // A chamada terminou do nosso lado (Finish concluído).
+    void Release() {
+        finished_ = true;
+        if (done_) {
+            delete this;
+        }
+    }
+
+    // Request não casou com nenhuma chamada (desligamento): o aviso de
+    // término nunca chega.
+    void Discard() { delete this; }
+
+    using Joined = std::shared_ptr<const SingleFlight::Result>;
+
+    // Executa task depois de FileOperations::PreAdmit. Quem recebeu o
+    // resultado de uma execução idêntica (joined) só o copia: roda na hora,
+    // na thread que o entregou (a do líder), sem fila nem vaga; o resto vai
+    // ao executor, com vaga se needs_slot.
+    void Submit(AsyncJobExecutor* executor, const JobInfo& job, bool needs_slot, Joined joined,
+                std::function<void(const RequestContext& context)> task,
+                std::function<void(const Status&)> on_reject) {
+        if (joined != nullptr) {
+            task(MakeRequestContext(nullptr, std::move(joined)));
+            return;
+        }
+        executor->Submit(
+            job, needs_slot, [this] { return cancelled(); },
+            [this, task = std::move(task)](JobScheduler::Slot* slot) { task(MakeRequestContext(slot, nullptr)); },
+            std::move(on_reject));
+    }
+
+    // Contexto para FileOperations, consultado de outras threads; slot é a
+    // vaga entregue pelo AsyncJobExecutor.
+    RequestContext MakeRequestContext(JobScheduler::Slot* slot, Joined joined) {
+        RequestContext context;
+        context.is_cancelled = [this] { return cancelled(); };
+        context.deadline = SteadyDeadline(ctx_.deadline());
+        context.slot = slot;
+        context.joined = std::move(joined);
+        return context;
+    }
+
+    bool cancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+
+    // O envio vai do primeiro Write (ou Finish, na unária) até o Finish concluir.
+    void StartSend() { send_start_ = std::chrono::steady_clock::now(); }
+
+    // Finish concluído: fecha as métricas da chamada e a libera.
+    void Complete() {
+        if (send_start_ != std::chrono::steady_clock::time_point()) {
+            GlobalMetrics().RecordStage(tracker_.rpc(), Stage::kSend, std::chrono::steady_clock::now() - send_start_);
+        }
+        tracker_.End(status_);
+        Release();
+    }
+
+    ServerContext ctx_;
+    RpcTracker tracker_;
+    // Status entregue no Finish.
+    Status status_;
+
+private:
+    class DoneTag final : public CallData {
+    public:
+        explicit DoneTag(AsyncCall* call) : call_(call) {}
+        void Proceed(bool /*ok*/) override { call_->OnDone(); }
+
+    private:
+        AsyncCall* call_;
+    };
+
+    void OnDone() {
+        cancelled_ = ctx_.IsCancelled();
+        done_ = true;
+        if (finished_) {
+            delete this;
+        }
+    }
+
+    DoneTag done_tag_;
+    std::atomic<bool> cancelled_{false};
+    std::chrono::steady_clock::time_point send_start_;
+    bool finished_ = false;
+    bool done_ = false;
+};
+
+// CompressPDF (unária).
+class CompressCall final : public AsyncCall {
+public:
+    CompressCall(FileProcessor::AsyncService* service, ServerCompletionQueue* cq,
+                 FileOperations* operations, AsyncJobExecutor* executor)
+        : service_(service), cq_(cq), operations_(operations), executor_(executor), responder_(&ctx_) {
+        service_->RequestCompressPDF(&ctx_, &request_, &responder_, cq_, cq_, this);
+    }
+
+    void Proceed(bool ok) override {
+        if (state_ == State::kFinish) {
+            Complete();
+            return;
+        }
+        if (!ok) {
+            Discard();
+            return;
+        }
+
+        // Nova chamada chegou: deixar outra à espera da próxima.
+        new CompressCall(service_, cq_, operations_, executor_);
+
+        tracker_.Begin(Rpc::kCompressPDF);
+        GlobalMetrics().AddBytesIn(Rpc::kCompressPDF, request_.file_content().size());
+        state_ = State::kFinish;
+        JobInfo job{Rpc::kCompressPDF, request_.file_content().size(), SteadyDeadline(ctx_.deadline())};
+        operations_->PreAdmit(request_, &content_digest_, [this, job](bool needs_slot, Joined joined) {
+            Submit(
+                executor_, job, needs_slot, std::move(joined),
+                [this](const RequestContext& admitted) {
+                    RequestContext context = admitted;
+                    context.content_digest = content_digest_;
+                    status_ = operations_->CompressPDF(context, request_, &response_);
+                    GlobalMetrics().AddBytesOut(Rpc::kCompressPDF, response_.file_content().size());
+                    StartSend();
+                    responder_.Finish(response_, status_, this);
+                },
+                [this](const Status& status) {
+                    status_ = status;
+                    responder_.FinishWithError(status_, this);
+                });
+        });
+    }
+
+private:
+    enum class State { kRequest, kFinish };
+
+    FileProcessor::AsyncService* service_;
+    ServerCompletionQueue* cq_;
+    FileOperations* operations_;
+    AsyncJobExecutor* executor_;
+    FileRequest request_;
+    // Digest de request_ calculado por PreAdmit (vazio sem cache nem single flight).
+    std::string content_digest_;
+    FileResponse response_;
+    ServerAsyncResponseWriter<FileResponse> responder_;
+    State state_ = State::kRequest;
+};
+
+using StreamRequestMethod = void (FileProcessor::AsyncService::*)(
+    ServerContext*, ServerAsyncReaderWriter<FileChunk, FileChunk>*,
+    grpc::CompletionQueue*, ServerCompletionQueue*, void*);
+using StreamOperation = Status (FileOperations::*)(const RequestContext&, UploadedFile, StreamResult*);
+
+// ConvertToTXT, ConvertImageFormat e ResizeImage (bidi streaming):
+// lê todos os chunks, converte no executor e devolve o resultado em chunks.
+class StreamCall final : public AsyncCall {
+public:
+    StreamCall(FileProcessor::AsyncService* service, ServerCompletionQueue* cq,
+               FileOperations* operations, AsyncJobExecutor* executor, size_t response_chunk_size, Rpc rpc,
+               StreamRequestMethod request_method, StreamOperation operation)
+        : service_(service), cq_(cq), operations_(operations), executor_(executor),
+          response_chunk_size_(response_chunk_size), rpc_(rpc),
+          request_method_(request_method), operation_(operation), stream_(&ctx_),
+          assembler_(0, operations->wants_content_digest(), operations->max_upload_bytes()) {
+        (service_->*request_method_)(&ctx_, &stream_, cq_, cq_, this);
+    }
+
+    void Proceed(bool ok) override {
+        switch (state_) {
+        case State::kRequest:
+            if (!ok) {
+                Discard();
+                return;
+            }
+            new StreamCall(service_, cq_, operations_, executor_, response_chunk_size_, rpc_,
+                           request_method_, operation_);
+            tracker_.Begin(rpc_);
+            state_ = State::kRead;
+            stream_.Read(&chunk_, this);
+            break;
+
+        case State::kRead:
+            if (!ok) {
+                // Cliente encerrou o envio sem is_last.
+                StartProcessing();
+                break;
+            }
+            if (assembler_.Add(&chunk_)) {
+                if (!assembler_.status().ok()) {
+                    LogError(RpcName(rpc_), assembler_.filename(), assembler_.status().error_message());
+                    Finish(assembler_.status());
+                    break;
+                }
+                StartProcessing();
+            } else {
+                stream_.Read(&chunk_, this);
+            }
+            break;
+
+        case State::kWrite:
+            if (!ok) {
+                // Cliente desconectou no meio da resposta.
+                Finish(Status(grpc::StatusCode::CANCELLED, "Cliente desconectado"));
+                break;
+            }
+            WriteNext();
+            break;
+
+        case State::kProcess:
+            Release();
+            break;
+
+        case State::kFinish:
+            Complete();
+            break;
+        }
+    }
+
+private:
+    enum class State { kRequest, kRead, kProcess, kWrite, kFinish };
+
+    void StartProcessing() {
+        GlobalMetrics().RecordStage(rpc_, Stage::kReceive, std::chrono::steady_clock::now() - tracker_.start());
+        GlobalMetrics().AddBytesIn(rpc_, assembler_.size());
+        state_ = State::kProcess;
+        JobInfo job{rpc_, assembler_.size(), SteadyDeadline(ctx_.deadline())};
+        upload_ = assembler_.TakeUpload();
+        operations_->PreAdmit(rpc_, upload_, [this, job](bool needs_slot, Joined joined) {
+            Submit(
+                executor_, job, needs_slot, std::move(joined),
+                [this](const RequestContext& context) {
+                    Status status = (operations_->*operation_)(context, std::move(upload_), &result_);
+                    if (!status.ok()) {
+                        Finish(status);
+                        return;
+                    }
+                    result_.chunk_size = NegotiateChunkSize(ctx_, response_chunk_size_, result_.chunk_size_hint);
+                    GlobalMetrics().AddBytesOut(rpc_, result_.data.size());
+                    state_ = State::kWrite;
+                    StartSend();
+                    WriteNext();
+                },
+                [this](const Status& status) { Finish(status); });
+        });
+    }
+
+    // Envia o próximo pedaço de result_ ou finaliza a chamada.
+    void WriteNext() {
+        const std::string& data = result_.data;
+        if (!wrote_any_) {
+            total_size_ = data.size();
+        }
+        if (offset_ >= total_size_) {
+            Finish(Status::OK);
+            return;
+        }
+        size_t length = std::min(total_size_ - offset_, result_.chunk_size);
+        reply_.Clear();
+        reply_.set_file_name(result_.file_name);
+        if (offset_ == 0 && length == data.size()) {
+            // Resposta cabe em uma mensagem: sem cópia.
+            reply_.mutable_chunk_data()->swap(result_.data);
+        } else {
+            reply_.set_chunk_data(data.data() + offset_, length);
+        }
+        offset_ += length;
+        reply_.set_is_last(offset_ >= total_size_);
+        wrote_any_ = true;
+        stream_.Write(reply_, this);
+    }
+
+    void Finish(const Status& status) {
+        state_ = State::kFinish;
+        status_ = status;
+        stream_.Finish(status_, this);
+    }
+
+    FileProcessor::AsyncService* service_;
+    ServerCompletionQueue* cq_;
+    FileOperations* operations_;
+    AsyncJobExecutor* executor_;
+    size_t response_chunk_size_;
+    Rpc rpc_;
+    StreamRequestMethod request_method_;
+    StreamOperation operation_;
+
+    ServerAsyncReaderWriter<FileChunk, FileChunk> stream_;
+    State state_ = State::kRequest;
+
+    FileChunk chunk_;
+    ChunkAssembler assembler_;
+    // Arquivo montado, entregue à operação no executor.
+    UploadedFile upload_;
+
+    StreamResult result_;
+    FileChunk reply_;
+    size_t offset_ = 0;
+    size_t total_size_ = 0;
+    bool wrote_any_ = false;
+};
+
+}  // namespace
+
+AsyncFileProcessorServer::AsyncFileProcessorServer(const ServerOptions& options, FileOperations* operations,
+                                                   JobScheduler* scheduler)
+    : options_(options),
+      operations_(operations),
+      scheduler_(scheduler),
+      executor_(options.workers, options.max_queued_jobs) {
+    if (scheduler != nullptr && options.sjf_large_job_ms > 0) {
+        size_t small_workers = options.small_lane_workers > 0 ? static_cast<size_t>(options.small_lane_workers)
+                                                               : std::max<size_t>(1, executor_.size() / 4);
+        small_executor_ = std::make_unique<ThreadPool>(small_workers, options.max_queued_jobs);
+    }
+    jobs_ = std::make_unique<AsyncJobExecutor>(&executor_, small_executor_.get(), scheduler);
+}
+
+AsyncFileProcessorServer::~AsyncFileProcessorServer() {
+    Shutdown();
+    for (std::thread& thread : cq_threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+void AsyncFileProcessorServer::Run() {
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort(options_.address, grpc::InsecureServerCredentials());
+    builder.RegisterService(&service_);
+
+    int cq_count = options_.cq_count;
+    if (cq_count <= 0) {
+        cq_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (int i = 0; i < cq_count; ++i) {
+        cqs_.push_back(builder.AddCompletionQueue());
+    }
+    server_ = builder.BuildAndStart();
+
+    // Cada fila começa com uma chamada pendente por RPC.
+    for (auto& cq : cqs_) {
+        new CompressCall(&service_, cq.get(), operations_, jobs_.get());
+        new StreamCall(&service_, cq.get(), operations_, jobs_.get(), options_.response_chunk_size,
+                       Rpc::kConvertToTXT, &FileProcessor::AsyncService::RequestConvertToTXT,
+                       &FileOperations::ConvertToTXT);
+        new StreamCall(&service_, cq.get(), operations_, jobs_.get(), options_.response_chunk_size,
+                       Rpc::kConvertImageFormat, &FileProcessor::AsyncService::RequestConvertImageFormat,
+                       &FileOperations::ConvertImageFormat);
+        new StreamCall(&service_, cq.get(), operations_, jobs_.get(), options_.response_chunk_size,
+                       Rpc::kResizeImage, &FileProcessor::AsyncService::RequestResizeImage,
+                       &FileOperations::ResizeImage);
+    }
+
+    std::cout << "Servidor assíncrono ouvindo em " << options_.address
+              << " (" << cqs_.size() << " completion queues, "
+              << executor_.size() << " workers";
+    if (small_executor_) {
+        std::cout << " + " << small_executor_->size() << " para jobs pequenos";
+    }
+    std::cout << ")" << std::endl;
+
+    for (auto& cq : cqs_) {
+        cq_threads_.emplace_back(&AsyncFileProcessorServer::PollQueue, this, cq.get());
+    }
+    std::thread sweeper;
+    if (scheduler_ != nullptr) {
+        sweeper = std::thread(&AsyncFileProcessorServer::SweepScheduler, this);
+    }
+    for (std::thread& thread : cq_threads_) {
+        thread.join();
+    }
+    if (sweeper.joinable()) {
+        sweeper.join();
+    }
+}
+
+void AsyncFileProcessorServer::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(sweep_mutex_);
+        stopping_ = true;
+    }
+    sweep_cv_.notify_all();
+    if (server_) {
+        server_->Shutdown();
+        for (auto& cq : cqs_) {
+            cq->Shutdown();
+        }
+        server_.reset();
+    }
+}
+
+void AsyncFileProcessorServer::PollQueue(ServerCompletionQueue* cq) {
+    void* tag = nullptr;
+    bool ok = false;
+    while (cq->Next(&tag, &ok)) {
+        static_cast<CallData*>(tag)->Proceed(ok);
+    }
+}
+
+void AsyncFileProcessorServer::SweepScheduler() {
+    std::unique_lock<std::mutex> lock(sweep_mutex_);
+    while (!sweep_cv_.wait_for(lock, JobScheduler::kCancelPollInterval, [this] { return stopping_; })) {
+        lock.unlock();
+        scheduler_->Sweep();
+        lock.lock();
+    }
+}
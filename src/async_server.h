@@ -0,0 +1,64 @@
+#pragma once
+
+#include <grpcpp/grpcpp.h>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "proto/file_processor.grpc.pb.h"
+#include "src/file_operations.h"
+#include "src/job_scheduler.h"
+#include "src/server_options.h"
+#include "src/thread_pool.h"
+
+// Servidor assíncrono baseado em FileProcessor::AsyncService.
+//
+// Há uma ServerCompletionQueue por núcleo (--cq-count), cada uma com sua
+// thread. Cada RPC em andamento é um objeto de estado (ver async_server.cpp)
+// que avança a cada evento da fila, de modo que uploads lentos não ocupam
+// nenhuma thread enquanto esperam dados. A conversão em si roda no executor
+// limitado (--workers / --max-queued-jobs), em ordem de prazo: o deadline do
+// cliente ou, sem ele, o custo estimado com envelhecimento (ver JobScheduler).
+// Jobs pequenos têm ainda uma faixa de threads própria (--small-lane-workers),
+// para não esperar atrás de PDFs enormes que ocupam todo o executor. Com
+// escalonador, a vaga é obtida antes do executor e quem espera por ela fica
+// na fila do escalonador, não numa thread; acertos de cache e requisições
+// iguais a uma já em execução não precisam de vaga (ver AsyncJobExecutor).
+
+// Escolhe o executor de cada job (definido em async_server.cpp).
+class AsyncJobExecutor;
+
+class AsyncFileProcessorServer {
+public:
+    // scheduler (pode ser nullptr) estima o custo e o prazo dos jobs; sem ele
+    // a fila do executor é FIFO e não há faixa de jobs pequenos.
+    AsyncFileProcessorServer(const ServerOptions& options, FileOperations* operations, JobScheduler* scheduler);
+    ~AsyncFileProcessorServer();
+
+    // Inicia o servidor e bloqueia até Shutdown().
+    void Run();
+    // Pode ser chamado de qualquer thread.
+    void Shutdown();
+
+private:
+    void PollQueue(grpc::ServerCompletionQueue* cq);
+    // Chama JobScheduler::Sweep a cada kCancelPollInterval até Shutdown.
+    void SweepScheduler();
+
+    ServerOptions options_;
+    FileOperations* operations_;
+    file_processor::FileProcessor::AsyncService service_;
+    std::unique_ptr<grpc::Server> server_;
+    std::vector<std::unique_ptr<grpc::ServerCompletionQueue>> cqs_;
+    std::vector<std::thread> cq_threads_;
+    JobScheduler* scheduler_;
+    std::mutex sweep_mutex_;
+    std::condition_variable sweep_cv_;
+    bool stopping_ = false;
+    ThreadPool executor_;
+    std::unique_ptr<ThreadPool> small_executor_;
+    std::unique_ptr<AsyncJobExecutor> jobs_;
+};
@@ -0,0 +1,111 @@
+#include "src/chunk_io.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+using file_processor::FileChunk;
+
+size_t NegotiateChunkSize(const grpc::ServerContext& context, size_t default_size, size_t hint) {
+    size_t size = hint > 0 ? hint : default_size;
+    const auto& metadata = context.client_metadata();
+    auto it = metadata.find(kChunkSizeMetadataKey);
+    if (it != metadata.end()) {
+        std::string value(it->second.data(), it->second.size());
+        char* end = nullptr;
+        unsigned long long requested = std::strtoull(value.c_str(), &end, 10);
+        if (end != value.c_str() && *end == '\0' && requested > 0) {
+            size = static_cast<size_t>(requested);
+        }
+    }
+    return std::clamp(size, kMinResponseChunkSize, kMaxResponseChunkSize);
+}
+
+ChunkAssembler::ChunkAssembler(size_t expected_size, bool hash_content, size_t max_size) : max_size_(max_size) {
+    if (expected_size > 0) {
+        buffer_.reserve(expected_size);
+    }
+    if (hash_content) {
+        hasher_ = std::make_unique<ContentHasher>();
+    }
+}
+
+bool ChunkAssembler::Add(FileChunk* chunk) {
+    if (filename_.empty()) {
+        filename_ = chunk->file_name();
+    }
+    if (first_chunk_) {
+        // As opções só valem no header do stream.
+        if (chunk->has_options()) {
+            options_.Swap(chunk->mutable_options());
+        }
+        expected_size_ = static_cast<size_t>(std::max<int64_t>(options_.total_size(), 0));
+        first_chunk_ = false;
+    }
+    if (!status_.ok()) {
+        return true;
+    }
+
+    std::string* payload = chunk->mutable_chunk_data();
+    size_t received = buffer_.size() + payload->size();
+    if (max_size_ > 0 && std::max(expected_size_, received) > max_size_) {
+        status_ = grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED,
+                               "Upload maior que o limite de " + std::to_string(max_size_) + " bytes");
+        std::string().swap(buffer_);
+        return true;
+    }
+    if (!payload->empty()) {
+        if (hasher_) {
+            hasher_->Update(payload->data(), payload->size());
+        }
+        if (buffer_.empty() && buffer_.capacity() < payload->size()) {
+            // Primeiro pedaço: adotamos a alocação do próprio chunk.
+            buffer_.swap(*payload);
+        } else {
+            const size_t capacity = buffer_.capacity();
+            const size_t previous = buffer_.size();
+            if (expected_size_ > 0 && received > capacity) {
+                buffer_.reserve(std::min(std::max(expected_size_, received), kUploadReserveFactor * received));
+            }
+            buffer_.append(*payload);
+            bytes_copied_ += payload->size();
+            if (buffer_.capacity() != capacity) {
+                bytes_copied_ += previous;
+            }
+        }
+    }
+    return chunk->is_last();
+}
+
+UploadedFile ChunkAssembler::TakeUpload() {
+    UploadedFile upload;
+    upload.file_name = filename_;
+    upload.options.Swap(&options_);
+    upload.data = std::move(buffer_);
+    if (hasher_) {
+        upload.content_digest = hasher_->HexDigest();
+        hasher_.reset();
+    }
+    return upload;
+}
+
+bool WriteChunked(std::string* data, const std::string& file_name, size_t chunk_size,
+                  const std::function<bool(const FileChunk&)>& write, bool last) {
+    FileChunk response_chunk;
+    response_chunk.set_file_name(file_name);
+    if (data->size() <= chunk_size) {
+        response_chunk.mutable_chunk_data()->swap(*data);
+        response_chunk.set_is_last(last);
+        return write(response_chunk);
+    }
+
+    for (size_t i = 0; i < data->size(); i += chunk_size) {
+        // assign reaproveita a capacidade; set_chunk_data(ptr, n) criaria uma
+        // std::string temporária por mensagem.
+        response_chunk.mutable_chunk_data()->assign(data->data() + i, std::min(chunk_size, data->size() - i));
+        response_chunk.set_is_last(last && i + chunk_size >= data->size());
+        if (!write(response_chunk)) {
+            return false;
+        }
+    }
+    return true;
+}
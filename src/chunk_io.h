@@ -0,0 +1,95 @@
+#pragma once
+
+#include <grpcpp/grpcpp.h>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "proto/file_processor.pb.h"
+#include "src/content_hash.h"
+
+// ProcessingOptions.total_size vem do cliente: o buffer é reservado em
+// direção a ele, mas nunca além deste múltiplo do que já chegou.
+constexpr size_t kUploadReserveFactor = 4;
+
+// Metadado opcional em que o cliente pede o tamanho dos FileChunks de resposta.
+constexpr char kChunkSizeMetadataKey[] = "x-chunk-size";
+// Limites aceitos: abaixo do mínimo o overhead por mensagem domina; acima do
+// máximo a mensagem estouraria o limite padrão de 4 MB do gRPC.
+constexpr size_t kMinResponseChunkSize = 4 * 1024;
+constexpr size_t kMaxResponseChunkSize = 4 * 1024 * 1024 - 64 * 1024;
+
+// Tamanho de chunk de resposta para esta chamada: o valor pedido pelo
+// cliente em x-chunk-size, senão hint (ProcessingOptions.chunk_size_hint,
+// 0 = nenhum), senão default_size; sempre dentro dos limites.
+size_t NegotiateChunkSize(const grpc::ServerContext& context, size_t default_size, size_t hint = 0);
+
+// Arquivo recebido por uma RPC de streaming.
+struct UploadedFile {
+    std::string file_name;
+    std::string data;
+    // Hash do conteúdo (vazio se não foi calculado); chave do ResultCache.
+    std::string content_digest;
+    // Opções do primeiro chunk (vazias se o cliente não enviou).
+    file_processor::ProcessingOptions options;
+};
+
+// Monta o arquivo recebido em um único buffer. Se o header traz
+// ProcessingOptions.total_size, o buffer cresce direto até ele, em passos de
+// até kUploadReserveFactor vezes o recebido (um header mentiroso não faz o
+// servidor alocar o que o cliente não mandou); senão o payload do primeiro
+// FileChunk é trocado (swap) para dentro dele e os demais são anexados, com
+// o buffer crescendo por realocação. Sem as cópias intermediárias
+// (std::string -> std::vector -> std::string) do código antigo.
+class ChunkAssembler {
+public:
+    // expected_size, se conhecido, reserva o buffer inteiro de uma vez.
+    // hash_content calcula o digest do conteúdo conforme os chunks chegam.
+    // max_size limita o upload (0 = sem limite).
+    explicit ChunkAssembler(size_t expected_size = 0, bool hash_content = false, size_t max_size = 0);
+
+    // Consome o payload de chunk (chunk_data fica vazio ou com lixo reutilizável).
+    // Retorna true se era o último chunk (is_last) ou se o upload foi
+    // recusado (ver status).
+    bool Add(file_processor::FileChunk* chunk);
+
+    // RESOURCE_EXHAUSTED se total_size ou os dados recebidos passam de
+    // max_size; o buffer é descartado e os chunks seguintes são ignorados.
+    const grpc::Status& status() const { return status_; }
+
+    const std::string& filename() const { return filename_; }
+    const file_processor::ProcessingOptions& options() const { return options_; }
+    size_t size() const { return buffer_.size(); }
+
+    // Entrega o buffer montado; o assembler fica vazio.
+    std::string Release() { return std::move(buffer_); }
+    // Entrega nome, opções, buffer e digest (se hash_content).
+    UploadedFile TakeUpload();
+
+    // Bytes copiados até agora: os anexados e os movidos a cada realocação
+    // do buffer (os trocados via swap não contam).
+    size_t bytes_copied() const { return bytes_copied_; }
+
+private:
+    std::string filename_;
+    file_processor::ProcessingOptions options_;
+    const size_t max_size_;
+    bool first_chunk_ = true;
+    // total_size do header (0 = não informado).
+    size_t expected_size_ = 0;
+    std::string buffer_;
+    size_t bytes_copied_ = 0;
+    grpc::Status status_;
+    std::unique_ptr<ContentHasher> hasher_;
+};
+
+// Envia data como FileChunks de no máximo chunk_size bytes (o último com
+// is_last). Se couber em uma mensagem, o buffer vai para a resposta por
+// swap, sem cópia; senão cada pedaço é copiado uma única vez para o chunk,
+// que é reutilizado entre as mensagens. data é consumido. Para no primeiro
+// write que falhar (cliente desconectado) e retorna false. Com last = false
+// nenhum chunk leva is_last (parte de uma resposta que ainda continua).
+bool WriteChunked(std::string* data, const std::string& file_name, size_t chunk_size,
+                  const std::function<bool(const file_processor::FileChunk&)>& write, bool last = true);
@@ -0,0 +1,42 @@
+#include "src/content_hash.h"
+
+#include <openssl/evp.h>
+
+struct ContentHasher::Context {
+    EVP_MD_CTX* md = nullptr;
+};
+
+ContentHasher::ContentHasher() : context_(new Context) {
+    context_->md = EVP_MD_CTX_new();
+    EVP_DigestInit_ex(context_->md, EVP_blake2b512(), nullptr);
+}
+
+ContentHasher::~ContentHasher() {
+    EVP_MD_CTX_free(context_->md);
+    delete context_;
+}
+
+void ContentHasher::Update(const void* data, size_t size) {
+    EVP_DigestUpdate(context_->md, data, size);
+}
+
+std::string ContentHasher::HexDigest() {
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int length = 0;
+    EVP_DigestFinal_ex(context_->md, digest, &length);
+
+    static const char kHex[] = "0123456789abcdef";
+    std::string hex;
+    // 256 bits bastam para endereçar conteúdo.
+    for (unsigned int i = 0; i < length && i < 32; ++i) {
+        hex += kHex[digest[i] >> 4];
+        hex += kHex[digest[i] & 0xf];
+    }
+    return hex;
+}
+
+std::string HashContent(const std::string& data) {
+    ContentHasher hasher;
+    hasher.Update(data.data(), data.size());
+    return hasher.HexDigest();
+}
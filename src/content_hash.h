@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Hash incremental de conteúdo (BLAKE2b-512 via OpenSSL, truncado em 256
+// bits), alimentado conforme os chunks chegam.
+class ContentHasher {
+public:
+    ContentHasher();
+    ~ContentHasher();
+
+    ContentHasher(const ContentHasher&) = delete;
+    ContentHasher& operator=(const ContentHasher&) = delete;
+
+    void Update(const void* data, size_t size);
+    // Finaliza e devolve o digest em hexadecimal (64 caracteres).
+    std::string HexDigest();
+
+private:
+    struct Context;
+    Context* context_;
+};
+
+// Digest em hexadecimal de um buffer inteiro.
+std::string HashContent(const std::string& data);
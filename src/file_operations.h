@@ -0,0 +1,183 @@
+#pragma once
+
+#include <grpcpp/grpcpp.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "proto/file_processor.pb.h"
+#include "src/chunk_io.h"
+#include "src/image_resize.h"
+#include "src/job_scheduler.h"
+#include "src/pdf_compressor.h"
+#include "src/pdf_text.h"
+#include "src/processing_options.h"
+#include "src/result_cache.h"
+#include "src/scratch_storage.h"
+#include "src/single_flight.h"
+
+// Resultado de uma RPC de streaming: o que deve voltar ao cliente.
+struct StreamResult {
+    std::string file_name;
+    std::string data;
+    // Tamanho máximo de cada FileChunk de resposta, definido pelo transporte
+    // (ver NegotiateChunkSize).
+    size_t chunk_size = 0;
+    // chunk_size_hint das opções da requisição (0 = nenhum).
+    size_t chunk_size_hint = 0;
+    // Opcional, definido pelo transporte: a operação entrega por aqui o
+    // início de data assim que fica pronto (o ConvertToTXT, uma página por
+    // vez), e a resposta começa antes do fim da operação. Retorna false se o
+    // cliente desconectou. Ao final, o transporte envia só o resto de data.
+    std::function<bool(std::string piece)> send_partial;
+    // Bytes do início de data já enviados por send_partial.
+    size_t sent_bytes = 0;
+};
+
+// Atalhos do CompressPDF: o PDF volta sem alteração quando a pré-análise
+// prevê que o gs não vai reduzi-lo ou quando a saída do gs não é menor.
+struct PdfShortcutStats {
+    uint64_t precheck_skips = 0;
+    uint64_t output_larger = 0;
+};
+
+// Informações da chamada que as operações podem consultar.
+struct RequestContext {
+    // true se o cliente cancelou ou o deadline expirou (opcional).
+    std::function<bool()> is_cancelled;
+    // Deadline do cliente (ver SteadyDeadline); orienta o escalonador.
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    // Vaga já obtida pelo transporte (servidor assíncrono, ver
+    // JobScheduler::AcquireAsync); nullptr = Execute espera a sua.
+    JobScheduler::Slot* slot = nullptr;
+    // Digest de request.file_content() já calculado pelo transporte (ver
+    // PreAdmit); vazio = o CompressPDF calcula.
+    std::string content_digest;
+    // Resultado da execução idêntica que a requisição esperou antes da
+    // admissão (ver PreAdmit); Execute o entrega sem executar nada.
+    std::shared_ptr<const SingleFlight::Result> joined;
+
+    bool cancelled() const { return is_cancelled && is_cancelled(); }
+};
+
+// Lógica das quatro RPCs, independente do transporte. É compartilhada pelo
+// serviço síncrono (server.cpp) e pelo servidor assíncrono (async_server).
+// Todos os métodos são thread-safe.
+//
+// Em volta de cada operação ficam o cache de resultados (opcional), a
+// deduplicação de requisições idênticas simultâneas (single flight) e o
+// controle de admissão, que só é consultado por quem vai de fato executar.
+class FileOperations {
+public:
+    struct Options {
+        // CompressPDF passa o PDF ao gs pelo stdin quando o motor permite.
+        bool pipeline = false;
+        // Pode ser nullptr (sem cache de resultados).
+        ResultCache* cache = nullptr;
+        bool single_flight = true;
+        // Controle de admissão das execuções (nullptr = sem limite).
+        JobScheduler* scheduler = nullptr;
+        // Redimensionamento em processo do ResizeImage (nullptr = a imagem
+        // volta sem alteração).
+        const ImageResizer* resizer = nullptr;
+        // Com resizer, JPEGs bem maiores que o destino são decodificados já
+        // reduzidos pela escala do DCT (ver DecodeOptions).
+        bool shrink_on_load = true;
+        // Extração de texto em processo do ConvertToTXT (nullptr = texto
+        // fixo de demonstração).
+        const PdfTextExtractor* text_extractor = nullptr;
+        // Pré-análise do CompressPDF (ver EstimatePdfCompression): abaixo
+        // desta economia estimada, em % do arquivo, o gs não roda (0 = sempre roda).
+        int pdf_precheck_min_savings = 5;
+        // Maior upload das RPCs de streaming (0 = sem limite).
+        size_t max_upload_bytes = 0;
+    };
+
+    // scratch guarda os arquivos de entrada e saída do gs fora do pipeline.
+    FileOperations(PdfCompressor* pdf_compressor, ScratchStorage* scratch, const Options& options)
+        : pdf_compressor_(pdf_compressor), scratch_(scratch), options_(options) {}
+
+    // Se true, os transportes devem calcular UploadedFile::content_digest.
+    bool wants_content_digest() const { return options_.cache != nullptr || options_.single_flight; }
+    // Limite que os transportes passam ao ChunkAssembler.
+    size_t max_upload_bytes() const { return options_.max_upload_bytes; }
+
+    // Recebe, de PreAdmit, se a requisição precisa de vaga no escalonador e
+    // o resultado da execução idêntica que ela esperou (ou nullptr).
+    using AdmitCallback =
+        std::function<void(bool needs_slot, std::shared_ptr<const SingleFlight::Result> joined)>;
+
+    // Etapa anterior à admissão, para o servidor assíncrono: acertos de cache
+    // e requisições iguais a uma já em execução não precisam de vaga. admit é
+    // chamado exatamente uma vez: na hora (needs_slot = false num acerto de
+    // cache, true se a requisição vai executar) ou, se há execução idêntica
+    // em andamento, quando ela termina, com o resultado dela em joined — a
+    // espera não ocupa thread. Se o resultado sumir do cache antes de
+    // Execute, ela espera a vaga na própria thread. Na versão do CompressPDF,
+    // content_digest recebe o digest do arquivo, a repassar em
+    // RequestContext::content_digest.
+    void PreAdmit(const file_processor::FileRequest& request, std::string* content_digest,
+                  const AdmitCallback& admit);
+    void PreAdmit(Rpc rpc, const UploadedFile& upload, const AdmitCallback& admit);
+
+    grpc::Status CompressPDF(const RequestContext& context, const file_processor::FileRequest& request,
+                             file_processor::FileResponse* response);
+
+    // As operações de streaming recebem o arquivo já montado. Parâmetros
+    // inválidos em upload.options resultam em INVALID_ARGUMENT.
+    // ConvertImageFormat converte em processo (image_codec.h) para png,
+    // jpg/jpeg e pnm; os outros formatos aceitos pelas opções (webp, gif,
+    // bmp, tiff), e os codecs ausentes do build, passam pelo convert.
+    grpc::Status ConvertToTXT(const RequestContext& context, UploadedFile upload, StreamResult* result);
+    grpc::Status ConvertImageFormat(const RequestContext& context, UploadedFile upload, StreamResult* result);
+    grpc::Status ResizeImage(const RequestContext& context, UploadedFile upload, StreamResult* result);
+
+    SingleFlight::Stats single_flight_stats() const { return flights_.stats(); }
+    PdfShortcutStats pdf_shortcut_stats() const;
+
+private:
+    using Producer = std::function<grpc::Status(std::string* data)>;
+
+    grpc::Status CompressPDFFiles(const file_processor::FileRequest& request, const PdfCompressSettings& settings,
+                                  std::string* compressed, file_processor::FileResponse* response);
+    grpc::Status CompressPDFPipe(const file_processor::FileRequest& request, const PdfCompressSettings& settings,
+                                 std::string* compressed, file_processor::FileResponse* response);
+    // Decodifica input, redimensiona para caber em params.width x
+    // params.height e codifica no mesmo formato.
+    grpc::Status ResizeNative(const std::string& input, const RequestParams& params, std::string* output);
+    // Status da compressão que falhou: CANCELLED se a requisição foi
+    // cancelada (o gs foi interrompido), senão INTERNAL.
+    grpc::Status CompressFailure(const file_processor::FileRequest& request, const PdfCompressSettings& settings,
+                                 const std::string& gs_error, file_processor::FileResponse* response);
+
+    // Chave de cache/deduplicação da requisição; vazia se nenhum dos dois
+    // está ativo ou o digest não foi calculado.
+    std::string RequestKey(const std::string& content_digest, const char* method,
+                           const std::string& params) const;
+    // RequestKey de cada RPC, a partir das opções já resolvidas.
+    std::string CompressPDFKey(const std::string& content_digest, const RequestParams& params) const;
+    std::string UploadKey(Rpc rpc, const UploadedFile& upload, const RequestParams& params) const;
+    void PreAdmitKey(const std::string& key, const AdmitCallback& admit);
+
+    // Executa produce (que grava o resultado em *data) consultando antes o
+    // cache e compartilhando a execução com requisições idênticas. Se a
+    // requisição já foi cancelada, retorna CANCELLED sem executar nada; sem
+    // vaga no escalonador, o status de JobScheduler::Acquire. Com
+    // context.slot, a vaga é liberada assim que produce termina (ou logo, num
+    // acerto de cache ou para esperar um líder do single flight).
+    // input_bytes orienta a ordem na fila do escalonador.
+    grpc::Status Execute(const RequestContext& context, const char* method, const std::string& filename,
+                         size_t input_bytes, const std::string& key, const Producer& produce, std::string* data);
+
+    PdfCompressor* pdf_compressor_;
+    ScratchStorage* scratch_;
+    const Options options_;
+    SingleFlight flights_;
+    std::atomic<uint64_t> pdf_precheck_skips_{0};
+    std::atomic<uint64_t> pdf_output_larger_{0};
+};
@@ -0,0 +1,245 @@
+#include "src/flate.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#ifdef FP_HAVE_LIBDEFLATE
+#include <libdeflate.h>
+#endif
+
+namespace {
+
+// Estimativa da saída da descompressão em buffer inteiro quando quem chama
+// não sabe o tamanho; o zlib dobra o buffer enquanto não couber.
+constexpr size_t kMinDecompressCapacity = 64 * 1024;
+constexpr size_t kDecompressExpansion = 4;
+
+size_t InitialCapacity(size_t size, size_t max_size, size_t size_hint) {
+    size_t estimate = size_hint > 0 ? size_hint : std::max(kMinDecompressCapacity, size * kDecompressExpansion);
+    return std::min(max_size, estimate);
+}
+
+FlateBackend BestBackend() {
+#ifdef FP_HAVE_LIBDEFLATE
+    return FlateBackend::kLibdeflate;
+#else
+    return FlateBackend::kZlib;
+#endif
+}
+
+std::atomic<FlateBackend> active_backend{BestBackend()};
+
+int ClampLevel(int level) {
+    if (level <= 0) {
+        return kDefaultFlateLevel;
+    }
+    return std::min(level, kMaxFlateLevel);
+}
+
+bool ZlibCompress(const char* data, size_t size, int level, std::string* out, std::string* error) {
+    uLongf compressed_size = compressBound(static_cast<uLong>(size));
+    out->resize(compressed_size);
+    if (compress2(reinterpret_cast<Bytef*>(&(*out)[0]), &compressed_size, reinterpret_cast<const Bytef*>(data),
+                  static_cast<uLong>(size), std::min(level, 9)) != Z_OK) {
+        out->clear();
+        *error = "falha ao comprimir com o zlib";
+        return false;
+    }
+    out->resize(compressed_size);
+    return true;
+}
+
+// Inflate incremental numa passada só: a saída começa com capacity bytes e
+// cresce no lugar, sem recomeçar o stream.
+bool ZlibDecompress(const char* data, size_t size, size_t max_size, size_t capacity, std::string* out,
+                    std::string* error) {
+    z_stream stream{};
+    if (inflateInit(&stream) != Z_OK) {
+        *error = "falha ao iniciar o zlib";
+        return false;
+    }
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    stream.avail_in = static_cast<uInt>(std::min<size_t>(size, UINT32_MAX));
+    out->resize(capacity);
+    size_t produced = 0;
+    // Sempre há espaço na saída: Z_BUF_ERROR é entrada acabando antes do fim
+    // do stream.
+    int result = Z_OK;
+    while (result == Z_OK) {
+        if (produced == out->size()) {
+            if (out->size() >= max_size) {
+                break;
+            }
+            out->resize(std::min(max_size, out->size() * 2));
+        }
+        stream.next_out = reinterpret_cast<Bytef*>(&(*out)[produced]);
+        stream.avail_out = static_cast<uInt>(std::min<size_t>(out->size() - produced, UINT32_MAX));
+        const uInt available = stream.avail_out;
+        result = inflate(&stream, Z_NO_FLUSH);
+        produced += available - stream.avail_out;
+    }
+    inflateEnd(&stream);
+    if (result != Z_STREAM_END) {
+        out->clear();
+        *error = produced >= max_size ? "stream descomprimido grande demais" : "dados Flate corrompidos ou truncados";
+        return false;
+    }
+    out->resize(produced);
+    return true;
+}
+
+#ifdef FP_HAVE_LIBDEFLATE
+
+struct CompressorDeleter {
+    void operator()(libdeflate_compressor* compressor) const { libdeflate_free_compressor(compressor); }
+};
+struct DecompressorDeleter {
+    void operator()(libdeflate_decompressor* decompressor) const { libdeflate_free_decompressor(decompressor); }
+};
+
+// Os objetos da libdeflate não são thread-safe e alocam até alguns MB nos
+// níveis altos: um por thread e por nível, criado no primeiro uso.
+libdeflate_compressor* ThreadCompressor(int level) {
+    thread_local std::unique_ptr<libdeflate_compressor, CompressorDeleter> compressors[kMaxFlateLevel + 1];
+    if (!compressors[level]) {
+        compressors[level].reset(libdeflate_alloc_compressor(level));
+    }
+    return compressors[level].get();
+}
+
+libdeflate_decompressor* ThreadDecompressor() {
+    thread_local std::unique_ptr<libdeflate_decompressor, DecompressorDeleter> decompressor(
+        libdeflate_alloc_decompressor());
+    return decompressor.get();
+}
+
+bool LibdeflateCompress(const char* data, size_t size, int level, std::string* out, std::string* error) {
+    libdeflate_compressor* compressor = ThreadCompressor(level);
+    if (compressor == nullptr) {
+        *error = "falha ao iniciar a libdeflate";
+        return false;
+    }
+    out->resize(libdeflate_zlib_compress_bound(compressor, size));
+    size_t compressed_size = libdeflate_zlib_compress(compressor, data, size, &(*out)[0], out->size());
+    if (compressed_size == 0) {
+        out->clear();
+        *error = "falha ao comprimir com a libdeflate";
+        return false;
+    }
+    out->resize(compressed_size);
+    return true;
+}
+
+// A libdeflate só descomprime num buffer de tamanho fixo e, se não cabe,
+// recomeça do zero. Uma tentativa com a estimativa; se faltar espaço, o
+// resto vai pelo zlib incremental, em vez de dobrar e repetir (um stream
+// gigante seria decodificado várias vezes antes de ser recusado).
+bool LibdeflateDecompress(const char* data, size_t size, size_t max_size, size_t size_hint, std::string* out,
+                          std::string* error) {
+    libdeflate_decompressor* decompressor = ThreadDecompressor();
+    if (decompressor == nullptr) {
+        *error = "falha ao iniciar a libdeflate";
+        return false;
+    }
+    size_t capacity = InitialCapacity(size, max_size, size_hint);
+    out->resize(capacity);
+    size_t consumed = 0, produced = 0;
+    libdeflate_result result =
+        libdeflate_zlib_decompress_ex(decompressor, data, size, &(*out)[0], capacity, &consumed, &produced);
+    if (result == LIBDEFLATE_SUCCESS) {
+        out->resize(produced);
+        return true;
+    }
+    if (result == LIBDEFLATE_INSUFFICIENT_SPACE && capacity < max_size) {
+        return ZlibDecompress(data, size, max_size, std::min(max_size, capacity * 2), out, error);
+    }
+    out->clear();
+    *error = result == LIBDEFLATE_INSUFFICIENT_SPACE ? "stream descomprimido grande demais"
+                                                     : "dados Flate corrompidos ou truncados";
+    return false;
+}
+
+#endif  // FP_HAVE_LIBDEFLATE
+
+}  // namespace
+
+const char* FlateBackendName(FlateBackend backend) {
+    switch (backend) {
+    case FlateBackend::kAuto:
+        return "auto";
+    case FlateBackend::kZlib:
+        return "zlib";
+    case FlateBackend::kLibdeflate:
+        return "libdeflate";
+    }
+    return "?";
+}
+
+bool ParseFlateBackend(const std::string& name, FlateBackend* backend) {
+    for (FlateBackend candidate : {FlateBackend::kAuto, FlateBackend::kZlib, FlateBackend::kLibdeflate}) {
+        if (name == FlateBackendName(candidate)) {
+            *backend = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FlateBackendAvailable(FlateBackend backend) {
+#ifdef FP_HAVE_LIBDEFLATE
+    (void)backend;
+    return true;
+#else
+    return backend != FlateBackend::kLibdeflate;
+#endif
+}
+
+bool SetFlateBackend(FlateBackend backend) {
+    if (!FlateBackendAvailable(backend)) {
+        return false;
+    }
+    active_backend = backend == FlateBackend::kAuto ? BestBackend() : backend;
+    return true;
+}
+
+FlateBackend ActiveFlateBackend() { return active_backend; }
+
+bool FlateCompress(const char* data, size_t size, int level, std::string* out, std::string* error) {
+    level = ClampLevel(level);
+#ifdef FP_HAVE_LIBDEFLATE
+    if (active_backend == FlateBackend::kLibdeflate) {
+        return LibdeflateCompress(data, size, level, out, error);
+    }
+#endif
+    return ZlibCompress(data, size, level, out, error);
+}
+
+bool FlateDecompress(const char* data, size_t size, size_t max_size, std::string* out, std::string* error,
+                     size_t size_hint) {
+#ifdef FP_HAVE_LIBDEFLATE
+    if (active_backend == FlateBackend::kLibdeflate) {
+        return LibdeflateDecompress(data, size, max_size, size_hint, out, error);
+    }
+#endif
+    return ZlibDecompress(data, size, max_size, InitialCapacity(size, max_size, size_hint), out, error);
+}
+
+uint32_t FlateCrc32(uint32_t crc, const char* data, size_t size) {
+#ifdef FP_HAVE_LIBDEFLATE
+    if (active_backend == FlateBackend::kLibdeflate) {
+        return libdeflate_crc32(crc, data, size);
+    }
+#endif
+    // crc32 recebe uInt: blocos de até 1 GiB.
+    const size_t kBlock = size_t{1} << 30;
+    while (size > 0) {
+        const size_t block = std::min(size, kBlock);
+        crc = static_cast<uint32_t>(crc32(crc, reinterpret_cast<const Bytef*>(data), static_cast<uInt>(block)));
+        data += block;
+        size -= block;
+    }
+    return crc;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Codec Flate (streams zlib, RFC 1950/1951) de todo o trabalho em processo:
+// FlateDecode do leitor de PDF, streams escritos pelo NativePdfCompressor,
+// amostras da pré-análise e o IDAT dos PNGs gerados.
+//
+// Com a libdeflate (FP_HAVE_LIBDEFLATE, ver CMakeLists.txt) os buffers são
+// comprimidos e descomprimidos inteiros por ela, que escolhe em tempo de
+// execução os kernels da CPU (Adler-32 e CRC-32 com SSE2/AVX2/PCLMUL,
+// decodificação com tabelas maiores e matchfinders mais rápidos). Ela só
+// descomprime num buffer de tamanho fixo: quando a saída não cabe na
+// estimativa (ver FlateDecompress), o zlib incremental faz o stream. Sem ela,
+// ou com --flate-backend=zlib, vale o zlib com que o servidor foi ligado
+// (um zlib-ng em modo compatível também despacha pela CPU).
+
+enum class FlateBackend { kAuto, kZlib, kLibdeflate };
+
+const char* FlateBackendName(FlateBackend backend);
+// "auto", "zlib" ou "libdeflate". Retorna false se o nome não é conhecido.
+bool ParseFlateBackend(const std::string& name, FlateBackend* backend);
+// true se backend foi compilado (kAuto e kZlib sempre).
+bool FlateBackendAvailable(FlateBackend backend);
+// Backend de todas as chamadas seguintes (kAuto = libdeflate se compilada).
+// Retorna false, sem trocar, se backend não está disponível.
+bool SetFlateBackend(FlateBackend backend);
+// Backend em uso (nunca kAuto).
+FlateBackend ActiveFlateBackend();
+
+// Níveis de compressão: 1 (mais rápido) a 12 (menor saída); 0 =
+// kDefaultFlateLevel. O zlib vai só até 9: acima disso usa 9.
+constexpr int kDefaultFlateLevel = 6;
+constexpr int kMaxFlateLevel = 12;
+
+// Comprime data[0, size) num stream zlib em out.
+bool FlateCompress(const char* data, size_t size, int level, std::string* out, std::string* error);
+
+// Descomprime um stream zlib completo (dados depois do fim são ignorados).
+// Retorna false e preenche error se o stream está truncado ou corrompido ou
+// se a saída passaria de max_size; quem precisa aproveitar o começo de um
+// stream danificado usa o zlib incremental diretamente. size_hint é o
+// tamanho esperado da saída, se conhecido (ex: /DL de um stream PDF): com
+// ele certo, a libdeflate acerta o buffer na primeira tentativa.
+bool FlateDecompress(const char* data, size_t size, size_t max_size, std::string* out, std::string* error,
+                     size_t size_hint = 0);
+
+// CRC-32 (o dos chunks PNG e do gzip) de data, continuando de crc.
+uint32_t FlateCrc32(uint32_t crc, const char* data, size_t size);
@@ -0,0 +1,195 @@
+#include "src/gs_instance_pool.h"
+
+#include <ghostscript/iapi.h>
+
+#include <time.h>
+
+#include <algorithm>
+#include <thread>
+
+#include "src/abort_stats.h"
+#include "src/logging.h"
+#include "src/tool_commands.h"
+
+namespace {
+
+// CPU gasto pela thread atual (o gsapi roda na thread da requisição).
+double ThreadCpuSeconds() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Argumentos da instância. A saída inicial vai para /dev/null; cada
+// requisição troca o OutputFile via setpagedevice. Sem -dBATCH: sem arquivo
+// de entrada, o init executaria quit e as chamadas seguintes rodariam num
+// interpretador encerrado.
+const char* const kBaseArgs[] = {
+    "gs",
+    "-sDEVICE=pdfwrite",
+    "-dCompatibilityLevel=1.4",
+    "-dPDFSETTINGS=/ebook",
+    "-dNOPAUSE",
+    "-dQUIET",
+    "-dSAFER",
+    "-sOutputFile=/dev/null",
+};
+
+}  // namespace
+
+struct GhostscriptInstancePool::Instance {
+    void* gs = nullptr;
+    // stderr do Ghostscript da requisição atual (usado na mensagem de erro).
+    std::string messages;
+    // Cancelamento da requisição atual, consultado pelo callback de poll.
+    std::function<bool()> is_cancelled;
+    bool cancelled = false;
+
+    ~Instance() {
+        if (gs != nullptr) {
+            gsapi_exit(gs);
+            gsapi_delete_instance(gs);
+        }
+    }
+
+    // O interpretador chama o poll periodicamente; retorno negativo aborta a
+    // execução em andamento.
+    static int OnPoll(void* handle) {
+        auto* self = static_cast<Instance*>(handle);
+        if (!self->cancelled && self->is_cancelled && self->is_cancelled()) {
+            self->cancelled = true;
+        }
+        return self->cancelled ? -1 : 0;
+    }
+
+    static int OnStdin(void*, char*, int) { return 0; }
+    static int OnStdout(void*, const char*, int len) { return len; }
+    static int OnStderr(void* handle, const char* str, int len) {
+        auto* self = static_cast<Instance*>(handle);
+        if (self->messages.size() < 4096) {
+            self->messages.append(str, len);
+        }
+        return len;
+    }
+};
+
+std::unique_ptr<GhostscriptInstancePool> GhostscriptInstancePool::Create(int size, std::string* error) {
+    if (size <= 0) {
+        size = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::unique_ptr<GhostscriptInstancePool> pool(new GhostscriptInstancePool());
+    for (int i = 0; i < size; ++i) {
+        std::unique_ptr<Instance> instance = NewInstance(error);
+        if (!instance) {
+            return nullptr;
+        }
+        pool->idle_.push_back(std::move(instance));
+    }
+    pool->size_ = size;
+    return pool;
+}
+
+GhostscriptInstancePool::~GhostscriptInstancePool() = default;
+
+std::unique_ptr<GhostscriptInstancePool::Instance> GhostscriptInstancePool::NewInstance(std::string* error) {
+    auto instance = std::make_unique<Instance>();
+    int code = gsapi_new_instance(&instance->gs, instance.get());
+    if (code < 0) {
+        instance->gs = nullptr;
+        *error = "gsapi_new_instance falhou: " + std::to_string(code);
+        return nullptr;
+    }
+    gsapi_set_stdio(instance->gs, &Instance::OnStdin, &Instance::OnStdout, &Instance::OnStderr);
+    gsapi_set_poll(instance->gs, &Instance::OnPoll);
+    gsapi_set_arg_encoding(instance->gs, GS_ARG_ENCODING_UTF8);
+
+    int argc = static_cast<int>(sizeof(kBaseArgs) / sizeof(kBaseArgs[0]));
+    code = gsapi_init_with_args(instance->gs, argc, const_cast<char**>(kBaseArgs));
+    if (code < 0) {
+        *error = "gsapi_init_with_args falhou: " + std::to_string(code) + " " + instance->messages;
+        return nullptr;
+    }
+    instance->messages.clear();
+    return instance;
+}
+
+std::unique_ptr<GhostscriptInstancePool::Instance> GhostscriptInstancePool::Acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    available_.wait(lock, [this] { return !idle_.empty() || size_ == 0; });
+    if (idle_.empty()) {
+        return nullptr;
+    }
+    std::unique_ptr<Instance> instance = std::move(idle_.back());
+    idle_.pop_back();
+    return instance;
+}
+
+void GhostscriptInstancePool::Release(std::unique_ptr<Instance> instance) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (instance) {
+            idle_.push_back(std::move(instance));
+        } else {
+            --size_;
+        }
+    }
+    // Com o pool vazio, todas as esperas precisam acordar para falhar.
+    available_.notify_all();
+}
+
+bool GhostscriptInstancePool::Compress(const std::string& input_path, const std::string& output_path,
+                                       const PdfCompressSettings& settings, std::string* error) {
+    std::unique_ptr<Instance> instance = Acquire();
+    if (!instance) {
+        *error = "gsapi indisponível: todas as instâncias do pool foram descartadas";
+        return false;
+    }
+    instance->messages.clear();
+    instance->is_cancelled = settings.is_cancelled;
+    instance->cancelled = false;
+    const double cpu_start = ThreadCpuSeconds();
+
+    // Com -dSAFER o Ghostscript só acessa caminhos liberados explicitamente.
+    gsapi_add_control_path(instance->gs, GS_PERMIT_FILE_READING, input_path.c_str());
+    gsapi_add_control_path(instance->gs, GS_PERMIT_FILE_WRITING, output_path.c_str());
+
+    int exit_code = 0;
+    // O pdfwrite aceita PDFSETTINGS como parâmetro do device, então o preset
+    // troca junto com o OutputFile.
+    std::string open_output = "<< /OutputFile " + PostScriptString(output_path) + " /PDFSETTINGS " +
+                              settings.pdf_settings + " >> setpagedevice";
+    int code = gsapi_run_string(instance->gs, open_output.c_str(), 0, &exit_code);
+    if (code >= 0) {
+        code = gsapi_run_file(instance->gs, input_path.c_str(), 0, &exit_code);
+    }
+    // Trocar o OutputFile fecha o device e grava o trailer do PDF gerado.
+    int close_code = gsapi_run_string(instance->gs, "<< /OutputFile (/dev/null) >> setpagedevice", 0, &exit_code);
+
+    gsapi_remove_control_path(instance->gs, GS_PERMIT_FILE_READING, input_path.c_str());
+    gsapi_remove_control_path(instance->gs, GS_PERMIT_FILE_WRITING, output_path.c_str());
+
+    instance->is_cancelled = nullptr;
+    bool ok = code >= 0 && close_code >= 0 && !instance->cancelled;
+    double cpu_seconds = ThreadCpuSeconds() - cpu_start;
+    if (instance->cancelled) {
+        RecordToolAbort("gsapi", cpu_seconds);
+    } else if (ok) {
+        RecordToolRun("gsapi", cpu_seconds);
+    }
+    if (!ok) {
+        *error = instance->cancelled
+                     ? std::string("gsapi interrompido: requisição cancelada")
+                     : "gsapi retornou " + std::to_string(code < 0 ? code : close_code) + ": " + instance->messages;
+        // Depois de um erro o estado do interpretador não é confiável:
+        // substituímos a instância por uma nova. Se a nova não inicia, a
+        // quebrada é descartada e o pool encolhe.
+        instance.reset();
+        std::string init_error;
+        instance = NewInstance(&init_error);
+        if (!instance) {
+            LogError("gsapi", input_path, "Instância descartada, pool encolhe: " + init_error);
+        }
+    }
+    Release(std::move(instance));
+    return ok;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+// Só compilado com FP_HAVE_LIBGS (ver CMakeLists.txt).
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "src/pdf_compressor.h"
+
+// Pool de instâncias Ghostscript (libgs) já inicializadas com o device
+// pdfwrite. Cada requisição pega uma instância livre, troca o OutputFile,
+// executa o PDF de entrada e devolve a instância ao pool, evitando o custo
+// de criar processo e carregar fontes/recursos a cada PDF.
+//
+// Requer uma libgs com suporte a múltiplas instâncias (padrão desde 9.5x).
+class GhostscriptInstancePool final : public PdfCompressor {
+public:
+    // size <= 0 usa o número de núcleos.
+    static std::unique_ptr<GhostscriptInstancePool> Create(int size, std::string* error);
+    ~GhostscriptInstancePool() override;
+
+    bool Compress(const std::string& input_path, const std::string& output_path,
+                  const PdfCompressSettings& settings, std::string* error) override;
+    const char* Name() const override { return "gsapi"; }
+
+private:
+    struct Instance;
+
+    GhostscriptInstancePool() = default;
+
+    static std::unique_ptr<Instance> NewInstance(std::string* error);
+    // nullptr se o pool ficou sem instâncias.
+    std::unique_ptr<Instance> Acquire();
+    // instance nulo: a instância foi descartada e o pool encolhe.
+    void Release(std::unique_ptr<Instance> instance);
+
+    std::mutex mutex_;
+    std::condition_variable available_;
+    std::vector<std::unique_ptr<Instance>> idle_;
+    // Instâncias vivas (ociosas ou em uso).
+    int size_ = 0;
+};
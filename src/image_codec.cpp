@@ -0,0 +1,545 @@
+#include "src/image_codec.h"
+
+#include <algorithm>
+#include <cctype>
+#include <csetjmp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "src/flate.h"
+
+#ifdef FP_HAVE_LIBJPEG
+#include <jpeglib.h>
+#endif
+#ifdef FP_HAVE_LIBPNG
+#include <png.h>
+#endif
+
+namespace {
+
+// Limite de pixels de uma imagem decodificada (evita alocar gigabytes por
+// causa de um cabeçalho malicioso).
+constexpr size_t kMaxPixels = size_t{1} << 28;
+
+bool CheckDimensions(long width, long height, std::string* error) {
+    if (width <= 0 || height <= 0 || static_cast<size_t>(width) * static_cast<size_t>(height) > kMaxPixels) {
+        *error = "Dimensões de imagem inválidas: " + std::to_string(width) + "x" + std::to_string(height);
+        return false;
+    }
+    return true;
+}
+
+// Cópia de image sem o canal alfa (RGBA -> RGB); as outras voltam como estão.
+const Image& WithoutAlpha(const Image& image, Image* storage) {
+    if (image.channels != 4) {
+        return image;
+    }
+    storage->width = image.width;
+    storage->height = image.height;
+    storage->channels = 3;
+    storage->pixels.resize(static_cast<size_t>(image.width) * image.height * 3);
+    const uint8_t* src = image.pixels.data();
+    uint8_t* dst = storage->pixels.data();
+    for (size_t i = 0, n = static_cast<size_t>(image.width) * image.height; i < n; ++i, src += 4, dst += 3) {
+        dst[0] = src[0];
+        dst[1] = src[1];
+        dst[2] = src[2];
+    }
+    return *storage;
+}
+
+// --- PNM (P5 cinza, P6 RGB, maxval 255) -------------------------------------
+
+// Lê o próximo inteiro do cabeçalho PNM, pulando espaços e comentários.
+bool ReadPnmNumber(const std::string& data, size_t* pos, long* value) {
+    while (*pos < data.size()) {
+        char c = data[*pos];
+        if (c == '#') {
+            while (*pos < data.size() && data[*pos] != '\n') {
+                ++*pos;
+            }
+        } else if (std::isspace(static_cast<unsigned char>(c))) {
+            ++*pos;
+        } else {
+            break;
+        }
+    }
+    size_t start = *pos;
+    long result = 0;
+    while (*pos < data.size() && std::isdigit(static_cast<unsigned char>(data[*pos])) && result < 1000000) {
+        result = result * 10 + (data[*pos] - '0');
+        ++*pos;
+    }
+    *value = result;
+    return *pos > start;
+}
+
+// Lê o cabeçalho; *pos fica no último espaço antes dos pixels.
+bool ReadPnmHeader(const std::string& data, size_t* pos, long* width, long* height, long* maxval) {
+    *pos = 2;
+    return ReadPnmNumber(data, pos, width) && ReadPnmNumber(data, pos, height) && ReadPnmNumber(data, pos, maxval) &&
+           *pos < data.size();
+}
+
+bool DecodePnm(const std::string& data, Image* image, std::string* error) {
+    int channels = data[1] == '5' ? 1 : 3;
+    size_t pos = 0;
+    long width = 0, height = 0, maxval = 0;
+    if (!ReadPnmHeader(data, &pos, &width, &height, &maxval)) {
+        *error = "Cabeçalho PNM inválido";
+        return false;
+    }
+    if (maxval != 255) {
+        *error = "PNM com maxval " + std::to_string(maxval) + " não suportado";
+        return false;
+    }
+    if (!CheckDimensions(width, height, error)) {
+        return false;
+    }
+    ++pos;  // um único espaço separa o cabeçalho dos pixels
+    size_t size = static_cast<size_t>(width) * height * channels;
+    if (data.size() - pos < size) {
+        *error = "PNM truncado";
+        return false;
+    }
+    image->width = static_cast<int>(width);
+    image->height = static_cast<int>(height);
+    image->channels = channels;
+    image->pixels.assign(data.begin() + pos, data.begin() + pos + size);
+    return true;
+}
+
+void EncodePnm(const Image& image, std::string* out) {
+    Image rgb;
+    const Image& source = WithoutAlpha(image, &rgb);
+    *out = (source.channels == 1 ? "P5\n" : "P6\n") + std::to_string(source.width) + " " +
+           std::to_string(source.height) + "\n255\n";
+    out->append(reinterpret_cast<const char*>(source.pixels.data()), source.pixels.size());
+}
+
+// --- JPEG (libjpeg) -----------------------------------------------------------
+
+#ifdef FP_HAVE_LIBJPEG
+
+// Erros do libjpeg voltam por longjmp em vez de encerrar o processo.
+struct JpegErrorManager {
+    jpeg_error_mgr base;
+    std::jmp_buf jump;
+    char message[JMSG_LENGTH_MAX];
+};
+
+void JpegErrorExit(j_common_ptr info) {
+    JpegErrorManager* manager = reinterpret_cast<JpegErrorManager*>(info->err);
+    (*info->err->format_message)(info, manager->message);
+    std::longjmp(manager->jump, 1);
+}
+
+void JpegSilence(j_common_ptr, int) {}
+
+// Objetos com destrutor não podem ser criados depois do setjmp: image e out
+// são preenchidos só por ponteiro.
+bool DecodeJpeg(const std::string& data, const DecodeOptions& options, Image* image, std::string* error) {
+    jpeg_decompress_struct info;
+    JpegErrorManager manager;
+    info.err = jpeg_std_error(&manager.base);
+    manager.base.error_exit = JpegErrorExit;
+    manager.base.emit_message = JpegSilence;
+    if (setjmp(manager.jump)) {
+        jpeg_destroy_decompress(&info);
+        *error = std::string("JPEG inválido: ") + manager.message;
+        return false;
+    }
+    jpeg_create_decompress(&info);
+    jpeg_mem_src(&info, reinterpret_cast<const unsigned char*>(data.data()), data.size());
+    jpeg_read_header(&info, TRUE);
+    if (info.jpeg_color_space == JCS_CMYK || info.jpeg_color_space == JCS_YCCK) {
+        jpeg_destroy_decompress(&info);
+        *error = "JPEG CMYK não suportado";
+        return false;
+    }
+    info.out_color_space = info.jpeg_color_space == JCS_GRAYSCALE ? JCS_GRAYSCALE : JCS_RGB;
+    if (options.min_width > 0 || options.min_height > 0) {
+        // Da maior redução para a menor; sem nenhuma que sirva, 1/1.
+        for (unsigned denom : {8u, 4u, 2u, 1u}) {
+            info.scale_num = 1;
+            info.scale_denom = denom;
+            jpeg_calc_output_dimensions(&info);
+            if (info.output_width >= static_cast<JDIMENSION>(options.min_width) &&
+                info.output_height >= static_cast<JDIMENSION>(options.min_height)) {
+                break;
+            }
+        }
+    }
+    jpeg_start_decompress(&info);
+    if (!CheckDimensions(info.output_width, info.output_height, error)) {
+        jpeg_destroy_decompress(&info);
+        return false;
+    }
+    image->width = static_cast<int>(info.output_width);
+    image->height = static_cast<int>(info.output_height);
+    image->channels = info.output_components;
+    image->pixels.resize(image->stride() * image->height);
+    while (info.output_scanline < info.output_height) {
+        JSAMPROW row = image->row(static_cast<int>(info.output_scanline));
+        jpeg_read_scanlines(&info, &row, 1);
+    }
+    jpeg_finish_decompress(&info);
+    jpeg_destroy_decompress(&info);
+    return true;
+}
+
+bool ReadJpegSize(const std::string& data, int* width, int* height) {
+    jpeg_decompress_struct info;
+    JpegErrorManager manager;
+    info.err = jpeg_std_error(&manager.base);
+    manager.base.error_exit = JpegErrorExit;
+    manager.base.emit_message = JpegSilence;
+    if (setjmp(manager.jump)) {
+        jpeg_destroy_decompress(&info);
+        return false;
+    }
+    jpeg_create_decompress(&info);
+    jpeg_mem_src(&info, reinterpret_cast<const unsigned char*>(data.data()), data.size());
+    jpeg_read_header(&info, TRUE);
+    *width = static_cast<int>(info.image_width);
+    *height = static_cast<int>(info.image_height);
+    jpeg_destroy_decompress(&info);
+    return true;
+}
+
+bool EncodeJpegRows(const Image& image, int quality, unsigned char** buffer, unsigned long* size,
+                    std::string* error) {
+    jpeg_compress_struct info;
+    JpegErrorManager manager;
+    info.err = jpeg_std_error(&manager.base);
+    manager.base.error_exit = JpegErrorExit;
+    manager.base.emit_message = JpegSilence;
+    if (setjmp(manager.jump)) {
+        jpeg_destroy_compress(&info);
+        *error = std::string("Falha ao codificar JPEG: ") + manager.message;
+        return false;
+    }
+    jpeg_create_compress(&info);
+    jpeg_mem_dest(&info, buffer, size);
+    info.image_width = static_cast<JDIMENSION>(image.width);
+    info.image_height = static_cast<JDIMENSION>(image.height);
+    info.input_components = image.channels;
+    info.in_color_space = image.channels == 1 ? JCS_GRAYSCALE : JCS_RGB;
+    jpeg_set_defaults(&info);
+    jpeg_set_quality(&info, quality > 0 ? quality : 85, TRUE);
+    jpeg_start_compress(&info, TRUE);
+    while (info.next_scanline < info.image_height) {
+        JSAMPROW row = const_cast<JSAMPROW>(image.row(static_cast<int>(info.next_scanline)));
+        jpeg_write_scanlines(&info, &row, 1);
+    }
+    jpeg_finish_compress(&info);
+    jpeg_destroy_compress(&info);
+    return true;
+}
+
+bool EncodeJpeg(const Image& image, int quality, std::string* out, std::string* error) {
+    Image rgb;
+    const Image& source = WithoutAlpha(image, &rgb);
+    unsigned char* buffer = nullptr;
+    unsigned long size = 0;
+    bool ok = EncodeJpegRows(source, quality, &buffer, &size, error);
+    if (ok) {
+        out->assign(reinterpret_cast<const char*>(buffer), size);
+    }
+    std::free(buffer);
+    return ok;
+}
+
+#endif  // FP_HAVE_LIBJPEG
+
+// --- PNG (leitura pela API simplificada da libpng) ----------------------------
+
+#ifdef FP_HAVE_LIBPNG
+
+bool DecodePng(const std::string& data, Image* image, std::string* error) {
+    png_image png;
+    std::memset(&png, 0, sizeof(png));
+    png.version = PNG_IMAGE_VERSION;
+    if (!png_image_begin_read_from_memory(&png, data.data(), data.size())) {
+        *error = std::string("PNG inválido: ") + png.message;
+        return false;
+    }
+    if (!CheckDimensions(png.width, png.height, error)) {
+        png_image_free(&png);
+        return false;
+    }
+    // Cinza com alfa vira RGBA: o redimensionamento só trata 1, 3 ou 4 canais.
+    if (png.format & PNG_FORMAT_FLAG_ALPHA) {
+        png.format = PNG_FORMAT_RGBA;
+    } else {
+        png.format = (png.format & PNG_FORMAT_FLAG_COLOR) ? PNG_FORMAT_RGB : PNG_FORMAT_GRAY;
+    }
+    image->width = static_cast<int>(png.width);
+    image->height = static_cast<int>(png.height);
+    image->channels = static_cast<int>(PNG_IMAGE_PIXEL_CHANNELS(png.format));
+    image->pixels.resize(PNG_IMAGE_SIZE(png));
+    if (!png_image_finish_read(&png, nullptr, image->pixels.data(), 0, nullptr)) {
+        *error = std::string("PNG inválido: ") + png.message;
+        return false;
+    }
+    return true;
+}
+
+// Codificação própria: filtros de linha + Flate do flate.h (a libpng só
+// comprimiria com o zlib dela).
+
+// Bytes de IDAT por chunk.
+constexpr size_t kPngChunkBytes = 1 << 20;
+
+uint8_t Paeth(uint8_t left, uint8_t up, uint8_t up_left) {
+    const int estimate = left + up - up_left;
+    const int to_left = std::abs(estimate - left);
+    const int to_up = std::abs(estimate - up);
+    const int to_up_left = std::abs(estimate - up_left);
+    if (to_left <= to_up && to_left <= to_up_left) {
+        return left;
+    }
+    return to_up <= to_up_left ? up : up_left;
+}
+
+// Linha row com o filtro type (1-4) em out; prev é a linha anterior (zeros
+// na primeira) e bpp o número de bytes por pixel. Retorna a soma dos valores
+// absolutos como bytes com sinal, a heurística da libpng para escolher o
+// filtro.
+uint64_t FilterRow(int type, const uint8_t* row, const uint8_t* prev, size_t stride, int bpp, uint8_t* out) {
+    uint64_t cost = 0;
+    for (size_t i = 0; i < stride; ++i) {
+        const uint8_t left = i >= static_cast<size_t>(bpp) ? row[i - bpp] : 0;
+        const uint8_t up_left = i >= static_cast<size_t>(bpp) ? prev[i - bpp] : 0;
+        uint8_t predictor = 0;
+        switch (type) {
+        case 1:
+            predictor = left;
+            break;
+        case 2:
+            predictor = prev[i];
+            break;
+        case 3:
+            predictor = static_cast<uint8_t>((left + prev[i]) / 2);
+            break;
+        default:
+            predictor = Paeth(left, prev[i], up_left);
+            break;
+        }
+        out[i] = static_cast<uint8_t>(row[i] - predictor);
+        cost += static_cast<uint64_t>(std::abs(static_cast<int8_t>(out[i])));
+    }
+    return cost;
+}
+
+void AppendBigEndian32(uint32_t value, std::string* out) {
+    const char bytes[4] = {static_cast<char>(value >> 24), static_cast<char>(value >> 16),
+                           static_cast<char>(value >> 8), static_cast<char>(value)};
+    out->append(bytes, 4);
+}
+
+void AppendPngChunk(const char* type, const char* data, size_t size, std::string* out) {
+    AppendBigEndian32(static_cast<uint32_t>(size), out);
+    const size_t start = out->size();
+    out->append(type, 4);
+    out->append(data, size);
+    AppendBigEndian32(FlateCrc32(0, out->data() + start, size + 4), out);
+}
+
+bool EncodePng(const Image& image, int compression_level, std::string* out, std::string* error) {
+    const size_t stride = image.stride();
+    const int bpp = image.channels;
+    // Cada linha vira o byte do filtro seguido dos bytes filtrados; vale o
+    // filtro de menor custo (0 = nenhum).
+    std::string filtered((stride + 1) * static_cast<size_t>(image.height), '\0');
+    std::vector<uint8_t> zeros(stride, 0);
+    std::vector<uint8_t> candidate(stride);
+    for (int y = 0; y < image.height; ++y) {
+        const uint8_t* row = image.row(y);
+        const uint8_t* prev = y > 0 ? image.row(y - 1) : zeros.data();
+        uint8_t* dest = reinterpret_cast<uint8_t*>(&filtered[(stride + 1) * static_cast<size_t>(y)]);
+        std::memcpy(dest + 1, row, stride);
+        uint64_t best = 0;
+        for (size_t i = 0; i < stride; ++i) {
+            best += static_cast<uint64_t>(std::abs(static_cast<int8_t>(row[i])));
+        }
+        for (int type = 1; type <= 4; ++type) {
+            uint64_t cost = FilterRow(type, row, prev, stride, bpp, candidate.data());
+            if (cost < best) {
+                best = cost;
+                dest[0] = static_cast<uint8_t>(type);
+                std::memcpy(dest + 1, candidate.data(), stride);
+            }
+        }
+    }
+    std::string compressed;
+    if (!FlateCompress(filtered.data(), filtered.size(), compression_level, &compressed, error)) {
+        *error = "Falha ao codificar PNG: " + *error;
+        return false;
+    }
+    filtered = std::string();
+
+    std::string header;
+    AppendBigEndian32(static_cast<uint32_t>(image.width), &header);
+    AppendBigEndian32(static_cast<uint32_t>(image.height), &header);
+    // Profundidade 8; tipo de cor 0 (cinza), 2 (RGB) ou 6 (RGBA); compressão,
+    // filtro e entrelaçamento padrão.
+    const char color_type = image.channels == 4 ? 6 : image.channels == 3 ? 2 : 0;
+    header += {8, color_type, 0, 0, 0};
+
+    out->clear();
+    out->reserve(compressed.size() + compressed.size() / kPngChunkBytes * 12 + 64);
+    out->append("\x89PNG\r\n\x1A\n", 8);
+    AppendPngChunk("IHDR", header.data(), header.size(), out);
+    for (size_t pos = 0; pos < compressed.size(); pos += kPngChunkBytes) {
+        AppendPngChunk("IDAT", compressed.data() + pos, std::min(kPngChunkBytes, compressed.size() - pos), out);
+    }
+    AppendPngChunk("IEND", nullptr, 0, out);
+    return true;
+}
+
+#endif  // FP_HAVE_LIBPNG
+
+}  // namespace
+
+ImageFormat DetectImageFormat(const std::string& data) {
+    if (data.size() >= 3 && data[0] == 'P' && (data[1] == '5' || data[1] == '6') &&
+        std::isspace(static_cast<unsigned char>(data[2]))) {
+        return ImageFormat::kPnm;
+    }
+    if (data.size() >= 3 && data.compare(0, 3, "\xFF\xD8\xFF") == 0) {
+        return ImageFormat::kJpeg;
+    }
+    if (data.size() >= 8 && data.compare(0, 8, "\x89PNG\r\n\x1A\n", 8) == 0) {
+        return ImageFormat::kPng;
+    }
+    return ImageFormat::kUnknown;
+}
+
+const char* ImageFormatName(ImageFormat format) {
+    switch (format) {
+    case ImageFormat::kPnm:
+        return "pnm";
+    case ImageFormat::kJpeg:
+        return "jpeg";
+    case ImageFormat::kPng:
+        return "png";
+    case ImageFormat::kUnknown:
+        break;
+    }
+    return "desconhecido";
+}
+
+bool ImageFormatSupported(ImageFormat format) {
+    switch (format) {
+    case ImageFormat::kPnm:
+        return true;
+    case ImageFormat::kJpeg:
+#ifdef FP_HAVE_LIBJPEG
+        return true;
+#else
+        return false;
+#endif
+    case ImageFormat::kPng:
+#ifdef FP_HAVE_LIBPNG
+        return true;
+#else
+        return false;
+#endif
+    case ImageFormat::kUnknown:
+        break;
+    }
+    return false;
+}
+
+bool DecodeImage(const std::string& data, Image* image, std::string* error, const DecodeOptions& options) {
+    ImageFormat format = DetectImageFormat(data);
+    if (!ImageFormatSupported(format)) {
+        *error = std::string("Formato de imagem não suportado: ") + ImageFormatName(format);
+        return false;
+    }
+    switch (format) {
+    case ImageFormat::kPnm:
+        return DecodePnm(data, image, error);
+#ifdef FP_HAVE_LIBJPEG
+    case ImageFormat::kJpeg:
+        return DecodeJpeg(data, options, image, error);
+#endif
+#ifdef FP_HAVE_LIBPNG
+    case ImageFormat::kPng:
+        return DecodePng(data, image, error);
+#endif
+    default:
+        break;
+    }
+    *error = "Formato de imagem não suportado";
+    return false;
+}
+
+bool ReadImageSize(const std::string& data, int* width, int* height) {
+    switch (DetectImageFormat(data)) {
+    case ImageFormat::kPnm: {
+        size_t pos = 0;
+        long w = 0, h = 0, maxval = 0;
+        if (!ReadPnmHeader(data, &pos, &w, &h, &maxval) || w <= 0 || h <= 0) {
+            return false;
+        }
+        *width = static_cast<int>(w);
+        *height = static_cast<int>(h);
+        return true;
+    }
+#ifdef FP_HAVE_LIBJPEG
+    case ImageFormat::kJpeg:
+        return ReadJpegSize(data, width, height);
+#endif
+    case ImageFormat::kPng: {
+        // IHDR: largura e altura big-endian logo depois da assinatura e do
+        // cabeçalho do chunk.
+        if (data.size() < 24 || data.compare(12, 4, "IHDR") != 0) {
+            return false;
+        }
+        auto read32 = [&data](size_t offset) {
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(data.data()) + offset;
+            return (uint32_t{p[0]} << 24) | (uint32_t{p[1]} << 16) | (uint32_t{p[2]} << 8) | uint32_t{p[3]};
+        };
+        uint32_t w = read32(16), h = read32(20);
+        if (w == 0 || h == 0 || w > 0x7FFFFFFF || h > 0x7FFFFFFF) {
+            return false;
+        }
+        *width = static_cast<int>(w);
+        *height = static_cast<int>(h);
+        return true;
+    }
+    default:
+        break;
+    }
+    return false;
+}
+
+bool EncodeImage(const Image& image, ImageFormat format, const EncodeOptions& options, std::string* out,
+                 std::string* error) {
+    if (!ImageFormatSupported(format)) {
+        *error = std::string("Formato de imagem não suportado: ") + ImageFormatName(format);
+        return false;
+    }
+    switch (format) {
+    case ImageFormat::kPnm:
+        EncodePnm(image, out);
+        return true;
+#ifdef FP_HAVE_LIBJPEG
+    case ImageFormat::kJpeg:
+        return EncodeJpeg(image, options.quality, out, error);
+#endif
+#ifdef FP_HAVE_LIBPNG
+    case ImageFormat::kPng:
+        return EncodePng(image, options.compression_level, out, error);
+#endif
+    default:
+        break;
+    }
+    (void)options;
+    *error = "Formato de imagem não suportado";
+    return false;
+}
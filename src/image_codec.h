@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Imagem decodificada: pixels de 8 bits intercalados, linha a linha, sem
+// preenchimento (stride = width * channels).
+struct Image {
+    int width = 0;
+    int height = 0;
+    // 1 (cinza), 3 (RGB) ou 4 (RGBA, alfa não pré-multiplicado).
+    int channels = 0;
+    std::vector<uint8_t> pixels;
+
+    size_t stride() const { return static_cast<size_t>(width) * channels; }
+    uint8_t* row(int y) { return pixels.data() + static_cast<size_t>(y) * stride(); }
+    const uint8_t* row(int y) const { return pixels.data() + static_cast<size_t>(y) * stride(); }
+};
+
+enum class ImageFormat { kUnknown, kPnm, kJpeg, kPng };
+
+// Formato pela assinatura dos primeiros bytes (kUnknown se não reconhecido).
+ImageFormat DetectImageFormat(const std::string& data);
+const char* ImageFormatName(ImageFormat format);
+// true se o servidor foi compilado com o codec de format (PNM sempre; JPEG e
+// PNG com libjpeg/libpng, ver CMakeLists.txt).
+bool ImageFormatSupported(ImageFormat format);
+
+struct DecodeOptions {
+    // JPEG: decodifica já reduzido pela escala do DCT (1/8, 1/4 ou 1/2, a
+    // menor que ainda deixe a imagem com pelo menos min_width x min_height),
+    // o que corta o tempo e a memória da decodificação em até 64 vezes.
+    // 0 = tamanho original. Os outros formatos ignoram.
+    int min_width = 0;
+    int min_height = 0;
+};
+
+// Decodifica data (PNM binário P5/P6, JPEG ou PNG). Retorna false e preenche
+// error se o formato não é suportado ou os dados estão corrompidos.
+bool DecodeImage(const std::string& data, Image* image, std::string* error,
+                 const DecodeOptions& options = DecodeOptions());
+
+// Dimensões originais de data lendo só o cabeçalho. Retorna false se o
+// formato não é suportado ou o cabeçalho é inválido.
+bool ReadImageSize(const std::string& data, int* width, int* height);
+
+struct EncodeOptions {
+    // JPEG: qualidade 1-100 (0 = padrão).
+    int quality = 0;
+    // PNG: nível do Flate do IDAT, 1-12 (0 = padrão; ver flate.h).
+    int compression_level = 0;
+};
+
+// Codifica image em format. PNM e JPEG descartam o alfa.
+bool EncodeImage(const Image& image, ImageFormat format, const EncodeOptions& options, std::string* out,
+                 std::string* error);
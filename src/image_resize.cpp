@@ -0,0 +1,467 @@
+#include "src/image_resize.h"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define FP_RESIZE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Limite de pixels do destino (o mesmo dos decodificadores).
+constexpr size_t kMaxPixels = size_t{1} << 28;
+
+// Faixas menores que isso não compensam a thread extra.
+constexpr int kMinBandRows = 32;
+constexpr size_t kMinParallelPixels = 256 * 256;
+
+double FilterSupport(ResizeFilter filter) {
+    switch (filter) {
+    case ResizeFilter::kBox:
+        return 0.5;
+    case ResizeFilter::kBilinear:
+        return 1.0;
+    case ResizeFilter::kLanczos3:
+        return 3.0;
+    }
+    return 1.0;
+}
+
+double FilterWeight(ResizeFilter filter, double x) {
+    switch (filter) {
+    case ResizeFilter::kBox:
+        return x > -0.5 && x <= 0.5 ? 1.0 : 0.0;
+    case ResizeFilter::kBilinear:
+        x = std::fabs(x);
+        return x < 1.0 ? 1.0 - x : 0.0;
+    case ResizeFilter::kLanczos3:
+        x = std::fabs(x);
+        if (x < 1e-8) {
+            return 1.0;
+        }
+        if (x >= 3.0) {
+            return 0.0;
+        }
+        return 3.0 * std::sin(kPi * x) * std::sin(kPi * x / 3.0) / (kPi * kPi * x * x);
+    }
+    return 0.0;
+}
+
+// Pesos de um eixo: a saída i é a soma de weights[i * taps + k] vezes a
+// entrada start[i] + k, para k < count[i]. Os pesos depois de count[i] são
+// zero.
+struct Contributions {
+    int taps = 0;
+    std::vector<int> start;
+    std::vector<int> count;
+    std::vector<float> weights;
+};
+
+// even_count arredonda count para par (o kernel AVX2 horizontal consome as
+// entradas de duas em duas; a linha de origem tem preenchimento para isso).
+Contributions ComputeContributions(int in_size, int out_size, ResizeFilter filter, bool even_count) {
+    double scale = static_cast<double>(in_size) / out_size;
+    double filter_scale = std::max(scale, 1.0);
+    double support = FilterSupport(filter) * filter_scale;
+
+    Contributions c;
+    c.taps = static_cast<int>(std::ceil(support)) * 2 + 2;
+    c.start.resize(out_size);
+    c.count.resize(out_size);
+    c.weights.assign(static_cast<size_t>(out_size) * c.taps, 0.0f);
+    std::vector<double> weights(c.taps);
+    for (int i = 0; i < out_size; ++i) {
+        double center = (i + 0.5) * scale;
+        int left = std::max(static_cast<int>(center - support + 0.5), 0);
+        int right = std::min(static_cast<int>(center + support + 0.5), in_size);
+        int count = std::min(std::max(right - left, 1), c.taps);
+        double total = 0;
+        for (int k = 0; k < count; ++k) {
+            weights[k] = FilterWeight(filter, (left + k - center + 0.5) / filter_scale);
+            total += weights[k];
+        }
+        for (int k = 0; k < count; ++k) {
+            c.weights[static_cast<size_t>(i) * c.taps + k] =
+                static_cast<float>(total != 0 ? weights[k] / total : (k == 0 ? 1.0 : 0.0));
+        }
+        c.start[i] = left;
+        c.count[i] = even_count ? std::min(count + (count & 1), c.taps) : count;
+    }
+    return c;
+}
+
+// --- Conversão uint8 <-> float em 4 canais -----------------------------------
+
+// Cinza e RGB ocupam os primeiros canais; RGBA tem a cor pré-multiplicada pelo
+// alfa, para que pixels transparentes não "sangrem" para os vizinhos.
+void LoadRow(const uint8_t* src, int width, int channels, float* dst) {
+    switch (channels) {
+    case 1:
+        for (int x = 0; x < width; ++x, dst += 4) {
+            dst[0] = src[x];
+            dst[1] = dst[2] = dst[3] = 0.0f;
+        }
+        break;
+    case 3:
+        for (int x = 0; x < width; ++x, src += 3, dst += 4) {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            dst[3] = 0.0f;
+        }
+        break;
+    default:
+        for (int x = 0; x < width; ++x, src += 4, dst += 4) {
+            float alpha = src[3] * (1.0f / 255.0f);
+            dst[0] = src[0] * alpha;
+            dst[1] = src[1] * alpha;
+            dst[2] = src[2] * alpha;
+            dst[3] = src[3];
+        }
+        break;
+    }
+}
+
+uint8_t ToByte(float value) {
+    return static_cast<uint8_t>(std::min(std::max(value + 0.5f, 0.0f), 255.0f));
+}
+
+void StoreRow(const float* src, int width, int channels, uint8_t* dst) {
+    switch (channels) {
+    case 1:
+        for (int x = 0; x < width; ++x, src += 4) {
+            dst[x] = ToByte(src[0]);
+        }
+        break;
+    case 3:
+        for (int x = 0; x < width; ++x, src += 4, dst += 3) {
+            dst[0] = ToByte(src[0]);
+            dst[1] = ToByte(src[1]);
+            dst[2] = ToByte(src[2]);
+        }
+        break;
+    default:
+        for (int x = 0; x < width; ++x, src += 4, dst += 4) {
+            // Divide pelo alfa ainda em float: arredondado, um alfa de 1 ou 2
+            // amplificaria o erro da cor em até 255 vezes.
+            uint8_t alpha = ToByte(src[3]);
+            float unpremultiply = alpha > 0 ? 255.0f / src[3] : 0.0f;
+            dst[0] = ToByte(src[0] * unpremultiply);
+            dst[1] = ToByte(src[1] * unpremultiply);
+            dst[2] = ToByte(src[2] * unpremultiply);
+            dst[3] = alpha;
+        }
+        break;
+    }
+}
+
+// --- Kernels -------------------------------------------------------------------
+
+// Filtra uma linha (pixels float de 4 canais, com preenchimento de taps
+// pixels zerados no fim) na horizontal: out_width pixels em dst.
+using HorizontalKernel = void (*)(const float* src, const Contributions& c, int out_width, float* dst);
+// dst[i] = soma de weights[k] * rows[k][i], k < count, i < n (n múltiplo de 4).
+using VerticalKernel = void (*)(const float* const* rows, const float* weights, int count, float* dst, int n);
+
+void HorizontalScalar(const float* src, const Contributions& c, int out_width, float* dst) {
+    for (int x = 0; x < out_width; ++x, dst += 4) {
+        const float* w = &c.weights[static_cast<size_t>(x) * c.taps];
+        const float* p = src + static_cast<size_t>(c.start[x]) * 4;
+        float acc[4] = {0, 0, 0, 0};
+        for (int k = 0; k < c.count[x]; ++k, p += 4) {
+            for (int ch = 0; ch < 4; ++ch) {
+                acc[ch] += w[k] * p[ch];
+            }
+        }
+        std::memcpy(dst, acc, sizeof(acc));
+    }
+}
+
+void VerticalScalar(const float* const* rows, const float* weights, int count, float* dst, int n) {
+    std::fill(dst, dst + n, 0.0f);
+    for (int k = 0; k < count; ++k) {
+        const float* row = rows[k];
+        float w = weights[k];
+        for (int i = 0; i < n; ++i) {
+            dst[i] += w * row[i];
+        }
+    }
+}
+
+#ifdef FP_RESIZE_X86
+
+// Um pixel inteiro por registrador de 128 bits.
+__attribute__((target("sse4.1"))) void HorizontalSse41(const float* src, const Contributions& c, int out_width,
+                                                        float* dst) {
+    for (int x = 0; x < out_width; ++x) {
+        const float* w = &c.weights[static_cast<size_t>(x) * c.taps];
+        const float* p = src + static_cast<size_t>(c.start[x]) * 4;
+        __m128 acc = _mm_setzero_ps();
+        for (int k = 0; k < c.count[x]; ++k) {
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(w[k]), _mm_loadu_ps(p + 4 * k)));
+        }
+        _mm_storeu_ps(dst + 4 * x, acc);
+    }
+}
+
+__attribute__((target("sse4.1"))) void VerticalSse41(const float* const* rows, const float* weights, int count,
+                                                      float* dst, int n) {
+    for (int i = 0; i < n; i += 4) {
+        __m128 acc = _mm_setzero_ps();
+        for (int k = 0; k < count; ++k) {
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(rows[k] + i)));
+        }
+        _mm_storeu_ps(dst + i, acc);
+    }
+}
+
+// Dois pixels de origem vizinhos por registrador de 256 bits, cada metade com
+// o seu peso; as metades são somadas no fim.
+__attribute__((target("avx2,fma"))) void HorizontalAvx2(const float* src, const Contributions& c, int out_width,
+                                                         float* dst) {
+    for (int x = 0; x < out_width; ++x) {
+        const float* w = &c.weights[static_cast<size_t>(x) * c.taps];
+        const float* p = src + static_cast<size_t>(c.start[x]) * 4;
+        __m256 acc = _mm256_setzero_ps();
+        for (int k = 0; k < c.count[x]; k += 2) {
+            __m256 weight = _mm256_set_m128(_mm_set1_ps(w[k + 1]), _mm_set1_ps(w[k]));
+            acc = _mm256_fmadd_ps(weight, _mm256_loadu_ps(p + 4 * k), acc);
+        }
+        _mm_storeu_ps(dst + 4 * x, _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1)));
+    }
+}
+
+__attribute__((target("avx2,fma"))) void VerticalAvx2(const float* const* rows, const float* weights, int count,
+                                                       float* dst, int n) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 acc = _mm256_setzero_ps();
+        for (int k = 0; k < count; ++k) {
+            acc = _mm256_fmadd_ps(_mm256_set1_ps(weights[k]), _mm256_loadu_ps(rows[k] + i), acc);
+        }
+        _mm256_storeu_ps(dst + i, acc);
+    }
+    if (i < n) {
+        __m128 acc = _mm_setzero_ps();
+        for (int k = 0; k < count; ++k) {
+            acc = _mm_fmadd_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(rows[k] + i), acc);
+        }
+        _mm_storeu_ps(dst + i, acc);
+    }
+}
+
+#endif  // FP_RESIZE_X86
+
+struct Kernels {
+    HorizontalKernel horizontal;
+    VerticalKernel vertical;
+};
+
+Kernels KernelsFor(ResizeIsa isa) {
+#ifdef FP_RESIZE_X86
+    switch (isa) {
+    case ResizeIsa::kAvx2:
+        return {HorizontalAvx2, VerticalAvx2};
+    case ResizeIsa::kSse41:
+        return {HorizontalSse41, VerticalSse41};
+    default:
+        break;
+    }
+#else
+    (void)isa;
+#endif
+    return {HorizontalScalar, VerticalScalar};
+}
+
+// --- Faixas --------------------------------------------------------------------
+
+struct ResizeJob {
+    const Image* src;
+    Image* dst;
+    Contributions horizontal;
+    Contributions vertical;
+    Kernels kernels;
+};
+
+// Linhas [y0, y1) do destino. As linhas de origem filtradas na horizontal
+// ficam num anel de vertical.taps posições: as janelas de saídas seguidas
+// avançam sem voltar, então cada linha de origem é filtrada uma vez por faixa.
+void ResizeBand(const ResizeJob& job, int y0, int y1) {
+    const Image& src = *job.src;
+    Image* dst = job.dst;
+    const Contributions& v = job.vertical;
+    const size_t row_floats = static_cast<size_t>(dst->width) * 4;
+
+    std::vector<float> line((static_cast<size_t>(src.width) + job.horizontal.taps) * 4, 0.0f);
+    std::vector<float> ring(row_floats * v.taps);
+    std::vector<const float*> rows(v.taps);
+    std::vector<float> out(row_floats);
+
+    int next = 0;
+    for (int y = y0; y < y1; ++y) {
+        int start = v.start[y];
+        int end = start + v.count[y];
+        next = std::max(next, start);
+        for (; next < end; ++next) {
+            LoadRow(src.row(next), src.width, src.channels, line.data());
+            job.kernels.horizontal(line.data(), job.horizontal, dst->width, &ring[(next % v.taps) * row_floats]);
+        }
+        for (int k = 0; k < v.count[y]; ++k) {
+            rows[k] = &ring[((start + k) % v.taps) * row_floats];
+        }
+        job.kernels.vertical(rows.data(), &v.weights[static_cast<size_t>(y) * v.taps], v.count[y], out.data(),
+                             static_cast<int>(row_floats));
+        StoreRow(out.data(), dst->width, dst->channels, dst->row(y));
+    }
+}
+
+// Conta as faixas que faltam e acorda a chamadora quando todas terminam.
+class BandLatch {
+public:
+    explicit BandLatch(int pending) : pending_(pending) {}
+
+    void Done() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--pending_ == 0) {
+            done_.notify_all();
+        }
+    }
+
+    void Wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return pending_ == 0; });
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable done_;
+    int pending_;
+};
+
+}  // namespace
+
+const char* ResizeFilterName(ResizeFilter filter) {
+    switch (filter) {
+    case ResizeFilter::kBox:
+        return "box";
+    case ResizeFilter::kBilinear:
+        return "bilinear";
+    case ResizeFilter::kLanczos3:
+        return "lanczos3";
+    }
+    return "?";
+}
+
+bool ParseResizeFilter(const std::string& name, ResizeFilter* filter) {
+    for (ResizeFilter candidate : {ResizeFilter::kBox, ResizeFilter::kBilinear, ResizeFilter::kLanczos3}) {
+        if (name == ResizeFilterName(candidate)) {
+            *filter = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* ResizeIsaName(ResizeIsa isa) {
+    switch (isa) {
+    case ResizeIsa::kAuto:
+        return "auto";
+    case ResizeIsa::kScalar:
+        return "scalar";
+    case ResizeIsa::kSse41:
+        return "sse4.1";
+    case ResizeIsa::kAvx2:
+        return "avx2";
+    }
+    return "?";
+}
+
+ResizeIsa DetectResizeIsa() {
+#ifdef FP_RESIZE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return ResizeIsa::kAvx2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return ResizeIsa::kSse41;
+    }
+#endif
+    return ResizeIsa::kScalar;
+}
+
+void FitWithin(int src_width, int src_height, int box_width, int box_height, int* width, int* height) {
+    double scale = std::min(static_cast<double>(box_width) / src_width, static_cast<double>(box_height) / src_height);
+    *width = std::max(1, static_cast<int>(std::lround(src_width * scale)));
+    *height = std::max(1, static_cast<int>(std::lround(src_height * scale)));
+}
+
+ImageResizer::ImageResizer(const Options& options)
+    : filter_(options.filter),
+      // Um conjunto pedido que a CPU não tem cai para o melhor disponível.
+      isa_(options.isa == ResizeIsa::kAuto || options.isa > DetectResizeIsa() ? DetectResizeIsa() : options.isa),
+      threads_(options.threads > 0 ? options.threads
+                                   : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))) {
+    if (threads_ > 1) {
+        pool_ = std::make_unique<ThreadPool>(static_cast<size_t>(threads_ - 1), 0);
+    }
+}
+
+bool ImageResizer::Resize(const Image& src, int width, int height, Image* dst, std::string* error) const {
+    if (src.channels != 1 && src.channels != 3 && src.channels != 4) {
+        *error = "Imagem com " + std::to_string(src.channels) + " canais não suportada";
+        return false;
+    }
+    if (src.width <= 0 || src.height <= 0 || src.pixels.size() < src.stride() * src.height) {
+        *error = "Imagem de origem inválida";
+        return false;
+    }
+    if (width <= 0 || height <= 0 || static_cast<size_t>(width) * static_cast<size_t>(height) > kMaxPixels) {
+        *error = "Dimensões de destino inválidas: " + std::to_string(width) + "x" + std::to_string(height);
+        return false;
+    }
+    dst->width = width;
+    dst->height = height;
+    dst->channels = src.channels;
+    if (width == src.width && height == src.height) {
+        dst->pixels = src.pixels;
+        return true;
+    }
+    dst->pixels.resize(dst->stride() * height);
+
+    ResizeJob job;
+    job.src = &src;
+    job.dst = dst;
+    job.horizontal = ComputeContributions(src.width, width, filter_, isa_ == ResizeIsa::kAvx2);
+    job.vertical = ComputeContributions(src.height, height, filter_, false);
+    job.kernels = KernelsFor(isa_);
+
+    int bands = 1;
+    if (pool_ && static_cast<size_t>(width) * height >= kMinParallelPixels) {
+        bands = std::max(1, std::min(threads_, height / kMinBandRows));
+    }
+    BandLatch latch(bands - 1);
+    for (int band = 1; band < bands; ++band) {
+        int y0 = static_cast<int>(static_cast<int64_t>(height) * band / bands);
+        int y1 = static_cast<int>(static_cast<int64_t>(height) * (band + 1) / bands);
+        bool queued = pool_->TrySubmit([&job, &latch, y0, y1] {
+            ResizeBand(job, y0, y1);
+            latch.Done();
+        });
+        if (!queued) {
+            ResizeBand(job, y0, y1);
+            latch.Done();
+        }
+    }
+    ResizeBand(job, 0, static_cast<int>(static_cast<int64_t>(height) / bands));
+    latch.Wait();
+    return true;
+}
@@ -0,0 +1,119 @@
+#include "src/job_cost.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Peso de cada nova observação na média móvel.
+constexpr double kAlpha = 0.1;
+
+// Amostras de uma faixa antes de a mediana valer.
+constexpr uint32_t kMinSamples = 8;
+
+// Faixa i do histograma de durações: [1 ms * 2^(i/2), 1 ms * 2^((i+1)/2)).
+constexpr double kFirstBucketSeconds = 0.001;
+
+size_t DurationBucket(double seconds, size_t buckets) {
+    if (seconds < kFirstBucketSeconds) {
+        return 0;
+    }
+    size_t bucket = static_cast<size_t>(2 * std::log2(seconds / kFirstBucketSeconds));
+    return std::min(bucket, buckets - 1);
+}
+
+double BucketLowerBound(size_t bucket) {
+    return bucket == 0 ? 0 : kFirstBucketSeconds * std::exp2(bucket / 2.0);
+}
+
+// Vazões iniciais (bytes/s) até haver observações: gs é o mais lento.
+double InitialBytesPerSecond(Rpc rpc) {
+    switch (rpc) {
+    case Rpc::kCompressPDF:
+        return 20e6;
+    case Rpc::kConvertToTXT:
+        return 100e6;
+    case Rpc::kConvertImageFormat:
+    case Rpc::kResizeImage:
+        return 50e6;
+    case Rpc::kCount:
+        break;
+    }
+    return 20e6;
+}
+
+void UpdateAverage(std::atomic<double>* average, double sample) {
+    double current = average->load(std::memory_order_relaxed);
+    double next;
+    do {
+        next = current + kAlpha * (sample - current);
+    } while (!average->compare_exchange_weak(current, next, std::memory_order_relaxed));
+}
+
+}  // namespace
+
+JobCostModel::JobCostModel() {
+    for (size_t i = 0; i < kRpcs; ++i) {
+        seconds_per_byte_[i] = 1.0 / InitialBytesPerSecond(static_cast<Rpc>(i));
+        average_bytes_[i] = static_cast<double>(kMinBytes);
+    }
+}
+
+double JobCostModel::EstimateSeconds(Rpc rpc, size_t input_bytes) const {
+    size_t i = static_cast<size_t>(rpc);
+    double bytes = input_bytes > 0 ? static_cast<double>(input_bytes)
+                                   : average_bytes_[i].load(std::memory_order_relaxed);
+    return std::max(bytes, static_cast<double>(kMinBytes)) * seconds_per_byte_[i].load(std::memory_order_relaxed);
+}
+
+void JobCostModel::Observe(Rpc rpc, size_t input_bytes, double seconds) {
+    if (input_bytes == 0 || seconds <= 0) {
+        return;
+    }
+    size_t i = static_cast<size_t>(rpc);
+    double bytes = std::max(static_cast<double>(input_bytes), static_cast<double>(kMinBytes));
+    UpdateAverage(&seconds_per_byte_[i], seconds / bytes);
+    UpdateAverage(&average_bytes_[i], static_cast<double>(input_bytes));
+
+    std::lock_guard<std::mutex> lock(history_mutex_);
+    History& history = history_[i][SizeClass(rpc, input_bytes)];
+    if (history.total >= kHistoryWindow) {
+        history.total = 0;
+        for (uint32_t& count : history.counts) {
+            count /= 2;
+            history.total += count;
+        }
+    }
+    ++history.counts[DurationBucket(seconds, kDurationBuckets)];
+    ++history.total;
+}
+
+size_t JobCostModel::SizeClass(Rpc rpc, size_t input_bytes) const {
+    double bytes = input_bytes > 0 ? static_cast<double>(input_bytes)
+                                   : average_bytes_[static_cast<size_t>(rpc)].load(std::memory_order_relaxed);
+    size_t size_class = 0;
+    for (double limit = kMinBytes; bytes > limit && size_class + 1 < kSizeClasses; limit *= 4) {
+        ++size_class;
+    }
+    return size_class;
+}
+
+double JobCostModel::MedianSeconds(Rpc rpc, size_t input_bytes) const {
+    std::lock_guard<std::mutex> lock(history_mutex_);
+    const History& history = history_[static_cast<size_t>(rpc)][SizeClass(rpc, input_bytes)];
+    if (history.total < kMinSamples) {
+        return 0;
+    }
+    uint32_t seen = 0;
+    for (size_t bucket = 0; bucket < kDurationBuckets; ++bucket) {
+        seen += history.counts[bucket];
+        if (2 * seen >= history.total) {
+            return BucketLowerBound(bucket);
+        }
+    }
+    return 0;
+}
+
+double JobCostModel::SecondsPerByte(Rpc rpc) const {
+    return seconds_per_byte_[static_cast<size_t>(rpc)].load(std::memory_order_relaxed);
+}
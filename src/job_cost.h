@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "src/metrics.h"
+
+// Estimativa do tempo de execução de uma conversão a partir da RPC e do
+// tamanho da entrada, usada para ordenar as filas (menor job primeiro).
+//
+// O modelo é linear no tamanho: segundos = max(bytes, kMinBytes) * s/byte,
+// com s/byte por RPC começando num valor típico e ajustado por média móvel
+// exponencial a cada execução observada. Entradas de tamanho desconhecido
+// (modo pipeline) usam a média dos tamanhos já vistos.
+//
+// Para decidir se um deadline ainda é alcançável há também a mediana
+// histórica da duração por RPC e faixa de tamanho (potências de 4 a partir de
+// kMinBytes), num histograma logarítmico que é reduzido à metade a cada
+// kHistoryWindow amostras para acompanhar mudanças de carga.
+//
+// EstimateSeconds e Observe da média são lock-free; o histograma tem mutex.
+class JobCostModel {
+public:
+    // Abaixo disso o custo fixo (processo, cabeçalhos) domina.
+    static constexpr size_t kMinBytes = 64 * 1024;
+
+    JobCostModel();
+
+    // input_bytes 0 = desconhecido.
+    double EstimateSeconds(Rpc rpc, size_t input_bytes) const;
+    // Execução concluída de input_bytes (> 0) em seconds.
+    void Observe(Rpc rpc, size_t input_bytes, double seconds);
+
+    double SecondsPerByte(Rpc rpc) const;
+
+    // Mediana (limite inferior da faixa do histograma) das durações
+    // observadas para rpc com entrada do tamanho de input_bytes (0 =
+    // desconhecido). 0 se ainda não há amostras suficientes.
+    double MedianSeconds(Rpc rpc, size_t input_bytes) const;
+
+private:
+    static constexpr size_t kRpcs = static_cast<size_t>(Rpc::kCount);
+    static constexpr size_t kSizeClasses = 10;
+    // Faixas de duração de 1 ms com razão sqrt(2): até ~17 min.
+    static constexpr size_t kDurationBuckets = 40;
+    static constexpr uint32_t kHistoryWindow = 1024;
+
+    struct History {
+        std::array<uint32_t, kDurationBuckets> counts{};
+        uint32_t total = 0;
+    };
+
+    size_t SizeClass(Rpc rpc, size_t input_bytes) const;
+
+    std::array<std::atomic<double>, kRpcs> seconds_per_byte_;
+    std::array<std::atomic<double>, kRpcs> average_bytes_;
+
+    mutable std::mutex history_mutex_;
+    std::array<std::array<History, kSizeClasses>, kRpcs> history_;
+};
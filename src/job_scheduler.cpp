@@ -0,0 +1,349 @@
+#include "src/job_scheduler.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace {
+
+// Memória típica de uma execução (gs com um PDF grande, imagem
+// decodificada...) e execuções por núcleo de cada RPC.
+struct RpcCost {
+    size_t memory_bytes;
+    int per_core;
+};
+
+RpcCost CostOf(Rpc rpc) {
+    switch (rpc) {
+    case Rpc::kCompressPDF:
+        return {256u << 20, 1};
+    case Rpc::kConvertToTXT:
+        return {64u << 20, 2};
+    case Rpc::kConvertImageFormat:
+    case Rpc::kResizeImage:
+        return {128u << 20, 1};
+    case Rpc::kCount:
+        break;
+    }
+    return {256u << 20, 1};
+}
+
+size_t PhysicalMemory() {
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long page_size = sysconf(_SC_PAGE_SIZE);
+    if (pages <= 0 || page_size <= 0) {
+        return 0;
+    }
+    return static_cast<size_t>(pages) * static_cast<size_t>(page_size);
+}
+
+grpc::Status Expired(Rpc rpc) {
+    return grpc::Status(grpc::StatusCode::DEADLINE_EXCEEDED,
+                        std::string("Deadline insuficiente para ") + RpcName(rpc) + ": requisição descartada");
+}
+
+grpc::Status QueueFull(Rpc rpc) {
+    return grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED,
+                        std::string("Servidor sobrecarregado: fila de ") + RpcName(rpc) + " cheia");
+}
+
+grpc::Status Cancelled() { return grpc::Status(grpc::StatusCode::CANCELLED, "Requisição cancelada"); }
+
+}  // namespace
+
+std::chrono::steady_clock::time_point SteadyDeadline(std::chrono::system_clock::time_point deadline) {
+    if (deadline == std::chrono::system_clock::time_point::max()) {
+        return std::chrono::steady_clock::time_point::max();
+    }
+    auto remaining = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        deadline - std::chrono::system_clock::now());
+    return std::chrono::steady_clock::now() + remaining;
+}
+
+JobScheduler::Slot& JobScheduler::Slot::operator=(Slot&& other) noexcept {
+    if (this != &other) {
+        Release();
+        scheduler_ = std::exchange(other.scheduler_, nullptr);
+        job_ = other.job_;
+        large_ = other.large_;
+        start_ = other.start_;
+    }
+    return *this;
+}
+
+void JobScheduler::Slot::Release() {
+    if (scheduler_ != nullptr) {
+        scheduler_->Release(*this);
+        scheduler_ = nullptr;
+        start_ = std::chrono::steady_clock::time_point();
+    }
+}
+
+JobScheduler::JobScheduler(const Options& options)
+    : max_queued_(options.max_queued), large_job_seconds_(options.large_job_seconds) {
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    size_t budget = options.memory_budget_bytes > 0 ? options.memory_budget_bytes : PhysicalMemory() / 2;
+    for (size_t i = 0; i < kRpcs; ++i) {
+        limits_[i] = options.limits[i] > 0 ? options.limits[i] : DefaultLimit(static_cast<Rpc>(i), cores, budget);
+        // Com uma vaga só não há o que reservar.
+        int reserved = limits_[i] >= 2 ? std::max(1, limits_[i] / 4) : 0;
+        large_limits_[i] = limits_[i] - reserved;
+    }
+}
+
+JobScheduler::~JobScheduler() {
+    for (Lane& lane : lanes_) {
+        for (Waiter* waiter : lane.waiters) {
+            if (waiter->on_grant) {
+                delete waiter;
+            }
+        }
+    }
+}
+
+int JobScheduler::DefaultLimit(Rpc rpc, unsigned cores, size_t memory_budget) {
+    RpcCost cost = CostOf(rpc);
+    size_t limit = static_cast<size_t>(cores) * cost.per_core;
+    if (memory_budget > 0) {
+        limit = std::min(limit, memory_budget / cost.memory_bytes);
+    }
+    return static_cast<int>(std::max<size_t>(1, limit));
+}
+
+std::chrono::steady_clock::time_point JobScheduler::Due(const JobInfo& job, double estimated_seconds,
+                                                       std::chrono::steady_clock::time_point enqueued) {
+    auto aging = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(kAgingFactor * estimated_seconds));
+    return std::min(enqueued + aging, job.deadline);
+}
+
+bool JobScheduler::Doomed(const JobInfo& job, std::chrono::steady_clock::time_point now) const {
+    if (job.deadline == std::chrono::steady_clock::time_point::max()) {
+        return false;
+    }
+    double remaining = std::chrono::duration<double>(job.deadline - now).count();
+    return remaining <= 0 || remaining < costs_.MedianSeconds(job.rpc, job.input_bytes);
+}
+
+grpc::Status JobScheduler::Acquire(const JobInfo& job, const std::function<bool()>& is_cancelled, Slot* slot) {
+    StageTimer wait(job.rpc, Stage::kAdmission);
+    auto now = std::chrono::steady_clock::now();
+    double cost = EstimateSeconds(job);
+    Waiter waiter;
+    waiter.job = job;
+    waiter.large = IsLarge(cost);
+    waiter.enqueued = now;
+    waiter.due = Due(job, cost, now);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    Lane& lane = lanes_[Index(job.rpc)];
+    if (Doomed(job, now)) {
+        ++lane.expired;
+        return Expired(job.rpc);
+    }
+    auto position = lane.waiters.insert(lane.waiters.end(), &waiter);
+    std::vector<Waiter*> done;
+    DispatchLocked(job.rpc, &done);
+    bool full = waiter.outcome == Waiter::Outcome::kWaiting && lane.waiters.size() > max_queued_;
+    if (full) {
+        lane.waiters.erase(position);
+        ++lane.rejected;
+    }
+    if (!done.empty()) {
+        // Esperas de AcquireAsync que saíram da fila junto.
+        lock.unlock();
+        Complete(done);
+        lock.lock();
+    }
+    if (full) {
+        return QueueFull(job.rpc);
+    }
+    // Quem libera a vaga a entrega direto (kGranted) ao escolhido.
+    while (waiter.outcome == Waiter::Outcome::kWaiting) {
+        if (is_cancelled && is_cancelled()) {
+            lane.waiters.erase(position);
+            ++lane.abandoned;
+            return Cancelled();
+        }
+        if (Doomed(job, std::chrono::steady_clock::now())) {
+            lane.waiters.erase(position);
+            ++lane.expired;
+            return Expired(job.rpc);
+        }
+        waiter.cv.wait_for(lock, kCancelPollInterval);
+    }
+    if (waiter.outcome == Waiter::Outcome::kExpired) {
+        // DispatchLocked já o tirou da fila.
+        return Expired(job.rpc);
+    }
+    slot->scheduler_ = this;
+    slot->job_ = job;
+    slot->large_ = waiter.large;
+    return grpc::Status::OK;
+}
+
+void JobScheduler::AcquireAsync(const JobInfo& job, std::function<bool()> is_cancelled, GrantCallback on_grant) {
+    auto now = std::chrono::steady_clock::now();
+    double cost = EstimateSeconds(job);
+    auto waiter = std::make_unique<Waiter>();
+    waiter->job = job;
+    waiter->large = IsLarge(cost);
+    waiter->enqueued = now;
+    waiter->due = Due(job, cost, now);
+    waiter->is_cancelled = std::move(is_cancelled);
+    waiter->on_grant = std::move(on_grant);
+
+    std::vector<Waiter*> done;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Lane& lane = lanes_[Index(job.rpc)];
+        Waiter* queued = waiter.release();
+        if (Doomed(job, now)) {
+            ++lane.expired;
+            queued->outcome = Waiter::Outcome::kExpired;
+            done.push_back(queued);
+        } else {
+            auto position = lane.waiters.insert(lane.waiters.end(), queued);
+            DispatchLocked(job.rpc, &done);
+            if (queued->outcome == Waiter::Outcome::kWaiting && lane.waiters.size() > max_queued_) {
+                lane.waiters.erase(position);
+                ++lane.rejected;
+                queued->outcome = Waiter::Outcome::kRejected;
+                done.push_back(queued);
+            }
+        }
+    }
+    Complete(done);
+}
+
+void JobScheduler::Sweep() {
+    std::vector<Waiter*> done;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < kRpcs; ++i) {
+            DispatchLocked(static_cast<Rpc>(i), &done);
+        }
+    }
+    Complete(done);
+}
+
+void JobScheduler::DispatchLocked(Rpc rpc, std::vector<Waiter*>* done) {
+    Lane& lane = lanes_[Index(rpc)];
+    auto now = std::chrono::steady_clock::now();
+    // Tira waiter da fila com o resultado dado e avisa quem espera por ele.
+    auto finish = [done](Waiter* waiter, Waiter::Outcome outcome) {
+        waiter->outcome = outcome;
+        if (waiter->on_grant) {
+            done->push_back(waiter);
+        } else {
+            waiter->cv.notify_one();
+        }
+    };
+    for (auto it = lane.waiters.begin(); it != lane.waiters.end();) {
+        Waiter* waiter = *it;
+        if (Doomed(waiter->job, now)) {
+            it = lane.waiters.erase(it);
+            ++lane.expired;
+            finish(waiter, Waiter::Outcome::kExpired);
+        } else if (waiter->on_grant && waiter->is_cancelled && waiter->is_cancelled()) {
+            it = lane.waiters.erase(it);
+            ++lane.abandoned;
+            finish(waiter, Waiter::Outcome::kCancelled);
+        } else {
+            ++it;
+        }
+    }
+    while (lane.running < limits_[Index(rpc)]) {
+        bool large_allowed = lane.running_large < large_limits_[Index(rpc)];
+        auto best = lane.waiters.end();
+        for (auto it = lane.waiters.begin(); it != lane.waiters.end(); ++it) {
+            if ((*it)->large && !large_allowed) {
+                continue;
+            }
+            // Empate: o mais antigo (primeiro na lista).
+            if (best == lane.waiters.end() || (*it)->due < (*best)->due) {
+                best = it;
+            }
+        }
+        if (best == lane.waiters.end()) {
+            return;
+        }
+        Waiter* chosen = *best;
+        lane.waiters.erase(best);
+        ++lane.running;
+        if (chosen->large) {
+            ++lane.running_large;
+        }
+        ++lane.admitted;
+        finish(chosen, Waiter::Outcome::kGranted);
+    }
+}
+
+void JobScheduler::Complete(const std::vector<Waiter*>& done) {
+    auto now = std::chrono::steady_clock::now();
+    for (Waiter* waiter : done) {
+        std::unique_ptr<Waiter> owned(waiter);
+        Rpc rpc = waiter->job.rpc;
+        GlobalMetrics().RecordStage(rpc, Stage::kAdmission, now - waiter->enqueued);
+        Slot slot;
+        grpc::Status status;
+        switch (waiter->outcome) {
+        case Waiter::Outcome::kGranted:
+            slot.scheduler_ = this;
+            slot.job_ = waiter->job;
+            slot.large_ = waiter->large;
+            break;
+        case Waiter::Outcome::kExpired:
+            status = Expired(rpc);
+            break;
+        case Waiter::Outcome::kCancelled:
+            status = Cancelled();
+            break;
+        case Waiter::Outcome::kRejected:
+        case Waiter::Outcome::kWaiting:
+            status = QueueFull(rpc);
+            break;
+        }
+        waiter->on_grant(status, std::move(slot));
+    }
+}
+
+void JobScheduler::Release(const Slot& slot) {
+    if (slot.start_ != std::chrono::steady_clock::time_point()) {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - slot.start_).count();
+        costs_.Observe(slot.job_.rpc, slot.job_.input_bytes, seconds);
+    }
+
+    std::vector<Waiter*> done;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Lane& lane = lanes_[Index(slot.job_.rpc)];
+        --lane.running;
+        if (slot.large_) {
+            --lane.running_large;
+        }
+        DispatchLocked(slot.job_.rpc, &done);
+    }
+    Complete(done);
+}
+
+SchedulerStats JobScheduler::stats() const {
+    SchedulerStats stats;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < kRpcs; ++i) {
+        const Lane& lane = lanes_[i];
+        stats.limits[i] = limits_[i];
+        stats.running[i] = lane.running;
+        stats.running_large[i] = lane.running_large;
+        stats.queued[i] = lane.waiters.size();
+        stats.admitted[i] = lane.admitted;
+        stats.rejected[i] = lane.rejected;
+        stats.abandoned[i] = lane.abandoned;
+        stats.expired[i] = lane.expired;
+        stats.seconds_per_byte[i] = costs_.SecondsPerByte(static_cast<Rpc>(i));
+    }
+    return stats;
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <grpcpp/grpcpp.h>
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "src/job_cost.h"
+#include "src/metrics.h"
+
+// Contadores do escalonador por RPC (índice = Rpc).
+struct SchedulerStats {
+    static constexpr size_t kRpcs = static_cast<size_t>(Rpc::kCount);
+
+    std::array<int, kRpcs> limits{};
+    std::array<int, kRpcs> running{};
+    std::array<int, kRpcs> running_large{};
+    std::array<size_t, kRpcs> queued{};
+    std::array<uint64_t, kRpcs> admitted{};
+    std::array<uint64_t, kRpcs> rejected{};   // fila cheia
+    std::array<uint64_t, kRpcs> abandoned{};  // cancelados enquanto esperavam
+    std::array<uint64_t, kRpcs> expired{};    // deadline inalcançável
+    std::array<double, kRpcs> seconds_per_byte{};
+};
+
+// O que o escalonador sabe de uma requisição antes de executá-la.
+struct JobInfo {
+    Rpc rpc = Rpc::kCompressPDF;
+    // Tamanho da entrada (0 = desconhecido, ex: modo pipeline).
+    size_t input_bytes = 0;
+    // Deadline do cliente (time_point::max() = sem deadline).
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+};
+
+// Converte o deadline de uma chamada gRPC (ServerContext::deadline()) para o
+// relógio monotônico; system_clock::time_point::max() vira "sem deadline".
+std::chrono::steady_clock::time_point SteadyDeadline(std::chrono::system_clock::time_point deadline);
+
+// Controle de admissão na frente das conversões.
+//
+// Cada RPC tem um limite de execuções simultâneas; o que passa disso espera
+// numa fila limitada, e com a fila cheia a requisição é recusada na hora com
+// RESOURCE_EXHAUSTED. Assim uma rajada de CompressPDF não dispara centenas de
+// gs disputando CPU e memória: a vazão fica no patamar dos limites e o
+// excesso é recusado cedo, em vez de tudo ficar lento.
+//
+// A fila é ordenada por prazo, o mais cedo primeiro (EDF). O prazo de uma
+// requisição é o deadline do cliente; sem deadline, é um prazo virtual de
+// chegada + kAgingFactor × custo estimado (JobCostModel), ou seja, o menor
+// job primeiro com envelhecimento — um job grande ganha prioridade conforme
+// espera e não fica parado para sempre atrás de pequenos. Quem tem deadline
+// usa o menor dos dois. Além disso, jobs estimados em large_job_seconds ou
+// mais não ocupam todas as vagas: um quarto delas (ao menos uma, se o limite
+// for 2 ou mais) fica para os pequenos, que assim nunca esperam só porque há
+// PDFs enormes rodando.
+//
+// Requisições que não podem mais terminar a tempo — o que resta até o
+// deadline é menor que a mediana histórica da duração para a RPC e o tamanho
+// — são recusadas com DEADLINE_EXCEEDED, na chegada ou enquanto esperam, em
+// vez de ocupar uma vaga com um gs cujo resultado ninguém vai receber.
+//
+// Os limites padrão saem do número de núcleos e de um orçamento de memória
+// dividido pela memória típica de uma execução de cada RPC (ver
+// DefaultLimit). Thread-safe.
+class JobScheduler {
+public:
+    static constexpr size_t kRpcs = SchedulerStats::kRpcs;
+    // Sem deadline, quantas vezes o próprio custo estimado um job espera
+    // antes de passar à frente de um recém-chegado de custo zero.
+    static constexpr double kAgingFactor = 4.0;
+
+    struct Options {
+        // Execuções simultâneas por RPC (0 = derivar de núcleos e memória).
+        std::array<int, kRpcs> limits{};
+        // Requisições esperando vaga, por RPC.
+        size_t max_queued = 64;
+        // Orçamento de memória das conversões (0 = metade da RAM).
+        size_t memory_budget_bytes = 0;
+        // Custo estimado a partir do qual um job é "grande" (0 = sem
+        // reserva de vagas para os pequenos).
+        double large_job_seconds = 2.0;
+    };
+
+    // Vaga de execução; liberada no destrutor (ou em Release), quando passa
+    // para o próximo da fila. O tempo entre Start e a liberação alimenta o
+    // JobCostModel (uma vaga liberada sem Start, ex: acerto de cache, não).
+    class Slot {
+    public:
+        Slot() = default;
+        ~Slot() { Release(); }
+
+        Slot(const Slot&) = delete;
+        Slot& operator=(const Slot&) = delete;
+        Slot(Slot&& other) noexcept { *this = std::move(other); }
+        Slot& operator=(Slot&& other) noexcept;
+
+        // A execução começa agora.
+        void Start() { start_ = std::chrono::steady_clock::now(); }
+        void Release();
+
+        bool held() const { return scheduler_ != nullptr; }
+        // Ocupa uma das vagas de jobs grandes.
+        bool large() const { return large_; }
+
+    private:
+        friend class JobScheduler;
+
+        JobScheduler* scheduler_ = nullptr;
+        JobInfo job_;
+        bool large_ = false;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    // Resultado de AcquireAsync: o status e, com OK, a vaga ocupada.
+    using GrantCallback = std::function<void(grpc::Status status, Slot slot)>;
+
+    // Intervalo em que as esperas conferem cancelamento e deadline (ver
+    // Acquire e Sweep).
+    static constexpr std::chrono::milliseconds kCancelPollInterval{50};
+
+    explicit JobScheduler(const Options& options);
+    // Esperas de AcquireAsync ainda na fila são descartadas sem aviso.
+    ~JobScheduler();
+
+    JobScheduler(const JobScheduler&) = delete;
+    JobScheduler& operator=(const JobScheduler&) = delete;
+
+    // Espera uma vaga para job. Retorna OK com slot ocupado, RESOURCE_EXHAUSTED
+    // se a fila da RPC está cheia, DEADLINE_EXCEEDED se o deadline de job não
+    // dá mais para a execução, ou CANCELLED se is_cancelled (opcional) passar
+    // a retornar true durante a espera. O tempo de espera entra na etapa
+    // admission. slot deve estar vazio.
+    grpc::Status Acquire(const JobInfo& job, const std::function<bool()>& is_cancelled, Slot* slot);
+
+    // Acquire sem bloquear, para o servidor assíncrono: a requisição espera
+    // na fila do escalonador e não numa thread. on_grant é chamado uma única
+    // vez, com os mesmos status de Acquire: na hora se a vaga (ou a recusa) é
+    // imediata, senão na thread que libera uma vaga ou chama Sweep, sem o
+    // lock do escalonador. Deve ser rápido (repassar a vaga a um executor).
+    // is_cancelled (opcional) é consultado com o lock e deve ser barato.
+    void AcquireAsync(const JobInfo& job, std::function<bool()> is_cancelled, GrantCallback on_grant);
+
+    // Retira das filas as esperas de AcquireAsync canceladas ou sem tempo
+    // para terminar. Quem usa AcquireAsync chama a cada kCancelPollInterval;
+    // sem isso elas só saem quando alguma vaga da RPC é liberada.
+    void Sweep();
+
+    // Custo estimado de job, em segundos.
+    double EstimateSeconds(const JobInfo& job) const { return costs_.EstimateSeconds(job.rpc, job.input_bytes); }
+    // Prazo de um job com esse custo estimado que chegou em enqueued (ver
+    // acima); a ordem das filas é a do menor prazo.
+    static std::chrono::steady_clock::time_point Due(const JobInfo& job, double estimated_seconds,
+                                                     std::chrono::steady_clock::time_point enqueued);
+    // true se job não tem mais como terminar antes do deadline.
+    bool Doomed(const JobInfo& job, std::chrono::steady_clock::time_point now) const;
+    // true se um job com esse custo estimado é "grande".
+    bool IsLarge(double estimated_seconds) const {
+        return large_job_seconds_ > 0 && estimated_seconds >= large_job_seconds_;
+    }
+
+    int limit(Rpc rpc) const { return limits_[Index(rpc)]; }
+    SchedulerStats stats() const;
+
+    // Limite derivado para rpc com cores núcleos e memory_budget bytes.
+    static int DefaultLimit(Rpc rpc, unsigned cores, size_t memory_budget);
+
+private:
+    struct Waiter {
+        enum class Outcome { kWaiting, kGranted, kExpired, kCancelled, kRejected };
+
+        std::condition_variable cv;
+        JobInfo job;
+        bool large = false;
+        std::chrono::steady_clock::time_point enqueued;
+        std::chrono::steady_clock::time_point due;
+        // Definido por DispatchLocked ao retirá-lo da fila.
+        Outcome outcome = Outcome::kWaiting;
+        // Só nas esperas de AcquireAsync, que DispatchLocked devolve em vez
+        // de notificar cv.
+        std::function<bool()> is_cancelled;
+        GrantCallback on_grant;
+    };
+
+    struct Lane {
+        int running = 0;
+        int running_large = 0;
+        std::list<Waiter*> waiters;
+        uint64_t admitted = 0;
+        uint64_t rejected = 0;
+        uint64_t abandoned = 0;
+        uint64_t expired = 0;
+    };
+
+    static size_t Index(Rpc rpc) { return static_cast<size_t>(rpc); }
+    // Descarta os waiters de rpc sem tempo para terminar (e os de
+    // AcquireAsync cancelados) e entrega as vagas livres aos de menor prazo
+    // entre os elegíveis. Os de AcquireAsync que saíram da fila vão para
+    // done, para Complete depois de soltar o lock.
+    void DispatchLocked(Rpc rpc, std::vector<Waiter*>* done);
+    // Chama on_grant de cada waiter de AcquireAsync e os apaga.
+    void Complete(const std::vector<Waiter*>& done);
+    void Release(const Slot& slot);
+
+    std::array<int, kRpcs> limits_{};
+    // Vagas que jobs grandes podem ocupar ao mesmo tempo, por RPC.
+    std::array<int, kRpcs> large_limits_{};
+    const size_t max_queued_;
+    const double large_job_seconds_;
+    JobCostModel costs_;
+
+    mutable std::mutex mutex_;
+    std::array<Lane, kRpcs> lanes_;
+};
@@ -0,0 +1,425 @@
+#include "src/logging.h"
+
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Texto máximo de um registro; mensagens maiores são truncadas com "...".
+constexpr size_t kMaxRecordText = 480;
+// Atraso máximo entre o log e a escrita quando o ring não enche.
+constexpr auto kFlushInterval = std::chrono::milliseconds(20);
+// Lotes maiores que isso são gravados sem esperar o fim da drenagem.
+constexpr size_t kBatchBytes = 64 * 1024;
+
+struct LogRecord {
+    int64_t time_ns;
+    LogLevel level;
+    uint32_t length;
+    char text[kMaxRecordText];
+};
+
+int64_t NowNanos() {
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+const char* LevelTag(LogLevel level) {
+    switch (level) {
+        case LogLevel::kInfo:
+            return "[INFO]";
+        case LogLevel::kSuccess:
+            return "[SUCCESS]";
+        case LogLevel::kError:
+            return "[ERROR]";
+    }
+    return "[?]";
+}
+
+// Monta "[NIVEL][method] filename: message" em out, truncando em capacity.
+size_t FormatRecord(LogLevel level, const std::string& method, const std::string& filename,
+                    const std::string& message, char* out, size_t capacity) {
+    size_t length = 0;
+    bool truncated = false;
+    auto append = [&](const char* data, size_t size) {
+        size_t n = std::min(size, capacity - length);
+        std::memcpy(out + length, data, n);
+        length += n;
+        truncated = truncated || n < size;
+    };
+    const char* tag = LevelTag(level);
+    append(tag, std::strlen(tag));
+    append("[", 1);
+    append(method.data(), method.size());
+    append("] ", 2);
+    append(filename.data(), filename.size());
+    append(": ", 2);
+    append(message.data(), message.size());
+    if (truncated) {
+        std::memcpy(out + capacity - 3, "...", 3);
+    }
+    return length;
+}
+
+void WriteAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;  // sem ter onde reportar
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+}
+
+size_t RoundUpPowerOfTwo(size_t n) {
+    size_t power = 1;
+    while (power < n) {
+        power <<= 1;
+    }
+    return power;
+}
+
+// Ring single-producer/single-consumer de uma thread: só a dona escreve
+// (tail_), só a thread de escrita consome (head_).
+class LogRing {
+public:
+    explicit LogRing(size_t capacity) : mask_(capacity - 1), records_(new LogRecord[capacity]) {}
+
+    // Produtor: slot livre (publicado com Commit) ou nullptr se cheio.
+    // used recebe a ocupação atual.
+    LogRecord* TryReserve(size_t* used) {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        *used = static_cast<size_t>(tail - head_.load(std::memory_order_acquire));
+        if (*used > mask_) {
+            return nullptr;
+        }
+        return &records_[tail & mask_];
+    }
+
+    void Commit() { tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // Consumidor: visita os registros publicados e libera os slots.
+    template <typename Visit>
+    size_t Drain(Visit visit) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        uint64_t tail = tail_.load(std::memory_order_acquire);
+        for (uint64_t i = head; i != tail; ++i) {
+            visit(records_[i & mask_]);
+        }
+        head_.store(tail, std::memory_order_release);
+        return static_cast<size_t>(tail - head);
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    std::atomic<uint64_t> dropped{0};
+    // A thread dona terminou; o ring sai do registro quando esvaziar.
+    std::atomic<bool> closed{false};
+
+private:
+    const uint64_t mask_;
+    std::unique_ptr<LogRecord[]> records_;
+    alignas(64) std::atomic<uint64_t> head_{0};
+    alignas(64) std::atomic<uint64_t> tail_{0};
+};
+
+struct ThreadRingHolder {
+    std::shared_ptr<LogRing> ring;
+    ~ThreadRingHolder() {
+        if (ring) {
+            ring->closed.store(true, std::memory_order_release);
+        }
+    }
+};
+
+thread_local ThreadRingHolder t_ring;
+
+class AsyncLogger {
+public:
+    explicit AsyncLogger(const LoggerOptions& options)
+        : ring_capacity_(RoundUpPowerOfTwo(std::max<size_t>(options.ring_capacity, 2))),
+          overflow_(options.overflow) {
+        if (!options.file_path.empty()) {
+            file_fd_ = ::open(options.file_path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+            if (file_fd_ < 0) {
+                std::string error = "Falha ao abrir arquivo de log " + options.file_path + ": " +
+                                    std::strerror(errno) + "\n";
+                WriteAll(STDERR_FILENO, error.data(), error.size());
+            }
+        }
+        writer_ = std::thread([this] { WriterLoop(); });
+    }
+
+    void Log(LogLevel level, const std::string& method, const std::string& filename, const std::string& message) {
+        if (stopped_.load(std::memory_order_acquire)) {
+            WriteSync(level, method, filename, message);
+            return;
+        }
+        LogRing* ring = ThreadRing();
+        size_t used = 0;
+        LogRecord* record = ring->TryReserve(&used);
+        if (record == nullptr) {
+            // Erros nunca são descartados; no modo kBlock nada é.
+            if (overflow_ == LogOverflow::kDrop && level != LogLevel::kError) {
+                ring->dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            while ((record = ring->TryReserve(&used)) == nullptr) {
+                if (stopped_.load(std::memory_order_acquire)) {
+                    WriteSync(level, method, filename, message);
+                    return;
+                }
+                Wake();
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+        record->time_ns = NowNanos();
+        record->level = level;
+        record->length = static_cast<uint32_t>(
+            FormatRecord(level, method, filename, message, record->text, kMaxRecordText));
+        ring->Commit();
+        // Acorda a escrita antes de o ring encher; fora disso ela acorda sozinha.
+        if (used + 1 == ring_capacity_ - ring_capacity_ / 4) {
+            Wake();
+        }
+    }
+
+    void Shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                return;
+            }
+            stopping_ = true;
+            wake_ = true;
+        }
+        wake_cv_.notify_one();
+        writer_.join();
+        stopped_.store(true, std::memory_order_release);
+        // Pega o que chegou entre a última drenagem e stopped_.
+        std::lock_guard<std::mutex> lock(sync_mutex_);
+        while (DrainAll() > 0) {
+        }
+    }
+
+    uint64_t dropped() const { return dropped_total_.load(std::memory_order_relaxed); }
+
+private:
+    LogRing* ThreadRing() {
+        if (!t_ring.ring) {
+            t_ring.ring = std::make_shared<LogRing>(ring_capacity_);
+            std::lock_guard<std::mutex> lock(mutex_);
+            rings_.push_back(t_ring.ring);
+            rings_version_.fetch_add(1, std::memory_order_release);
+        }
+        return t_ring.ring.get();
+    }
+
+    void Wake() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            wake_ = true;
+        }
+        wake_cv_.notify_one();
+    }
+
+    void WriterLoop() {
+        while (true) {
+            size_t drained = DrainAll();
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (stopping_ && drained == 0) {
+                return;
+            }
+            if (drained == 0) {
+                wake_cv_.wait_for(lock, kFlushInterval, [this] { return wake_ || stopping_; });
+            }
+            wake_ = false;
+        }
+    }
+
+    // Drena todos os rings e grava os lotes. Só a thread de escrita chama
+    // (ou Shutdown, depois do join).
+    size_t DrainAll() {
+        uint64_t version = rings_version_.load(std::memory_order_acquire);
+        bool prune = false;
+        if (version != snapshot_version_) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            snapshot_ = rings_;
+            snapshot_version_ = rings_version_.load(std::memory_order_relaxed);
+        }
+
+        size_t drained = 0;
+        uint64_t dropped = 0;
+        for (const std::shared_ptr<LogRing>& ring : snapshot_) {
+            drained += ring->Drain([this](const LogRecord& record) { AppendRecord(record); });
+            dropped += ring->dropped.exchange(0, std::memory_order_relaxed);
+            prune = prune || ring->closed.load(std::memory_order_acquire);
+        }
+        if (dropped > 0) {
+            dropped_total_.fetch_add(dropped, std::memory_order_relaxed);
+            char text[96];
+            int length = std::snprintf(text, sizeof(text), "[LOG] %llu mensagens descartadas (buffer de log cheio)",
+                                       static_cast<unsigned long long>(dropped));
+            AppendLine(LogLevel::kError, NowNanos(), text, static_cast<size_t>(length));
+        }
+        FlushBatches();
+
+        if (prune) {
+            PruneClosedRings();
+        }
+        return drained;
+    }
+
+    void PruneClosedRings() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                    [](const std::shared_ptr<LogRing>& ring) {
+                                        return ring->closed.load(std::memory_order_acquire) && ring->empty();
+                                    }),
+                     rings_.end());
+        rings_version_.fetch_add(1, std::memory_order_release);
+    }
+
+    void AppendRecord(const LogRecord& record) { AppendLine(record.level, record.time_ns, record.text, record.length); }
+
+    void AppendLine(LogLevel level, int64_t time_ns, const char* text, size_t length) {
+        std::string& batch = level == LogLevel::kError ? err_batch_ : out_batch_;
+        size_t start = batch.size();
+        AppendTimestamp(&batch, time_ns);
+        batch.append(text, length);
+        batch.push_back('\n');
+        if (file_fd_ >= 0) {
+            file_batch_.append(batch, start, std::string::npos);
+        }
+        if (batch.size() >= kBatchBytes || file_batch_.size() >= kBatchBytes) {
+            FlushBatches();
+        }
+    }
+
+    // "AAAA-MM-DD HH:MM:SS.mmm "; a parte até os segundos é reaproveitada.
+    void AppendTimestamp(std::string* out, int64_t time_ns) {
+        int64_t second = time_ns / 1000000000;
+        if (second != cached_second_) {
+            time_t t = static_cast<time_t>(second);
+            tm local;
+            localtime_r(&t, &local);
+            cached_time_length_ = std::strftime(cached_time_, sizeof(cached_time_), "%Y-%m-%d %H:%M:%S", &local);
+            cached_second_ = second;
+        }
+        out->append(cached_time_, cached_time_length_);
+        int millis = static_cast<int>(time_ns / 1000000 % 1000);
+        char suffix[6] = {'.', static_cast<char>('0' + millis / 100), static_cast<char>('0' + millis / 10 % 10),
+                          static_cast<char>('0' + millis % 10), ' ', '\0'};
+        out->append(suffix, 5);
+    }
+
+    void FlushBatches() {
+        if (!out_batch_.empty()) {
+            WriteAll(STDOUT_FILENO, out_batch_.data(), out_batch_.size());
+            out_batch_.clear();
+        }
+        if (!err_batch_.empty()) {
+            WriteAll(STDERR_FILENO, err_batch_.data(), err_batch_.size());
+            err_batch_.clear();
+        }
+        if (!file_batch_.empty()) {
+            WriteAll(file_fd_, file_batch_.data(), file_batch_.size());
+            file_batch_.clear();
+        }
+    }
+
+    // Caminho depois do Shutdown: grava direto, sem ring.
+    void WriteSync(LogLevel level, const std::string& method, const std::string& filename,
+                   const std::string& message) {
+        char text[kMaxRecordText];
+        size_t length = FormatRecord(level, method, filename, message, text, sizeof(text));
+        std::lock_guard<std::mutex> lock(sync_mutex_);
+        AppendLine(level, NowNanos(), text, length);
+        FlushBatches();
+    }
+
+    const size_t ring_capacity_;
+    const LogOverflow overflow_;
+    int file_fd_ = -1;
+
+    // Protege o registro de rings e a sinalização da thread de escrita; os
+    // produtores só o tomam ao registrar a thread ou para acordar a escrita.
+    std::mutex mutex_;
+    std::condition_variable wake_cv_;
+    bool wake_ = false;
+    bool stopping_ = false;
+    std::vector<std::shared_ptr<LogRing>> rings_;
+    std::atomic<uint64_t> rings_version_{0};
+    std::atomic<bool> stopped_{false};
+    std::atomic<uint64_t> dropped_total_{0};
+
+    // Estado da thread de escrita; depois do Shutdown, protegido por sync_mutex_.
+    std::mutex sync_mutex_;
+    std::vector<std::shared_ptr<LogRing>> snapshot_;
+    uint64_t snapshot_version_ = 0;
+    std::string out_batch_;
+    std::string err_batch_;
+    std::string file_batch_;
+    int64_t cached_second_ = -1;
+    char cached_time_[32] = {};
+    size_t cached_time_length_ = 0;
+
+    std::thread writer_;
+};
+
+LoggerOptions& PendingOptions() {
+    static LoggerOptions options;
+    return options;
+}
+
+// Nunca destruído: logs disparados por destrutores estáticos continuam
+// funcionando (pelo caminho síncrono, depois do Shutdown via atexit).
+AsyncLogger* Logger() {
+    static AsyncLogger* logger = [] {
+        auto* instance = new AsyncLogger(PendingOptions());
+        std::atexit(ShutdownLogging);
+        return instance;
+    }();
+    return logger;
+}
+
+}  // namespace
+
+void InitLogging(const LoggerOptions& options) {
+    PendingOptions() = options;
+    Logger();
+}
+
+void ShutdownLogging() {
+    Logger()->Shutdown();
+}
+
+uint64_t LogMessagesDropped() {
+    return Logger()->dropped();
+}
+
+void LogEvent(LogLevel level, const std::string& method, const std::string& filename,
+              const std::string& message) {
+    Logger()->Log(level, method, filename, message);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Logging assíncrono.
+//
+// Cada thread escreve em um ring buffer próprio (single-producer, sem
+// locks); uma thread de escrita drena todos os rings, formata o timestamp
+// (cacheado por segundo) e grava em lote com write(2). O handler nunca
+// disputa o lock de std::cout/std::cerr nem espera o flush.
+
+enum class LogLevel {
+    kInfo,
+    kSuccess,
+    kError,
+};
+
+// O que fazer quando o ring da thread está cheio.
+enum class LogOverflow {
+    kDrop,   // INFO/SUCCESS são descartados e contados; ERROR espera
+    kBlock,  // toda mensagem espera espaço no ring (backpressure)
+};
+
+struct LoggerOptions {
+    // Registros por thread (arredondado para potência de 2).
+    size_t ring_capacity = 256;
+    LogOverflow overflow = LogOverflow::kDrop;
+    // Além do console, grava também neste arquivo (vazio = só console).
+    std::string file_path;
+};
+
+// Configura o logger. Deve ser chamada antes do primeiro log; depois disso
+// não tem efeito. Sem ela, valem as opções padrão.
+void InitLogging(const LoggerOptions& options);
+
+// Drena o que estiver pendente e encerra a thread de escrita. Logs
+// posteriores são gravados de forma síncrona. Registrada com atexit.
+void ShutdownLogging();
+
+// Mensagens descartadas por ring cheio desde o início.
+uint64_t LogMessagesDropped();
+
+void LogEvent(LogLevel level, const std::string& method, const std::string& filename,
+              const std::string& message);
+
+// Funções auxiliares para logging
+inline void LogSuccess(const std::string& method, const std::string& filename, const std::string& message) {
+    LogEvent(LogLevel::kSuccess, method, filename, message);
+}
+
+inline void LogError(const std::string& method, const std::string& filename, const std::string& message) {
+    LogEvent(LogLevel::kError, method, filename, message);
+}
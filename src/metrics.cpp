@@ -0,0 +1,358 @@
+#include "src/metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+#include "src/abort_stats.h"
+#include "src/file_operations.h"
+#include "src/job_scheduler.h"
+#include "src/logging.h"
+
+namespace {
+
+const char* const kRpcNames[] = {"CompressPDF", "ConvertToTXT", "ConvertImageFormat", "ResizeImage"};
+const char* const kStageNames[] = {"receive", "queue_wait", "admission", "execute", "send", "cleanup", "total"};
+const char* const kStatusNames[] = {
+    "OK",        "CANCELLED",      "UNKNOWN",           "INVALID_ARGUMENT",   "DEADLINE_EXCEEDED",
+    "NOT_FOUND", "ALREADY_EXISTS", "PERMISSION_DENIED", "RESOURCE_EXHAUSTED", "FAILED_PRECONDITION",
+    "ABORTED",   "OUT_OF_RANGE",   "UNIMPLEMENTED",     "INTERNAL",           "UNAVAILABLE",
+    "DATA_LOSS", "UNAUTHENTICATED",
+};
+
+// Fronteiras (em segundos) do histograma Prometheus derivado dos baldes HDR.
+const double kPrometheusBuckets[] = {0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25,
+                                     0.5,   1,      2.5,   5,    10,    30,   60};
+const double kQuantiles[] = {0.5, 0.9, 0.99, 0.999};
+
+void AppendFormat(std::string* out, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+void AppendFormat(std::string* out, const char* format, ...) {
+    char line[256];
+    va_list args;
+    va_start(args, format);
+    int length = std::vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (length > 0) {
+        out->append(line, std::min(static_cast<size_t>(length), sizeof(line) - 1));
+    }
+}
+
+void AppendHeader(std::string* out, const char* name, const char* type, const char* help) {
+    AppendFormat(out, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+unsigned long long ToULL(uint64_t value) {
+    return static_cast<unsigned long long>(value);
+}
+
+}  // namespace
+
+const char* RpcName(Rpc rpc) {
+    return kRpcNames[static_cast<size_t>(rpc)];
+}
+
+Rpc RpcFromMethod(const char* method) {
+    for (size_t i = 0; i < static_cast<size_t>(Rpc::kCount); ++i) {
+        if (std::strcmp(method, kRpcNames[i]) == 0) {
+            return static_cast<Rpc>(i);
+        }
+    }
+    return Rpc::kCompressPDF;
+}
+
+const char* StageName(Stage stage) {
+    return kStageNames[static_cast<size_t>(stage)];
+}
+
+const char* StatusCodeName(grpc::StatusCode code) {
+    size_t index = static_cast<size_t>(code);
+    return index < sizeof(kStatusNames) / sizeof(kStatusNames[0]) ? kStatusNames[index] : "UNKNOWN";
+}
+
+int LatencyHistogram::BucketIndex(uint64_t micros) {
+    if (micros < static_cast<uint64_t>(kSubBuckets)) {
+        return static_cast<int>(micros);
+    }
+    int exponent = 63 - __builtin_clzll(micros);
+    if (exponent >= kMaxExponent) {
+        return kBuckets - 1;
+    }
+    int sub = static_cast<int>(micros >> (exponent - kSubBucketBits)) - kSubBuckets;
+    return (exponent - kSubBucketBits + 1) * kSubBuckets + sub;
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(int index) {
+    if (index < kSubBuckets) {
+        return static_cast<uint64_t>(index);
+    }
+    int exponent = index / kSubBuckets + kSubBucketBits - 1;
+    int sub = index % kSubBuckets;
+    uint64_t width = uint64_t{1} << (exponent - kSubBucketBits);
+    return static_cast<uint64_t>(kSubBuckets + sub) * width + width - 1;
+}
+
+void LatencyHistogram::Record(uint64_t micros) {
+    counts_[BucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+    sum_micros_.fetch_add(micros, std::memory_order_relaxed);
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::Take() const {
+    Snapshot snapshot;
+    // A contagem é a soma dos baldes, para bater com eles mesmo com
+    // gravações concorrentes.
+    for (int i = 0; i < kBuckets; ++i) {
+        snapshot.counts[i] = counts_[i].load(std::memory_order_relaxed);
+        snapshot.count += snapshot.counts[i];
+    }
+    snapshot.sum_micros = sum_micros_.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+uint64_t LatencyHistogram::Snapshot::ValueAtQuantile(double q) const {
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(std::ceil(q * static_cast<double>(count)));
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (int i = 0; i < kBuckets; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return BucketUpperBound(i);
+        }
+    }
+    return BucketUpperBound(kBuckets - 1);
+}
+
+uint64_t LatencyHistogram::Snapshot::CountAtOrBelow(uint64_t micros) const {
+    uint64_t total = 0;
+    for (int i = 0; i < kBuckets && BucketUpperBound(i) <= micros; ++i) {
+        total += counts[i];
+    }
+    return total;
+}
+
+void ServerMetrics::RecordStage(Rpc rpc, Stage stage, std::chrono::steady_clock::duration elapsed) {
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    stages_[static_cast<size_t>(rpc)][static_cast<size_t>(stage)].Record(
+        static_cast<uint64_t>(std::max<int64_t>(micros, 0)));
+}
+
+void ServerMetrics::AddBytesIn(Rpc rpc, size_t bytes) {
+    bytes_in_[static_cast<size_t>(rpc)].fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void ServerMetrics::AddBytesOut(Rpc rpc, size_t bytes) {
+    bytes_out_[static_cast<size_t>(rpc)].fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void ServerMetrics::RecordStatus(Rpc rpc, grpc::StatusCode code) {
+    size_t index = static_cast<size_t>(code);
+    if (index >= kStatusCodes) {
+        index = grpc::StatusCode::UNKNOWN;
+    }
+    status_[static_cast<size_t>(rpc)][index].fetch_add(1, std::memory_order_relaxed);
+}
+
+void ServerMetrics::EnterRpc(Rpc rpc) {
+    in_flight_[static_cast<size_t>(rpc)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void ServerMetrics::ExitRpc(Rpc rpc) {
+    in_flight_[static_cast<size_t>(rpc)].fetch_sub(1, std::memory_order_relaxed);
+}
+
+void ServerMetrics::AppendPrometheus(std::string* out) const {
+    // Os dois formatos saem dos mesmos baldes HDR: o histograma serve para
+    // histogram_quantile() sobre janelas; o summary dá os quantis desde o
+    // início do processo com a precisão dos baldes.
+    LatencyHistogram::Snapshot snapshots[kRpcs][kStages];
+    for (size_t r = 0; r < kRpcs; ++r) {
+        for (size_t s = 0; s < kStages; ++s) {
+            snapshots[r][s] = stages_[r][s].Take();
+        }
+    }
+
+    AppendHeader(out, "fp_stage_duration_seconds", "histogram", "Duração de cada etapa das RPCs.");
+    for (size_t r = 0; r < kRpcs; ++r) {
+        for (size_t s = 0; s < kStages; ++s) {
+            const LatencyHistogram::Snapshot& snapshot = snapshots[r][s];
+            if (snapshot.count == 0) {
+                continue;
+            }
+            for (double bound : kPrometheusBuckets) {
+                AppendFormat(out, "fp_stage_duration_seconds_bucket{rpc=\"%s\",stage=\"%s\",le=\"%g\"} %llu\n",
+                             kRpcNames[r], kStageNames[s], bound,
+                             ToULL(snapshot.CountAtOrBelow(static_cast<uint64_t>(bound * 1e6))));
+            }
+            AppendFormat(out, "fp_stage_duration_seconds_bucket{rpc=\"%s\",stage=\"%s\",le=\"+Inf\"} %llu\n",
+                         kRpcNames[r], kStageNames[s], ToULL(snapshot.count));
+            AppendFormat(out, "fp_stage_duration_seconds_sum{rpc=\"%s\",stage=\"%s\"} %.6f\n", kRpcNames[r],
+                         kStageNames[s], static_cast<double>(snapshot.sum_micros) / 1e6);
+            AppendFormat(out, "fp_stage_duration_seconds_count{rpc=\"%s\",stage=\"%s\"} %llu\n", kRpcNames[r],
+                         kStageNames[s], ToULL(snapshot.count));
+        }
+    }
+
+    AppendHeader(out, "fp_stage_latency_seconds", "summary", "Quantis de duração por etapa desde o início.");
+    for (size_t r = 0; r < kRpcs; ++r) {
+        for (size_t s = 0; s < kStages; ++s) {
+            const LatencyHistogram::Snapshot& snapshot = snapshots[r][s];
+            if (snapshot.count == 0) {
+                continue;
+            }
+            for (double q : kQuantiles) {
+                AppendFormat(out, "fp_stage_latency_seconds{rpc=\"%s\",stage=\"%s\",quantile=\"%g\"} %.6f\n",
+                             kRpcNames[r], kStageNames[s], q,
+                             static_cast<double>(snapshot.ValueAtQuantile(q)) / 1e6);
+            }
+            AppendFormat(out, "fp_stage_latency_seconds_sum{rpc=\"%s\",stage=\"%s\"} %.6f\n", kRpcNames[r],
+                         kStageNames[s], static_cast<double>(snapshot.sum_micros) / 1e6);
+            AppendFormat(out, "fp_stage_latency_seconds_count{rpc=\"%s\",stage=\"%s\"} %llu\n", kRpcNames[r],
+                         kStageNames[s], ToULL(snapshot.count));
+        }
+    }
+
+    AppendHeader(out, "fp_received_bytes_total", "counter", "Bytes de arquivo recebidos dos clientes.");
+    for (size_t r = 0; r < kRpcs; ++r) {
+        AppendFormat(out, "fp_received_bytes_total{rpc=\"%s\"} %llu\n", kRpcNames[r],
+                     ToULL(bytes_in_[r].load(std::memory_order_relaxed)));
+    }
+    AppendHeader(out, "fp_sent_bytes_total", "counter", "Bytes de resultado enviados aos clientes.");
+    for (size_t r = 0; r < kRpcs; ++r) {
+        AppendFormat(out, "fp_sent_bytes_total{rpc=\"%s\"} %llu\n", kRpcNames[r],
+                     ToULL(bytes_out_[r].load(std::memory_order_relaxed)));
+    }
+    AppendHeader(out, "fp_in_flight_requests", "gauge", "RPCs em andamento.");
+    for (size_t r = 0; r < kRpcs; ++r) {
+        AppendFormat(out, "fp_in_flight_requests{rpc=\"%s\"} %lld\n", kRpcNames[r],
+                     static_cast<long long>(in_flight_[r].load(std::memory_order_relaxed)));
+    }
+    AppendHeader(out, "fp_requests_total", "counter", "RPCs concluídas por código de status.");
+    for (size_t r = 0; r < kRpcs; ++r) {
+        for (size_t c = 0; c < kStatusCodes; ++c) {
+            uint64_t count = status_[r][c].load(std::memory_order_relaxed);
+            if (count > 0) {
+                AppendFormat(out, "fp_requests_total{rpc=\"%s\",code=\"%s\"} %llu\n", kRpcNames[r],
+                             kStatusNames[c], ToULL(count));
+            }
+        }
+    }
+}
+
+ServerMetrics& GlobalMetrics() {
+    static ServerMetrics* metrics = new ServerMetrics();
+    return *metrics;
+}
+
+RpcTracker::~RpcTracker() {
+    if (active_) {
+        // Chamada abandonada sem End (ex.: desligamento no meio da RPC).
+        End(grpc::Status(grpc::StatusCode::UNKNOWN, ""));
+    }
+}
+
+void RpcTracker::Begin(Rpc rpc) {
+    rpc_ = rpc;
+    start_ = std::chrono::steady_clock::now();
+    active_ = true;
+    GlobalMetrics().EnterRpc(rpc);
+}
+
+grpc::Status RpcTracker::End(const grpc::Status& status) {
+    if (active_) {
+        active_ = false;
+        ServerMetrics& metrics = GlobalMetrics();
+        metrics.RecordStage(rpc_, Stage::kTotal, std::chrono::steady_clock::now() - start_);
+        metrics.RecordStatus(rpc_, status.error_code());
+        metrics.ExitRpc(rpc_);
+    }
+    return status;
+}
+
+void AppendResultCacheMetrics(const ResultCache::Stats& stats, std::string* out) {
+    AppendHeader(out, "fp_cache_hits_total", "counter", "Acertos do cache de resultados por camada.");
+    AppendFormat(out, "fp_cache_hits_total{tier=\"memory\"} %llu\n", ToULL(stats.memory_hits));
+    AppendFormat(out, "fp_cache_hits_total{tier=\"disk\"} %llu\n", ToULL(stats.disk_hits));
+    AppendHeader(out, "fp_cache_misses_total", "counter", "Consultas ao cache sem resultado.");
+    AppendFormat(out, "fp_cache_misses_total %llu\n", ToULL(stats.misses));
+    AppendHeader(out, "fp_cache_insertions_total", "counter", "Resultados inseridos no cache.");
+    AppendFormat(out, "fp_cache_insertions_total %llu\n", ToULL(stats.insertions));
+    AppendHeader(out, "fp_cache_evictions_total", "counter", "Resultados removidos do cache.");
+    AppendFormat(out, "fp_cache_evictions_total %llu\n", ToULL(stats.evictions));
+    AppendHeader(out, "fp_cache_bytes", "gauge", "Bytes ocupados pelo cache por camada.");
+    AppendFormat(out, "fp_cache_bytes{tier=\"memory\"} %llu\n", ToULL(stats.memory_bytes));
+    AppendFormat(out, "fp_cache_bytes{tier=\"disk\"} %llu\n", ToULL(stats.disk_bytes));
+}
+
+void AppendSingleFlightMetrics(const SingleFlight::Stats& stats, std::string* out) {
+    AppendHeader(out, "fp_single_flight_total", "counter", "Execuções deduplicadas por papel.");
+    AppendFormat(out, "fp_single_flight_total{role=\"leader\"} %llu\n", ToULL(stats.leaders));
+    AppendFormat(out, "fp_single_flight_total{role=\"follower\"} %llu\n", ToULL(stats.followers));
+    AppendFormat(out, "fp_single_flight_total{role=\"retry\"} %llu\n", ToULL(stats.retries));
+}
+
+void AppendPdfShortcutMetrics(const PdfShortcutStats& stats, std::string* out) {
+    AppendHeader(out, "fp_pdf_compress_shortcut_total", "counter",
+                 "CompressPDF devolvido sem alteração, por motivo (pré-análise ou saída do gs maior).");
+    AppendFormat(out, "fp_pdf_compress_shortcut_total{reason=\"precheck\"} %llu\n", ToULL(stats.precheck_skips));
+    AppendFormat(out, "fp_pdf_compress_shortcut_total{reason=\"output_larger\"} %llu\n",
+                 ToULL(stats.output_larger));
+}
+
+void AppendScratchMetrics(const ScratchStorage::Stats& stats, std::string* out) {
+    AppendHeader(out, "fp_scratch_files_total", "counter", "Arquivos temporários criados por local.");
+    AppendFormat(out, "fp_scratch_files_total{backing=\"memory\"} %llu\n", ToULL(stats.memory_files));
+    AppendFormat(out, "fp_scratch_files_total{backing=\"disk\"} %llu\n", ToULL(stats.spilled_files));
+    AppendHeader(out, "fp_scratch_failures_total", "counter", "Falhas ao criar arquivos temporários.");
+    AppendFormat(out, "fp_scratch_failures_total %llu\n", ToULL(stats.failures));
+}
+
+void AppendSchedulerMetrics(const SchedulerStats& stats, std::string* out) {
+    AppendHeader(out, "fp_scheduler_limit", "gauge", "Execuções simultâneas permitidas por RPC.");
+    for (size_t i = 0; i < SchedulerStats::kRpcs; ++i) {
+        AppendFormat(out, "fp_scheduler_limit{rpc=\"%s\"} %d\n", kRpcNames[i], stats.limits[i]);
+    }
+    AppendHeader(out, "fp_scheduler_running", "gauge", "Execuções em andamento por RPC.");
+    for (size_t i = 0; i < SchedulerStats::kRpcs; ++i) {
+        AppendFormat(out, "fp_scheduler_running{rpc=\"%s\"} %d\n", kRpcNames[i], stats.running[i]);
+    }
+    AppendHeader(out, "fp_scheduler_running_large", "gauge", "Execuções de jobs grandes em andamento por RPC.");
+    for (size_t i = 0; i < SchedulerStats::kRpcs; ++i) {
+        AppendFormat(out, "fp_scheduler_running_large{rpc=\"%s\"} %d\n", kRpcNames[i], stats.running_large[i]);
+    }
+    AppendHeader(out, "fp_scheduler_seconds_per_mb", "gauge", "Custo estimado de execução por MB de entrada.");
+    for (size_t i = 0; i < SchedulerStats::kRpcs; ++i) {
+        AppendFormat(out, "fp_scheduler_seconds_per_mb{rpc=\"%s\"} %.6f\n", kRpcNames[i],
+                     stats.seconds_per_byte[i] * (1 << 20));
+    }
+    AppendHeader(out, "fp_scheduler_queued", "gauge", "Requisições esperando vaga por RPC.");
+    for (size_t i = 0; i < SchedulerStats::kRpcs; ++i) {
+        AppendFormat(out, "fp_scheduler_queued{rpc=\"%s\"} %llu\n", kRpcNames[i], ToULL(stats.queued[i]));
+    }
+    AppendHeader(out, "fp_scheduler_requests_total", "counter", "Decisões do controle de admissão por RPC.");
+    for (size_t i = 0; i < SchedulerStats::kRpcs; ++i) {
+        AppendFormat(out, "fp_scheduler_requests_total{rpc=\"%s\",outcome=\"admitted\"} %llu\n", kRpcNames[i],
+                     ToULL(stats.admitted[i]));
+        AppendFormat(out, "fp_scheduler_requests_total{rpc=\"%s\",outcome=\"rejected\"} %llu\n", kRpcNames[i],
+                     ToULL(stats.rejected[i]));
+        AppendFormat(out, "fp_scheduler_requests_total{rpc=\"%s\",outcome=\"abandoned\"} %llu\n", kRpcNames[i],
+                     ToULL(stats.abandoned[i]));
+        AppendFormat(out, "fp_scheduler_requests_total{rpc=\"%s\",outcome=\"expired\"} %llu\n", kRpcNames[i],
+                     ToULL(stats.expired[i]));
+    }
+}
+
+void AppendProcessMetrics(std::string* out) {
+    AbortStats aborts = GetAbortStats();
+    AppendHeader(out, "fp_aborted_conversions_total", "counter", "Conversões interrompidas por cancelamento.");
+    AppendFormat(out, "fp_aborted_conversions_total %llu\n", ToULL(aborts.aborted));
+    AppendHeader(out, "fp_abort_cpu_seconds_saved_total", "counter",
+                 "CPU estimado economizado pelas conversões interrompidas.");
+    AppendFormat(out, "fp_abort_cpu_seconds_saved_total %.3f\n", aborts.cpu_seconds_saved);
+    AppendHeader(out, "fp_log_dropped_messages_total", "counter", "Mensagens de log descartadas (buffer cheio).");
+    AppendFormat(out, "fp_log_dropped_messages_total %llu\n", ToULL(LogMessagesDropped()));
+}
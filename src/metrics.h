@@ -0,0 +1,155 @@
+#pragma once
+
+#include <grpcpp/grpcpp.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "src/result_cache.h"
+#include "src/scratch_storage.h"
+#include "src/single_flight.h"
+
+struct PdfShortcutStats;
+struct SchedulerStats;
+
+// Métricas do servidor: latência por RPC e etapa, bytes recebidos/enviados,
+// chamadas em andamento e códigos de status, exportadas em texto Prometheus
+// (ver MetricsHttpServer). Toda gravação é lock-free (contadores atômicos).
+
+enum class Rpc {
+    kCompressPDF,
+    kConvertToTXT,
+    kConvertImageFormat,
+    kResizeImage,
+    kCount,
+};
+
+enum class Stage {
+    kReceive,    // upload do cliente até o arquivo montado
+    kQueueWait,  // espera na fila do executor (servidor assíncrono)
+    kAdmission,  // espera por vaga no controle de admissão (JobScheduler)
+    kExecute,    // a conversão em si (gs, convert...); não inclui acertos de cache
+    kSend,       // envio do resultado até o Finish
+    kCleanup,    // remoção de temporários
+    kTotal,      // a RPC inteira
+    kCount,
+};
+
+const char* RpcName(Rpc rpc);
+// Rpc pelo nome do método ("CompressPDF"...); nomes desconhecidos caem em kCompressPDF.
+Rpc RpcFromMethod(const char* method);
+const char* StageName(Stage stage);
+const char* StatusCodeName(grpc::StatusCode code);
+
+// Histograma de latência no estilo HDR: baldes log-lineares com 8
+// sub-baldes por potência de 2 (erro relativo de no máximo 12,5%), em
+// microssegundos, até ~2^40 us. Record é um fetch_add relaxado.
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 3;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    static constexpr int kMaxExponent = 40;
+    static constexpr int kBuckets = (kMaxExponent - kSubBucketBits + 1) * kSubBuckets;
+
+    void Record(uint64_t micros);
+
+    struct Snapshot {
+        std::array<uint64_t, kBuckets> counts{};
+        uint64_t count = 0;
+        uint64_t sum_micros = 0;
+
+        // Limite superior do balde que contém o quantil q (0..1).
+        uint64_t ValueAtQuantile(double q) const;
+        // Amostras <= micros (aproximado pela fronteira dos baldes).
+        uint64_t CountAtOrBelow(uint64_t micros) const;
+    };
+    Snapshot Take() const;
+
+    static int BucketIndex(uint64_t micros);
+    static uint64_t BucketUpperBound(int index);
+
+private:
+    std::array<std::atomic<uint64_t>, kBuckets> counts_{};
+    std::atomic<uint64_t> sum_micros_{0};
+};
+
+class ServerMetrics {
+public:
+    void RecordStage(Rpc rpc, Stage stage, std::chrono::steady_clock::duration elapsed);
+    void AddBytesIn(Rpc rpc, size_t bytes);
+    void AddBytesOut(Rpc rpc, size_t bytes);
+    void RecordStatus(Rpc rpc, grpc::StatusCode code);
+    void EnterRpc(Rpc rpc);
+    void ExitRpc(Rpc rpc);
+
+    // Histogramas, contadores e gauges deste objeto em texto Prometheus.
+    void AppendPrometheus(std::string* out) const;
+
+private:
+    static constexpr size_t kRpcs = static_cast<size_t>(Rpc::kCount);
+    static constexpr size_t kStages = static_cast<size_t>(Stage::kCount);
+    static constexpr size_t kStatusCodes = 17;
+
+    std::array<std::array<LatencyHistogram, kStages>, kRpcs> stages_;
+    std::array<std::atomic<uint64_t>, kRpcs> bytes_in_{};
+    std::array<std::atomic<uint64_t>, kRpcs> bytes_out_{};
+    std::array<std::atomic<int64_t>, kRpcs> in_flight_{};
+    std::array<std::array<std::atomic<uint64_t>, kStatusCodes>, kRpcs> status_{};
+};
+
+// Instância única do processo.
+ServerMetrics& GlobalMetrics();
+
+// Mede o escopo como uma etapa de rpc.
+class StageTimer {
+public:
+    StageTimer(Rpc rpc, Stage stage)
+        : rpc_(rpc), stage_(stage), start_(std::chrono::steady_clock::now()) {}
+    ~StageTimer() { GlobalMetrics().RecordStage(rpc_, stage_, std::chrono::steady_clock::now() - start_); }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+private:
+    Rpc rpc_;
+    Stage stage_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Vida de uma RPC: gauge de chamadas em andamento, etapa kTotal e contagem
+// por código de status. Begin/End explícitos porque no servidor
+// assíncrono a chamada atravessa vários eventos da completion queue.
+class RpcTracker {
+public:
+    RpcTracker() = default;
+    explicit RpcTracker(Rpc rpc) { Begin(rpc); }
+    ~RpcTracker();
+
+    RpcTracker(const RpcTracker&) = delete;
+    RpcTracker& operator=(const RpcTracker&) = delete;
+
+    void Begin(Rpc rpc);
+    // Encerra a RPC com status e o devolve (para "return tracker.End(...)").
+    grpc::Status End(const grpc::Status& status);
+
+    Rpc rpc() const { return rpc_; }
+    std::chrono::steady_clock::time_point start() const { return start_; }
+
+private:
+    Rpc rpc_ = Rpc::kCompressPDF;
+    std::chrono::steady_clock::time_point start_;
+    bool active_ = false;
+};
+
+// Métricas dos outros módulos no mesmo formato.
+void AppendResultCacheMetrics(const ResultCache::Stats& stats, std::string* out);
+void AppendSingleFlightMetrics(const SingleFlight::Stats& stats, std::string* out);
+void AppendScratchMetrics(const ScratchStorage::Stats& stats, std::string* out);
+void AppendSchedulerMetrics(const SchedulerStats& stats, std::string* out);
+void AppendPdfShortcutMetrics(const PdfShortcutStats& stats, std::string* out);
+// Abortos por cancelamento (abort_stats) e mensagens de log descartadas.
+void AppendProcessMetrics(std::string* out);
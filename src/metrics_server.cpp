@@ -0,0 +1,122 @@
+#include "src/metrics_server.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+namespace {
+
+// Intervalo em que a thread confere se deve parar.
+constexpr int kPollMillis = 200;
+// Requisições maiores que isso não são de um scraper.
+constexpr size_t kMaxRequestBytes = 8192;
+
+void SendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        sent += static_cast<size_t>(n);
+    }
+}
+
+std::string HttpResponse(const char* status, const char* content_type, const std::string& body) {
+    return std::string("HTTP/1.1 ") + status + "\r\nContent-Type: " + content_type +
+           "\r\nContent-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+}
+
+}  // namespace
+
+MetricsHttpServer::MetricsHttpServer(std::function<std::string()> render) : render_(std::move(render)) {}
+
+MetricsHttpServer::~MetricsHttpServer() {
+    Stop();
+}
+
+bool MetricsHttpServer::Start(int port, std::string* error) {
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        *error = std::string("socket: ") + std::strerror(errno);
+        return false;
+    }
+    int one = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listen_fd_, 16) != 0) {
+        *error = "porta " + std::to_string(port) + ": " + std::strerror(errno);
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    thread_ = std::thread([this] { ServeLoop(); });
+    return true;
+}
+
+void MetricsHttpServer::Stop() {
+    stopping_ = true;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+    }
+}
+
+void MetricsHttpServer::ServeLoop() {
+    while (!stopping_) {
+        pollfd pfd{listen_fd_, POLLIN, 0};
+        if (::poll(&pfd, 1, kPollMillis) <= 0) {
+            continue;
+        }
+        int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+        HandleConnection(fd);
+        ::close(fd);
+    }
+}
+
+void MetricsHttpServer::HandleConnection(int fd) {
+    // Um cliente parado não pode prender a thread.
+    timeval timeout{1, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < kMaxRequestBytes) {
+        ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        request.append(buffer, static_cast<size_t>(n));
+    }
+
+    // Só a linha de requisição importa: "GET /metrics HTTP/1.1".
+    std::string line = request.substr(0, request.find("\r\n"));
+    if (line.rfind("GET /metrics ", 0) == 0 || line.rfind("GET /metrics?", 0) == 0) {
+        SendAll(fd, HttpResponse("200 OK", "text/plain; version=0.0.4; charset=utf-8", render_()));
+    } else {
+        SendAll(fd, HttpResponse("404 Not Found", "text/plain; charset=utf-8", "Use GET /metrics\n"));
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+
+// Endpoint HTTP mínimo para o Prometheus (--metrics-port): GET /metrics em
+// 127.0.0.1 devolve o texto de render(); qualquer outro caminho é 404.
+// Uma thread atende uma conexão por vez, o suficiente para scrapes.
+class MetricsHttpServer {
+public:
+    explicit MetricsHttpServer(std::function<std::string()> render);
+    ~MetricsHttpServer();
+
+    MetricsHttpServer(const MetricsHttpServer&) = delete;
+    MetricsHttpServer& operator=(const MetricsHttpServer&) = delete;
+
+    // Abre a porta e inicia a thread. Retorna false e descreve o problema em error.
+    bool Start(int port, std::string* error);
+    void Stop();
+
+private:
+    void ServeLoop();
+    void HandleConnection(int fd);
+
+    std::function<std::string()> render_;
+    int listen_fd_ = -1;
+    std::atomic<bool> stopping_{false};
+    std::thread thread_;
+};
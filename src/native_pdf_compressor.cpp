@@ -0,0 +1,614 @@
+#include "src/native_pdf_compressor.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "src/flate.h"
+#include "src/image_codec.h"
+#include "src/pdf_analysis.h"
+#include "src/pdf_document.h"
+
+namespace {
+
+using Type = PdfObject::Type;
+
+// Filtros sem perdas que DecodeStream desfaz.
+const char* const kLosslessFilters[] = {"FlateDecode", "Fl", "LZWDecode", "LZW", "ASCIIHexDecode",
+                                        "AHx", "ASCII85Decode", "A85", "RunLengthDecode", "RL"};
+
+// Chaves do dicionário da imagem que descrevem os dados antigos.
+const char* const kReplacedKeys[] = {"Width", "Height", "BitsPerComponent", "Filter", "DecodeParms", "Length", "DL"};
+
+// Uma imagem a recomprimir. data fica vazio se a imagem não pôde ser
+// decodificada ou se o JPEG não saiu menor que o stream original.
+struct ImageJob {
+    int num = 0;
+    PdfObject image;
+    bool dct = false;
+    int components = 0;
+    int width = 0;
+    int height = 0;
+    int target_width = 0;
+    int target_height = 0;
+    std::string data;
+};
+
+int IntValue(const PdfDocument& document, const PdfObject& dict, const char* key) {
+    const PdfObject* value = dict.Get(key);
+    return value != nullptr ? document.Resolve(*value).AsInt(0) : 0;
+}
+
+// Componentes de cor de uma imagem que o JPEG representa sem conversão:
+// 1 (cinza) ou 3 (RGB). 0 para CMYK, Indexed, Separation, Lab etc.
+int JpegComponents(const PdfDocument& document, const PdfObject& image) {
+    const PdfObject* value = image.Get("ColorSpace");
+    if (value == nullptr) {
+        return 0;
+    }
+    PdfObject space = document.Resolve(*value);
+    if (space.is(Type::kName)) {
+        return space.text == "DeviceGray" ? 1 : space.text == "DeviceRGB" ? 3 : 0;
+    }
+    if (!space.array || space.array->empty()) {
+        return 0;
+    }
+    const PdfObject& family = (*space.array)[0];
+    if (family.IsName("CalGray")) {
+        return 1;
+    }
+    if (family.IsName("CalRGB")) {
+        return 3;
+    }
+    if (family.IsName("ICCBased") && space.array->size() >= 2) {
+        int components = IntValue(document, document.Resolve((*space.array)[1]), "N");
+        return components == 1 || components == 3 ? components : 0;
+    }
+    return 0;
+}
+
+// Monta o job de num se a imagem é recomprimível e o preset a mudaria:
+// reamostrada acima do limiar de resolução, ou sem perdas e grande o
+// bastante para o JPEG. Máscaras, imagens de 1 bit, com chave de cor ou
+// com filtros especializados ficam como estão.
+bool PlanImage(const PdfDocument& document, int num, double dpi, const PdfImagePreset& preset, ImageJob* job) {
+    PdfObject image = document.GetObject(num);
+    const PdfObject* subtype = image.Get("Subtype");
+    if (!image.is(Type::kStream) || subtype == nullptr || !subtype->IsName("Image")) {
+        return false;
+    }
+    const PdfObject* image_mask = image.Get("ImageMask");
+    const PdfObject* mask = image.Get("Mask");
+    if ((image_mask != nullptr && document.Resolve(*image_mask).boolean) ||
+        (mask != nullptr && !mask->is(Type::kRef)) || image.Get("SMaskInData") != nullptr ||
+        IntValue(document, image, "BitsPerComponent") != 8) {
+        return false;
+    }
+    job->width = IntValue(document, image, "Width");
+    job->height = IntValue(document, image, "Height");
+    job->components = JpegComponents(document, image);
+    if (job->width <= 0 || job->height <= 0 || job->components == 0) {
+        return false;
+    }
+    std::vector<std::string> filters = document.FilterNames(image);
+    job->dct = filters.size() == 1 && (filters[0] == "DCTDecode" || filters[0] == "DCT");
+    if (job->dct) {
+        // ColorTransform e afins mudam a interpretação das cores.
+        if (image.Get("DecodeParms") != nullptr) {
+            return false;
+        }
+    } else {
+        for (const std::string& name : filters) {
+            if (std::find(std::begin(kLosslessFilters), std::end(kLosslessFilters), name) ==
+                std::end(kLosslessFilters)) {
+                return false;
+            }
+        }
+    }
+
+    job->target_width = job->width;
+    job->target_height = job->height;
+    if (dpi > preset.color_dpi * kPdfDownsampleThreshold) {
+        double scale = preset.color_dpi / dpi;
+        job->target_width = std::max(1, static_cast<int>(std::lround(job->width * scale)));
+        job->target_height = std::max(1, static_cast<int>(std::lround(job->height * scale)));
+    } else if (job->dct || static_cast<double>(job->width) * job->height < kPdfMinLosslessPixels) {
+        return false;
+    }
+    job->num = num;
+    job->image = std::move(image);
+    return true;
+}
+
+void RecompressImage(const PdfDocument& document, const ImageResizer& resizer, int quality, ImageJob* job) {
+    const PdfObject& image = job->image;
+    Image decoded;
+    std::string error;
+    if (job->dct) {
+        if (image.stream_offset + image.stream_length > document.size()) {
+            return;
+        }
+        std::string jpeg(document.data() + image.stream_offset, image.stream_length);
+        DecodeOptions options;
+        options.min_width = job->target_width;
+        options.min_height = job->target_height;
+        if (!DecodeImage(jpeg, &decoded, &error, options) || decoded.channels != job->components) {
+            return;
+        }
+    } else {
+        std::string samples;
+        const size_t expected = static_cast<size_t>(job->width) * job->height * job->components;
+        if (!document.DecodeStream(image, &samples, &error) || samples.size() < expected) {
+            return;
+        }
+        decoded.width = job->width;
+        decoded.height = job->height;
+        decoded.channels = job->components;
+        decoded.pixels.assign(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(expected));
+    }
+
+    Image resized;
+    const Image* source = &decoded;
+    if (decoded.width != job->target_width || decoded.height != job->target_height) {
+        if (!resizer.Resize(decoded, job->target_width, job->target_height, &resized, &error)) {
+            return;
+        }
+        source = &resized;
+    }
+    EncodeOptions encode;
+    encode.quality = quality;
+    if (!EncodeImage(*source, ImageFormat::kJpeg, encode, &job->data, &error) ||
+        job->data.size() >= image.stream_length) {
+        job->data.clear();
+    }
+}
+
+// Imagens de uma reescrita, pegas em ordem por quem estiver livre (threads
+// do pool e a chamadora). Compartilhado por shared_ptr: uma tarefa que só
+// sai da fila do pool depois do fim da reescrita não encontra mais imagens
+// e não toca no documento.
+struct ImageQueue {
+    ImageQueue(const PdfDocument* document, const ImageResizer* resizer, int quality,
+               const std::function<bool()>& is_cancelled, std::vector<ImageJob> jobs)
+        : document(document), resizer(resizer), quality(quality), is_cancelled(is_cancelled),
+          jobs(std::move(jobs)) {}
+
+    bool Claim(size_t* index) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (next >= jobs.size()) {
+            return false;
+        }
+        *index = next++;
+        return true;
+    }
+
+    void Run(size_t index) {
+        // Com a requisição cancelada, as imagens restantes só são contadas.
+        if (!is_cancelled || !is_cancelled()) {
+            RecompressImage(*document, *resizer, quality, &jobs[index]);
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (++finished == jobs.size()) {
+            changed.notify_all();
+        }
+    }
+
+    void Help() {
+        size_t index = 0;
+        while (Claim(&index)) {
+            Run(index);
+        }
+    }
+
+    void Wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return finished == jobs.size(); });
+    }
+
+    const PdfDocument* document;
+    const ImageResizer* resizer;
+    const int quality;
+    const std::function<bool()> is_cancelled;
+    std::vector<ImageJob> jobs;
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t next = 0;
+    size_t finished = 0;
+};
+
+void AppendName(const std::string& name, std::string* out) {
+    out->push_back('/');
+    for (unsigned char c : name) {
+        if (c < 0x21 || c > 0x7E || std::strchr("#()<>[]{}/%", c) != nullptr) {
+            char escaped[4];
+            std::snprintf(escaped, sizeof(escaped), "#%02X", c);
+            out->append(escaped);
+        } else {
+            out->push_back(static_cast<char>(c));
+        }
+    }
+}
+
+void AppendNumber(double value, std::string* out) {
+    char text[32];
+    if (value == std::floor(value) && std::fabs(value) < 1e15) {
+        std::snprintf(text, sizeof(text), "%lld", static_cast<long long>(value));
+    } else {
+        std::snprintf(text, sizeof(text), "%.6f", value);
+        // PDF não aceita expoente; zeros à direita só ocupam espaço.
+        char* end = text + std::strlen(text);
+        while (end[-1] == '0') {
+            *--end = '\0';
+        }
+        if (end[-1] == '.') {
+            end[-1] = '\0';
+        }
+    }
+    out->append(text);
+}
+
+// Serializa um objeto lido pelo PdfParser (strings saem em hexadecimal).
+void AppendObject(const PdfObject& object, std::string* out) {
+    static const char kHex[] = "0123456789ABCDEF";
+    switch (object.type) {
+    case Type::kNull:
+        out->append("null");
+        break;
+    case Type::kBool:
+        out->append(object.boolean ? "true" : "false");
+        break;
+    case Type::kNumber:
+        AppendNumber(object.number, out);
+        break;
+    case Type::kString:
+        out->push_back('<');
+        for (unsigned char c : object.text) {
+            out->push_back(kHex[c >> 4]);
+            out->push_back(kHex[c & 0xF]);
+        }
+        out->push_back('>');
+        break;
+    case Type::kName:
+        AppendName(object.text, out);
+        break;
+    case Type::kArray:
+        out->push_back('[');
+        if (object.array) {
+            for (size_t i = 0; i < object.array->size(); ++i) {
+                if (i > 0) {
+                    out->push_back(' ');
+                }
+                AppendObject((*object.array)[i], out);
+            }
+        }
+        out->push_back(']');
+        break;
+    case Type::kDict:
+    case Type::kStream:
+        out->append("<<");
+        if (object.dict) {
+            for (const auto& entry : *object.dict) {
+                AppendName(entry.first, out);
+                out->push_back(' ');
+                AppendObject(entry.second, out);
+            }
+        }
+        out->append(">>");
+        break;
+    case Type::kRef:
+        out->append(std::to_string(object.ref_num) + " " + std::to_string(object.ref_gen) + " R");
+        break;
+    case Type::kOperator:
+        out->append(object.text);
+        break;
+    }
+}
+
+// Objeto da imagem com o JPEG novo: o dicionário original sem as chaves que
+// descreviam os dados antigos, mais as novas.
+void AppendImageObject(const ImageJob& job, int generation, std::string* out) {
+    out->append(std::to_string(job.num) + " " + std::to_string(generation) + " obj\n<<");
+    for (const auto& entry : *job.image.dict) {
+        if (std::none_of(std::begin(kReplacedKeys), std::end(kReplacedKeys),
+                         [&](const char* key) { return entry.first == key; })) {
+            AppendName(entry.first, out);
+            out->push_back(' ');
+            AppendObject(entry.second, out);
+        }
+    }
+    out->append("/Width " + std::to_string(job.target_width) + "/Height " + std::to_string(job.target_height) +
+                "/BitsPerComponent 8/Filter/DCTDecode/Length " + std::to_string(job.data.size()) +
+                ">>\nstream\n");
+    out->append(job.data);
+    out->append("\nendstream\nendobj\n");
+}
+
+// Entrada da xref nova.
+struct XrefEntry {
+    // 0 = livre, 1 = offset na saída, 2 = dentro de object stream.
+    int type = 0;
+    // type 1: offset; type 2: número do object stream.
+    size_t field = 0;
+    // type 1: geração; type 2: índice.
+    int extra = 0;
+};
+
+// /Root, /Info e /ID do trailer original.
+void AppendTrailerEntries(const PdfObject& trailer, std::string* out) {
+    for (const char* key : {"Root", "Info", "ID"}) {
+        const PdfObject* value = trailer.Get(key);
+        if (value != nullptr) {
+            AppendName(key, out);
+            out->push_back(' ');
+            AppendObject(*value, out);
+        }
+    }
+}
+
+void AppendXrefTable(const std::vector<XrefEntry>& entries, const PdfObject& trailer, std::string* out) {
+    size_t xref_offset = out->size();
+    out->append("xref\n0 " + std::to_string(entries.size()) + "\n0000000000 65535 f \n");
+    char line[32];
+    for (size_t num = 1; num < entries.size(); ++num) {
+        if (entries[num].type == 1) {
+            std::snprintf(line, sizeof(line), "%010zu %05d n \n", entries[num].field, entries[num].extra);
+            out->append(line);
+        } else {
+            out->append("0000000000 00000 f \n");
+        }
+    }
+    out->append("trailer\n<</Size " + std::to_string(entries.size()));
+    AppendTrailerEntries(trailer, out);
+    out->append(">>\nstartxref\n" + std::to_string(xref_offset) + "\n%%EOF\n");
+}
+
+// Xref stream (necessária quando há objetos em object streams). O próprio
+// stream ocupa o número entries.size().
+bool AppendXrefStream(std::vector<XrefEntry> entries, const PdfObject& trailer, int flate_level, std::string* out,
+                      std::string* error) {
+    const size_t xref_offset = out->size();
+    const size_t self = entries.size();
+    entries.push_back({1, xref_offset, 0});
+    int offset_width = 1;
+    for (const XrefEntry& entry : entries) {
+        while (offset_width < 8 && (entry.field >> (8 * offset_width)) != 0) {
+            ++offset_width;
+        }
+    }
+    std::string rows;
+    rows.reserve(entries.size() * (3 + offset_width));
+    for (size_t num = 0; num < entries.size(); ++num) {
+        const XrefEntry& entry = entries[num];
+        const int extra = num == 0 ? 0xFFFF : entry.extra;
+        rows.push_back(static_cast<char>(entry.type));
+        for (int shift = 8 * (offset_width - 1); shift >= 0; shift -= 8) {
+            rows.push_back(static_cast<char>((entry.field >> shift) & 0xFF));
+        }
+        rows.push_back(static_cast<char>((extra >> 8) & 0xFF));
+        rows.push_back(static_cast<char>(extra & 0xFF));
+    }
+    std::string compressed;
+    if (!FlateCompress(rows.data(), rows.size(), flate_level, &compressed, error)) {
+        *error = "Xref stream: " + *error;
+        return false;
+    }
+    out->append(std::to_string(self) + " 0 obj\n<</Type/XRef/Size " + std::to_string(entries.size()) + "/W[1 " +
+                std::to_string(offset_width) + " 2]");
+    AppendTrailerEntries(trailer, out);
+    out->append("/Filter/FlateDecode/Length " + std::to_string(compressed.size()) + ">>\nstream\n");
+    out->append(compressed);
+    out->append("\nendstream\nendobj\nstartxref\n" + std::to_string(xref_offset) + "\n%%EOF\n");
+    return true;
+}
+
+// Versão do cabeçalho original ("1.4"; "1.4" se não for legível).
+std::string HeaderVersion(const PdfDocument& document) {
+    const char* data = document.data();
+    const size_t limit = std::min<size_t>(document.size(), 1024);
+    for (size_t pos = 0; pos + 8 <= limit; ++pos) {
+        if (std::memcmp(data + pos, "%PDF-", 5) == 0) {
+            std::string version(data + pos + 5, 3);
+            bool valid = std::isdigit(static_cast<unsigned char>(version[0])) && version[1] == '.' &&
+                         std::isdigit(static_cast<unsigned char>(version[2]));
+            return valid ? version : "1.4";
+        }
+    }
+    return "1.4";
+}
+
+// Escreve o documento com os streams de replaced trocados. Os demais
+// objetos são copiados byte a byte do original; a xref antiga, o dicionário
+// de linearização (que deixaria de valer) e objetos ilegíveis ficam de fora.
+bool WriteDocument(const PdfDocument& document, const std::vector<const ImageJob*>& replaced, int flate_level,
+                   std::string* out, std::string* error) {
+    const int limit = document.object_limit();
+    std::vector<XrefEntry> entries(static_cast<size_t>(std::max(limit, 1)));
+    std::vector<const ImageJob*> jobs(entries.size(), nullptr);
+    for (const ImageJob* job : replaced) {
+        if (job->num < limit) {
+            jobs[job->num] = job;
+        }
+    }
+    // A versão tem sempre três caracteres: trocada no lugar se for preciso.
+    const std::string version = HeaderVersion(document);
+    out->clear();
+    out->append("%PDF-" + version + "\n%\xE2\xE3\xCF\xD3\n");
+    bool object_streams = false;
+    for (int num = 1; num < limit; ++num) {
+        PdfDocument::Location location;
+        PdfObject object;
+        if (!document.Locate(num, &location, &object)) {
+            continue;
+        }
+        XrefEntry& entry = entries[num];
+        if (!location.in_file) {
+            entry = {2, static_cast<size_t>(location.object_stream), location.index};
+            object_streams = true;
+            continue;
+        }
+        const PdfObject* type = object.Get("Type");
+        if ((type != nullptr && type->IsName("XRef")) || object.Get("Linearized") != nullptr) {
+            continue;
+        }
+        entry = {1, out->size(), location.generation};
+        if (jobs[num] != nullptr) {
+            AppendImageObject(*jobs[num], location.generation, out);
+            continue;
+        }
+        out->append(document.data() + location.begin, location.end - location.begin);
+        out->append(location.stream ? "\nendstream\nendobj\n" : "\nendobj\n");
+    }
+    // Objetos num object stream que não foi copiado deixam de existir.
+    for (XrefEntry& entry : entries) {
+        if (entry.type == 2 && (entry.field >= entries.size() || entries[entry.field].type != 1)) {
+            entry = XrefEntry();
+        }
+    }
+    if (!object_streams) {
+        AppendXrefTable(entries, document.trailer(), out);
+        return true;
+    }
+    // Xref streams e object streams são do PDF 1.5.
+    if (version < "1.5") {
+        out->replace(5, 3, "1.5");
+    }
+    return AppendXrefStream(std::move(entries), document.trailer(), flate_level, out, error);
+}
+
+}  // namespace
+
+NativePdfCompressor::NativePdfCompressor(std::unique_ptr<PdfCompressor> fallback, const Options& options)
+    : fallback_(std::move(fallback)),
+      name_(std::string("native+") + fallback_->Name()),
+      threads_(options.threads > 0 ? options.threads
+                                   : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))),
+      resizer_([&options] {
+          ImageResizer::Options resize_options;
+          resize_options.filter = options.filter;
+          resize_options.threads = 1;
+          return resize_options;
+      }()) {
+    if (threads_ > 1) {
+        pool_ = std::make_unique<ThreadPool>(static_cast<size_t>(threads_ - 1), 0);
+    }
+}
+
+bool NativePdfCompressor::Compress(const std::string& input_path, const std::string& output_path,
+                                   const PdfCompressSettings& settings, std::string* error) {
+    PdfDocument document(input_path);
+    std::string output;
+    switch (Rewrite(&document, settings, &output, error)) {
+    case Outcome::kRewritten:
+        break;
+    case Outcome::kFailed:
+        return false;
+    case Outcome::kNotApplicable:
+        return fallback_->Compress(input_path, output_path, settings, error);
+    }
+    std::ofstream file(output_path, std::ios::binary | std::ios::trunc);
+    if (!file.write(output.data(), static_cast<std::streamsize>(output.size())) || !file.flush()) {
+        *error = "Falha ao escrever " + output_path;
+        return false;
+    }
+    return true;
+}
+
+bool NativePdfCompressor::CompressPipe(const std::string& input, const PdfCompressSettings& settings,
+                                       std::string* output, std::string* error) {
+    PdfDocument document(input.data(), input.size());
+    switch (Rewrite(&document, settings, output, error)) {
+    case Outcome::kRewritten:
+        return true;
+    case Outcome::kFailed:
+        return false;
+    case Outcome::kNotApplicable:
+        break;
+    }
+    return fallback_->CompressPipe(input, settings, output, error);
+}
+
+NativePdfCompressor::Outcome NativePdfCompressor::Rewrite(PdfDocument* document, const PdfCompressSettings& settings,
+                                                          std::string* output, std::string* error) const {
+    std::string open_error;
+    if (!document->Open(&open_error)) {
+        return Outcome::kNotApplicable;
+    }
+    // Se a maior parte da economia está fora das imagens (fontes sem
+    // subset, estrutura), só o gs a realiza.
+    PdfAnalysis own;
+    const PdfAnalysis* analysis = settings.analysis;
+    if (analysis == nullptr) {
+        own.estimate = EstimatePdfCompression(*document, settings.pdf_settings, &own.resolutions);
+        analysis = &own;
+    }
+    const PdfCompressionEstimate& estimate = analysis->estimate;
+    size_t image_savings = estimate.downsample_savings + estimate.lossless_image_savings;
+    if (!estimate.analyzed || image_savings == 0 || image_savings * 2 < estimate.savings_bytes()) {
+        return Outcome::kNotApplicable;
+    }
+
+    const PdfImagePreset preset = PdfImagePresetFor(settings.pdf_settings);
+    std::vector<ImageJob> jobs;
+    std::unordered_set<int> masks;
+    for (const auto& drawn : analysis->resolutions) {
+        ImageJob job;
+        if (PlanImage(*document, drawn.first, drawn.second, preset, &job)) {
+            jobs.push_back(std::move(job));
+        }
+        PdfObject image = document->GetObject(drawn.first);
+        for (const char* key : {"SMask", "Mask"}) {
+            const PdfObject* mask = image.Get(key);
+            if (mask != nullptr && mask->is(PdfObject::Type::kRef)) {
+                masks.insert(mask->ref_num);
+            }
+        }
+    }
+    // Máscaras continuam sem perdas, como no pdfwrite.
+    jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [&](const ImageJob& job) { return masks.count(job.num); }),
+               jobs.end());
+    if (jobs.empty()) {
+        return Outcome::kNotApplicable;
+    }
+    // Maiores primeiro, para a última imagem não ficar sozinha no fim.
+    std::sort(jobs.begin(), jobs.end(), [](const ImageJob& a, const ImageJob& b) {
+        return static_cast<double>(a.width) * a.height > static_cast<double>(b.width) * b.height;
+    });
+
+    auto queue = std::make_shared<ImageQueue>(document, &resizer_, preset.jpeg_quality, settings.is_cancelled,
+                                              std::move(jobs));
+    if (pool_ != nullptr) {
+        size_t helpers = std::min(static_cast<size_t>(threads_ - 1), queue->jobs.size() - 1);
+        for (size_t i = 0; i < helpers; ++i) {
+            pool_->TrySubmit([queue] { queue->Help(); });
+        }
+    }
+    queue->Help();
+    queue->Wait();
+    if (settings.is_cancelled && settings.is_cancelled()) {
+        *error = "requisição cancelada";
+        return Outcome::kFailed;
+    }
+
+    std::vector<const ImageJob*> replaced;
+    for (const ImageJob& job : queue->jobs) {
+        if (!job.data.empty()) {
+            replaced.push_back(&job);
+        }
+    }
+    if (replaced.empty()) {
+        return Outcome::kNotApplicable;
+    }
+    return WriteDocument(*document, replaced, settings.flate_level, output, error) ? Outcome::kRewritten
+                                                                                   : Outcome::kFailed;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "src/image_resize.h"
+#include "src/pdf_compressor.h"
+#include "src/thread_pool.h"
+
+class PdfDocument;
+
+// Recompressão das imagens do PDF em processo (--native-pdf-images).
+//
+// Quando a pré-análise (pdf_analysis.h) atribui às imagens a maior parte da
+// economia do preset — PDFs digitalizados, tipicamente —, as image XObjects
+// desenhadas acima da resolução do preset são decodificadas, reamostradas
+// pelo ImageResizer e recodificadas em JPEG, e as grandes sem perdas viram
+// JPEG no mesmo tamanho, como faria o pdfwrite. Cada imagem é uma tarefa:
+// o pool e a própria thread chamadora as processam em paralelo. A saída
+// copia todos os outros objetos byte a byte, troca só os streams dessas
+// imagens e ganha uma xref nova.
+//
+// Os demais PDFs (economia concentrada em fontes ou estrutura, arquivos que
+// o leitor não abre, nenhuma imagem que diminua) seguem pelo motor fallback.
+class NativePdfCompressor final : public PdfCompressor {
+public:
+    struct Options {
+        // Imagens processadas ao mesmo tempo por documento, contando a
+        // chamadora (0 = núcleos; 1 = sem pool).
+        int threads = 0;
+        ResizeFilter filter = ResizeFilter::kLanczos3;
+    };
+
+    NativePdfCompressor(std::unique_ptr<PdfCompressor> fallback, const Options& options);
+
+    bool Compress(const std::string& input_path, const std::string& output_path,
+                  const PdfCompressSettings& settings, std::string* error) override;
+    const char* Name() const override { return name_.c_str(); }
+
+    // A reescrita também funciona em memória; o pipeline depende do fallback.
+    bool SupportsPipe() const override { return fallback_->SupportsPipe(); }
+    bool CompressPipe(const std::string& input, const PdfCompressSettings& settings, std::string* output,
+                      std::string* error) override;
+
+    int threads() const { return threads_; }
+
+private:
+    enum class Outcome { kRewritten, kNotApplicable, kFailed };
+
+    // Reescreve document em output. kNotApplicable: o documento vai para o
+    // fallback; kFailed preenche error (cancelamento ou falha de escrita).
+    Outcome Rewrite(PdfDocument* document, const PdfCompressSettings& settings, std::string* output,
+                    std::string* error) const;
+
+    const std::unique_ptr<PdfCompressor> fallback_;
+    const std::string name_;
+    const int threads_;
+    // Resize de cada imagem numa thread só: o paralelismo é entre imagens.
+    const ImageResizer resizer_;
+    // Executa imagens em paralelo com a chamadora (nullptr com threads == 1).
+    std::unique_ptr<ThreadPool> pool_;
+};
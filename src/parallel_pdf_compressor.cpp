@@ -0,0 +1,189 @@
+#include "src/parallel_pdf_compressor.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+
+#include "src/pdf_document.h"
+#include "src/subprocess.h"
+#include "src/tool_commands.h"
+
+namespace {
+
+// Espera N tarefas do pool terminarem.
+class Latch {
+public:
+    explicit Latch(size_t count) : count_(count) {}
+
+    void CountDown() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--count_ == 0) {
+            done_.notify_all();
+        }
+    }
+
+    void Wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return count_ == 0; });
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable done_;
+    size_t count_;
+};
+
+// Arquivos das partes, liberados ao sair do escopo.
+struct PartFiles {
+    std::vector<std::string> paths;
+    // Com ScratchStorage; senão paths são arquivos nomeados a remover.
+    std::vector<ScratchFile> scratch;
+    ~PartFiles() {
+        if (scratch.empty()) {
+            for (const std::string& path : paths) {
+                unlink(path.c_str());
+            }
+        }
+    }
+};
+
+}  // namespace
+
+ParallelPdfCompressor::ParallelPdfCompressor(std::unique_ptr<PdfCompressor> single_pass,
+                                             const Options& options)
+    : single_pass_(std::move(single_pass)),
+      min_pages_(std::max(2, options.min_pages)),
+      name_(std::string("parallel+") + single_pass_->Name()),
+      use_qpdf_(ProgramInPath("qpdf")),
+      scratch_(options.scratch),
+      workers_(options.workers, 0) {}
+
+bool ParallelPdfCompressor::Compress(const std::string& input_path, const std::string& output_path,
+                                     const PdfCompressSettings& settings, std::string* error) {
+    // Com um único worker dividir só acrescenta o custo da junção.
+    if (workers_.size() < 2) {
+        return single_pass_->Compress(input_path, output_path, settings, error);
+    }
+    std::string count_error;
+    int pages = CountPages(input_path, &count_error, settings.is_cancelled);
+    if (settings.is_cancelled && settings.is_cancelled()) {
+        *error = count_error;
+        return false;
+    }
+    if (pages < min_pages_) {
+        return single_pass_->Compress(input_path, output_path, settings, error);
+    }
+    return CompressParallel(input_path, output_path, settings, pages, error);
+}
+
+int ParallelPdfCompressor::CountPages(const std::string& input_path, std::string* error,
+                                      const std::function<bool()>& is_cancelled) {
+    // O leitor em processo mapeia o arquivo e lê só trailer, xref e o /Count
+    // da raiz; o gs fica para o que ele não abre (ex.: criptografados).
+    PdfDocument document(input_path);
+    std::string open_error;
+    if (document.Open(&open_error)) {
+        return document.page_count();
+    }
+    std::string output;
+    if (!RunSubprocess(GhostscriptPageCountCommand(input_path), std::string(), &output, error, is_cancelled)) {
+        return -1;
+    }
+    char* end = nullptr;
+    long pages = std::strtol(output.c_str(), &end, 10);
+    if (end == output.c_str() || pages < 0) {
+        *error = "Contagem de páginas inválida: " + output;
+        return -1;
+    }
+    return static_cast<int>(pages);
+}
+
+std::vector<std::pair<int, int>> ParallelPdfCompressor::SplitPages(int pages, int parts) {
+    std::vector<std::pair<int, int>> ranges;
+    parts = std::max(1, std::min(parts, pages));
+    int first = 1;
+    for (int i = 0; i < parts; ++i) {
+        // As primeiras (pages % parts) partes levam uma página a mais.
+        int count = pages / parts + (i < pages % parts ? 1 : 0);
+        ranges.emplace_back(first, first + count - 1);
+        first += count;
+    }
+    return ranges;
+}
+
+bool ParallelPdfCompressor::CompressParallel(const std::string& input_path, const std::string& output_path,
+                                             const PdfCompressSettings& settings, int pages, std::string* error) {
+    std::vector<std::pair<int, int>> ranges = SplitPages(pages, static_cast<int>(workers_.size()));
+
+    PartFiles parts;
+    if (scratch_ != nullptr) {
+        // Cada parte fica perto da sua fração da entrada.
+        struct stat st;
+        size_t part_hint = 0;
+        if (stat(input_path.c_str(), &st) == 0) {
+            part_hint = static_cast<size_t>(st.st_size) / ranges.size();
+        }
+        parts.scratch.resize(ranges.size());
+        for (size_t i = 0; i < ranges.size(); ++i) {
+            if (!scratch_->Create("part" + std::to_string(i), part_hint, &parts.scratch[i], error)) {
+                *error = "Arquivo temporário da parte: " + *error;
+                return false;
+            }
+            parts.paths.push_back(parts.scratch[i].path());
+        }
+    } else {
+        for (size_t i = 0; i < ranges.size(); ++i) {
+            parts.paths.push_back(output_path + ".part" + std::to_string(i));
+        }
+    }
+
+    std::vector<std::string> errors(ranges.size());
+    std::vector<char> ok(ranges.size(), 0);
+    Latch latch(ranges.size());
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        // Fila sem limite: TrySubmit só falha durante o desligamento.
+        bool submitted = workers_.TrySubmit([&, i] {
+            std::string ignored;
+            // Com a requisição cancelada, partes ainda na fila nem iniciam.
+            if (settings.is_cancelled && settings.is_cancelled()) {
+                errors[i] = "requisição cancelada";
+            } else {
+                ok[i] = RunSubprocess(GhostscriptRangeCommand(input_path, parts.paths[i], settings.pdf_settings,
+                                                              ranges[i].first, ranges[i].second),
+                                      std::string(), &ignored, &errors[i], settings.is_cancelled);
+            }
+            latch.CountDown();
+        });
+        if (!submitted) {
+            errors[i] = "Pool de compressão encerrado";
+            latch.CountDown();
+        }
+    }
+    latch.Wait();
+
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        if (!ok[i]) {
+            *error = "Páginas " + std::to_string(ranges[i].first) + "-" + std::to_string(ranges[i].second) +
+                     ": " + errors[i];
+            return false;
+        }
+    }
+    return Merge(parts.paths, output_path, settings, error);
+}
+
+bool ParallelPdfCompressor::Merge(const std::vector<std::string>& parts, const std::string& output_path,
+                                  const PdfCompressSettings& settings, std::string* error) {
+    std::string ignored;
+    // qpdf copia os objetos sem reprocessar; o gs reinterpreta as partes.
+    std::vector<std::string> argv =
+        use_qpdf_ ? QpdfMergeCommand(parts, output_path) : GhostscriptMergeCommand(parts, output_path);
+    if (!RunSubprocess(argv, std::string(), &ignored, error, settings.is_cancelled)) {
+        *error = "Junção das partes: " + *error;
+        return false;
+    }
+    return true;
+}
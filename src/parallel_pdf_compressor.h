@@ -0,0 +1,59 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/pdf_compressor.h"
+#include "src/scratch_storage.h"
+#include "src/thread_pool.h"
+
+// Compressão paralela por páginas (--parallel-pdf).
+//
+// PDFs com pelo menos min_pages páginas são divididos em intervalos
+// contíguos, um processo gs por intervalo (-dFirstPage/-dLastPage) no pool
+// de workers, e as partes são juntadas na ordem (qpdf se estiver no PATH,
+// senão gs). Documentos menores, ou cuja contagem de páginas falhe, seguem
+// pelo motor de passada única.
+class ParallelPdfCompressor final : public PdfCompressor {
+public:
+    struct Options {
+        int min_pages = 32;
+        // Processos gs simultâneos, somando todas as requisições (0 = núcleos).
+        int workers = 0;
+        // Onde ficam as partes comprimidas. nullptr: ao lado de output_path
+        // (output_path + ".partN").
+        ScratchStorage* scratch = nullptr;
+    };
+
+    ParallelPdfCompressor(std::unique_ptr<PdfCompressor> single_pass, const Options& options);
+
+    bool Compress(const std::string& input_path, const std::string& output_path,
+                  const PdfCompressSettings& settings, std::string* error) override;
+    const char* Name() const override { return name_.c_str(); }
+
+    // O modo paralelo precisa do arquivo; o pipeline não é usado.
+    bool SupportsPipe() const override { return false; }
+
+    // Número de páginas de input_path (pelo leitor em processo; gs se ele não
+    // abrir o arquivo), ou -1 (com error) em caso de falha.
+    static int CountPages(const std::string& input_path, std::string* error,
+                          const std::function<bool()>& is_cancelled = nullptr);
+
+    // Divide [1, pages] em até parts intervalos contíguos de tamanho parecido.
+    static std::vector<std::pair<int, int>> SplitPages(int pages, int parts);
+
+private:
+    bool CompressParallel(const std::string& input_path, const std::string& output_path,
+                          const PdfCompressSettings& settings, int pages, std::string* error);
+    bool Merge(const std::vector<std::string>& parts, const std::string& output_path,
+               const PdfCompressSettings& settings, std::string* error);
+
+    const std::unique_ptr<PdfCompressor> single_pass_;
+    const int min_pages_;
+    const std::string name_;
+    const bool use_qpdf_;
+    ScratchStorage* const scratch_;
+    ThreadPool workers_;
+};
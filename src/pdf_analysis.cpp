@@ -0,0 +1,383 @@
+#include "src/pdf_analysis.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "src/flate.h"
+#include "src/pdf_document.h"
+
+namespace {
+
+using Type = PdfObject::Type;
+
+// Resoluções para as quais cada preset do pdfwrite reamostra imagens
+// coloridas/cinza e monocromáticas. Algumas versões do gs não reamostram em
+// /printer e /prepress; supor que sim só faz o gs rodar à toa. A qualidade
+// JPEG corresponde ao QFactor dos presets (0,76 e 0,15).
+struct NamedPreset {
+    const char* name;
+    PdfImagePreset preset;
+};
+
+constexpr NamedPreset kPresets[] = {
+    {"/screen", {72, 300, 60}},
+    {"/ebook", {150, 300, 60}},
+    {"/printer", {300, 1200, 90}},
+    {"/prepress", {300, 1200, 90}},
+};
+
+// Economia suposta para imagens sem perdas recodificadas em JPEG
+// (conservadora).
+constexpr double kLosslessSavings = 0.5;
+// Subset de uma fonte embutida completa.
+constexpr double kFontSavings = 0.5;
+// Streams sem filtro: até kSampleChunk bytes de cada um, no máximo
+// kSampleBytes no total, são comprimidos para estimar a taxa do Flate.
+constexpr size_t kSampleChunk = 4096;
+constexpr size_t kSampleBytes = 256 * 1024;
+constexpr size_t kMinUnfilteredBytes = 512;
+
+// O que o pdfwrite escreve fora de streams por página (dicionários da
+// página, dos recursos e das fontes, e a xref).
+constexpr size_t kStructureBytesPerPage = 1024;
+
+// Limites da análise rápida; acima deles quem decide é o gs.
+constexpr int kMaxObjects = 1 << 20;
+constexpr size_t kMaxContentBytes = 64 * 1024 * 1024;
+constexpr int kMaxFormDepth = 8;
+constexpr size_t kMaxOperands = 64;
+
+// Compressão de verdade (ASCIIHex e ASCII85 só aumentam o stream).
+bool Compressed(const std::vector<std::string>& filters) {
+    return std::any_of(filters.begin(), filters.end(), [](const std::string& name) {
+        return name != "ASCIIHexDecode" && name != "ASCII85Decode";
+    });
+}
+
+// Filtros com que o gs não ganha nada recodificando a imagem.
+bool LossyOrSpecialized(const std::vector<std::string>& filters) {
+    return std::any_of(filters.begin(), filters.end(), [](const std::string& name) {
+        return name == "DCTDecode" || name == "JPXDecode" || name == "JBIG2Decode" || name == "CCITTFaxDecode";
+    });
+}
+
+// Nome com prefixo de subset ("ABCDEF+Helvetica").
+bool IsSubsetName(const std::string& name) {
+    if (name.size() < 8 || name[6] != '+') {
+        return false;
+    }
+    return std::all_of(name.begin(), name.begin() + 6, [](char c) { return c >= 'A' && c <= 'Z'; });
+}
+
+// Percorre as páginas (e os Form XObjects que elas desenham) registrando a
+// maior resolução efetiva de cada imagem, e depois classifica os objetos.
+class Analyzer {
+public:
+    Analyzer(const PdfDocument& document, const PdfImagePreset& preset)
+        : document_(document), preset_(preset) {}
+
+    // false se a análise passou dos limites.
+    bool WalkPages() {
+        for (const PdfPage& page : document_.pages()) {
+            std::string content;
+            if (document_.PageContent(page, &content)) {
+                if (!Charge(content.size())) {
+                    return false;
+                }
+                Run(content, page.resources, PdfMatrix(), 0);
+            }
+            if (over_budget_) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const PdfImageResolutions& drawn() const { return drawn_; }
+
+    bool ScanObjects(PdfCompressionEstimate* estimate) {
+        // object_limit e não o /Size do trailer: numa xref reconstruída o
+        // trailer pode não ter /Size, ou ter um valor menor que o real.
+        int objects = document_.object_limit();
+        if (objects <= 0 || objects > kMaxObjects) {
+            return false;
+        }
+        std::vector<RawStream> unfiltered;
+        std::unordered_set<int> font_programs;
+        size_t stream_bytes = 0;
+        for (int num = 1; num < objects; ++num) {
+            PdfObject object = document_.GetObject(num);
+            const PdfObject* type = object.Get("Type");
+            if (type != nullptr && type->IsName("FontDescriptor")) {
+                AddFont(object, &font_programs, estimate);
+                continue;
+            }
+            if (!object.is(Type::kStream)) {
+                continue;
+            }
+            stream_bytes += object.stream_length;
+            if (type != nullptr && (type->IsName("XRef") || type->IsName("ObjStm"))) {
+                continue;
+            }
+            const PdfObject* subtype = object.Get("Subtype");
+            std::vector<std::string> filters = document_.FilterNames(object);
+            if (subtype != nullptr && subtype->IsName("Image")) {
+                AddImage(num, object, filters, estimate);
+            } else if (!Compressed(filters) && object.stream_length >= kMinUnfilteredBytes) {
+                unfiltered.push_back({num, object.stream_offset, object.stream_length});
+            }
+        }
+        unfiltered.erase(std::remove_if(unfiltered.begin(), unfiltered.end(),
+                                        [&](const RawStream& stream) { return font_programs.count(stream.num); }),
+                         unfiltered.end());
+        estimate->unfiltered_stream_savings = UnfilteredSavings(unfiltered);
+        // Object streams contam como streams: os dicionários já estão comprimidos.
+        size_t structure_bytes = document_.size() - std::min(stream_bytes, document_.size());
+        size_t baseline = document_.pages().size() * kStructureBytesPerPage;
+        estimate->structure_savings = structure_bytes > baseline ? structure_bytes - baseline : 0;
+        return true;
+    }
+
+private:
+    // Stream sem filtro: dados crus no arquivo.
+    struct RawStream {
+        int num;
+        size_t offset;
+        size_t length;
+    };
+
+    bool Charge(size_t bytes) {
+        content_bytes_ += bytes;
+        if (content_bytes_ > kMaxContentBytes) {
+            over_budget_ = true;
+        }
+        return !over_budget_;
+    }
+
+    void Run(const std::string& content, const PdfObject& resources, PdfMatrix ctm, int depth) {
+        PdfParser parser(content.data(), content.size(), 0, false);
+        std::vector<PdfMatrix> saved;
+        std::vector<PdfObject> operands;
+        PdfObject token;
+        while (!over_budget_ && parser.Next(&token)) {
+            if (!token.is(Type::kOperator)) {
+                if (operands.size() < kMaxOperands) {
+                    operands.push_back(std::move(token));
+                }
+                continue;
+            }
+            const std::string& op = token.text;
+            if (op == "q") {
+                saved.push_back(ctm);
+            } else if (op == "Q") {
+                if (!saved.empty()) {
+                    ctm = saved.back();
+                    saved.pop_back();
+                }
+            } else if (op == "cm" && operands.size() >= 6) {
+                ctm = PdfMatrixFrom(operands).Then(ctm);
+            } else if (op == "Do" && !operands.empty()) {
+                Draw(resources, operands.back(), ctm, depth);
+            } else if (op == "BI") {
+                parser.SkipInlineImage();
+            }
+            operands.clear();
+        }
+    }
+
+    void Draw(const PdfObject& resources, const PdfObject& name, const PdfMatrix& ctm, int depth) {
+        PdfObject xobjects = resources.Get("XObject") ? document_.Resolve(*resources.Get("XObject")) : PdfObject();
+        const PdfObject* entry = xobjects.Get(name.text.c_str());
+        if (entry == nullptr || !entry->is(Type::kRef)) {
+            return;
+        }
+        PdfObject xobject = document_.GetObject(entry->ref_num);
+        const PdfObject* subtype = xobject.Get("Subtype");
+        if (!xobject.is(Type::kStream) || subtype == nullptr) {
+            return;
+        }
+        if (subtype->IsName("Image")) {
+            // A imagem ocupa o quadrado unitário transformado pela CTM.
+            double width_inches = std::hypot(ctm.a, ctm.b) / 72;
+            double height_inches = std::hypot(ctm.c, ctm.d) / 72;
+            double dpi = 0;
+            if (width_inches > 1e-3 && height_inches > 1e-3) {
+                dpi = std::min(Number(xobject, "Width") / width_inches, Number(xobject, "Height") / height_inches);
+            }
+            MarkDrawn(entry->ref_num, xobject, dpi);
+            return;
+        }
+        if (!subtype->IsName("Form") || depth >= kMaxFormDepth) {
+            return;
+        }
+        std::string content, error;
+        if (!document_.DecodeStream(xobject, &content, &error) || !Charge(content.size())) {
+            return;
+        }
+        PdfObject form_resources = xobject.Get("Resources") ? document_.Resolve(*xobject.Get("Resources"))
+                                                            : resources;
+        PdfObject matrix = xobject.Get("Matrix") ? document_.Resolve(*xobject.Get("Matrix")) : PdfObject();
+        PdfMatrix form_ctm = ctm;
+        if (matrix.array && matrix.array->size() == 6) {
+            form_ctm = PdfMatrixFrom(*matrix.array).Then(ctm);
+        }
+        Run(content, form_resources, form_ctm, depth + 1);
+    }
+
+    // A máscara (/SMask, /Mask) é desenhada junto com a imagem.
+    void MarkDrawn(int num, const PdfObject& image, double dpi) {
+        double& max_dpi = drawn_[num];
+        max_dpi = std::max(max_dpi, dpi);
+        for (const char* key : {"SMask", "Mask"}) {
+            const PdfObject* mask = image.Get(key);
+            if (mask != nullptr && mask->is(Type::kRef)) {
+                double& mask_dpi = drawn_[mask->ref_num];
+                mask_dpi = std::max(mask_dpi, dpi);
+            }
+        }
+    }
+
+    double Number(const PdfObject& dict, const char* key) const {
+        const PdfObject* value = dict.Get(key);
+        return value != nullptr ? document_.Resolve(*value).AsNumber() : 0;
+    }
+
+    void AddImage(int num, const PdfObject& image, const std::vector<std::string>& filters,
+                  PdfCompressionEstimate* estimate) const {
+        ++estimate->images;
+        const double bytes = static_cast<double>(image.stream_length);
+        auto drawn = drawn_.find(num);
+        if (drawn == drawn_.end()) {
+            // Nenhuma página desenha (ou só anotações e padrões, que esta
+            // análise não percorre: errar aqui só faz o gs rodar).
+            estimate->unused_image_savings += image.stream_length;
+            return;
+        }
+        const double dpi = drawn->second;
+        estimate->max_image_dpi = std::max(estimate->max_image_dpi, dpi);
+        const PdfObject* mask = image.Get("ImageMask");
+        bool mono = (mask != nullptr && mask->boolean) || Number(image, "BitsPerComponent") == 1;
+        double target = mono ? preset_.mono_dpi : preset_.color_dpi;
+        if (dpi > target * kPdfDownsampleThreshold) {
+            double kept = (target / dpi) * (target / dpi);
+            estimate->downsample_savings += static_cast<size_t>(bytes * (1 - kept));
+        } else if (!mono && !LossyOrSpecialized(filters) &&
+                   Number(image, "Width") * Number(image, "Height") >= kPdfMinLosslessPixels) {
+            estimate->lossless_image_savings += static_cast<size_t>(bytes * kLosslessSavings);
+        }
+    }
+
+    void AddFont(const PdfObject& descriptor, std::unordered_set<int>* font_programs,
+                 PdfCompressionEstimate* estimate) const {
+        const PdfObject* name = descriptor.Get("FontName");
+        bool subset = name != nullptr && IsSubsetName(name->text);
+        for (const char* key : {"FontFile", "FontFile2", "FontFile3"}) {
+            const PdfObject* program = descriptor.Get(key);
+            if (program == nullptr || !program->is(Type::kRef)) {
+                continue;
+            }
+            font_programs->insert(program->ref_num);
+            if (!subset) {
+                PdfObject stream = document_.GetObject(program->ref_num);
+                estimate->font_savings += static_cast<size_t>(static_cast<double>(stream.stream_length) * kFontSavings);
+            }
+        }
+    }
+
+    // Economia do Flate nos streams, pela taxa de uma amostra de todos eles.
+    size_t UnfilteredSavings(const std::vector<RawStream>& streams) const {
+        size_t total = 0;
+        std::string sample;
+        for (const RawStream& stream : streams) {
+            total += stream.length;
+            if (sample.size() < kSampleBytes && stream.offset + stream.length <= document_.size()) {
+                sample.append(document_.data() + stream.offset, std::min(stream.length, kSampleChunk));
+            }
+        }
+        if (sample.empty()) {
+            return 0;
+        }
+        std::string compressed, error;
+        if (!FlateCompress(sample.data(), sample.size(), kDefaultFlateLevel, &compressed, &error)) {
+            return 0;
+        }
+        double ratio = std::min(1.0, static_cast<double>(compressed.size()) / static_cast<double>(sample.size()));
+        return static_cast<size_t>(static_cast<double>(total) * (1 - ratio));
+    }
+
+    const PdfDocument& document_;
+    const PdfImagePreset& preset_;
+    // Número do objeto de cada imagem desenhada -> maior resolução efetiva.
+    PdfImageResolutions drawn_;
+    size_t content_bytes_ = 0;
+    bool over_budget_ = false;
+};
+
+std::string Kilobytes(size_t bytes) { return std::to_string((bytes + 512) / 1024) + " KB"; }
+
+}  // namespace
+
+bool PdfCompressionEstimate::WorthCompressing(int min_savings_percent) const {
+    if (!analyzed || min_savings_percent <= 0) {
+        return true;
+    }
+    return savings_bytes() * 100 >= file_bytes * static_cast<size_t>(min_savings_percent);
+}
+
+std::string PdfCompressionEstimate::Summary() const {
+    if (!analyzed) {
+        return "PDF não analisado";
+    }
+    char percent[32];
+    std::snprintf(percent, sizeof(percent), "%.1f%%",
+                  file_bytes > 0 ? 100.0 * static_cast<double>(savings_bytes()) / static_cast<double>(file_bytes)
+                                 : 0.0);
+    return "economia estimada " + Kilobytes(savings_bytes()) + " de " + Kilobytes(file_bytes) + " (" + percent +
+           "): reamostragem " + Kilobytes(downsample_savings) + ", imagens sem perdas " +
+           Kilobytes(lossless_image_savings) + ", imagens não usadas " + Kilobytes(unused_image_savings) +
+           ", streams sem filtro " + Kilobytes(unfiltered_stream_savings) + ", fontes " + Kilobytes(font_savings) +
+           ", estrutura " + Kilobytes(structure_savings) + "; " + std::to_string(images) + " imagens, até " +
+           std::to_string(static_cast<int>(max_image_dpi)) + " dpi";
+}
+
+PdfImagePreset PdfImagePresetFor(const std::string& pdf_settings) {
+    for (const NamedPreset& candidate : kPresets) {
+        if (pdf_settings == candidate.name) {
+            return candidate.preset;
+        }
+    }
+    return kPresets[1].preset;
+}
+
+PdfCompressionEstimate EstimatePdfCompression(const char* data, size_t size, const std::string& pdf_settings,
+                                              PdfImageResolutions* resolutions) {
+    PdfDocument document(data, size);
+    std::string error;
+    if (!document.Open(&error)) {
+        PdfCompressionEstimate estimate;
+        estimate.file_bytes = size;
+        return estimate;
+    }
+    return EstimatePdfCompression(document, pdf_settings, resolutions);
+}
+
+PdfCompressionEstimate EstimatePdfCompression(const PdfDocument& document, const std::string& pdf_settings,
+                                              PdfImageResolutions* resolutions) {
+    PdfCompressionEstimate estimate;
+    estimate.file_bytes = document.size();
+    const PdfImagePreset preset = PdfImagePresetFor(pdf_settings);
+    Analyzer analyzer(document, preset);
+    PdfCompressionEstimate result = estimate;
+    if (!analyzer.WalkPages() || !analyzer.ScanObjects(&result)) {
+        return estimate;
+    }
+    result.analyzed = true;
+    if (resolutions != nullptr) {
+        *resolutions = analyzer.drawn();
+    }
+    return result;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+class PdfDocument;
+
+// Pré-análise do CompressPDF: estima, sem rodar o gs, quanto um preset do
+// pdfwrite reduziria o PDF.
+//
+// A economia vem de seis fontes, cada uma estimada a partir dos dicionários
+// e dos content streams (os dados das imagens não são lidos): imagens
+// desenhadas acima da resolução do preset (reamostradas), imagens grandes
+// com compressão sem perdas (recodificadas em JPEG), imagens que nenhuma
+// página desenha (descartadas), streams sem filtro (comprimidos com Flate; a
+// taxa vem de uma amostra), fontes embutidas sem subset e objetos fora de
+// streams além do que o gs escreve por página (árvore de tags, revisões
+// antigas de atualizações incrementais, dicionários soltos).
+// PDFs já exportados para o preset ou mais agressivos ficam perto de zero:
+// o gs só reescreveria os objetos e a saída costuma sair maior.
+struct PdfCompressionEstimate {
+    // false se o PDF não pôde ser analisado (ilegível, criptografado ou
+    // grande demais para a análise rápida): a compressão segue normalmente.
+    bool analyzed = false;
+    size_t file_bytes = 0;
+    size_t images = 0;
+    // Maior resolução efetiva (pixels por polegada na página) entre as
+    // imagens desenhadas.
+    double max_image_dpi = 0;
+
+    // Economia estimada por fonte, em bytes do arquivo.
+    size_t downsample_savings = 0;
+    size_t lossless_image_savings = 0;
+    size_t unused_image_savings = 0;
+    size_t unfiltered_stream_savings = 0;
+    size_t font_savings = 0;
+    size_t structure_savings = 0;
+
+    size_t savings_bytes() const {
+        return downsample_savings + lossless_image_savings + unused_image_savings + unfiltered_stream_savings +
+               font_savings + structure_savings;
+    }
+    // true se não foi possível analisar ou se a economia estimada chega a
+    // min_savings_percent do arquivo.
+    bool WorthCompressing(int min_savings_percent) const;
+    // Resumo para os logs.
+    std::string Summary() const;
+};
+
+// Como um preset do pdfwrite trata as imagens: resoluções-alvo (dpi) das
+// coloridas/cinza e das monocromáticas, e a qualidade JPEG (escala do libjpeg)
+// equivalente ao QFactor do preset. Presets desconhecidos valem como /ebook.
+struct PdfImagePreset {
+    double color_dpi;
+    double mono_dpi;
+    int jpeg_quality;
+};
+PdfImagePreset PdfImagePresetFor(const std::string& pdf_settings);
+
+// O pdfwrite só reamostra imagens desenhadas acima de kPdfDownsampleThreshold
+// vezes a resolução alvo, e recodifica em JPEG as coloridas/cinza sem perdas
+// a partir de kPdfMinLosslessPixels pixels.
+constexpr double kPdfDownsampleThreshold = 1.5;
+constexpr double kPdfMinLosslessPixels = 128 * 128;
+
+// Imagens desenhadas pelas páginas (e por Form XObjects e como máscara de
+// outra imagem): número do objeto -> maior resolução efetiva, em dpi.
+using PdfImageResolutions = std::unordered_map<int, double>;
+
+// Analisa data[0, size) para o preset pdf_settings ("/ebook", "/screen"...;
+// ver PdfSettingsFor); resolutions, se não for nullptr, recebe as imagens
+// desenhadas.
+PdfCompressionEstimate EstimatePdfCompression(const char* data, size_t size, const std::string& pdf_settings,
+                                              PdfImageResolutions* resolutions = nullptr);
+// A mesma análise sobre um documento já aberto.
+PdfCompressionEstimate EstimatePdfCompression(const PdfDocument& document, const std::string& pdf_settings,
+                                              PdfImageResolutions* resolutions = nullptr);
+
+// Uma análise completa de um PDF, feita uma vez pela pré-análise do
+// CompressPDF e reaproveitada pelo NativePdfCompressor (ver
+// PdfCompressSettings::analysis).
+struct PdfAnalysis {
+    PdfCompressionEstimate estimate;
+    PdfImageResolutions resolutions;
+};
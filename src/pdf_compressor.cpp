@@ -0,0 +1,68 @@
+#include "src/pdf_compressor.h"
+
+#include "src/native_pdf_compressor.h"
+#include "src/parallel_pdf_compressor.h"
+#include "src/subprocess.h"
+#include "src/tool_commands.h"
+
+#ifdef FP_HAVE_LIBGS
+#include "src/gs_instance_pool.h"
+#endif
+
+bool GhostscriptProcessCompressor::Compress(const std::string& input_path,
+                                            const std::string& output_path,
+                                            const PdfCompressSettings& settings,
+                                            std::string* error) {
+    std::string ignored;
+    return RunSubprocess(GhostscriptFileCommand(input_path, output_path, settings.pdf_settings), std::string(),
+                         &ignored, error, settings.is_cancelled);
+}
+
+bool GhostscriptProcessCompressor::CompressPipe(const std::string& input, const PdfCompressSettings& settings,
+                                                std::string* output, std::string* error) {
+    return RunSubprocess(GhostscriptPipeCommand(settings.pdf_settings), input, output, error,
+                         settings.is_cancelled);
+}
+
+namespace {
+
+std::unique_ptr<PdfCompressor> CreateSinglePassCompressor(const ServerOptions& options, std::string* error) {
+    switch (options.pdf_engine) {
+    case PdfEngineKind::kProcess:
+        return std::make_unique<GhostscriptProcessCompressor>();
+    case PdfEngineKind::kGsApi:
+#ifdef FP_HAVE_LIBGS
+        return GhostscriptInstancePool::Create(options.gs_instances, error);
+#else
+        *error = "Servidor compilado sem libgs; use --pdf-engine=process ou recompile com FP_WITH_LIBGS=ON.";
+        return nullptr;
+#endif
+    }
+    *error = "Motor de PDF desconhecido.";
+    return nullptr;
+}
+
+}  // namespace
+
+std::unique_ptr<PdfCompressor> CreatePdfCompressor(const ServerOptions& options, ScratchStorage* scratch,
+                                                   std::string* error) {
+    std::unique_ptr<PdfCompressor> compressor = CreateSinglePassCompressor(options, error);
+    if (!compressor) {
+        return nullptr;
+    }
+    if (options.parallel_pdf) {
+        ParallelPdfCompressor::Options parallel_options;
+        parallel_options.min_pages = options.parallel_pdf_min_pages;
+        parallel_options.workers = options.parallel_pdf_workers;
+        parallel_options.scratch = scratch;
+        compressor = std::make_unique<ParallelPdfCompressor>(std::move(compressor), parallel_options);
+    }
+    if (options.native_pdf_images) {
+        // PDFs em que as imagens não dominam seguem pelo motor gs montado acima.
+        NativePdfCompressor::Options native_options;
+        native_options.threads = options.native_pdf_threads;
+        native_options.filter = options.resize_filter;
+        compressor = std::make_unique<NativePdfCompressor>(std::move(compressor), native_options);
+    }
+    return compressor;
+}
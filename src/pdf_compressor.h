@@ -0,0 +1,70 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "src/scratch_storage.h"
+#include "src/server_options.h"
+
+struct PdfAnalysis;
+
+// Parâmetros de uma compressão.
+struct PdfCompressSettings {
+    // Valor de -dPDFSETTINGS ("/ebook", "/screen", ...; ver PdfSettingsFor).
+    std::string pdf_settings = "/ebook";
+    // Nível dos streams Flate escritos em processo (flate.h; 0 = padrão). O
+    // gs usa o próprio.
+    int flate_level = 0;
+    // Opcional: se passar a retornar true, a compressão é interrompida (o
+    // processo gs é morto) e Compress retorna false.
+    std::function<bool()> is_cancelled;
+    // Opcional: análise já feita do mesmo PDF com o mesmo pdf_settings (a
+    // pré-análise do CompressPDF); o NativePdfCompressor a usa em vez de
+    // analisar de novo.
+    const PdfAnalysis* analysis = nullptr;
+};
+
+// Motor de compressão de PDF usado por CompressPDF.
+// As implementações trabalham com caminhos de arquivo porque o Ghostscript
+// precisa de acesso aleatório ao PDF de entrada.
+class PdfCompressor {
+public:
+    virtual ~PdfCompressor() = default;
+
+    // Comprime input_path em output_path.
+    // Retorna false e preenche error em caso de falha ou cancelamento.
+    virtual bool Compress(const std::string& input_path, const std::string& output_path,
+                          const PdfCompressSettings& settings, std::string* error) = 0;
+
+    // Nome curto para logs ("process", "gsapi").
+    virtual const char* Name() const = 0;
+
+    // Compressão direto da memória (modo --pipeline), sem arquivos
+    // temporários. Só válido se SupportsPipe().
+    virtual bool SupportsPipe() const { return false; }
+    virtual bool CompressPipe(const std::string& /*input*/, const PdfCompressSettings& /*settings*/,
+                              std::string* /*output*/, std::string* error) {
+        *error = "Motor não suporta pipeline";
+        return false;
+    }
+};
+
+// Executa um processo gs a cada requisição.
+class GhostscriptProcessCompressor final : public PdfCompressor {
+public:
+    bool Compress(const std::string& input_path, const std::string& output_path,
+                  const PdfCompressSettings& settings, std::string* error) override;
+    const char* Name() const override { return "process"; }
+
+    // gs lendo do stdin e escrevendo no stdout.
+    bool SupportsPipe() const override { return true; }
+    bool CompressPipe(const std::string& input, const PdfCompressSettings& settings, std::string* output,
+                      std::string* error) override;
+};
+
+// Cria o motor escolhido em options. Retorna nullptr e preenche error se o
+// motor não estiver disponível neste build (ex: gsapi sem libgs). scratch
+// guarda os arquivos intermediários do modo paralelo.
+std::unique_ptr<PdfCompressor> CreatePdfCompressor(const ServerOptions& options, ScratchStorage* scratch,
+                                                   std::string* error);
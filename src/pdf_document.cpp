@@ -0,0 +1,1462 @@
+#include "src/pdf_document.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <set>
+
+#include "src/flate.h"
+
+namespace {
+
+using Type = PdfObject::Type;
+
+// Limites contra arquivos malformados ou maliciosos.
+constexpr int kMaxNesting = 100;
+constexpr int kMaxObjectNumber = 8 * 1024 * 1024;
+constexpr int kMaxResolveDepth = 16;
+constexpr size_t kMaxPages = 1 << 20;
+// Um stream decodificado maior que isso é tratado como bomba de compressão.
+constexpr size_t kMaxDecodedBytes = 256 * 1024 * 1024;
+
+bool IsWhite(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\f' || c == '\0';
+}
+
+bool IsDelimiter(char c) {
+    return c == '(' || c == ')' || c == '<' || c == '>' || c == '[' || c == ']' || c == '{' || c == '}' ||
+           c == '/' || c == '%';
+}
+
+bool IsRegular(char c) { return !IsWhite(c) && !IsDelimiter(c); }
+
+int HexValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+// Posição de needle em [data + from, data + size) ou npos.
+size_t Find(const char* data, size_t size, size_t from, const char* needle) {
+    size_t length = std::strlen(needle);
+    if (from >= size || size - from < length) {
+        return std::string::npos;
+    }
+    const char* found = static_cast<const char*>(memmem(data + from, size - from, needle, length));
+    return found == nullptr ? std::string::npos : static_cast<size_t>(found - data);
+}
+
+// "oooooooooo ggggg n" (ou f): entrada de tabela xref clássica, 18 bytes.
+bool IsXrefEntry(const char* entry) {
+    for (int i = 0; i < 17; ++i) {
+        bool digit = entry[i] >= '0' && entry[i] <= '9';
+        if (digit != (i != 10 && i != 16)) {
+            return false;
+        }
+    }
+    return entry[17] == 'n' || entry[17] == 'f';
+}
+
+// Profundidade de GetObject na thread atual: um /Length ou object stream que
+// aponta para si mesmo não pode virar recursão infinita.
+thread_local int resolve_depth = 0;
+
+struct ResolveGuard {
+    ResolveGuard() { ++resolve_depth; }
+    ~ResolveGuard() { --resolve_depth; }
+    bool exceeded() const { return resolve_depth > kMaxResolveDepth; }
+};
+
+// Filtros de stream. Cada um lê [in, in + size) e grava em out.
+
+bool ApplyPredictor(const PdfObject& parms, std::string* data, std::string* error) {
+    int predictor = parms.is(Type::kDict) && parms.Get("Predictor") ? parms.Get("Predictor")->AsInt(1) : 1;
+    if (predictor < 2) {
+        return true;
+    }
+    int colors = std::max(1, parms.Get("Colors") ? parms.Get("Colors")->AsInt(1) : 1);
+    int bits = std::max(1, parms.Get("BitsPerComponent") ? parms.Get("BitsPerComponent")->AsInt(8) : 8);
+    int columns = std::max(1, parms.Get("Columns") ? parms.Get("Columns")->AsInt(1) : 1);
+    if (colors > 32 || bits > 16 || columns > (1 << 24)) {
+        *error = "parâmetros de preditor inválidos";
+        return false;
+    }
+    size_t bpp = std::max(1, colors * bits / 8);
+    size_t row_bytes = (static_cast<size_t>(colors) * bits * columns + 7) / 8;
+
+    if (predictor == 2) {
+        // TIFF: só o caso comum de 8 bits por componente.
+        if (bits != 8) {
+            *error = "preditor TIFF com BitsPerComponent != 8 não suportado";
+            return false;
+        }
+        for (size_t row = 0; row + row_bytes <= data->size(); row += row_bytes) {
+            for (size_t i = bpp; i < row_bytes; ++i) {
+                (*data)[row + i] = static_cast<char>((*data)[row + i] + (*data)[row + i - bpp]);
+            }
+        }
+        return true;
+    }
+
+    // PNG: cada linha começa com o byte do filtro daquela linha.
+    std::string out;
+    out.reserve(data->size());
+    std::string previous(row_bytes, '\0');
+    std::string current(row_bytes, '\0');
+    for (size_t pos = 0; pos < data->size(); pos += row_bytes + 1) {
+        int filter = static_cast<uint8_t>((*data)[pos]);
+        size_t available = std::min(row_bytes, data->size() - pos - 1);
+        std::fill(current.begin(), current.end(), '\0');
+        std::memcpy(&current[0], data->data() + pos + 1, available);
+        for (size_t i = 0; i < row_bytes; ++i) {
+            int left = i >= bpp ? static_cast<uint8_t>(current[i - bpp]) : 0;
+            int up = static_cast<uint8_t>(previous[i]);
+            int up_left = i >= bpp ? static_cast<uint8_t>(previous[i - bpp]) : 0;
+            int value = static_cast<uint8_t>(current[i]);
+            switch (filter) {
+            case 1:
+                value += left;
+                break;
+            case 2:
+                value += up;
+                break;
+            case 3:
+                value += (left + up) / 2;
+                break;
+            case 4: {
+                int p = left + up - up_left;
+                int pa = std::abs(p - left), pb = std::abs(p - up), pc = std::abs(p - up_left);
+                value += (pa <= pb && pa <= pc) ? left : (pb <= pc ? up : up_left);
+                break;
+            }
+            default:
+                break;
+            }
+            current[i] = static_cast<char>(value);
+        }
+        out.append(current, 0, available);
+        std::swap(previous, current);
+    }
+    data->swap(out);
+    return true;
+}
+
+// size_hint: tamanho esperado da saída (0 = desconhecido; ver FlateDecompress).
+bool FlateDecode(const char* in, size_t size, size_t size_hint, std::string* out, std::string* error) {
+    // Caso comum, stream zlib íntegro: descompressão em buffer inteiro pelo
+    // codec (libdeflate, se compilada).
+    std::string ignored;
+    if (FlateDecompress(in, size, kMaxDecodedBytes, out, &ignored, size_hint)) {
+        return true;
+    }
+    // Incremental, tolerante: com cabeçalho zlib (ou gzip) e depois deflate
+    // cru, sem cabeçalho, que alguns geradores gravam.
+    for (int window_bits : {15 + 32, -15}) {
+        z_stream stream{};
+        if (inflateInit2(&stream, window_bits) != Z_OK) {
+            *error = "falha ao iniciar o zlib";
+            return false;
+        }
+        out->clear();
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in));
+        stream.avail_in = static_cast<uInt>(std::min<size_t>(size, UINT32_MAX));
+        char buffer[64 * 1024];
+        int result = Z_OK;
+        while (result == Z_OK) {
+            stream.next_out = reinterpret_cast<Bytef*>(buffer);
+            stream.avail_out = sizeof(buffer);
+            result = inflate(&stream, Z_NO_FLUSH);
+            out->append(buffer, sizeof(buffer) - stream.avail_out);
+            if (out->size() > kMaxDecodedBytes) {
+                inflateEnd(&stream);
+                *error = "stream descomprimido grande demais";
+                return false;
+            }
+            if (result == Z_BUF_ERROR && stream.avail_in == 0) {
+                break;  // dados truncados: fica com o que saiu
+            }
+        }
+        inflateEnd(&stream);
+        // Stream corrompido no meio ainda rende o texto anterior ao defeito.
+        if (result == Z_STREAM_END || !out->empty()) {
+            return true;
+        }
+    }
+    *error = "FlateDecode: dados corrompidos";
+    return false;
+}
+
+// Tamanho da saída do FlateDecode quando ele é o último filtro de stream:
+// o /DL (tamanho decodificado, opcional no PDF) mais o byte de filtro por
+// linha do preditor PNG. 0 se o stream não diz.
+size_t FlateSizeHint(const PdfObject& stream, const PdfObject& parms) {
+    const PdfObject* decoded = stream.Get("DL");
+    if (decoded == nullptr || decoded->AsNumber(0) <= 0) {
+        return 0;
+    }
+    size_t hint = static_cast<size_t>(std::min<double>(decoded->AsNumber(0), kMaxDecodedBytes));
+    int predictor = parms.is(Type::kDict) && parms.Get("Predictor") ? parms.Get("Predictor")->AsInt(1) : 1;
+    if (predictor >= 10) {
+        int colors = std::max(1, parms.Get("Colors") ? parms.Get("Colors")->AsInt(1) : 1);
+        int bits = std::max(1, parms.Get("BitsPerComponent") ? parms.Get("BitsPerComponent")->AsInt(8) : 8);
+        int columns = std::max(1, parms.Get("Columns") ? parms.Get("Columns")->AsInt(1) : 1);
+        size_t row_bytes = (static_cast<size_t>(colors) * bits * columns + 7) / 8;
+        hint += (hint + row_bytes - 1) / row_bytes;
+    }
+    return hint;
+}
+
+bool LzwDecode(const char* in, size_t size, const PdfObject& parms, std::string* out, std::string* error) {
+    int early_change = parms.is(Type::kDict) && parms.Get("EarlyChange") ? parms.Get("EarlyChange")->AsInt(1) : 1;
+    std::vector<std::string> table;
+    auto reset = [&table] {
+        table.resize(258);
+        for (int i = 0; i < 256; ++i) {
+            table[i].assign(1, static_cast<char>(i));
+        }
+    };
+    reset();
+    int width = 9;
+    uint32_t buffer = 0;
+    int bits = 0;
+    int previous = -1;
+    out->clear();
+    for (size_t i = 0; i < size; ++i) {
+        buffer = (buffer << 8) | static_cast<uint8_t>(in[i]);
+        bits += 8;
+        while (bits >= width) {
+            int code = static_cast<int>((buffer >> (bits - width)) & ((1u << width) - 1));
+            bits -= width;
+            if (code == 256) {
+                reset();
+                width = 9;
+                previous = -1;
+                continue;
+            }
+            if (code == 257) {
+                return true;
+            }
+            std::string entry;
+            if (code < static_cast<int>(table.size())) {
+                entry = table[code];
+            } else if (code == static_cast<int>(table.size()) && previous >= 0) {
+                entry = table[previous] + table[previous][0];
+            } else {
+                *error = "LZWDecode: código inválido";
+                return !out->empty();
+            }
+            out->append(entry);
+            if (out->size() > kMaxDecodedBytes) {
+                *error = "stream descomprimido grande demais";
+                return false;
+            }
+            if (previous >= 0 && table.size() < 4096) {
+                table.push_back(table[previous] + entry[0]);
+            }
+            previous = code;
+            // A largura cresce quando o próximo código (mais EarlyChange)
+            // já não cabe nela: com EarlyChange 1, 10 bits a partir de 511.
+            size_t next = table.size() + early_change;
+            width = next >= 2048 ? 12 : next >= 1024 ? 11 : next >= 512 ? 10 : 9;
+        }
+    }
+    return true;
+}
+
+void AsciiHexDecode(const char* in, size_t size, std::string* out) {
+    out->clear();
+    int high = -1;
+    for (size_t i = 0; i < size && in[i] != '>'; ++i) {
+        int value = HexValue(in[i]);
+        if (value < 0) {
+            continue;
+        }
+        if (high < 0) {
+            high = value;
+        } else {
+            out->push_back(static_cast<char>(high << 4 | value));
+            high = -1;
+        }
+    }
+    if (high >= 0) {
+        out->push_back(static_cast<char>(high << 4));
+    }
+}
+
+bool Ascii85Decode(const char* in, size_t size, std::string* out, std::string* error) {
+    out->clear();
+    uint32_t tuple = 0;
+    int count = 0;
+    for (size_t i = 0; i < size; ++i) {
+        char c = in[i];
+        if (c == '~') {
+            break;
+        }
+        if (IsWhite(c)) {
+            continue;
+        }
+        if (c == 'z' && count == 0) {
+            out->append(4, '\0');
+            continue;
+        }
+        if (c < '!' || c > 'u') {
+            *error = "ASCII85Decode: caractere inválido";
+            return false;
+        }
+        tuple = tuple * 85 + static_cast<uint32_t>(c - '!');
+        if (++count == 5) {
+            for (int shift = 24; shift >= 0; shift -= 8) {
+                out->push_back(static_cast<char>(tuple >> shift));
+            }
+            tuple = 0;
+            count = 0;
+        }
+    }
+    if (count > 1) {
+        // Grupo final incompleto: completa com 'u' e descarta os bytes extras.
+        for (int i = count; i < 5; ++i) {
+            tuple = tuple * 85 + 84;
+        }
+        for (int i = 0; i < count - 1; ++i) {
+            out->push_back(static_cast<char>(tuple >> (24 - 8 * i)));
+        }
+    }
+    return true;
+}
+
+void RunLengthDecode(const char* in, size_t size, std::string* out) {
+    out->clear();
+    size_t i = 0;
+    while (i < size) {
+        int length = static_cast<uint8_t>(in[i++]);
+        if (length == 128) {
+            break;
+        }
+        if (length < 128) {
+            size_t n = std::min<size_t>(length + 1, size - i);
+            out->append(in + i, n);
+            i += n;
+        } else if (i < size) {
+            out->append(257 - length, in[i++]);
+        }
+    }
+}
+
+void SetStreamEnd(const PdfObject& stream, PdfDocument::Location* location) {
+    if (location != nullptr) {
+        location->stream = true;
+        location->end = stream.stream_offset + stream.stream_length;
+    }
+}
+
+}  // namespace
+
+PdfMatrix PdfMatrixFrom(const PdfArray& values) {
+    size_t base = values.size() - 6;
+    return {values[base].AsNumber(1), values[base + 1].AsNumber(), values[base + 2].AsNumber(),
+            values[base + 3].AsNumber(1), values[base + 4].AsNumber(), values[base + 5].AsNumber()};
+}
+
+void AppendUtf8(uint32_t code_point, std::string* out) {
+    if (code_point > 0x10FFFF || (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+        code_point = 0xFFFD;
+    }
+    if (code_point < 0x80) {
+        out->push_back(static_cast<char>(code_point));
+    } else if (code_point < 0x800) {
+        out->push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else if (code_point < 0x10000) {
+        out->push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else {
+        out->push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        out->push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+}
+
+const PdfObject* PdfObject::Get(const char* key) const {
+    if (!dict) {
+        return nullptr;
+    }
+    for (const auto& entry : *dict) {
+        if (entry.first == key) {
+            return &entry.second;
+        }
+    }
+    return nullptr;
+}
+
+int PdfObject::AsInt(int fallback) const {
+    if (type != Type::kNumber || number < INT32_MIN || number > INT32_MAX) {
+        return fallback;
+    }
+    return static_cast<int>(number);
+}
+
+double PdfObject::AsNumber(double fallback) const { return type == Type::kNumber ? number : fallback; }
+
+PdfParser::PdfParser(const char* data, size_t size, size_t pos, bool references)
+    : data_(data), size_(size), pos_(pos), references_(references) {}
+
+void PdfParser::SkipWhitespace() {
+    while (pos_ < size_) {
+        char c = data_[pos_];
+        if (IsWhite(c)) {
+            ++pos_;
+        } else if (c == '%') {
+            while (pos_ < size_ && data_[pos_] != '\n' && data_[pos_] != '\r') {
+                ++pos_;
+            }
+        } else {
+            break;
+        }
+    }
+}
+
+void PdfParser::SkipInlineImage() {
+    PdfObject token;
+    while (Next(&token) && !token.IsOperator("ID")) {
+    }
+    // Um byte de espaço separa ID dos dados; EI precisa estar isolado.
+    for (size_t pos = pos_ + 1; pos + 1 < size_; ++pos) {
+        if (data_[pos] == 'E' && data_[pos + 1] == 'I' && IsWhite(data_[pos - 1]) &&
+            (pos + 2 == size_ || IsWhite(data_[pos + 2]))) {
+            pos_ = pos + 2;
+            return;
+        }
+    }
+    pos_ = size_;
+}
+
+bool PdfParser::Next(PdfObject* object) {
+    *object = PdfObject();
+    return ParseObject(object, 0);
+}
+
+bool PdfParser::ParseObject(PdfObject* object, int depth) {
+    if (depth > kMaxNesting) {
+        return false;
+    }
+    SkipWhitespace();
+    if (pos_ >= size_) {
+        return false;
+    }
+    char c = data_[pos_];
+    switch (c) {
+    case '/':
+        ParseName(object);
+        return true;
+    case '(':
+        return ParseLiteralString(object);
+    case '<':
+        if (pos_ + 1 < size_ && data_[pos_ + 1] == '<') {
+            return ParseDict(object, depth);
+        }
+        return ParseHexString(object);
+    case '[':
+        return ParseArray(object, depth);
+    case ')':
+    case '>':
+    case ']':
+    case '{':
+    case '}':
+        // Fora de contexto: devolvido como operador para quem chamou decidir.
+        object->type = Type::kOperator;
+        object->text.assign(1, c);
+        ++pos_;
+        if (c == '>' && pos_ < size_ && data_[pos_] == '>') {
+            object->text = ">>";
+            ++pos_;
+        }
+        return true;
+    default:
+        break;
+    }
+    if ((c >= '0' && c <= '9') || c == '+' || c == '-' || c == '.') {
+        return ParseNumber(object);
+    }
+    size_t start = pos_;
+    while (pos_ < size_ && IsRegular(data_[pos_])) {
+        ++pos_;
+    }
+    object->text.assign(data_ + start, pos_ - start);
+    if (object->text == "true" || object->text == "false") {
+        object->type = Type::kBool;
+        object->boolean = object->text == "true";
+        object->text.clear();
+    } else if (object->text == "null") {
+        object->type = Type::kNull;
+        object->text.clear();
+    } else {
+        object->type = Type::kOperator;
+    }
+    return true;
+}
+
+bool PdfParser::ParseNumber(PdfObject* object) {
+    bool negative = false;
+    // Alguns geradores gravam sinais repetidos ("--5"); vale o último.
+    while (pos_ < size_ && (data_[pos_] == '+' || data_[pos_] == '-')) {
+        negative = data_[pos_] == '-';
+        ++pos_;
+    }
+    double value = 0;
+    bool integer = true;
+    while (pos_ < size_ && data_[pos_] >= '0' && data_[pos_] <= '9') {
+        value = value * 10 + (data_[pos_++] - '0');
+    }
+    if (pos_ < size_ && data_[pos_] == '.') {
+        integer = false;
+        ++pos_;
+        double scale = 0.1;
+        while (pos_ < size_ && data_[pos_] >= '0' && data_[pos_] <= '9') {
+            value += (data_[pos_++] - '0') * scale;
+            scale /= 10;
+        }
+    }
+    // Lixo colado no número (ex.: "1.2.3") é descartado.
+    while (pos_ < size_ && IsRegular(data_[pos_])) {
+        ++pos_;
+    }
+    object->type = Type::kNumber;
+    object->number = negative ? -value : value;
+    if (references_ && integer && !negative) {
+        TryReference(object);
+    }
+    return true;
+}
+
+void PdfParser::TryReference(PdfObject* object) {
+    size_t saved = pos_;
+    SkipWhitespace();
+    size_t start = pos_;
+    int generation = 0;
+    while (pos_ < size_ && data_[pos_] >= '0' && data_[pos_] <= '9' && generation < 1000000) {
+        generation = generation * 10 + (data_[pos_++] - '0');
+    }
+    if (pos_ > start && pos_ < size_ && IsWhite(data_[pos_])) {
+        SkipWhitespace();
+        if (pos_ < size_ && data_[pos_] == 'R' && (pos_ + 1 >= size_ || !IsRegular(data_[pos_ + 1]))) {
+            ++pos_;
+            object->ref_num = object->AsInt();
+            object->type = Type::kRef;
+            object->ref_gen = generation;
+            return;
+        }
+    }
+    pos_ = saved;
+}
+
+bool PdfParser::ParseLiteralString(PdfObject* object) {
+    ++pos_;
+    object->type = Type::kString;
+    std::string& text = object->text;
+    int depth = 1;
+    while (pos_ < size_) {
+        char c = data_[pos_++];
+        if (c == '(') {
+            ++depth;
+        } else if (c == ')') {
+            if (--depth == 0) {
+                return true;
+            }
+        } else if (c == '\\' && pos_ < size_) {
+            c = data_[pos_++];
+            switch (c) {
+            case 'n':
+                text.push_back('\n');
+                continue;
+            case 'r':
+                text.push_back('\r');
+                continue;
+            case 't':
+                text.push_back('\t');
+                continue;
+            case 'b':
+                text.push_back('\b');
+                continue;
+            case 'f':
+                text.push_back('\f');
+                continue;
+            case '\r':
+                // Barra no fim da linha: continuação, sem quebra.
+                if (pos_ < size_ && data_[pos_] == '\n') {
+                    ++pos_;
+                }
+                continue;
+            case '\n':
+                continue;
+            default:
+                break;
+            }
+            if (c >= '0' && c <= '7') {
+                int value = c - '0';
+                for (int i = 0; i < 2 && pos_ < size_ && data_[pos_] >= '0' && data_[pos_] <= '7'; ++i) {
+                    value = value * 8 + (data_[pos_++] - '0');
+                }
+                text.push_back(static_cast<char>(value));
+                continue;
+            }
+        }
+        text.push_back(c);
+    }
+    // String sem fechamento: fica com o que foi lido.
+    return true;
+}
+
+bool PdfParser::ParseHexString(PdfObject* object) {
+    ++pos_;
+    size_t end = pos_;
+    while (end < size_ && data_[end] != '>') {
+        ++end;
+    }
+    object->type = Type::kString;
+    AsciiHexDecode(data_ + pos_, end - pos_, &object->text);
+    pos_ = std::min(end + 1, size_);
+    return true;
+}
+
+void PdfParser::ParseName(PdfObject* object) {
+    ++pos_;
+    object->type = Type::kName;
+    while (pos_ < size_ && IsRegular(data_[pos_])) {
+        char c = data_[pos_++];
+        if (c == '#' && pos_ + 1 < size_ && HexValue(data_[pos_]) >= 0 && HexValue(data_[pos_ + 1]) >= 0) {
+            c = static_cast<char>(HexValue(data_[pos_]) << 4 | HexValue(data_[pos_ + 1]));
+            pos_ += 2;
+        }
+        object->text.push_back(c);
+    }
+}
+
+bool PdfParser::ParseDict(PdfObject* object, int depth) {
+    pos_ += 2;
+    auto dict = std::make_shared<PdfDict>();
+    while (true) {
+        SkipWhitespace();
+        if (pos_ >= size_) {
+            return false;
+        }
+        if (data_[pos_] == '>') {
+            pos_ = std::min(pos_ + 2, size_);
+            break;
+        }
+        PdfObject key;
+        if (!ParseObject(&key, depth + 1)) {
+            return false;
+        }
+        if (!key.is(Type::kName)) {
+            continue;  // lixo no lugar da chave
+        }
+        SkipWhitespace();
+        PdfObject value;
+        if (pos_ < size_ && data_[pos_] == '>') {
+            // Chave sem valor no fim do dicionário.
+        } else if (!ParseObject(&value, depth + 1)) {
+            return false;
+        }
+        dict->emplace_back(std::move(key.text), std::move(value));
+    }
+    object->type = Type::kDict;
+    object->dict = std::move(dict);
+    return true;
+}
+
+bool PdfParser::ParseArray(PdfObject* object, int depth) {
+    ++pos_;
+    auto array = std::make_shared<PdfArray>();
+    while (true) {
+        SkipWhitespace();
+        if (pos_ >= size_) {
+            return false;
+        }
+        if (data_[pos_] == ']') {
+            ++pos_;
+            break;
+        }
+        PdfObject item;
+        if (!ParseObject(&item, depth + 1)) {
+            return false;
+        }
+        array->push_back(std::move(item));
+    }
+    object->type = Type::kArray;
+    object->array = std::move(array);
+    return true;
+}
+
+PdfDocument::PdfDocument(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        map_error_ = "falha ao abrir " + path + ": " + std::strerror(errno);
+        return;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        map_error_ = "falha em fstat: " + std::string(std::strerror(errno));
+    } else if (info.st_size == 0) {
+        map_error_ = "não é um PDF (arquivo vazio)";
+    } else {
+        void* mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            map_error_ = "falha em mmap: " + std::string(std::strerror(errno));
+        } else {
+            mapping_ = mapping;
+            data_ = static_cast<const char*>(mapping);
+            size_ = static_cast<size_t>(info.st_size);
+        }
+    }
+    close(fd);
+}
+
+PdfDocument::~PdfDocument() {
+    if (mapping_ != nullptr) {
+        munmap(mapping_, size_);
+    }
+}
+
+bool PdfDocument::Open(std::string* error) {
+    if (data_ == nullptr && !map_error_.empty()) {
+        *error = map_error_;
+        return false;
+    }
+    if (Find(data_, std::min<size_t>(size_, 1024), 0, "%PDF-") == std::string::npos) {
+        *error = "não é um PDF (cabeçalho %PDF- ausente)";
+        return false;
+    }
+    // startxref fica no fim do arquivo; lixo depois do %%EOF é comum.
+    size_t tail = size_ > 4096 ? size_ - 4096 : 0;
+    size_t startxref = std::string::npos;
+    for (size_t pos = Find(data_, size_, tail, "startxref"); pos != std::string::npos;
+         pos = Find(data_, size_, pos + 1, "startxref")) {
+        startxref = pos;
+    }
+    bool loaded = false;
+    if (startxref != std::string::npos) {
+        PdfParser parser(data_, size_, startxref + 9, false);
+        PdfObject offset;
+        if (parser.Next(&offset) && offset.is(PdfObject::Type::kNumber) && offset.number >= 0) {
+            loaded = ReadXref(static_cast<size_t>(offset.number));
+        }
+    }
+    auto root_ok = [this] {
+        const PdfObject* root = trailer_.Get("Root");
+        return root != nullptr && Resolve(*root).Get("Pages") != nullptr;
+    };
+    if (!loaded || !root_ok()) {
+        if (!Reconstruct() || !root_ok()) {
+            *error = "PDF corrompido: catálogo (/Root) não encontrado";
+            return false;
+        }
+    }
+    if (trailer_.Get("Encrypt") != nullptr) {
+        *error = "PDF criptografado não suportado";
+        return false;
+    }
+    return true;
+}
+
+PdfDocument::XrefEntry* PdfDocument::EntryFor(int num) {
+    if (num < 0 || num > kMaxObjectNumber) {
+        return nullptr;
+    }
+    if (static_cast<size_t>(num) >= xref_.size()) {
+        xref_.resize(num + 1);
+    }
+    return &xref_[num];
+}
+
+bool PdfDocument::ReadXref(size_t offset) {
+    // Cada seção aponta para a anterior (/Prev); a mais nova vem primeiro e
+    // prevalece na consulta.
+    std::set<size_t> visited;
+    while (offset < size_ && visited.size() < 64 && visited.insert(offset).second) {
+        PdfParser parser(data_, size_, offset, false);
+        parser.SkipWhitespace();
+        PdfObject trailer;
+        auto section = std::make_unique<XrefSection>();
+        if (Find(data_, std::min(size_, parser.pos() + 4), parser.pos(), "xref") == parser.pos()) {
+            parser.set_pos(parser.pos() + 4);
+            if (!ReadXrefTable(&parser, section.get())) {
+                return !sections_.empty();
+            }
+            // O trailer tem referências (/Root N G R), a tabela não.
+            PdfParser trailer_parser(data_, size_, parser.pos());
+            if (!trailer_parser.Next(&trailer) || !trailer.is(PdfObject::Type::kDict)) {
+                return !sections_.empty();
+            }
+            sections_.push_back(std::move(section));
+            // Arquivo híbrido: a xref stream complementa a tabela e é
+            // consultada antes da seção anterior.
+            const PdfObject* hybrid = trailer.Get("XRefStm");
+            PdfObject stream;
+            auto extra = std::make_unique<XrefSection>();
+            if (hybrid != nullptr && hybrid->number > 0 &&
+                ParseIndirectAt(static_cast<size_t>(hybrid->number), -1, &stream) &&
+                ReadXrefStream(stream, extra.get())) {
+                sections_.push_back(std::move(extra));
+            }
+        } else {
+            if (!ParseIndirectAt(offset, -1, &trailer) || !ReadXrefStream(trailer, section.get())) {
+                return !sections_.empty();
+            }
+            sections_.push_back(std::move(section));
+        }
+        MergeTrailer(trailer);
+        const PdfObject* prev = trailer.Get("Prev");
+        if (prev == nullptr || prev->AsNumber(-1) < 0) {
+            break;
+        }
+        offset = static_cast<size_t>(prev->number);
+    }
+    return !sections_.empty();
+}
+
+bool PdfDocument::ReadXrefTable(PdfParser* parser, XrefSection* section) {
+    // Subseções "primeiro quantidade" seguidas de entradas de tamanho fixo
+    // "oooooooooo ggggg n" mais fim de linha, até a palavra trailer. As
+    // entradas não são lidas: só o tamanho da primeira, para pular a subseção.
+    while (true) {
+        PdfObject first, count;
+        if (!parser->Next(&first)) {
+            return false;
+        }
+        if (first.IsOperator("trailer")) {
+            return true;
+        }
+        if (!first.is(PdfObject::Type::kNumber) || !parser->Next(&count) || !count.is(PdfObject::Type::kNumber)) {
+            return false;
+        }
+        int start = first.AsInt(-1);
+        int entries = count.AsInt(-1);
+        if (start < 0 || entries < 0 || entries > kMaxObjectNumber || start > kMaxObjectNumber - entries) {
+            return false;
+        }
+        if (entries == 0) {
+            continue;
+        }
+        parser->SkipWhitespace();
+        size_t pos = parser->pos();
+        if (pos + 18 > size_) {
+            return false;
+        }
+        size_t end = pos + 18;
+        while (end < size_ && end < pos + 20 && IsWhite(data_[end])) {
+            ++end;
+        }
+        size_t entry_size = end - pos;
+        if (entry_size < 19 || static_cast<size_t>(entries) > (size_ - pos) / entry_size || !IsXrefEntry(data_ + pos)) {
+            return false;  // fora do formato fixo: a xref é reconstruída
+        }
+        section->ranges.push_back({start, entries, pos, entry_size});
+        parser->set_pos(pos + entries * entry_size);
+    }
+}
+
+bool PdfDocument::ReadXrefStream(const PdfObject& stream, XrefSection* section) const {
+    if (!stream.is(PdfObject::Type::kStream) || !stream.Get("Type") || !stream.Get("Type")->IsName("XRef")) {
+        return false;
+    }
+    const PdfObject* w = stream.Get("W");
+    if (w == nullptr || !w->array || w->array->size() < 3) {
+        return false;
+    }
+    size_t entry_size = 0;
+    for (int i = 0; i < 3; ++i) {
+        section->widths[i] = (*w->array)[i].AsInt(-1);
+        if (section->widths[i] < 0 || section->widths[i] > 8) {
+            return false;
+        }
+        entry_size += section->widths[i];
+    }
+    if (entry_size == 0) {
+        return false;
+    }
+    std::vector<int> index;
+    const PdfObject* index_object = stream.Get("Index");
+    if (index_object != nullptr && index_object->array) {
+        for (const PdfObject& value : *index_object->array) {
+            index.push_back(value.AsInt(-1));
+        }
+    } else {
+        index = {0, stream.Get("Size") ? stream.Get("Size")->AsInt(0) : 0};
+    }
+    size_t start = 0;
+    for (size_t i = 0; i + 1 < index.size(); i += 2) {
+        int first = index[i];
+        int count = index[i + 1];
+        if (first < 0 || count < 0 || count > kMaxObjectNumber || first > kMaxObjectNumber - count) {
+            return false;
+        }
+        section->ranges.push_back({first, count, start, entry_size});
+        start += count;
+    }
+    section->compressed = true;
+    section->stream = stream;
+    return true;
+}
+
+bool PdfDocument::ReadEntry(XrefSection* section, const XrefSection::Range& range, int num,
+                            XrefEntry* entry) const {
+    size_t i = static_cast<size_t>(num - range.first);
+    if (!section->compressed) {
+        // Largura fixa: 10 dígitos de offset, espaço, 5 de geração, espaço, n|f.
+        size_t pos = range.start + i * range.entry_size;
+        if (pos + 18 > size_ || data_[pos + 17] != 'n') {
+            return false;
+        }
+        uint64_t offset = 0;
+        for (size_t k = 0; k < 10; ++k) {
+            char c = data_[pos + k];
+            if (c < '0' || c > '9') {
+                return false;
+            }
+            offset = offset * 10 + static_cast<uint64_t>(c - '0');
+        }
+        entry->type = 1;
+        entry->offset = offset;
+        entry->index = 0;
+        return offset > 0;
+    }
+
+    std::call_once(section->decode_once, [this, section] {
+        std::string error;
+        if (!DecodeStream(section->stream, &section->data, &error)) {
+            section->data.clear();
+        }
+    });
+    size_t pos = (range.start + i) * range.entry_size;
+    if (pos + range.entry_size > section->data.size()) {
+        return false;
+    }
+    auto field = [&](int width, uint64_t fallback) {
+        if (width == 0) {
+            return fallback;
+        }
+        uint64_t value = 0;
+        for (int k = 0; k < width; ++k) {
+            value = value << 8 | static_cast<uint8_t>(section->data[pos++]);
+        }
+        return value;
+    };
+    uint64_t type = field(section->widths[0], 1);
+    uint64_t second = field(section->widths[1], 0);
+    uint64_t third = field(section->widths[2], 0);
+    if (type != 1 && type != 2) {
+        return false;
+    }
+    entry->type = static_cast<uint8_t>(type);
+    entry->offset = second;
+    entry->index = static_cast<uint32_t>(third);
+    return true;
+}
+
+bool PdfDocument::FindEntry(int num, XrefEntry* entry) const {
+    if (num <= 0 || num > kMaxObjectNumber) {
+        return false;
+    }
+    if (sections_.empty()) {
+        if (static_cast<size_t>(num) >= xref_.size() || xref_[num].type == 0) {
+            return false;
+        }
+        *entry = xref_[num];
+        return true;
+    }
+    // Entradas livres não encerram a busca: em arquivos híbridos a tabela
+    // marca como livres os objetos que estão na xref stream.
+    for (const auto& section : sections_) {
+        for (const XrefSection::Range& range : section->ranges) {
+            if (num >= range.first && num - range.first < range.count) {
+                if (ReadEntry(section.get(), range, num, entry)) {
+                    return true;
+                }
+                break;
+            }
+        }
+    }
+    return false;
+}
+
+void PdfDocument::MergeTrailer(const PdfObject& trailer) {
+    if (!trailer.dict) {
+        return;
+    }
+    auto merged = trailer_.dict ? std::make_shared<PdfDict>(*trailer_.dict) : std::make_shared<PdfDict>();
+    for (const auto& entry : *trailer.dict) {
+        if (trailer_.Get(entry.first.c_str()) == nullptr) {
+            merged->push_back(entry);
+        }
+    }
+    trailer_.type = PdfObject::Type::kDict;
+    trailer_.dict = std::move(merged);
+}
+
+bool PdfDocument::Reconstruct() {
+    // Sem seções, as consultas passam a usar xref_.
+    sections_.clear();
+    xref_.clear();
+    trailer_ = PdfObject();
+    // "N G obj" em qualquer ponto do arquivo; ocorrências posteriores
+    // (atualizações incrementais) substituem as anteriores.
+    std::vector<int> numbers;
+    for (size_t pos = Find(data_, size_, 0, "obj"); pos != std::string::npos;
+         pos = Find(data_, size_, pos + 3, "obj")) {
+        if (pos + 3 < size_ && IsRegular(data_[pos + 3])) {
+            continue;
+        }
+        size_t p = pos;
+        auto skip_white_back = [&] {
+            size_t start = p;
+            while (p > 0 && IsWhite(data_[p - 1])) {
+                --p;
+            }
+            return p < start;
+        };
+        auto digits_back = [&] {
+            size_t end = p;
+            while (p > 0 && data_[p - 1] >= '0' && data_[p - 1] <= '9') {
+                --p;
+            }
+            return p < end && end - p <= 10;
+        };
+        if (!skip_white_back() || !digits_back() || !skip_white_back() || !digits_back()) {
+            continue;
+        }
+        if (p > 0 && IsRegular(data_[p - 1])) {
+            continue;
+        }
+        int num = std::atoi(data_ + p);
+        XrefEntry* entry = EntryFor(num);
+        if (entry != nullptr) {
+            entry->type = 1;
+            entry->offset = p;
+            numbers.push_back(num);
+        }
+    }
+
+    // Trailers de tabelas clássicas, do mais novo para o mais antigo.
+    std::vector<size_t> trailers;
+    for (size_t pos = Find(data_, size_, 0, "trailer"); pos != std::string::npos;
+         pos = Find(data_, size_, pos + 7, "trailer")) {
+        trailers.push_back(pos + 7);
+    }
+    for (auto it = trailers.rbegin(); it != trailers.rend(); ++it) {
+        PdfParser parser(data_, size_, *it);
+        PdfObject trailer;
+        if (parser.Next(&trailer) && trailer.is(PdfObject::Type::kDict)) {
+            MergeTrailer(trailer);
+        }
+    }
+
+    // Xref streams fazem o papel de trailer e localizam os objetos que estão
+    // dentro de object streams; sem /Root em lugar nenhum, vale o catálogo.
+    std::sort(numbers.begin(), numbers.end());
+    numbers.erase(std::unique(numbers.begin(), numbers.end()), numbers.end());
+    int catalog = 0;
+    std::vector<XrefEntry> compressed;
+    for (int num : numbers) {
+        PdfObject object = GetObject(num);
+        const PdfObject* type = object.Get("Type");
+        if (type == nullptr) {
+            continue;
+        }
+        if (type->IsName("XRef")) {
+            MergeTrailer(object);
+            XrefSection section;
+            if (!ReadXrefStream(object, &section)) {
+                continue;
+            }
+            for (const XrefSection::Range& range : section.ranges) {
+                for (int i = 0; i < range.count; ++i) {
+                    XrefEntry entry;
+                    size_t target = static_cast<size_t>(range.first) + i;
+                    if (!ReadEntry(&section, range, range.first + i, &entry)) {
+                        if (section.data.empty()) {
+                            break;  // stream ilegível
+                        }
+                        continue;
+                    }
+                    if (entry.type != 2) {
+                        continue;
+                    }
+                    compressed.resize(std::max(compressed.size(), target + 1));
+                    if (compressed[target].type == 0) {
+                        compressed[target] = entry;
+                    }
+                }
+            }
+        } else if (type->IsName("Catalog")) {
+            catalog = num;
+        }
+    }
+    for (size_t i = 0; i < compressed.size(); ++i) {
+        if (compressed[i].type == 2 && (i >= xref_.size() || xref_[i].type == 0)) {
+            *EntryFor(static_cast<int>(i)) = compressed[i];
+        }
+    }
+    if (trailer_.Get("Root") == nullptr && catalog > 0) {
+        PdfObject root;
+        root.type = PdfObject::Type::kRef;
+        root.ref_num = catalog;
+        PdfObject dict;
+        dict.type = PdfObject::Type::kDict;
+        dict.dict = std::make_shared<PdfDict>(PdfDict{{"Root", root}});
+        MergeTrailer(dict);
+    }
+    return !xref_.empty();
+}
+
+int PdfDocument::page_count() const {
+    PdfObject root = Resolve(*trailer_.Get("Root"));
+    const PdfObject* tree = root.Get("Pages");
+    if (tree != nullptr) {
+        // Guardado: com /Pages direto, Resolve devolve uma cópia.
+        PdfObject pages_root = Resolve(*tree);
+        const PdfObject* count = pages_root.Get("Count");
+        if (count != nullptr && count->is(PdfObject::Type::kNumber) && count->number >= 0 &&
+            count->number <= static_cast<double>(kMaxPages)) {
+            return count->AsInt();
+        }
+    }
+    return static_cast<int>(pages().size());
+}
+
+const std::vector<PdfPage>& PdfDocument::pages() const {
+    std::call_once(pages_once_, [this] { LoadPages(); });
+    return pages_;
+}
+
+void PdfDocument::LoadPages() const {
+    PdfObject root = Resolve(*trailer_.Get("Root"));
+    const PdfObject* tree = root.Get("Pages");
+    if (tree == nullptr) {
+        return;
+    }
+    // Busca em profundidade preservando a ordem dos /Kids; /Resources é herdado.
+    struct Node {
+        PdfObject object;
+        PdfObject resources;
+    };
+    std::vector<Node> stack{{*tree, PdfObject()}};
+    std::set<int> visited;
+    while (!stack.empty() && pages_.size() < kMaxPages) {
+        Node node = std::move(stack.back());
+        stack.pop_back();
+        if (node.object.is(PdfObject::Type::kRef) && !visited.insert(node.object.ref_num).second) {
+            continue;  // ciclo na árvore
+        }
+        PdfObject dict = Resolve(node.object);
+        if (!dict.dict) {
+            continue;
+        }
+        const PdfObject* own = dict.Get("Resources");
+        PdfObject resources = own != nullptr ? Resolve(*own) : node.resources;
+        const PdfObject* kids = dict.Get("Kids");
+        const PdfObject* type = dict.Get("Type");
+        if (kids != nullptr && (type == nullptr || !type->IsName("Page"))) {
+            PdfObject kid_array = Resolve(*kids);
+            if (kid_array.array) {
+                for (auto it = kid_array.array->rbegin(); it != kid_array.array->rend(); ++it) {
+                    stack.push_back({*it, resources});
+                }
+            }
+            continue;
+        }
+        pages_.push_back({std::move(dict), std::move(resources)});
+    }
+}
+
+bool PdfDocument::ParseIndirectAt(size_t offset, int expected_num, PdfObject* object, Location* location) const {
+    if (offset >= size_) {
+        return false;
+    }
+    PdfParser parser(data_, size_, offset, false);
+    PdfObject num, generation, keyword;
+    if (!parser.Next(&num) || !num.is(PdfObject::Type::kNumber) || !parser.Next(&generation) ||
+        !generation.is(PdfObject::Type::kNumber) || !parser.Next(&keyword) || !keyword.IsOperator("obj")) {
+        return false;
+    }
+    if (expected_num >= 0 && num.AsInt() != expected_num) {
+        return false;
+    }
+    PdfParser body(data_, size_, parser.pos());
+    if (!body.Next(object)) {
+        return false;
+    }
+    if (location != nullptr) {
+        location->in_file = true;
+        location->generation = generation.AsInt();
+        location->begin = offset;
+        location->end = body.pos();
+    }
+    if (!object->is(PdfObject::Type::kDict)) {
+        return true;
+    }
+    PdfObject next;
+    size_t after_dict = body.pos();
+    if (!body.Next(&next) || !next.IsOperator("stream")) {
+        body.set_pos(after_dict);
+        return true;
+    }
+
+    // "stream" é seguido de CRLF ou LF (às vezes só CR) antes dos dados.
+    size_t start = body.pos();
+    if (start < size_ && data_[start] == '\r') {
+        ++start;
+    }
+    if (start < size_ && data_[start] == '\n') {
+        ++start;
+    }
+    object->type = PdfObject::Type::kStream;
+    object->stream_offset = start;
+
+    double length = -1;
+    const PdfObject* length_object = object->Get("Length");
+    if (length_object != nullptr) {
+        length = length_object->is(PdfObject::Type::kRef) && length_object->ref_num != num.AsInt()
+                     ? GetObject(length_object->ref_num).AsNumber(-1)
+                     : length_object->AsNumber(-1);
+    }
+    if (length >= 0 && start + static_cast<size_t>(length) <= size_) {
+        PdfParser check(data_, size_, start + static_cast<size_t>(length), false);
+        PdfObject end;
+        if (check.Next(&end) && end.IsOperator("endstream")) {
+            object->stream_length = static_cast<size_t>(length);
+            SetStreamEnd(*object, location);
+            return true;
+        }
+    }
+    // /Length ausente ou errado: vale a posição do endstream.
+    size_t end = Find(data_, size_, start, "endstream");
+    if (end == std::string::npos) {
+        end = size_;
+    } else if (end > start && data_[end - 1] == '\n') {
+        --end;
+        if (end > start && data_[end - 1] == '\r') {
+            --end;
+        }
+    } else if (end > start && data_[end - 1] == '\r') {
+        --end;
+    }
+    object->stream_length = end - start;
+    SetStreamEnd(*object, location);
+    return true;
+}
+
+PdfObject PdfDocument::GetObject(int num) const {
+    ResolveGuard guard;
+    XrefEntry entry;
+    if (guard.exceeded() || !FindEntry(num, &entry)) {
+        return PdfObject();
+    }
+    PdfObject object;
+    if (entry.type == 1) {
+        if (!ParseIndirectAt(entry.offset, num, &object)) {
+            return PdfObject();
+        }
+        return object;
+    }
+    if (entry.type == 2 && entry.offset <= static_cast<uint64_t>(kMaxObjectNumber)) {
+        std::shared_ptr<const ObjectStream> container = LoadObjectStream(static_cast<int>(entry.offset));
+        if (container) {
+            auto it = container->offsets.find(num);
+            if (it != container->offsets.end()) {
+                PdfParser parser(container->data.data(), container->data.size(), it->second);
+                if (parser.Next(&object)) {
+                    return object;
+                }
+            }
+        }
+    }
+    return PdfObject();
+}
+
+bool PdfDocument::Locate(int num, Location* location, PdfObject* object) const {
+    XrefEntry entry;
+    if (!FindEntry(num, &entry)) {
+        return false;
+    }
+    *location = Location();
+    if (entry.type == 2) {
+        if (entry.offset > static_cast<uint64_t>(kMaxObjectNumber)) {
+            return false;
+        }
+        location->object_stream = static_cast<int>(entry.offset);
+        location->index = static_cast<int>(entry.index);
+        return true;
+    }
+    PdfObject parsed;
+    if (entry.type != 1 || !ParseIndirectAt(entry.offset, num, object != nullptr ? object : &parsed, location)) {
+        return false;
+    }
+    return true;
+}
+
+int PdfDocument::object_limit() const {
+    const PdfObject* size = trailer_.Get("Size");
+    int limit = size != nullptr ? size->AsInt(0) : 0;
+    if (sections_.empty()) {
+        limit = std::max(limit, static_cast<int>(xref_.size()));
+    }
+    return std::min(std::max(limit, 0), kMaxObjectNumber + 1);
+}
+
+bool PdfDocument::PageContent(const PdfPage& page, std::string* out) const {
+    const PdfObject* contents = page.dict.Get("Contents");
+    if (contents == nullptr) {
+        return false;
+    }
+    PdfObject resolved = Resolve(*contents);
+    std::vector<PdfObject> streams;
+    if (resolved.array) {
+        for (const PdfObject& item : *resolved.array) {
+            streams.push_back(Resolve(item));
+        }
+    } else {
+        streams.push_back(std::move(resolved));
+    }
+    // Os streams podem ser divididos entre dois tokens: a quebra de linha
+    // entre eles mantém os tokens separados.
+    bool any = false;
+    for (const PdfObject& stream : streams) {
+        std::string data, error;
+        if (DecodeStream(stream, &data, &error)) {
+            out->append(data);
+            out->push_back('\n');
+            any = true;
+        }
+    }
+    return any;
+}
+
+PdfObject PdfDocument::Resolve(const PdfObject& object) const {
+    if (!object.is(PdfObject::Type::kRef)) {
+        return object;
+    }
+    return GetObject(object.ref_num);
+}
+
+std::shared_ptr<const PdfDocument::ObjectStream> PdfDocument::LoadObjectStream(int num) const {
+    {
+        std::lock_guard<std::mutex> lock(object_streams_mutex_);
+        auto it = object_streams_.find(num);
+        if (it != object_streams_.end()) {
+            return it->second;
+        }
+    }
+    // Descomprimido fora do lock; se duas threads chegarem juntas, a segunda
+    // cópia é descartada.
+    PdfObject stream = GetObject(num);
+    auto container = std::make_shared<ObjectStream>();
+    std::string error;
+    if (!stream.is(PdfObject::Type::kStream) || !DecodeStream(stream, &container->data, &error)) {
+        return nullptr;
+    }
+    int count = stream.Get("N") ? stream.Get("N")->AsInt(0) : 0;
+    int first = stream.Get("First") ? stream.Get("First")->AsInt(0) : 0;
+    if (first < 0 || static_cast<size_t>(first) > container->data.size()) {
+        return nullptr;
+    }
+    PdfParser header(container->data.data(), static_cast<size_t>(first), 0, false);
+    for (int i = 0; i < count; ++i) {
+        PdfObject object_num, offset;
+        if (!header.Next(&object_num) || !header.Next(&offset) || offset.AsNumber(-1) < 0) {
+            break;
+        }
+        container->offsets.emplace(object_num.AsInt(), first + static_cast<size_t>(offset.number));
+    }
+    std::lock_guard<std::mutex> lock(object_streams_mutex_);
+    return object_streams_.emplace(num, std::move(container)).first->second;
+}
+
+std::vector<PdfObject> PdfDocument::ResolveList(const PdfObject* value) const {
+    std::vector<PdfObject> list;
+    if (value == nullptr) {
+        return list;
+    }
+    PdfObject resolved = Resolve(*value);
+    if (resolved.array) {
+        for (const PdfObject& item : *resolved.array) {
+            list.push_back(Resolve(item));
+        }
+    } else {
+        list.push_back(std::move(resolved));
+    }
+    return list;
+}
+
+std::vector<std::string> PdfDocument::FilterNames(const PdfObject& stream) const {
+    std::vector<std::string> names;
+    for (const PdfObject& filter : ResolveList(stream.Get("Filter"))) {
+        // Um item que não é nome vira "", filtro desconhecido como em DecodeStream.
+        names.push_back(filter.is(PdfObject::Type::kName) ? filter.text : std::string());
+    }
+    return names;
+}
+
+bool PdfDocument::DecodeStream(const PdfObject& stream, std::string* out, std::string* error) const {
+    if (!stream.is(PdfObject::Type::kStream) || stream.stream_offset + stream.stream_length > size_) {
+        *error = "stream inválido";
+        return false;
+    }
+    std::vector<PdfObject> filters = ResolveList(stream.Get("Filter"));
+    std::vector<PdfObject> parms = ResolveList(stream.Get("DecodeParms"));
+
+    const char* in = data_ + stream.stream_offset;
+    size_t size = stream.stream_length;
+    std::string current;
+    for (size_t i = 0; i < filters.size(); ++i) {
+        const std::string& name = filters[i].text;
+        const PdfObject& parm = i < parms.size() ? parms[i] : PdfObject();
+        std::string next;
+        if (name == "FlateDecode" || name == "Fl") {
+            size_t hint = i + 1 == filters.size() ? FlateSizeHint(stream, parm) : 0;
+            if (!FlateDecode(in, size, hint, &next, error) || !ApplyPredictor(parm, &next, error)) {
+                return false;
+            }
+        } else if (name == "LZWDecode" || name == "LZW") {
+            if (!LzwDecode(in, size, parm, &next, error) || !ApplyPredictor(parm, &next, error)) {
+                return false;
+            }
+        } else if (name == "ASCIIHexDecode" || name == "AHx") {
+            AsciiHexDecode(in, size, &next);
+        } else if (name == "ASCII85Decode" || name == "A85") {
+            if (!Ascii85Decode(in, size, &next, error)) {
+                return false;
+            }
+        } else if (name == "RunLengthDecode" || name == "RL") {
+            RunLengthDecode(in, size, &next);
+        } else if (name == "Crypt") {
+            continue;  // /Identity: sem criptografia (documentos cifrados já foram recusados)
+        } else {
+            *error = "filtro não suportado: " + name;
+            return false;
+        }
+        current.swap(next);
+        in = current.data();
+        size = current.size();
+    }
+    if (filters.empty()) {
+        out->assign(in, size);
+    } else {
+        out->swap(current);
+    }
+    return true;
+}
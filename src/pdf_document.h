@@ -0,0 +1,257 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Leitor de PDF em processo: objetos, tabela xref (clássica, xref stream e
+// object streams), árvore de páginas e filtros de stream. Cobre o que a
+// extração de texto e a análise de imagens precisam; não renderiza PDFs, e
+// quem os reescreve copia os objetos a partir de Locate.
+
+struct PdfObject;
+using PdfArray = std::vector<PdfObject>;
+// Dicionários de PDF são pequenos: busca linear, na ordem do arquivo.
+using PdfDict = std::vector<std::pair<std::string, PdfObject>>;
+
+struct PdfObject {
+    enum class Type { kNull, kBool, kNumber, kString, kName, kArray, kDict, kStream, kRef, kOperator };
+
+    Type type = Type::kNull;
+    bool boolean = false;
+    double number = 0;
+    // kString (bytes, já sem escapes), kName (sem a barra) e kOperator.
+    std::string text;
+    // kRef.
+    int ref_num = 0;
+    int ref_gen = 0;
+    // Compartilhados entre cópias (objetos são imutáveis depois de lidos).
+    std::shared_ptr<const PdfArray> array;
+    // kDict e kStream.
+    std::shared_ptr<const PdfDict> dict;
+    // kStream: dados brutos (ainda com filtros) no buffer do documento.
+    size_t stream_offset = 0;
+    size_t stream_length = 0;
+
+    bool is(Type t) const { return type == t; }
+    bool IsName(const char* name) const { return type == Type::kName && text == name; }
+    bool IsOperator(const char* name) const { return type == Type::kOperator && text == name; }
+    // Valor de key em dicionários e streams (nullptr se não há).
+    const PdfObject* Get(const char* key) const;
+    int AsInt(int fallback = 0) const;
+    double AsNumber(double fallback = 0) const;
+};
+
+// Lê objetos em sequência de um buffer. Em content streams e CMaps
+// (references = false) palavras desconhecidas viram kOperator e "N G R" não
+// é tratado como referência.
+class PdfParser {
+public:
+    PdfParser(const char* data, size_t size, size_t pos = 0, bool references = true);
+
+    // Próximo objeto ou operador; false no fim dos dados ou em erro de sintaxe.
+    bool Next(PdfObject* object);
+
+    size_t pos() const { return pos_; }
+    void set_pos(size_t pos) { pos_ = pos; }
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    // Pula espaços e comentários.
+    void SkipWhitespace();
+    // Logo depois do operador BI: pula os parâmetros, o ID e os dados
+    // binários da imagem inline até o EI.
+    void SkipInlineImage();
+
+private:
+    bool ParseObject(PdfObject* object, int depth);
+    bool ParseNumber(PdfObject* object);
+    bool ParseLiteralString(PdfObject* object);
+    bool ParseHexString(PdfObject* object);
+    void ParseName(PdfObject* object);
+    bool ParseDict(PdfObject* object, int depth);
+    bool ParseArray(PdfObject* object, int depth);
+    // Depois de um inteiro, tenta "G R"; volta a posição se não for.
+    void TryReference(PdfObject* object);
+
+    const char* data_;
+    size_t size_;
+    size_t pos_;
+    const bool references_;
+};
+
+// Matriz de transformação [a b c d e f] de PDF.
+struct PdfMatrix {
+    double a = 1, b = 0, c = 0, d = 1, e = 0, f = 0;
+
+    // this seguida de other.
+    PdfMatrix Then(const PdfMatrix& other) const {
+        return {a * other.a + b * other.c,
+                a * other.b + b * other.d,
+                c * other.a + d * other.c,
+                c * other.b + d * other.d,
+                e * other.a + f * other.c + other.e,
+                e * other.b + f * other.d + other.f};
+    }
+};
+
+// Matriz dos seis últimos números de values (operandos de cm/Tm ou /Matrix);
+// values precisa ter pelo menos seis itens.
+PdfMatrix PdfMatrixFrom(const PdfArray& values);
+
+struct PdfPage {
+    PdfObject dict;
+    // /Resources da página ou herdado de um nó Pages (resolvido).
+    PdfObject resources;
+};
+
+// Documento sobre um buffer em memória (sem cópia: data precisa continuar
+// válido enquanto o documento existir) ou sobre um arquivo mapeado com mmap.
+//
+// Open lê só o trailer e os cabeçalhos das seções da xref. Entradas da xref,
+// xref streams, object streams e a árvore de páginas são lidos na primeira
+// consulta, então contar páginas de um arquivo de centenas de MB toca poucas
+// páginas do mapeamento. Depois de Open, os métodos const são thread-safe
+// (várias páginas podem ser lidas em paralelo).
+class PdfDocument {
+public:
+    PdfDocument(const char* data, size_t size) : data_(data), size_(size) {}
+    // Mapeia path somente leitura; erro ao abrir ou mapear aparece em Open.
+    explicit PdfDocument(const std::string& path);
+    ~PdfDocument();
+
+    PdfDocument(const PdfDocument&) = delete;
+    PdfDocument& operator=(const PdfDocument&) = delete;
+
+    // Lê o trailer e localiza a xref (reconstruída por varredura do arquivo
+    // se estiver quebrada). Retorna false e preenche error se o arquivo não é
+    // um PDF legível ou está criptografado.
+    bool Open(std::string* error);
+
+    // Total de páginas pelo /Count da raiz da árvore, sem percorrê-la (a
+    // árvore só é lida se o /Count estiver ausente ou inválido).
+    int page_count() const;
+    // Todas as páginas, em ordem (a árvore é percorrida na primeira chamada).
+    const std::vector<PdfPage>& pages() const;
+    const PdfObject& trailer() const { return trailer_; }
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    // Objeto indireto num (null se não existe ou não pode ser lido).
+    PdfObject GetObject(int num) const;
+    // object, ou o objeto para onde ele aponta se for uma referência.
+    PdfObject Resolve(const PdfObject& object) const;
+
+    // Onde está um objeto indireto, para copiá-lo sem reinterpretar.
+    struct Location {
+        // true: "N G obj" começa em begin e o valor termina em end (num
+        // stream, no fim dos dados, antes do endstream). false: o objeto está
+        // no object stream object_stream, na posição index.
+        bool in_file = false;
+        bool stream = false;
+        int generation = 0;
+        size_t begin = 0;
+        size_t end = 0;
+        int object_stream = 0;
+        int index = 0;
+    };
+    // false se num está livre, não existe ou não pode ser lido. object, se
+    // não for nullptr, recebe o objeto de um in_file.
+    bool Locate(int num, Location* location, PdfObject* object = nullptr) const;
+    // Números de objeto válidos ficam abaixo deste (/Size do trailer ou o
+    // maior encontrado na reconstrução).
+    int object_limit() const;
+
+    // Content streams de page decodificados e concatenados (um /Contents em
+    // array forma um só stream). false se a página não tem conteúdo legível.
+    bool PageContent(const PdfPage& page, std::string* out) const;
+
+    // Conteúdo de um stream com os filtros aplicados (FlateDecode com
+    // preditores PNG/TIFF, LZWDecode, ASCIIHexDecode, ASCII85Decode e
+    // RunLengthDecode). Filtros de imagem (DCT, JPX, CCITT, JBIG2) falham.
+    bool DecodeStream(const PdfObject& stream, std::string* out, std::string* error) const;
+    // Nomes dos filtros de stream (/Filter como nome ou array, com
+    // referências resolvidas), na ordem em que DecodeStream os aplica.
+    std::vector<std::string> FilterNames(const PdfObject& stream) const;
+
+private:
+    struct XrefEntry {
+        // 0 = livre/ausente, 1 = offset no arquivo, 2 = dentro de object stream.
+        uint8_t type = 0;
+        // type 1: offset; type 2: número do object stream.
+        uint64_t offset = 0;
+        // type 2: índice dentro do object stream.
+        uint32_t index = 0;
+    };
+    // Uma seção da xref (tabela clássica ou xref stream). Só os limites das
+    // subseções são guardados; cada consulta lê a entrada na sua posição.
+    struct XrefSection {
+        struct Range {
+            int first = 0;
+            int count = 0;
+            // Tabela: offset da primeira entrada no arquivo; xref stream:
+            // índice da primeira entrada nos dados decodificados.
+            size_t start = 0;
+            size_t entry_size = 0;
+        };
+        std::vector<Range> ranges;
+        // Xref stream: larguras dos campos (/W) e o stream, decodificado uma
+        // vez, na primeira consulta.
+        bool compressed = false;
+        int widths[3] = {0, 0, 0};
+        PdfObject stream;
+        std::once_flag decode_once;
+        std::string data;
+    };
+    // Object stream já descomprimido: dados e offset de cada objeto.
+    struct ObjectStream {
+        std::string data;
+        std::map<int, size_t> offsets;
+    };
+
+    // Lê o cabeçalho da seção em offset e os das anteriores (/Prev).
+    bool ReadXref(size_t offset);
+    bool ReadXrefTable(PdfParser* parser, XrefSection* section);
+    bool ReadXrefStream(const PdfObject& stream, XrefSection* section) const;
+    bool ReadEntry(XrefSection* section, const XrefSection::Range& range, int num, XrefEntry* entry) const;
+    // Entrada em uso de num: a seção mais nova que a tem prevalece.
+    bool FindEntry(int num, XrefEntry* entry) const;
+    void MergeTrailer(const PdfObject& trailer);
+    XrefEntry* EntryFor(int num);
+    // Percorre o arquivo atrás de "N G obj" e dicionários de trailer.
+    bool Reconstruct();
+    void LoadPages() const;
+
+    // Lê "N G obj ... endobj" em offset. expected_num < 0 aceita qualquer
+    // número. location (opcional) recebe a geração e os limites do objeto.
+    bool ParseIndirectAt(size_t offset, int expected_num, PdfObject* object, Location* location = nullptr) const;
+    std::shared_ptr<const ObjectStream> LoadObjectStream(int num) const;
+    // value (/Filter ou /DecodeParms: um valor ou array) como lista, com
+    // referências resolvidas; vazia se value é nullptr.
+    std::vector<PdfObject> ResolveList(const PdfObject* value) const;
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    // Mapeamento próprio (construtor com path) e o erro de abri-lo.
+    void* mapping_ = nullptr;
+    std::string map_error_;
+
+    // Da mais nova para a mais antiga; vazio depois de Reconstruct, que
+    // preenche xref_ com todas as entradas.
+    std::vector<std::unique_ptr<XrefSection>> sections_;
+    std::vector<XrefEntry> xref_;
+    PdfObject trailer_;
+
+    mutable std::once_flag pages_once_;
+    mutable std::vector<PdfPage> pages_;
+
+    mutable std::mutex object_streams_mutex_;
+    mutable std::map<int, std::shared_ptr<const ObjectStream>> object_streams_;
+};
+
+// Code point -> UTF-8 (acrescentado a out).
+void AppendUtf8(uint32_t code_point, std::string* out);
@@ -0,0 +1,791 @@
+#include "src/pdf_text.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "src/pdf_document.h"
+
+namespace {
+
+using Type = PdfObject::Type;
+
+// Form XObjects dentro de Form XObjects.
+constexpr int kMaxFormDepth = 8;
+// Operandos acumulados antes de um operador (lixo no content stream).
+constexpr size_t kMaxOperands = 64;
+// Entradas de um único bfrange da ToUnicode.
+constexpr uint32_t kMaxRangeSize = 0x10000;
+
+// Nomes de glifo (Adobe Glyph List) de 0x20-0x7E e 0xA0-0xFF, na ordem.
+const char* const kAsciiGlyphNames[] = {
+    "space", "exclam", "quotedbl", "numbersign", "dollar", "percent", "ampersand", "quotesingle",
+    "parenleft", "parenright", "asterisk", "plus", "comma", "hyphen", "period", "slash",
+    "zero", "one", "two", "three", "four", "five", "six", "seven",
+    "eight", "nine", "colon", "semicolon", "less", "equal", "greater", "question",
+    "at", "A", "B", "C", "D", "E", "F", "G", "H", "I", "J", "K", "L", "M", "N", "O",
+    "P", "Q", "R", "S", "T", "U", "V", "W", "X", "Y", "Z", "bracketleft", "backslash", "bracketright",
+    "asciicircum", "underscore", "grave", "a", "b", "c", "d", "e", "f", "g", "h", "i", "j", "k", "l", "m",
+    "n", "o", "p", "q", "r", "s", "t", "u", "v", "w", "x", "y", "z", "braceleft", "bar", "braceright",
+    "asciitilde"};
+const char* const kLatin1GlyphNames[] = {
+    "nbspace", "exclamdown", "cent", "sterling", "currency", "yen", "brokenbar", "section",
+    "dieresis", "copyright", "ordfeminine", "guillemotleft", "logicalnot", "sfthyphen", "registered", "macron",
+    "degree", "plusminus", "twosuperior", "threesuperior", "acute", "mu", "paragraph", "periodcentered",
+    "cedilla", "onesuperior", "ordmasculine", "guillemotright", "onequarter", "onehalf", "threequarters",
+    "questiondown", "Agrave", "Aacute", "Acircumflex", "Atilde", "Adieresis", "Aring", "AE", "Ccedilla",
+    "Egrave", "Eacute", "Ecircumflex", "Edieresis", "Igrave", "Iacute", "Icircumflex", "Idieresis",
+    "Eth", "Ntilde", "Ograve", "Oacute", "Ocircumflex", "Otilde", "Odieresis", "multiply",
+    "Oslash", "Ugrave", "Uacute", "Ucircumflex", "Udieresis", "Yacute", "Thorn", "germandbls",
+    "agrave", "aacute", "acircumflex", "atilde", "adieresis", "aring", "ae", "ccedilla",
+    "egrave", "eacute", "ecircumflex", "edieresis", "igrave", "iacute", "icircumflex", "idieresis",
+    "eth", "ntilde", "ograve", "oacute", "ocircumflex", "otilde", "odieresis", "divide",
+    "oslash", "ugrave", "uacute", "ucircumflex", "udieresis", "yacute", "thorn", "ydieresis"};
+
+const struct {
+    const char* name;
+    uint32_t code_point;
+} kOtherGlyphNames[] = {
+    {"quoteleft", 0x2018}, {"quoteright", 0x2019}, {"quotedblleft", 0x201C}, {"quotedblright", 0x201D},
+    {"quotesinglbase", 0x201A}, {"quotedblbase", 0x201E}, {"endash", 0x2013}, {"emdash", 0x2014},
+    {"bullet", 0x2022}, {"ellipsis", 0x2026}, {"dagger", 0x2020}, {"daggerdbl", 0x2021},
+    {"perthousand", 0x2030}, {"trademark", 0x2122}, {"Euro", 0x20AC}, {"florin", 0x0192},
+    {"circumflex", 0x02C6}, {"tilde", 0x02DC}, {"OE", 0x0152}, {"oe", 0x0153}, {"Scaron", 0x0160},
+    {"scaron", 0x0161}, {"Zcaron", 0x017D}, {"zcaron", 0x017E}, {"Ydieresis", 0x0178},
+    {"dotlessi", 0x0131}, {"guilsinglleft", 0x2039}, {"guilsinglright", 0x203A}, {"fraction", 0x2044},
+    {"minus", 0x2212}, {"fi", 0xFB01}, {"fl", 0xFB02}, {"ff", 0xFB00}, {"ffi", 0xFB03}, {"ffl", 0xFB04},
+    {"nonbreakingspace", 0xA0}, {"hyphenminus", 0x2D}};
+
+// WinAnsiEncoding de 0x80-0x9F (0 = indefinido); o resto é Latin-1.
+const uint16_t kWinAnsiHigh[32] = {
+    0x20AC, 0, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021, 0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0, 0x017D, 0,
+    0, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014, 0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0, 0x017E,
+    0x0178};
+
+// MacRomanEncoding de 0x80-0xFF.
+const uint16_t kMacRomanHigh[128] = {
+    0x00C4, 0x00C5, 0x00C7, 0x00C9, 0x00D1, 0x00D6, 0x00DC, 0x00E1, 0x00E0, 0x00E2, 0x00E4, 0x00E3, 0x00E5,
+    0x00E7, 0x00E9, 0x00E8, 0x00EA, 0x00EB, 0x00ED, 0x00EC, 0x00EE, 0x00EF, 0x00F1, 0x00F3, 0x00F2, 0x00F4,
+    0x00F6, 0x00F5, 0x00FA, 0x00F9, 0x00FB, 0x00FC, 0x2020, 0x00B0, 0x00A2, 0x00A3, 0x00A7, 0x2022, 0x00B6,
+    0x00DF, 0x00AE, 0x00A9, 0x2122, 0x00B4, 0x00A8, 0x2260, 0x00C6, 0x00D8, 0x221E, 0x00B1, 0x2264, 0x2265,
+    0x00A5, 0x00B5, 0x2202, 0x2211, 0x220F, 0x03C0, 0x222B, 0x00AA, 0x00BA, 0x03A9, 0x00E6, 0x00F8, 0x00BF,
+    0x00A1, 0x00AC, 0x221A, 0x0192, 0x2248, 0x2206, 0x00AB, 0x00BB, 0x2026, 0x00A0, 0x00C0, 0x00C3, 0x00D5,
+    0x0152, 0x0153, 0x2013, 0x2014, 0x201C, 0x201D, 0x2018, 0x2019, 0x00F7, 0x25CA, 0x00FF, 0x0178, 0x2044,
+    0x20AC, 0x2039, 0x203A, 0xFB01, 0xFB02, 0x2021, 0x00B7, 0x201A, 0x201E, 0x2030, 0x00C2, 0x00CA, 0x00C1,
+    0x00CB, 0x00C8, 0x00CD, 0x00CE, 0x00CF, 0x00CC, 0x00D3, 0x00D4, 0xF8FF, 0x00D2, 0x00DA, 0x00DB, 0x00D9,
+    0x0131, 0x02C6, 0x02DC, 0x00AF, 0x02D8, 0x02D9, 0x02DA, 0x00B8, 0x02DD, 0x02DB, 0x02C7};
+
+enum class BaseEncoding { kStandard, kWinAnsi, kMacRoman };
+
+uint32_t BaseCodePoint(BaseEncoding encoding, int code) {
+    if (code < 0x20 || code == 0x7F) {
+        return 0;
+    }
+    if (code < 0x7F) {
+        // StandardEncoding só difere do ASCII nas aspas simples; a metade
+        // alta dela quase não aparece e fica sem mapa.
+        if (encoding == BaseEncoding::kStandard && code == 0x27) {
+            return 0x2019;
+        }
+        if (encoding == BaseEncoding::kStandard && code == 0x60) {
+            return 0x2018;
+        }
+        return static_cast<uint32_t>(code);
+    }
+    switch (encoding) {
+    case BaseEncoding::kStandard:
+        return 0;
+    case BaseEncoding::kWinAnsi:
+        return code < 0xA0 ? kWinAnsiHigh[code - 0x80] : static_cast<uint32_t>(code);
+    case BaseEncoding::kMacRoman:
+        return kMacRomanHigh[code - 0x80];
+    }
+    return 0;
+}
+
+const std::unordered_map<std::string, uint32_t>& GlyphNames() {
+    static const std::unordered_map<std::string, uint32_t> names = [] {
+        std::unordered_map<std::string, uint32_t> result;
+        for (uint32_t i = 0; i < sizeof(kAsciiGlyphNames) / sizeof(kAsciiGlyphNames[0]); ++i) {
+            result.emplace(kAsciiGlyphNames[i], 0x20 + i);
+        }
+        for (uint32_t i = 0; i < sizeof(kLatin1GlyphNames) / sizeof(kLatin1GlyphNames[0]); ++i) {
+            result.emplace(kLatin1GlyphNames[i], 0xA0 + i);
+        }
+        for (const auto& other : kOtherGlyphNames) {
+            result.emplace(other.name, other.code_point);
+        }
+        return result;
+    }();
+    return names;
+}
+
+// Texto de um nome de glifo: tabela acima, "uniXXXX[XXXX...]", "uXXXX[XX]",
+// sufixos (".sc", ".alt") ignorados e ligaduras "a_b". Vazio se desconhecido.
+std::string GlyphNameText(const std::string& glyph) {
+    std::string name = glyph.substr(0, glyph.find('.'));
+    std::string text;
+    if (name.find('_') != std::string::npos) {
+        size_t start = 0;
+        while (start <= name.size()) {
+            size_t end = std::min(name.find('_', start), name.size());
+            text += GlyphNameText(name.substr(start, end - start));
+            start = end + 1;
+        }
+        return text;
+    }
+    auto it = GlyphNames().find(name);
+    if (it != GlyphNames().end()) {
+        AppendUtf8(it->second, &text);
+        return text;
+    }
+    auto parse_hex = [](const std::string& digits, uint32_t* value) {
+        if (digits.empty()) {
+            return false;
+        }
+        *value = 0;
+        for (char c : digits) {
+            if (!std::isxdigit(static_cast<unsigned char>(c))) {
+                return false;
+            }
+            int nibble = c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10;
+            *value = *value << 4 | static_cast<uint32_t>(nibble);
+        }
+        return true;
+    };
+    uint32_t value = 0;
+    if (name.compare(0, 3, "uni") == 0 && name.size() >= 7 && (name.size() - 3) % 4 == 0) {
+        for (size_t pos = 3; pos < name.size(); pos += 4) {
+            if (!parse_hex(name.substr(pos, 4), &value)) {
+                return "";
+            }
+            AppendUtf8(value, &text);
+        }
+        return text;
+    }
+    if (name.size() >= 5 && name.size() <= 7 && name[0] == 'u' && parse_hex(name.substr(1), &value)) {
+        AppendUtf8(value, &text);
+    }
+    return text;
+}
+
+// Código de bytes big-endian.
+uint32_t CodeValue(const std::string& bytes) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < bytes.size() && i < 4; ++i) {
+        value = value << 8 | static_cast<uint8_t>(bytes[i]);
+    }
+    return value;
+}
+
+// UTF-16BE (destino das entradas da ToUnicode) -> UTF-8.
+std::string Utf16ToUtf8(const std::vector<uint16_t>& units) {
+    std::string text;
+    for (size_t i = 0; i < units.size(); ++i) {
+        uint32_t unit = units[i];
+        if (unit >= 0xD800 && unit <= 0xDBFF && i + 1 < units.size() && units[i + 1] >= 0xDC00 &&
+            units[i + 1] <= 0xDFFF) {
+            unit = 0x10000 + ((unit - 0xD800) << 10) + (units[++i] - 0xDC00);
+        }
+        AppendUtf8(unit, &text);
+    }
+    return text;
+}
+
+std::vector<uint16_t> Utf16Units(const std::string& bytes) {
+    std::vector<uint16_t> units;
+    if (bytes.size() == 1) {
+        units.push_back(static_cast<uint8_t>(bytes[0]));
+        return units;
+    }
+    for (size_t i = 0; i + 1 < bytes.size(); i += 2) {
+        units.push_back(
+            static_cast<uint16_t>(static_cast<uint8_t>(bytes[i]) << 8 | static_cast<uint8_t>(bytes[i + 1])));
+    }
+    return units;
+}
+
+// Fonte já preparada para decodificar strings de texto.
+struct PdfFont {
+    // Bytes por código: 2 nas fontes compostas (Type0), 1 nas simples.
+    int code_bytes = 1;
+    // Texto de cada código pela CMap ToUnicode.
+    std::unordered_map<uint32_t, std::string> to_unicode;
+    // Fontes simples: texto de cada código pela codificação (vazio = nenhum).
+    std::vector<std::string> simple;
+    // Type0 com CMap UCS-2/UTF-16: o próprio código é o code point.
+    bool unicode_codes = false;
+    // Larguras em milésimos do corpo, para posicionar o texto seguinte.
+    std::unordered_map<uint32_t, double> widths;
+    double default_width = 500;
+
+    void AppendText(uint32_t code, std::string* out) const {
+        auto it = to_unicode.find(code);
+        if (it != to_unicode.end()) {
+            out->append(it->second);
+        } else if (code < simple.size()) {
+            out->append(simple[code]);
+        } else if (unicode_codes) {
+            AppendUtf8(code, out);
+        }
+    }
+
+    double Width(uint32_t code) const {
+        auto it = widths.find(code);
+        return it != widths.end() ? it->second : default_width;
+    }
+};
+
+// Lê os bfchar/bfrange de uma CMap ToUnicode para font. Códigos acima do
+// espaço de códigos da fonte (0xFF nas simples, 0xFFFF nas Type0) não
+// aparecem no texto e são ignorados; as faixas são cortadas nesse limite.
+void ParseToUnicode(const std::string& cmap, PdfFont* font) {
+    const uint32_t max_code = font->code_bytes == 2 ? 0xFFFF : 0xFF;
+    PdfParser parser(cmap.data(), cmap.size(), 0, false);
+    std::vector<PdfObject> operands;
+    PdfObject token;
+    auto destination = [](const PdfObject& value) {
+        return value.is(Type::kName) ? GlyphNameText(value.text) : Utf16ToUtf8(Utf16Units(value.text));
+    };
+    // Os operandos de cada bloco bfchar/bfrange se acumulam até o end*.
+    while (parser.Next(&token)) {
+        if (!token.is(Type::kOperator)) {
+            operands.push_back(std::move(token));
+            continue;
+        }
+        if (token.text == "endbfchar") {
+            for (size_t i = 0; i + 1 < operands.size(); i += 2) {
+                if (!operands[i].is(Type::kString)) {
+                    continue;
+                }
+                uint32_t code = CodeValue(operands[i].text);
+                if (code <= max_code) {
+                    font->to_unicode[code] = destination(operands[i + 1]);
+                }
+            }
+        } else if (token.text == "endbfrange") {
+            for (size_t i = 0; i + 2 < operands.size(); i += 3) {
+                const PdfObject& target = operands[i + 2];
+                uint32_t low = CodeValue(operands[i].text);
+                uint32_t high = std::min(CodeValue(operands[i + 1].text), max_code);
+                if (high < low) {
+                    continue;
+                }
+                // Por deslocamento a partir de low: com high no máximo do
+                // tipo, "code <= high" nunca ficaria falso.
+                const uint32_t count = high - low;
+                if (target.array) {
+                    for (uint32_t offset = 0; offset <= count && offset < target.array->size(); ++offset) {
+                        font->to_unicode[low + offset] = destination((*target.array)[offset]);
+                    }
+                    continue;
+                }
+                // Destino string: a última unidade é incrementada a cada código.
+                std::vector<uint16_t> units = Utf16Units(target.text);
+                if (units.empty()) {
+                    continue;
+                }
+                for (uint32_t offset = 0; offset <= count; ++offset) {
+                    font->to_unicode[low + offset] = Utf16ToUtf8(units);
+                    ++units.back();
+                }
+            }
+        }
+        operands.clear();
+    }
+}
+
+std::shared_ptr<const PdfFont> LoadFont(const PdfDocument& document, const PdfObject& font_object) {
+    auto font = std::make_shared<PdfFont>();
+    PdfObject dict = document.Resolve(font_object);
+    const PdfObject* subtype = dict.Get("Subtype");
+    bool composite = subtype != nullptr && subtype->IsName("Type0");
+    PdfObject encoding = dict.Get("Encoding") ? document.Resolve(*dict.Get("Encoding")) : PdfObject();
+
+    if (composite) {
+        font->code_bytes = 2;
+    }
+    const PdfObject* to_unicode = dict.Get("ToUnicode");
+    if (to_unicode != nullptr) {
+        std::string cmap, error;
+        if (document.DecodeStream(document.Resolve(*to_unicode), &cmap, &error)) {
+            ParseToUnicode(cmap, font.get());
+        }
+    }
+
+    if (composite) {
+        font->default_width = 1000;
+        font->unicode_codes = encoding.is(Type::kName) && (encoding.text.find("UCS2") != std::string::npos ||
+                                                           encoding.text.find("UTF16") != std::string::npos);
+        // Larguras ficam na fonte descendente (CIDFont): /DW e /W, por CID.
+        // Com Identity-H, o caso comum, CID = código.
+        PdfObject descendants = dict.Get("DescendantFonts") ? document.Resolve(*dict.Get("DescendantFonts"))
+                                                            : PdfObject();
+        PdfObject cid_font =
+            descendants.array && !descendants.array->empty() ? document.Resolve(descendants.array->front())
+                                                             : PdfObject();
+        if (cid_font.Get("DW") != nullptr) {
+            font->default_width = cid_font.Get("DW")->AsNumber(1000);
+        }
+        PdfObject w = cid_font.Get("W") ? document.Resolve(*cid_font.Get("W")) : PdfObject();
+        if (w.array) {
+            const PdfArray& items = *w.array;
+            for (size_t i = 0; i + 1 < items.size() && font->widths.size() < kMaxRangeSize;) {
+                uint32_t first = static_cast<uint32_t>(std::max(0, items[i].AsInt()));
+                PdfObject next = document.Resolve(items[i + 1]);
+                if (next.array) {
+                    for (size_t k = 0; k < next.array->size(); ++k) {
+                        font->widths[first + static_cast<uint32_t>(k)] = (*next.array)[k].AsNumber();
+                    }
+                    i += 2;
+                } else if (i + 2 < items.size()) {
+                    uint32_t last = static_cast<uint32_t>(std::max(0, next.AsInt()));
+                    for (uint32_t code = first; code <= last && code - first < kMaxRangeSize; ++code) {
+                        font->widths[code] = items[i + 2].AsNumber();
+                    }
+                    i += 3;
+                } else {
+                    break;
+                }
+            }
+        }
+        return font;
+    }
+
+    // Fonte simples: codificação base mais /Differences.
+    BaseEncoding base = subtype != nullptr && subtype->IsName("Type1") ? BaseEncoding::kStandard
+                                                                       : BaseEncoding::kWinAnsi;
+    const PdfObject* base_name = encoding.is(Type::kName) ? &encoding : encoding.Get("BaseEncoding");
+    if (base_name != nullptr && base_name->IsName("WinAnsiEncoding")) {
+        base = BaseEncoding::kWinAnsi;
+    } else if (base_name != nullptr && base_name->IsName("MacRomanEncoding")) {
+        base = BaseEncoding::kMacRoman;
+    } else if (base_name == nullptr && encoding.is(Type::kDict)) {
+        base = BaseEncoding::kWinAnsi;
+    }
+    font->simple.resize(256);
+    for (int code = 0; code < 256; ++code) {
+        uint32_t code_point = BaseCodePoint(base, code);
+        if (code_point != 0) {
+            AppendUtf8(code_point, &font->simple[code]);
+        }
+    }
+    PdfObject differences = encoding.Get("Differences") ? document.Resolve(*encoding.Get("Differences"))
+                                                        : PdfObject();
+    if (differences.array) {
+        int code = 0;
+        for (const PdfObject& item : *differences.array) {
+            if (item.is(Type::kNumber)) {
+                code = item.AsInt();
+            } else if (item.is(Type::kName) && code >= 0 && code < 256) {
+                font->simple[code++] = GlyphNameText(item.text);
+            }
+        }
+    }
+
+    // /Widths a partir de /FirstChar; Type3 mede em espaço de glifo (FontMatrix).
+    double scale = 1;
+    PdfObject matrix = dict.Get("FontMatrix") ? document.Resolve(*dict.Get("FontMatrix")) : PdfObject();
+    if (subtype != nullptr && subtype->IsName("Type3") && matrix.array && !matrix.array->empty()) {
+        scale = (*matrix.array)[0].AsNumber(0.001) * 1000;
+    }
+    PdfObject widths = dict.Get("Widths") ? document.Resolve(*dict.Get("Widths")) : PdfObject();
+    if (widths.array) {
+        int first = dict.Get("FirstChar") ? dict.Get("FirstChar")->AsInt() : 0;
+        for (size_t i = 0; i < widths.array->size() && i < 256; ++i) {
+            font->widths[static_cast<uint32_t>(first) + static_cast<uint32_t>(i)] =
+                document.Resolve((*widths.array)[i]).AsNumber() * scale;
+        }
+        PdfObject descriptor = dict.Get("FontDescriptor") ? document.Resolve(*dict.Get("FontDescriptor"))
+                                                          : PdfObject();
+        font->default_width = descriptor.Get("MissingWidth") ? descriptor.Get("MissingWidth")->AsNumber() : 0;
+    }
+    return font;
+}
+
+// Fontes já carregadas do documento, por número de objeto (compartilhadas
+// entre as páginas e as threads).
+class FontCache {
+public:
+    explicit FontCache(const PdfDocument* document) : document_(document) {}
+
+    std::shared_ptr<const PdfFont> Get(const PdfObject& font_object) {
+        if (!font_object.is(Type::kRef)) {
+            return LoadFont(*document_, font_object);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = fonts_.find(font_object.ref_num);
+            if (it != fonts_.end()) {
+                return it->second;
+            }
+        }
+        std::shared_ptr<const PdfFont> font = LoadFont(*document_, font_object);
+        std::lock_guard<std::mutex> lock(mutex_);
+        return fonts_.emplace(font_object.ref_num, std::move(font)).first->second;
+    }
+
+private:
+    const PdfDocument* document_;
+    std::mutex mutex_;
+    std::unordered_map<int, std::shared_ptr<const PdfFont>> fonts_;
+};
+
+// Interpreta os content streams de uma página e monta o texto dela.
+//
+// O texto sai na ordem do content stream. Uma mudança de linha de base
+// maior que meio corpo vira quebra de linha; um avanço horizontal maior que
+// kSpaceGap do corpo, na mesma linha, vira espaço (geradores costumam
+// posicionar cada palavra com Td/TJ em vez de gravar o espaço).
+class PageText {
+public:
+    PageText(const PdfDocument& document, FontCache* fonts) : document_(document), fonts_(fonts) {}
+
+    void Run(const std::string& content, const PdfObject& resources, int depth) {
+        PdfParser parser(content.data(), content.size(), 0, false);
+        std::vector<PdfObject> operands;
+        PdfObject token;
+        while (parser.Next(&token)) {
+            if (!token.is(Type::kOperator)) {
+                if (operands.size() < kMaxOperands) {
+                    operands.push_back(std::move(token));
+                }
+                continue;
+            }
+            Execute(token.text, operands, resources, depth, &parser);
+            operands.clear();
+        }
+    }
+
+    // Texto da página no formato do pdftotext (termina com \f).
+    std::string Finish() {
+        while (!out_.empty() && (out_.back() == ' ' || out_.back() == '\n')) {
+            out_.pop_back();
+        }
+        if (!out_.empty()) {
+            out_ += '\n';
+        }
+        out_ += '\f';
+        return std::move(out_);
+    }
+
+private:
+    static constexpr double kSpaceGap = 0.2;
+
+    // Parte do estado gráfico salva por q/Q.
+    struct State {
+        PdfMatrix ctm;
+        std::shared_ptr<const PdfFont> font;
+        double font_size = 0;
+        double char_spacing = 0;
+        double word_spacing = 0;
+        double horizontal_scale = 1;
+        double leading = 0;
+    };
+
+    void Execute(const std::string& op, const std::vector<PdfObject>& operands, const PdfObject& resources,
+                 int depth, PdfParser* parser) {
+        size_t n = operands.size();
+        auto number = [&](size_t from_end) { return operands[n - from_end].AsNumber(); };
+        if (op == "BT") {
+            text_matrix_ = line_matrix_ = PdfMatrix();
+        } else if (op == "Tf" && n >= 2) {
+            state_.font_size = number(1);
+            state_.font = FindFont(resources, operands[n - 2]);
+        } else if (op == "Td" && n >= 2) {
+            MoveLine(number(2), number(1));
+        } else if (op == "TD" && n >= 2) {
+            state_.leading = -number(1);
+            MoveLine(number(2), number(1));
+        } else if (op == "Tm" && n >= 6) {
+            text_matrix_ = line_matrix_ = PdfMatrixFrom(operands);
+        } else if (op == "T*") {
+            MoveLine(0, -state_.leading);
+        } else if (op == "TL" && n >= 1) {
+            state_.leading = number(1);
+        } else if (op == "Tc" && n >= 1) {
+            state_.char_spacing = number(1);
+        } else if (op == "Tw" && n >= 1) {
+            state_.word_spacing = number(1);
+        } else if (op == "Tz" && n >= 1) {
+            state_.horizontal_scale = number(1) / 100;
+        } else if (op == "Tj" && n >= 1) {
+            ShowString(operands[n - 1].text);
+        } else if (op == "TJ" && n >= 1 && operands[n - 1].array) {
+            for (const PdfObject& item : *operands[n - 1].array) {
+                if (item.is(Type::kString)) {
+                    ShowString(item.text);
+                } else {
+                    Advance(-item.AsNumber() / 1000 * state_.font_size * state_.horizontal_scale);
+                }
+            }
+        } else if (op == "'" && n >= 1) {
+            MoveLine(0, -state_.leading);
+            ShowString(operands[n - 1].text);
+        } else if (op == "\"" && n >= 3) {
+            state_.word_spacing = number(3);
+            state_.char_spacing = number(2);
+            MoveLine(0, -state_.leading);
+            ShowString(operands[n - 1].text);
+        } else if (op == "q") {
+            saved_.push_back(state_);
+        } else if (op == "Q") {
+            if (!saved_.empty()) {
+                state_ = std::move(saved_.back());
+                saved_.pop_back();
+            }
+        } else if (op == "cm" && n >= 6) {
+            state_.ctm = PdfMatrixFrom(operands).Then(state_.ctm);
+        } else if (op == "Do" && n >= 1) {
+            DrawForm(resources, operands[n - 1], depth);
+        } else if (op == "BI") {
+            parser->SkipInlineImage();
+        }
+    }
+
+    std::shared_ptr<const PdfFont> FindFont(const PdfObject& resources, const PdfObject& name) {
+        PdfObject fonts = resources.Get("Font") ? document_.Resolve(*resources.Get("Font")) : PdfObject();
+        const PdfObject* font = fonts.Get(name.text.c_str());
+        return font != nullptr ? fonts_->Get(*font) : nullptr;
+    }
+
+    void MoveLine(double tx, double ty) {
+        line_matrix_ = PdfMatrix{1, 0, 0, 1, tx, ty}.Then(line_matrix_);
+        text_matrix_ = line_matrix_;
+    }
+
+    void Advance(double tx) {
+        text_matrix_.e += tx * text_matrix_.a;
+        text_matrix_.f += tx * text_matrix_.b;
+    }
+
+    void ShowString(const std::string& bytes) {
+        if (!state_.font) {
+            return;
+        }
+        const PdfFont& font = *state_.font;
+        PdfMatrix position = text_matrix_.Then(state_.ctm);
+        double size = std::fabs(state_.font_size) * std::hypot(position.c, position.d);
+        Separate(position, size);
+        for (size_t i = 0; i + font.code_bytes <= bytes.size(); i += font.code_bytes) {
+            uint32_t code = font.code_bytes == 2 ? static_cast<uint32_t>(static_cast<uint8_t>(bytes[i]) << 8 |
+                                                                         static_cast<uint8_t>(bytes[i + 1]))
+                                                 : static_cast<uint8_t>(bytes[i]);
+            font.AppendText(code, &out_);
+            double spacing = state_.char_spacing + (font.code_bytes == 1 && code == 32 ? state_.word_spacing : 0);
+            Advance((font.Width(code) / 1000 * state_.font_size + spacing) * state_.horizontal_scale);
+        }
+        PdfMatrix end = text_matrix_.Then(state_.ctm);
+        last_x_ = end.e;
+        last_y_ = end.f;
+        last_size_ = size;
+        has_last_ = true;
+    }
+
+    // Quebra de linha ou espaço entre o texto anterior e o que começa em position.
+    void Separate(const PdfMatrix& position, double size) {
+        if (!has_last_ || out_.empty()) {
+            return;
+        }
+        double reference = std::max({size, last_size_, 1.0});
+        if (std::fabs(position.f - last_y_) > reference / 2) {
+            while (!out_.empty() && out_.back() == ' ') {
+                out_.pop_back();
+            }
+            if (!out_.empty() && out_.back() != '\n') {
+                out_ += '\n';
+            }
+            return;
+        }
+        double gap = position.e - last_x_;
+        // Recuo grande na mesma linha: outra coluna desenhada depois.
+        if ((gap > kSpaceGap * reference || gap < -3 * reference) && out_.back() != ' ' && out_.back() != '\n') {
+            out_ += ' ';
+        }
+    }
+
+    void DrawForm(const PdfObject& resources, const PdfObject& name, int depth) {
+        if (depth >= kMaxFormDepth) {
+            return;
+        }
+        PdfObject xobjects = resources.Get("XObject") ? document_.Resolve(*resources.Get("XObject")) : PdfObject();
+        const PdfObject* entry = xobjects.Get(name.text.c_str());
+        if (entry == nullptr) {
+            return;
+        }
+        PdfObject form = document_.Resolve(*entry);
+        const PdfObject* subtype = form.Get("Subtype");
+        if (!form.is(Type::kStream) || subtype == nullptr || !subtype->IsName("Form")) {
+            return;
+        }
+        std::string content, error;
+        if (!document_.DecodeStream(form, &content, &error)) {
+            return;
+        }
+        PdfObject form_resources = form.Get("Resources") ? document_.Resolve(*form.Get("Resources")) : resources;
+        PdfObject matrix = form.Get("Matrix") ? document_.Resolve(*form.Get("Matrix")) : PdfObject();
+
+        // O form roda com estado gráfico próprio e não altera o texto em volta.
+        State saved = state_;
+        PdfMatrix text = text_matrix_, line = line_matrix_;
+        if (matrix.array && matrix.array->size() == 6) {
+            state_.ctm = PdfMatrixFrom(*matrix.array).Then(state_.ctm);
+        }
+        Run(content, form_resources, depth + 1);
+        state_ = std::move(saved);
+        text_matrix_ = text;
+        line_matrix_ = line;
+    }
+
+    const PdfDocument& document_;
+    FontCache* fonts_;
+    State state_;
+    std::vector<State> saved_;
+    PdfMatrix text_matrix_;
+    PdfMatrix line_matrix_;
+    // Fim do último texto desenhado, em espaço de dispositivo.
+    bool has_last_ = false;
+    double last_x_ = 0;
+    double last_y_ = 0;
+    double last_size_ = 0;
+    std::string out_;
+};
+
+std::string ExtractPage(const PdfDocument& document, const PdfPage& page, FontCache* fonts) {
+    PageText text(document, fonts);
+    std::string content;
+    if (document.PageContent(page, &content)) {
+        text.Run(content, page.resources, 0);
+    }
+    return text.Finish();
+}
+
+// Páginas de uma extração, pegas em ordem por quem estiver livre (threads do
+// pool e a chamadora). Compartilhado por shared_ptr: uma tarefa que só sai
+// da fila do pool depois do fim da extração encontra stop e não toca no
+// documento.
+struct PageQueue {
+    PageQueue(const PdfDocument* document, FontCache* fonts)
+        : document(document), fonts(fonts), texts(document->pages().size()),
+          done(document->pages().size(), false) {}
+
+    // Próxima página a extrair (pages().size() = nenhuma); false depois de stop.
+    bool Claim(size_t* page) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stop || next >= texts.size()) {
+            return false;
+        }
+        *page = next++;
+        return true;
+    }
+
+    void Extract(size_t page) {
+        std::string text = ExtractPage(*document, document->pages()[page], fonts);
+        std::lock_guard<std::mutex> lock(mutex);
+        texts[page] = std::move(text);
+        done[page] = true;
+        changed.notify_all();
+    }
+
+    // Laço de uma thread auxiliar.
+    void Help() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stop) {
+                return;
+            }
+            ++helpers;
+        }
+        size_t page = 0;
+        while (Claim(&page)) {
+            Extract(page);
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        --helpers;
+        changed.notify_all();
+    }
+
+    // Impede novas páginas e espera as auxiliares que estão extraindo uma.
+    void Stop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        stop = true;
+        changed.wait(lock, [this] { return helpers == 0; });
+    }
+
+    const PdfDocument* document;
+    FontCache* fonts;
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t next = 0;
+    bool stop = false;
+    int helpers = 0;
+    std::vector<std::string> texts;
+    std::vector<bool> done;
+};
+
+}  // namespace
+
+PdfTextExtractor::PdfTextExtractor(const Options& options)
+    : threads_(options.threads > 0 ? options.threads
+                                   : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))) {
+    if (threads_ > 1) {
+        pool_ = std::make_unique<ThreadPool>(static_cast<size_t>(threads_ - 1), 0);
+    }
+}
+
+bool PdfTextExtractor::Extract(const char* data, size_t size, const PageCallback& on_page,
+                               const std::function<bool()>& is_cancelled, std::string* error) const {
+    PdfDocument document(data, size);
+    if (!document.Open(error)) {
+        return false;
+    }
+    const size_t pages = document.pages().size();
+    FontCache fonts(&document);
+    auto queue = std::make_shared<PageQueue>(&document, &fonts);
+    if (pool_ != nullptr) {
+        size_t helpers = std::min(static_cast<size_t>(threads_ - 1), pages > 0 ? pages - 1 : 0);
+        for (size_t i = 0; i < helpers; ++i) {
+            pool_->TrySubmit([queue] { queue->Help(); });
+        }
+    }
+
+    // A chamadora entrega as páginas em ordem e, enquanto a próxima não fica
+    // pronta, extrai ela mesma as que ainda ninguém pegou.
+    bool ok = true;
+    for (size_t emitted = 0; emitted < pages && ok;) {
+        if (is_cancelled && is_cancelled()) {
+            *error = "Extração cancelada";
+            ok = false;
+            break;
+        }
+        std::unique_lock<std::mutex> lock(queue->mutex);
+        if (queue->done[emitted]) {
+            std::string text = std::move(queue->texts[emitted]);
+            lock.unlock();
+            if (!on_page(static_cast<int>(emitted), std::move(text))) {
+                *error = "Extração interrompida";
+                ok = false;
+            }
+            ++emitted;
+            continue;
+        }
+        lock.unlock();
+        size_t page = 0;
+        if (queue->Claim(&page)) {
+            queue->Extract(page);
+            continue;
+        }
+        // Todas as páginas já foram pegas: espera a auxiliar com a próxima.
+        lock.lock();
+        queue->changed.wait(lock, [&] { return queue->done[emitted]; });
+    }
+    queue->Stop();
+    return ok;
+}
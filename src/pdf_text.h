@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "src/thread_pool.h"
+
+// Extração de texto de PDF em processo (ConvertToTXT sem pdftotext).
+//
+// Interpreta os operadores de texto dos content streams de cada página (e
+// dos Form XObjects que ela desenha), decodifica os códigos pela CMap
+// ToUnicode da fonte ou, sem ela, pela codificação simples (WinAnsi com
+// /Differences) e reconstrói linhas e espaços pela posição do texto. A
+// saída segue o formato do pdftotext: UTF-8, uma linha por linha de texto e
+// um form feed (\f) no fim de cada página.
+//
+// As páginas são distribuídas, em ordem, entre o pool interno e a thread
+// chamadora; o texto de cada uma é entregue assim que ela e todas as
+// anteriores terminam, para a resposta começar antes do fim do documento.
+//
+// Thread-safe: várias requisições podem usar o mesmo extrator.
+class PdfTextExtractor {
+public:
+    struct Options {
+        // Threads por documento, contando a chamadora (0 = núcleos; 1 = sem pool).
+        int threads = 0;
+    };
+
+    // Recebe o texto de cada página, em ordem (page começa em 0). Retornar
+    // false interrompe a extração (ex.: cliente desconectado).
+    using PageCallback = std::function<bool(int page, std::string text)>;
+
+    explicit PdfTextExtractor(const Options& options);
+
+    // Extrai o texto de data[0, size), que precisa continuar válido até o
+    // retorno. is_cancelled (opcional) é consultado entre páginas. Retorna
+    // false e preenche error se o PDF não pode ser aberto, se foi cancelado
+    // ou se on_page pediu a interrupção; páginas ilegíveis saem vazias.
+    bool Extract(const char* data, size_t size, const PageCallback& on_page,
+                 const std::function<bool()>& is_cancelled, std::string* error) const;
+
+    int threads() const { return threads_; }
+
+private:
+    int threads_;
+    // Executa páginas em paralelo com a chamadora (nullptr com threads == 1).
+    std::unique_ptr<ThreadPool> pool_;
+};
@@ -0,0 +1,109 @@
+#include "src/pipeline.h"
+
+#include <memory>
+#include <thread>
+
+#include "src/abort_stats.h"
+#include "src/chunk_io.h"
+#include "src/logging.h"
+#include "src/metrics.h"
+#include "src/subprocess.h"
+
+using grpc::ServerReaderWriter;
+using grpc::Status;
+using file_processor::FileChunk;
+
+Status RunStreamingPipeline(grpc::ServerContext* context,
+                            ServerReaderWriter<FileChunk, FileChunk>* stream,
+                            const char* method,
+                            const std::function<PipelineCommand(const RequestParams& params)>& make_command,
+                            size_t default_chunk_size) {
+    FileChunk chunk;
+    if (!stream->Read(&chunk)) {
+        LogError(method, "", "Nenhum dado recebido");
+        return Status(grpc::StatusCode::INTERNAL, "Nenhum dado recebido");
+    }
+    std::string filename = chunk.file_name();
+    std::string error;
+    RequestParams params;
+    if (!ResolveRequestParams(filename, chunk.options(), &params, &error)) {
+        LogError(method, filename, error);
+        return Status(grpc::StatusCode::INVALID_ARGUMENT, error);
+    }
+    PipelineCommand command = make_command(params);
+    // Recepção, ferramenta e envio se sobrepõem: tudo conta como execute.
+    Rpc rpc = RpcFromMethod(method);
+    StageTimer execute_timer(rpc, Stage::kExecute);
+    size_t chunk_size = NegotiateChunkSize(*context, default_chunk_size, params.chunk_size_hint);
+
+    std::unique_ptr<Subprocess> process = Subprocess::Start(command.argv, &error);
+    if (!process) {
+        LogError(method, filename, "Falha ao iniciar " + command.argv[0] + ": " + error);
+        return Status(grpc::StatusCode::INTERNAL, "Falha ao iniciar conversão");
+    }
+    // Cliente desconectado ou deadline expirado: a ferramenta é morta e o
+    // upload/download param no próximo Read/Write.
+    process->KillWhen([context] { return context->IsCancelled(); });
+
+    // Saída da ferramenta -> cliente, em paralelo com o upload.
+    size_t bytes_out = 0;
+    std::thread sender([&] {
+        std::string buffer(chunk_size, '\0');
+        bool client_alive = true;
+        ssize_t n;
+        while ((n = process->ReadStdout(&buffer[0], buffer.size())) > 0) {
+            bytes_out += n;
+            if (!client_alive) {
+                continue;  // continuar drenando para o filho não travar
+            }
+            FileChunk response_chunk;
+            response_chunk.set_file_name(command.output_name);
+            response_chunk.set_chunk_data(buffer.data(), n);
+            client_alive = stream->Write(response_chunk);
+        }
+    });
+
+    // Upload -> stdin da ferramenta.
+    size_t bytes_in = 0;
+    bool stdin_open = true;
+    for (;;) {
+        const std::string& payload = chunk.chunk_data();
+        bytes_in += payload.size();
+        if (stdin_open && !payload.empty()) {
+            // Se o filho já saiu, seguimos lendo o stream até o fim e o
+            // erro aparece no código de saída.
+            stdin_open = process->WriteStdin(payload.data(), payload.size());
+        }
+        if (chunk.is_last() || !stream->Read(&chunk)) {
+            break;
+        }
+    }
+    process->CloseStdin();
+    sender.join();
+    GlobalMetrics().AddBytesIn(rpc, bytes_in);
+    GlobalMetrics().AddBytesOut(rpc, bytes_out);
+
+    int code = process->Wait();
+    if (process->cancelled() || context->IsCancelled()) {
+        LogError(method, filename, AbortLogMessage());
+        return Status(grpc::StatusCode::CANCELLED, "Requisição cancelada");
+    }
+    if (code != 0) {
+        LogError(method, filename, command.argv[0] + " retornou código " + std::to_string(code) + ": " +
+                 process->stderr_output());
+        return Status(grpc::StatusCode::INTERNAL, "Falha na conversão");
+    }
+    if (bytes_in == 0) {
+        LogError(method, filename, "Nenhum dado recebido");
+        return Status(grpc::StatusCode::INTERNAL, "Nenhum dado recebido");
+    }
+
+    FileChunk last_chunk;
+    last_chunk.set_file_name(command.output_name);
+    last_chunk.set_is_last(true);
+    stream->Write(last_chunk);
+
+    LogSuccess(method, filename, "Pipeline concluído (" + std::to_string(bytes_in) + " -> " +
+               std::to_string(bytes_out) + " bytes).");
+    return Status::OK;
+}
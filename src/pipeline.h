@@ -0,0 +1,34 @@
+#pragma once
+
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/support/sync_stream.h>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "proto/file_processor.grpc.pb.h"
+#include "src/processing_options.h"
+
+// Comando e nome do arquivo de resposta de uma RPC em modo pipeline.
+struct PipelineCommand {
+    std::vector<std::string> argv;
+    std::string output_name;
+};
+
+// Modo pipeline (--pipeline) das RPCs de streaming: a ferramenta é iniciada
+// ao chegar o primeiro FileChunk, cada payload é escrito no stdin dela assim
+// que chega e o stdout volta ao cliente em FileChunks de até chunk_size bytes
+// conforme é produzido. O último chunk de resposta vem vazio com is_last.
+// Se a chamada for cancelada a ferramenta é morta e o retorno é CANCELLED.
+//
+// make_command recebe os parâmetros resolvidos do primeiro chunk (opções
+// tipadas ou file_name legado). O tamanho dos chunks de resposta é negociado
+// com default_chunk_size e o chunk_size_hint das opções.
+grpc::Status RunStreamingPipeline(
+    grpc::ServerContext* context,
+    grpc::ServerReaderWriter<file_processor::FileChunk, file_processor::FileChunk>* stream,
+    const char* method,
+    const std::function<PipelineCommand(const RequestParams& params)>& make_command,
+    size_t default_chunk_size);
@@ -0,0 +1,156 @@
+#include "src/processing_options.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+#include "src/flate.h"
+
+namespace {
+
+// Limite de largura/altura aceito nas opções.
+constexpr int kMaxDimension = 65535;
+
+// Formatos de saída aceitos (em minúsculas). O valor vira o coder do
+// convert ("<formato>:-"): qualquer outro nome escolheria um coder arbitrário
+// do ImageMagick (msl, mvg, info...), então a lista é fechada.
+const char* const kOutputFormats[] = {"png", "jpg", "jpeg", "webp", "gif", "bmp", "tiff", "pnm"};
+
+std::string Lowercase(const std::string& text) {
+    std::string lower;
+    for (char c : text) {
+        lower += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return lower;
+}
+
+bool ValidFormat(const std::string& format) {
+    return std::find(std::begin(kOutputFormats), std::end(kOutputFormats), format) != std::end(kOutputFormats);
+}
+
+// Formato antigo, em que o cliente Python codificava os parâmetros no file_name:
+// "nome|largura|altura" (ResizeImage) ou "nome|formato" (ConvertImageFormat).
+struct LegacyFileName {
+    std::string name;
+    std::string format;
+    int width = 0;
+    int height = 0;
+};
+
+bool ParsePositive(const std::string& text, int* out) {
+    if (text.empty() || text.size() > 6) {
+        return false;
+    }
+    for (char c : text) {
+        if (!std::isdigit(static_cast<unsigned char>(c))) {
+            return false;
+        }
+    }
+    *out = std::atoi(text.c_str());
+    return *out > 0;
+}
+
+LegacyFileName ParseLegacyFileName(const std::string& file_name) {
+    LegacyFileName parsed;
+    size_t p1 = file_name.find('|');
+    parsed.name = file_name.substr(0, p1);
+    if (p1 == std::string::npos) {
+        return parsed;
+    }
+    size_t p2 = file_name.find('|', p1 + 1);
+    if (p2 == std::string::npos) {
+        // Fora da lista vale o padrão: o mesmo campo "nome|x" chega a
+        // todas as RPCs, e só o ConvertImageFormat o lê como formato.
+        std::string format = Lowercase(file_name.substr(p1 + 1));
+        if (ValidFormat(format)) {
+            parsed.format = format;
+        }
+        return parsed;
+    }
+    int width = 0, height = 0;
+    if (ParsePositive(file_name.substr(p1 + 1, p2 - p1 - 1), &width) &&
+        ParsePositive(file_name.substr(p2 + 1), &height)) {
+        parsed.width = width;
+        parsed.height = height;
+    }
+    return parsed;
+}
+
+}  // namespace
+
+bool ResolveRequestParams(const std::string& file_name, const file_processor::ProcessingOptions& options,
+                          RequestParams* params, std::string* error) {
+    LegacyFileName legacy = ParseLegacyFileName(file_name);
+    params->name = legacy.name;
+
+    if (!options.output_format().empty()) {
+        std::string format = Lowercase(options.output_format());
+        if (!ValidFormat(format)) {
+            *error = "output_format inválido: " + options.output_format();
+            return false;
+        }
+        params->output_format = format;
+    } else {
+        params->output_format = legacy.format.empty() ? kDefaultOutputFormat : legacy.format;
+    }
+
+    if (options.width() < 0 || options.width() > kMaxDimension || options.height() < 0 ||
+        options.height() > kMaxDimension) {
+        *error = "Dimensões inválidas: " + std::to_string(options.width()) + "x" +
+                 std::to_string(options.height());
+        return false;
+    }
+    params->width = options.width() > 0 ? options.width() : legacy.width;
+    params->height = options.height() > 0 ? options.height() : legacy.height;
+    if (params->width == 0) {
+        params->width = kDefaultResizeWidth;
+    }
+    if (params->height == 0) {
+        params->height = kDefaultResizeHeight;
+    }
+
+    if (options.quality() < 0 || options.quality() > 100) {
+        *error = "quality fora de 1-100: " + std::to_string(options.quality());
+        return false;
+    }
+    params->quality = options.quality();
+
+    if (!file_processor::PdfPreset_IsValid(options.pdf_preset())) {
+        *error = "pdf_preset desconhecido: " + std::to_string(options.pdf_preset());
+        return false;
+    }
+    params->pdf_preset = options.pdf_preset();
+
+    if (options.compression_level() < 0 || options.compression_level() > kMaxFlateLevel) {
+        *error = "compression_level fora de 1-" + std::to_string(kMaxFlateLevel) + ": " +
+                 std::to_string(options.compression_level());
+        return false;
+    }
+    params->compression_level = options.compression_level();
+
+    if (options.chunk_size_hint() < 0) {
+        *error = "chunk_size_hint negativo";
+        return false;
+    }
+    params->chunk_size_hint = options.chunk_size_hint();
+
+    // total_size só dimensiona o buffer do upload e é conferido contra --max-upload-mb (ChunkAssembler).
+    if (options.total_size() < 0) {
+        *error = "total_size negativo";
+        return false;
+    }
+    return true;
+}
+
+const char* PdfSettingsFor(file_processor::PdfPreset preset) {
+    switch (preset) {
+    case file_processor::PDF_PRESET_SCREEN:
+        return "/screen";
+    case file_processor::PDF_PRESET_PRINTER:
+        return "/printer";
+    case file_processor::PDF_PRESET_PREPRESS:
+        return "/prepress";
+    default:
+        return "/ebook";
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+
+#include "proto/file_processor.pb.h"
+
+// Padrões usados quando nem as opções nem o file_name legado definem o valor.
+constexpr char kDefaultOutputFormat[] = "png";
+constexpr int kDefaultResizeWidth = 800;
+constexpr int kDefaultResizeHeight = 600;
+
+// Parâmetros efetivos de uma requisição. Vêm de ProcessingOptions (header do
+// stream ou FileRequest.options); campos zerados caem no file_name legado
+// ("nome|largura|altura", "nome|formato") e depois nos padrões acima.
+struct RequestParams {
+    // file_name sem os parâmetros legados.
+    std::string name;
+    // Em minúsculas, um dos formatos aceitos (png, jpg, jpeg, webp, gif, bmp,
+    // tiff, pnm).
+    std::string output_format;
+    int width = 0;
+    int height = 0;
+    // 0 = padrão da ferramenta.
+    int quality = 0;
+    file_processor::PdfPreset pdf_preset = file_processor::PDF_PRESET_DEFAULT;
+    // Nível do Flate escrito em processo (flate.h); 0 = padrão.
+    int compression_level = 0;
+    // 0 = sem preferência (ver NegotiateChunkSize).
+    int chunk_size_hint = 0;
+};
+
+// Resolve os parâmetros. Retorna false e preenche error se options tiver
+// valores inválidos; parâmetros legados inválidos são ignorados, como antes.
+bool ResolveRequestParams(const std::string& file_name, const file_processor::ProcessingOptions& options,
+                          RequestParams* params, std::string* error);
+
+// Valor de -dPDFSETTINGS do preset ("/ebook" para o padrão).
+const char* PdfSettingsFor(file_processor::PdfPreset preset);
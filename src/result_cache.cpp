@@ -0,0 +1,224 @@
+#include "src/result_cache.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "src/content_hash.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Nomes de arquivo da camada em disco são as próprias chaves (hex).
+bool IsCacheKey(const std::string& name) {
+    if (name.size() != 64) {
+        return false;
+    }
+    for (char c : name) {
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+std::string MakeCacheKey(const std::string& content_digest, const std::string& method,
+                         const std::string& params) {
+    ContentHasher hasher;
+    // Separador '\0' evita ambiguidade entre os campos.
+    hasher.Update(content_digest.data(), content_digest.size());
+    hasher.Update("", 1);
+    hasher.Update(method.data(), method.size());
+    hasher.Update("", 1);
+    hasher.Update(params.data(), params.size());
+    return hasher.HexDigest();
+}
+
+ResultCache::ResultCache(const Options& options) : options_(options) {
+    if (!options_.disk_dir.empty()) {
+        std::error_code ec;
+        fs::create_directories(options_.disk_dir, ec);
+        LoadDiskIndex();
+    }
+}
+
+void ResultCache::LoadDiskIndex() {
+    std::error_code ec;
+    for (const fs::directory_entry& entry : fs::directory_iterator(options_.disk_dir, ec)) {
+        std::string name = entry.path().filename().string();
+        if (!entry.is_regular_file(ec) || !IsCacheKey(name)) {
+            continue;
+        }
+        size_t size = entry.file_size(ec);
+        if (ec) {
+            continue;
+        }
+        disk_lru_.push_back(DiskEntry{name, size});
+        disk_index_[name] = std::prev(disk_lru_.end());
+        disk_used_ += size;
+    }
+}
+
+std::string ResultCache::DiskPath(const std::string& key) const {
+    return options_.disk_dir + "/" + key;
+}
+
+std::shared_ptr<const std::string> ResultCache::Lookup(const std::string& key) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = memory_index_.find(key);
+        if (it != memory_index_.end()) {
+            memory_lru_.splice(memory_lru_.begin(), memory_lru_, it->second);
+            ++memory_hits_;
+            return it->second->data;
+        }
+        auto disk_it = disk_index_.find(key);
+        if (disk_it == disk_index_.end()) {
+            ++misses_;
+            return nullptr;
+        }
+        disk_lru_.splice(disk_lru_.begin(), disk_lru_, disk_it->second);
+    }
+
+    // Leitura do disco fora do lock. Se o arquivo sumiu (despejado em
+    // paralelo), conta como miss.
+    std::ifstream file(DiskPath(key), std::ios::binary);
+    if (!file) {
+        ++misses_;
+        return nullptr;
+    }
+    auto data = std::make_shared<std::string>((std::istreambuf_iterator<char>(file)),
+                                              std::istreambuf_iterator<char>());
+    ++disk_hits_;
+
+    // Promover para a memória, com o mesmo limite de tamanho do Insert:
+    // uma entrada grande ficaria sozinha na camada e expulsaria as outras.
+    if (!FitsInMemory(*data)) {
+        return data;
+    }
+    std::list<MemoryEntry> evicted;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (memory_index_.find(key) == memory_index_.end()) {
+            InsertMemoryLocked(key, data, &evicted);
+        }
+    }
+    for (const MemoryEntry& entry : evicted) {
+        SpillToDisk(entry.key, *entry.data);
+    }
+    return data;
+}
+
+bool ResultCache::Contains(const std::string& key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return memory_index_.count(key) != 0 || disk_index_.count(key) != 0;
+}
+
+void ResultCache::Insert(const std::string& key, std::string data) {
+    Insert(key, std::make_shared<const std::string>(std::move(data)));
+}
+
+void ResultCache::Insert(const std::string& key, std::shared_ptr<const std::string> shared) {
+    ++insertions_;
+
+    std::list<MemoryEntry> evicted;
+    bool fits_in_memory = FitsInMemory(*shared);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (memory_index_.count(key) != 0) {
+            return;
+        }
+        if (fits_in_memory) {
+            InsertMemoryLocked(key, shared, &evicted);
+        }
+    }
+    if (!fits_in_memory) {
+        // Grande demais para a memória: direto para o disco.
+        SpillToDisk(key, *shared);
+    }
+    for (const MemoryEntry& entry : evicted) {
+        SpillToDisk(entry.key, *entry.data);
+    }
+}
+
+void ResultCache::InsertMemoryLocked(const std::string& key, Data data, std::list<MemoryEntry>* evicted) {
+    memory_used_ += data->size();
+    memory_lru_.push_front(MemoryEntry{key, std::move(data)});
+    memory_index_[key] = memory_lru_.begin();
+
+    while (memory_used_ > options_.memory_bytes && memory_lru_.size() > 1) {
+        auto last = std::prev(memory_lru_.end());
+        memory_used_ -= last->data->size();
+        memory_index_.erase(last->key);
+        evicted->splice(evicted->end(), memory_lru_, last);
+        ++evictions_;
+    }
+}
+
+void ResultCache::SpillToDisk(const std::string& key, const std::string& data) {
+    if (options_.disk_dir.empty() || data.size() > options_.disk_bytes) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (disk_index_.count(key) != 0) {
+            return;
+        }
+    }
+
+    // Escrita atômica: arquivo temporário + rename.
+    std::string path = DiskPath(key);
+    std::string tmp_path = path + ".tmp." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!file.write(data.data(), data.size())) {
+            std::remove(tmp_path.c_str());
+            return;
+        }
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+        return;
+    }
+
+    std::vector<std::string> removed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (disk_index_.count(key) != 0) {
+            return;
+        }
+        disk_lru_.push_front(DiskEntry{key, data.size()});
+        disk_index_[key] = disk_lru_.begin();
+        disk_used_ += data.size();
+        while (disk_used_ > options_.disk_bytes && disk_lru_.size() > 1) {
+            const DiskEntry& last = disk_lru_.back();
+            disk_used_ -= last.size;
+            removed.push_back(last.key);
+            disk_index_.erase(last.key);
+            disk_lru_.pop_back();
+        }
+    }
+    for (const std::string& old_key : removed) {
+        std::remove(DiskPath(old_key).c_str());
+    }
+}
+
+ResultCache::Stats ResultCache::stats() const {
+    Stats stats;
+    stats.memory_hits = memory_hits_;
+    stats.disk_hits = disk_hits_;
+    stats.misses = misses_;
+    stats.insertions = insertions_;
+    stats.evictions = evictions_;
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats.memory_bytes = memory_used_;
+    stats.disk_bytes = disk_used_;
+    return stats;
+}
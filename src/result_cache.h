@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Cache de resultados endereçado por conteúdo.
+//
+// A chave combina o hash do arquivo recebido com a RPC e seus parâmetros
+// (MakeCacheKey). O valor é o conteúdo gerado (PDF comprimido, imagem...).
+// Camada em memória com LRU limitada por bytes; o que sai dela vai para a
+// camada em disco (opcional), também LRU, que sobrevive a reinícios.
+// Thread-safe.
+class ResultCache {
+public:
+    struct Options {
+        size_t memory_bytes = 256u << 20;
+        // Diretório da camada em disco; vazio desativa a camada.
+        std::string disk_dir;
+        size_t disk_bytes = 2048u << 20;
+    };
+
+    struct Stats {
+        uint64_t memory_hits = 0;
+        uint64_t disk_hits = 0;
+        uint64_t misses = 0;
+        uint64_t insertions = 0;
+        uint64_t evictions = 0;
+        size_t memory_bytes = 0;
+        size_t disk_bytes = 0;
+    };
+
+    explicit ResultCache(const Options& options);
+
+    // Resultado em cache para key, ou nullptr.
+    std::shared_ptr<const std::string> Lookup(const std::string& key);
+    // true se key está em alguma das camadas, sem ler o valor nem contar
+    // acerto ou miss (o Lookup seguinte ainda pode falhar se ela for despejada).
+    bool Contains(const std::string& key) const;
+    void Insert(const std::string& key, std::string data);
+    // Variante que compartilha um buffer já existente, sem cópia.
+    void Insert(const std::string& key, std::shared_ptr<const std::string> data);
+
+    Stats stats() const;
+
+private:
+    using Data = std::shared_ptr<const std::string>;
+
+    struct MemoryEntry {
+        std::string key;
+        Data data;
+    };
+    struct DiskEntry {
+        std::string key;
+        size_t size;
+    };
+
+    void LoadDiskIndex();
+    std::string DiskPath(const std::string& key) const;
+    // Só entradas de até 1/8 da camada em memória vão para ela; as maiores
+    // ficam no disco.
+    bool FitsInMemory(const std::string& data) const { return data.size() <= options_.memory_bytes / 8; }
+    void InsertMemoryLocked(const std::string& key, Data data, std::list<MemoryEntry>* evicted);
+    void SpillToDisk(const std::string& key, const std::string& data);
+
+    const Options options_;
+
+    mutable std::mutex mutex_;
+    std::list<MemoryEntry> memory_lru_;  // mais recente na frente
+    std::unordered_map<std::string, std::list<MemoryEntry>::iterator> memory_index_;
+    size_t memory_used_ = 0;
+    std::list<DiskEntry> disk_lru_;
+    std::unordered_map<std::string, std::list<DiskEntry>::iterator> disk_index_;
+    size_t disk_used_ = 0;
+
+    std::atomic<uint64_t> memory_hits_{0};
+    std::atomic<uint64_t> disk_hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> insertions_{0};
+    std::atomic<uint64_t> evictions_{0};
+};
+
+// Chave do cache: hash(digest do conteúdo, método, parâmetros).
+std::string MakeCacheKey(const std::string& content_digest, const std::string& method,
+                         const std::string& params);
@@ -0,0 +1,219 @@
+#include "src/scratch_storage.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+constexpr size_t kMaxLabelLength = 40;
+
+// Só caracteres seguros em nomes de arquivo e na linha de comando do gs
+// ('%' em -sOutputFile seria um formato de página).
+std::string SanitizeLabel(const std::string& label) {
+    std::string out;
+    for (char c : label) {
+        if (out.size() == kMaxLabelLength) {
+            break;
+        }
+        bool safe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '.' ||
+                    c == '_' || c == '-';
+        out.push_back(safe ? c : '_');
+    }
+    return out.empty() ? "scratch" : out;
+}
+
+std::string ErrnoMessage(const char* what) {
+    return std::string(what) + ": " + std::strerror(errno);
+}
+
+}  // namespace
+
+ScratchFile::~ScratchFile() {
+    Reset();
+}
+
+ScratchFile::ScratchFile(ScratchFile&& other) noexcept
+    : fd_(std::exchange(other.fd_, -1)),
+      path_(std::move(other.path_)),
+      in_memory_(other.in_memory_),
+      named_(std::exchange(other.named_, false)) {}
+
+ScratchFile& ScratchFile::operator=(ScratchFile&& other) noexcept {
+    if (this != &other) {
+        Reset();
+        fd_ = std::exchange(other.fd_, -1);
+        path_ = std::move(other.path_);
+        in_memory_ = other.in_memory_;
+        named_ = std::exchange(other.named_, false);
+    }
+    return *this;
+}
+
+void ScratchFile::Reset() {
+    if (named_) {
+        unlink(path_.c_str());
+        named_ = false;
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+    path_.clear();
+    in_memory_ = false;
+}
+
+bool ScratchFile::Write(const std::string& data, std::string* error) {
+    if (ftruncate(fd_, 0) != 0) {
+        *error = ErrnoMessage("ftruncate");
+        return false;
+    }
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t n = pwrite(fd_, data.data() + written, data.size() - written, static_cast<off_t>(written));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            *error = ErrnoMessage("write");
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool ScratchFile::ReadAll(std::string* data, std::string* error) const {
+    // A ferramenta pode ter truncado e regravado o arquivo por outro
+    // descritor: o tamanho vem do fstat, não do que foi escrito aqui.
+    struct stat st;
+    if (fstat(fd_, &st) != 0) {
+        *error = ErrnoMessage("fstat");
+        return false;
+    }
+    data->resize(static_cast<size_t>(st.st_size));
+    size_t read_bytes = 0;
+    while (read_bytes < data->size()) {
+        ssize_t n = pread(fd_, &(*data)[read_bytes], data->size() - read_bytes, static_cast<off_t>(read_bytes));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            *error = ErrnoMessage("read");
+            return false;
+        }
+        if (n == 0) {
+            break;
+        }
+        read_bytes += static_cast<size_t>(n);
+    }
+    data->resize(read_bytes);
+    return true;
+}
+
+ScratchStorage::ScratchStorage(const Options& options)
+    : options_(options), proc_available_(access("/proc/self/fd", R_OK | X_OK) == 0) {}
+
+bool ScratchStorage::Create(const std::string& label, size_t size_hint, ScratchFile* file, std::string* error) {
+    std::string safe_label = SanitizeLabel(label);
+    bool ok = false;
+    if (proc_available_ && memfd_supported_ && size_hint <= options_.memory_threshold &&
+        options_.memory_threshold > 0) {
+        ok = CreateInMemory(safe_label, file, error);
+    }
+    if (!ok) {
+        ok = CreateSpilled(safe_label, file, error);
+    }
+    if (!ok) {
+        failures_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    (file->in_memory() ? memory_files_ : spilled_files_).fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool ScratchStorage::CreateWith(const std::string& label, const std::string& data, ScratchFile* file,
+                                std::string* error) {
+    if (!Create(label, data.size(), file, error)) {
+        return false;
+    }
+    if (!file->Write(data, error)) {
+        failures_.fetch_add(1, std::memory_order_relaxed);
+        file->Reset();
+        return false;
+    }
+    return true;
+}
+
+bool ScratchStorage::CreateInMemory(const std::string& label, ScratchFile* file, std::string* error) {
+    int fd = memfd_create(("fp_" + label).c_str(), MFD_CLOEXEC);
+    if (fd < 0) {
+        if (errno == ENOSYS) {
+            memfd_supported_ = false;
+        }
+        *error = ErrnoMessage("memfd_create");
+        return false;
+    }
+    ScratchFile created;
+    created.fd_ = fd;
+    created.path_ = ProcPath(fd);
+    created.in_memory_ = true;
+    *file = std::move(created);
+    return true;
+}
+
+bool ScratchStorage::CreateSpilled(const std::string& label, ScratchFile* file, std::string* error) {
+    ScratchFile created;
+    if (proc_available_ && tmpfile_supported_) {
+        int fd = open(options_.spill_dir.c_str(), O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+        if (fd >= 0) {
+            created.fd_ = fd;
+            created.path_ = ProcPath(fd);
+            *file = std::move(created);
+            return true;
+        }
+        // Sistema de arquivos sem O_TMPFILE: mkstemp daqui em diante.
+        if (errno != EOPNOTSUPP && errno != EISDIR && errno != EINVAL) {
+            *error = ErrnoMessage(("open " + options_.spill_dir).c_str());
+            return false;
+        }
+        tmpfile_supported_ = false;
+    }
+
+    std::string path = options_.spill_dir + "/fp_" + label + "_XXXXXX";
+    int fd = mkostemp(&path[0], O_CLOEXEC);
+    if (fd < 0) {
+        *error = ErrnoMessage(("mkstemp " + options_.spill_dir).c_str());
+        return false;
+    }
+    created.fd_ = fd;
+    if (proc_available_) {
+        // O nome só serviu para criar o arquivo sem colisão.
+        unlink(path.c_str());
+        created.path_ = ProcPath(fd);
+    } else {
+        created.path_ = path;
+        created.named_ = true;
+    }
+    *file = std::move(created);
+    return true;
+}
+
+std::string ScratchStorage::ProcPath(int fd) const {
+    // /proc/self apontaria para o processo filho; o pid do servidor não.
+    return "/proc/" + std::to_string(getpid()) + "/fd/" + std::to_string(fd);
+}
+
+ScratchStorage::Stats ScratchStorage::stats() const {
+    Stats stats;
+    stats.memory_files = memory_files_.load(std::memory_order_relaxed);
+    stats.spilled_files = spilled_files_.load(std::memory_order_relaxed);
+    stats.failures = failures_.load(std::memory_order_relaxed);
+    return stats;
+}
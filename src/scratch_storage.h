@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Arquivos temporários das ferramentas externas (gs, qpdf).
+//
+// Arquivos com tamanho previsto até memory_threshold ficam em memória
+// (memfd_create); os maiores vão para spill_dir como arquivos anônimos
+// (O_TMPFILE). Nos dois casos o arquivo não tem nome no sistema de arquivos:
+// as ferramentas o abrem por /proc/<pid>/fd/<fd>, e fechar o descritor o
+// libera. Sem /proc (ou sem O_TMPFILE no spill_dir) o arquivo é criado com
+// mkstemp em spill_dir e removido pelo destrutor.
+//
+// Os nomes nunca vêm do cliente, então uploads simultâneos com o mesmo nome
+// não colidem.
+
+// Um arquivo temporário. Só pode ser movido; o destrutor libera o arquivo
+// (inclusive nos caminhos de erro).
+class ScratchFile {
+public:
+    ScratchFile() = default;
+    ~ScratchFile();
+
+    ScratchFile(ScratchFile&& other) noexcept;
+    ScratchFile& operator=(ScratchFile&& other) noexcept;
+    ScratchFile(const ScratchFile&) = delete;
+    ScratchFile& operator=(const ScratchFile&) = delete;
+
+    bool valid() const { return fd_ >= 0; }
+    // Caminho para passar às ferramentas (leitura e escrita).
+    const std::string& path() const { return path_; }
+    // true se o conteúdo está em memória (memfd).
+    bool in_memory() const { return in_memory_; }
+
+    // Substitui o conteúdo do arquivo por data.
+    bool Write(const std::string& data, std::string* error);
+    // Lê o conteúdo atual, inclusive o que uma ferramenta gravou pelo path().
+    bool ReadAll(std::string* data, std::string* error) const;
+
+private:
+    friend class ScratchStorage;
+
+    void Reset();
+
+    int fd_ = -1;
+    std::string path_;
+    bool in_memory_ = false;
+    // Arquivo com nome em disco (fallback do mkstemp): removido no destrutor.
+    bool named_ = false;
+};
+
+// Fábrica de ScratchFile. Thread-safe.
+class ScratchStorage {
+public:
+    struct Options {
+        // Arquivos previstos até este tamanho ficam em memória (0 = nunca).
+        size_t memory_threshold = 64u << 20;
+        // Diretório dos arquivos maiores.
+        std::string spill_dir = "/tmp";
+    };
+
+    struct Stats {
+        uint64_t memory_files = 0;
+        uint64_t spilled_files = 0;
+        uint64_t failures = 0;
+    };
+
+    explicit ScratchStorage(const Options& options);
+
+    // Cria um arquivo vazio para até size_hint bytes (0 = desconhecido,
+    // tratado como pequeno). label entra no nome do arquivo em disco (só
+    // [A-Za-z0-9._-], truncado) para facilitar a depuração.
+    bool Create(const std::string& label, size_t size_hint, ScratchFile* file, std::string* error);
+    // Cria um arquivo já com data.
+    bool CreateWith(const std::string& label, const std::string& data, ScratchFile* file, std::string* error);
+
+    Stats stats() const;
+
+private:
+    bool CreateInMemory(const std::string& label, ScratchFile* file, std::string* error);
+    bool CreateSpilled(const std::string& label, ScratchFile* file, std::string* error);
+    // Caminho /proc/<pid>/fd/<fd>, válido também nos processos filhos.
+    std::string ProcPath(int fd) const;
+
+    const Options options_;
+    // /proc acessível: arquivos anônimos podem ser abertos pelo caminho.
+    const bool proc_available_;
+
+    std::atomic<bool> memfd_supported_{true};
+    std::atomic<bool> tmpfile_supported_{true};
+    std::atomic<uint64_t> memory_files_{0};
+    std::atomic<uint64_t> spilled_files_{0};
+    std::atomic<uint64_t> failures_{0};
+};
@@ -0,0 +1,363 @@
+#include "src/server_options.h"
+
+#include <cstdlib>
+#include <sstream>
+
+namespace {
+
+// Separa "--nome=valor" em nome e valor. Retorna false se não for uma flag.
+bool SplitFlag(const std::string& arg, std::string* name, std::string* value) {
+    if (arg.rfind("--", 0) != 0) {
+        return false;
+    }
+    size_t eq = arg.find('=');
+    if (eq == std::string::npos) {
+        *name = arg.substr(2);
+        value->clear();
+    } else {
+        *name = arg.substr(2, eq - 2);
+        *value = arg.substr(eq + 1);
+    }
+    return true;
+}
+
+bool ParseInt(const std::string& text, int min_value, int* out) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    long v = std::strtol(text.c_str(), &end, 10);
+    if (*end != '\0' || v < min_value || v > 1 << 30) {
+        return false;
+    }
+    *out = static_cast<int>(v);
+    return true;
+}
+
+// Flags booleanas aceitam "--nome", "--nome=true" e "--nome=false".
+bool ParseBool(const std::string& text, bool* out) {
+    if (text.empty() || text == "true") {
+        *out = true;
+    } else if (text == "false") {
+        *out = false;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// "compress:4,resize:2" -> limites na ordem de Rpc. Nomes como no loadgen.
+bool ParseAdmissionLimits(const std::string& text, std::array<int, 4>* limits) {
+    static const char* const kNames[] = {"compress", "totxt", "convert", "resize"};
+    std::stringstream list(text);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        size_t colon = item.find(':');
+        if (colon == std::string::npos) {
+            return false;
+        }
+        std::string name = item.substr(0, colon);
+        int limit = 0;
+        if (!ParseInt(item.substr(colon + 1), 0, &limit)) {
+            return false;
+        }
+        bool known = false;
+        for (size_t i = 0; i < limits->size(); ++i) {
+            if (name == kNames[i]) {
+                (*limits)[i] = limit;
+                known = true;
+            }
+        }
+        if (!known) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+bool ParseServerOptions(int argc, char** argv, ServerOptions* options, std::string* error) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string name, value;
+        if (!SplitFlag(arg, &name, &value)) {
+            *error = "Argumento inválido: " + arg;
+            return false;
+        }
+
+        if (name == "address") {
+            options->address = value;
+        } else if (name == "pdf-engine") {
+            if (value == "process") {
+                options->pdf_engine = PdfEngineKind::kProcess;
+            } else if (value == "gsapi") {
+                options->pdf_engine = PdfEngineKind::kGsApi;
+            } else {
+                *error = "Valor inválido para --pdf-engine: " + value;
+                return false;
+            }
+        } else if (name == "gs-instances") {
+            if (!ParseInt(value, 0, &options->gs_instances)) {
+                *error = "Valor inválido para --gs-instances: " + value;
+                return false;
+            }
+        } else if (name == "async") {
+            if (!ParseBool(value, &options->async)) {
+                *error = "Valor inválido para --async: " + value;
+                return false;
+            }
+        } else if (name == "cq-count") {
+            if (!ParseInt(value, 0, &options->cq_count)) {
+                *error = "Valor inválido para --cq-count: " + value;
+                return false;
+            }
+        } else if (name == "workers") {
+            if (!ParseInt(value, 0, &options->workers)) {
+                *error = "Valor inválido para --workers: " + value;
+                return false;
+            }
+        } else if (name == "max-queued-jobs") {
+            if (!ParseInt(value, 1, &options->max_queued_jobs)) {
+                *error = "Valor inválido para --max-queued-jobs: " + value;
+                return false;
+            }
+        } else if (name == "response-chunk-size") {
+            if (!ParseInt(value, 1, &options->response_chunk_size)) {
+                *error = "Valor inválido para --response-chunk-size: " + value;
+                return false;
+            }
+        } else if (name == "max-upload-mb") {
+            if (!ParseInt(value, 0, &options->max_upload_mb)) {
+                *error = "Valor inválido para --max-upload-mb: " + value;
+                return false;
+            }
+        } else if (name == "pipeline") {
+            if (!ParseBool(value, &options->pipeline)) {
+                *error = "Valor inválido para --pipeline: " + value;
+                return false;
+            }
+        } else if (name == "cache-memory-mb") {
+            if (!ParseInt(value, 0, &options->cache_memory_mb)) {
+                *error = "Valor inválido para --cache-memory-mb: " + value;
+                return false;
+            }
+        } else if (name == "cache-dir") {
+            options->cache_dir = value;
+        } else if (name == "cache-disk-mb") {
+            if (!ParseInt(value, 0, &options->cache_disk_mb)) {
+                *error = "Valor inválido para --cache-disk-mb: " + value;
+                return false;
+            }
+        } else if (name == "scratch-memory-mb") {
+            if (!ParseInt(value, 0, &options->scratch_memory_mb)) {
+                *error = "Valor inválido para --scratch-memory-mb: " + value;
+                return false;
+            }
+        } else if (name == "scratch-dir") {
+            if (value.empty()) {
+                *error = "Valor inválido para --scratch-dir: " + value;
+                return false;
+            }
+            options->scratch_dir = value;
+        } else if (name == "admission") {
+            if (!ParseBool(value, &options->admission)) {
+                *error = "Valor inválido para --admission: " + value;
+                return false;
+            }
+        } else if (name == "admission-limits") {
+            if (!ParseAdmissionLimits(value, &options->admission_limits)) {
+                *error = "Valor inválido para --admission-limits: " + value;
+                return false;
+            }
+        } else if (name == "admission-queue") {
+            if (!ParseInt(value, 0, &options->admission_queue)) {
+                *error = "Valor inválido para --admission-queue: " + value;
+                return false;
+            }
+        } else if (name == "admission-memory-mb") {
+            if (!ParseInt(value, 0, &options->admission_memory_mb)) {
+                *error = "Valor inválido para --admission-memory-mb: " + value;
+                return false;
+            }
+        } else if (name == "sjf-large-job-ms") {
+            if (!ParseInt(value, 0, &options->sjf_large_job_ms)) {
+                *error = "Valor inválido para --sjf-large-job-ms: " + value;
+                return false;
+            }
+        } else if (name == "small-lane-workers") {
+            if (!ParseInt(value, 0, &options->small_lane_workers)) {
+                *error = "Valor inválido para --small-lane-workers: " + value;
+                return false;
+            }
+        } else if (name == "single-flight") {
+            if (!ParseBool(value, &options->single_flight)) {
+                *error = "Valor inválido para --single-flight: " + value;
+                return false;
+            }
+        } else if (name == "parallel-pdf") {
+            if (!ParseBool(value, &options->parallel_pdf)) {
+                *error = "Valor inválido para --parallel-pdf: " + value;
+                return false;
+            }
+        } else if (name == "parallel-pdf-min-pages") {
+            if (!ParseInt(value, 2, &options->parallel_pdf_min_pages)) {
+                *error = "Valor inválido para --parallel-pdf-min-pages: " + value;
+                return false;
+            }
+        } else if (name == "parallel-pdf-workers") {
+            if (!ParseInt(value, 0, &options->parallel_pdf_workers)) {
+                *error = "Valor inválido para --parallel-pdf-workers: " + value;
+                return false;
+            }
+        } else if (name == "native-pdf-images") {
+            if (!ParseBool(value, &options->native_pdf_images)) {
+                *error = "Valor inválido para --native-pdf-images: " + value;
+                return false;
+            }
+        } else if (name == "native-pdf-threads") {
+            if (!ParseInt(value, 0, &options->native_pdf_threads)) {
+                *error = "Valor inválido para --native-pdf-threads: " + value;
+                return false;
+            }
+        } else if (name == "pdf-precheck-min-savings") {
+            if (!ParseInt(value, 0, &options->pdf_precheck_min_savings) || options->pdf_precheck_min_savings > 100) {
+                *error = "Valor inválido para --pdf-precheck-min-savings: " + value;
+                return false;
+            }
+        } else if (name == "native-resize") {
+            if (!ParseBool(value, &options->native_resize)) {
+                *error = "Valor inválido para --native-resize: " + value;
+                return false;
+            }
+        } else if (name == "resize-filter") {
+            if (!ParseResizeFilter(value, &options->resize_filter)) {
+                *error = "Valor inválido para --resize-filter: " + value;
+                return false;
+            }
+        } else if (name == "resize-threads") {
+            if (!ParseInt(value, 0, &options->resize_threads)) {
+                *error = "Valor inválido para --resize-threads: " + value;
+                return false;
+            }
+        } else if (name == "jpeg-shrink-on-load") {
+            if (!ParseBool(value, &options->jpeg_shrink_on_load)) {
+                *error = "Valor inválido para --jpeg-shrink-on-load: " + value;
+                return false;
+            }
+        } else if (name == "flate-backend") {
+            if (!ParseFlateBackend(value, &options->flate_backend)) {
+                *error = "Valor inválido para --flate-backend: " + value;
+                return false;
+            }
+        } else if (name == "native-txt") {
+            if (!ParseBool(value, &options->native_txt)) {
+                *error = "Valor inválido para --native-txt: " + value;
+                return false;
+            }
+        } else if (name == "txt-threads") {
+            if (!ParseInt(value, 0, &options->txt_threads)) {
+                *error = "Valor inválido para --txt-threads: " + value;
+                return false;
+            }
+        } else if (name == "metrics-port") {
+            if (!ParseInt(value, 0, &options->metrics_port) || options->metrics_port > 65535) {
+                *error = "Valor inválido para --metrics-port: " + value;
+                return false;
+            }
+        } else if (name == "log-buffer") {
+            if (!ParseInt(value, 2, &options->log_buffer)) {
+                *error = "Valor inválido para --log-buffer: " + value;
+                return false;
+            }
+        } else if (name == "log-overflow") {
+            if (value == "drop") {
+                options->log_overflow = LogOverflow::kDrop;
+            } else if (value == "block") {
+                options->log_overflow = LogOverflow::kBlock;
+            } else {
+                *error = "Valor inválido para --log-overflow: " + value;
+                return false;
+            }
+        } else if (name == "log-file") {
+            options->log_file = value;
+        } else {
+            *error = "Flag desconhecida: --" + name;
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string ServerUsage(const char* program) {
+    std::ostringstream out;
+    out << "Uso: " << program << " [flags]\n"
+        << "  --address=HOST:PORTA      endereço de escuta (padrão 0.0.0.0:50051)\n"
+        << "  --pdf-engine=process|gsapi\n"
+        << "                            process: executa gs a cada requisição;\n"
+        << "                            gsapi: pool de instâncias libgs pré-inicializadas\n"
+        << "  --gs-instances=N          tamanho do pool gsapi (0 = núcleos)\n"
+        << "  --parallel-pdf            comprime PDFs grandes por intervalos de páginas em\n"
+        << "                            paralelo e junta o resultado\n"
+        << "  --parallel-pdf-min-pages=N\n"
+        << "                            páginas mínimas para o modo paralelo (padrão 32)\n"
+        << "  --parallel-pdf-workers=N  processos gs simultâneos no modo paralelo (0 = núcleos)\n"
+        << "  --native-pdf-images=BOOL  CompressPDF reamostra e recodifica em processo, em paralelo,\n"
+        << "                            as imagens de PDFs em que elas dominam a economia, sem gs\n"
+        << "                            (padrão false)\n"
+        << "  --native-pdf-threads=N    imagens simultâneas por PDF no modo acima (0 = núcleos)\n"
+        << "  --pdf-precheck-min-savings=PCT\n"
+        << "                            CompressPDF devolve o PDF sem passar pelo gs se a economia\n"
+        << "                            estimada pela pré-análise fica abaixo de PCT% (padrão 5;\n"
+        << "                            0 sempre roda o gs)\n"
+        << "  --native-resize=BOOL      ResizeImage em processo (SIMD) em vez de devolver a\n"
+        << "                            imagem inalterada (padrão true; PNM, JPEG e PNG)\n"
+        << "  --resize-filter=box|bilinear|lanczos3\n"
+        << "                            filtro do redimensionamento (padrão lanczos3)\n"
+        << "  --resize-threads=N        threads por imagem redimensionada (0 = núcleos)\n"
+        << "  --jpeg-shrink-on-load=BOOL\n"
+        << "                            decodifica JPEGs grandes já reduzidos pelo DCT antes do\n"
+        << "                            filtro final (padrão true)\n"
+        << "  --flate-backend=auto|zlib|libdeflate\n"
+        << "                            codec Flate dos PDFs e PNGs tratados em processo (padrão\n"
+        << "                            auto: libdeflate se compilada, senão zlib)\n"
+        << "  --native-txt=BOOL         ConvertToTXT em processo, página a página, sem pdftotext\n"
+        << "                            (padrão true; vale também no modo pipeline)\n"
+        << "  --txt-threads=N           threads por PDF na extração de texto (0 = núcleos)\n"
+        << "  --async                   servidor assíncrono com CompletionQueues\n"
+        << "  --cq-count=N              completion queues no modo assíncrono (0 = núcleos)\n"
+        << "  --workers=N               threads de conversão no modo assíncrono (0 = núcleos)\n"
+        << "  --max-queued-jobs=N       conversões em espera antes de RESOURCE_EXHAUSTED (padrão 256)\n"
+        << "  --response-chunk-size=BYTES\n"
+        << "                            tamanho dos chunks de resposta (padrão 1 MiB; cliente\n"
+        << "                            pode negociar com o metadado x-chunk-size)\n"
+        << "  --max-upload-mb=N         maior upload em streaming (padrão 1024; 0 = sem limite)\n"
+        << "  --pipeline                upload direto no stdin de gs/pdftotext/convert e\n"
+        << "                            resposta em streaming (servidor síncrono)\n"
+        << "  --cache-memory-mb=N       cache de resultados em memória (padrão 256; 0 desliga)\n"
+        << "  --cache-dir=DIR           camada em disco do cache (vazio = sem disco)\n"
+        << "  --cache-disk-mb=N         limite da camada em disco (padrão 2048)\n"
+        << "  --scratch-memory-mb=N     temporários do gs até N MiB ficam em memória (padrão 64;\n"
+        << "                            0 = sempre em disco)\n"
+        << "  --scratch-dir=DIR         diretório dos temporários maiores (padrão /tmp)\n"
+        << "  --admission=BOOL          limita execuções simultâneas por RPC (padrão true)\n"
+        << "  --admission-limits=RPC:N,...\n"
+        << "                            limites explícitos (compress, totxt, convert, resize);\n"
+        << "                            os omitidos saem dos núcleos e da memória\n"
+        << "  --admission-queue=N       requisições esperando vaga por RPC antes de\n"
+        << "                            RESOURCE_EXHAUSTED (padrão 64)\n"
+        << "  --admission-memory-mb=N   memória para as conversões ao derivar os limites\n"
+        << "                            (0 = metade da RAM)\n"
+        << "  --sjf-large-job-ms=N      custo estimado a partir do qual um job é grande e\n"
+        << "                            deixa vagas para os pequenos (padrão 2000; 0 = desligado)\n"
+        << "  --small-lane-workers=N    threads só para jobs pequenos no modo assíncrono\n"
+        << "                            (0 = workers / 4)\n"
+        << "  --single-flight=BOOL      requisições idênticas simultâneas compartilham uma\n"
+        << "                            execução (padrão true)\n"
+        << "  --metrics-port=N          endpoint Prometheus em 127.0.0.1:N/metrics (0 = desligado)\n"
+        << "  --log-buffer=N            registros de log em buffer por thread (padrão 256)\n"
+        << "  --log-overflow=drop|block com o buffer cheio: drop descarta INFO/SUCCESS (erros\n"
+        << "                            sempre esperam); block faz toda thread esperar\n"
+        << "  --log-file=PATH           grava o log também neste arquivo\n";
+    return out.str();
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <string>
+
+#include "src/flate.h"
+#include "src/image_resize.h"
+#include "src/logging.h"
+
+// Opções de linha de comando do servidor.
+// Cada flag tem o formato --nome=valor; flags desconhecidas são erro.
+
+enum class PdfEngineKind {
+    kProcess,  // um processo gs a cada requisição (comportamento original)
+    kGsApi,    // pool de instâncias libgs pré-inicializadas no próprio processo
+};
+
+struct ServerOptions {
+    std::string address = "0.0.0.0:50051";
+
+    // Motor usado por CompressPDF.
+    PdfEngineKind pdf_engine = PdfEngineKind::kProcess;
+    // Número de instâncias Ghostscript no pool (0 = número de núcleos).
+    int gs_instances = 0;
+
+    // Compressão paralela por páginas: PDFs com pelo menos
+    // parallel_pdf_min_pages páginas são divididos em intervalos comprimidos
+    // em paralelo e depois juntados. Menores seguem em passada única.
+    bool parallel_pdf = false;
+    int parallel_pdf_min_pages = 32;
+    // Processos gs simultâneos do modo paralelo (0 = número de núcleos).
+    int parallel_pdf_workers = 0;
+    // Pré-análise do CompressPDF: se a economia estimada do gs fica abaixo
+    // desta porcentagem do arquivo, o PDF volta sem passar pelo gs
+    // (0 desliga). A saída do gs maior que a entrada também é descartada.
+    int pdf_precheck_min_savings = 5;
+    // Recompressão das imagens em processo: PDFs cuja economia vem quase
+    // toda das imagens têm as imagens reamostradas e recodificadas em
+    // paralelo, sem gs; os demais seguem pelo motor acima. native_pdf_threads
+    // é o número de imagens simultâneas por documento (0 = número de núcleos).
+    bool native_pdf_images = false;
+    int native_pdf_threads = 0;
+
+    // ResizeImage em processo (decodifica, filtra e recodifica no mesmo
+    // formato) em vez de devolver a imagem inalterada. resize_threads é o
+    // número de threads por imagem (0 = número de núcleos).
+    bool native_resize = true;
+    ResizeFilter resize_filter = ResizeFilter::kLanczos3;
+    int resize_threads = 0;
+    // JPEGs muito maiores que o destino são decodificados já reduzidos (escala
+    // 1/2, 1/4 ou 1/8 do DCT) antes do filtro final.
+    bool jpeg_shrink_on_load = true;
+    // Codec dos streams Flate lidos e escritos em processo (PDF, PNG); auto
+    // usa a libdeflate quando o servidor foi compilado com ela.
+    FlateBackend flate_backend = FlateBackend::kAuto;
+
+    // ConvertToTXT em processo (parser de PDF próprio, texto enviado página a
+    // página) em vez do texto de demonstração; também substitui o pdftotext
+    // no modo pipeline. txt_threads é o número de threads por documento
+    // (0 = número de núcleos).
+    bool native_txt = true;
+    int txt_threads = 0;
+
+    // Servidor assíncrono (CompletionQueue) em vez do serviço síncrono.
+    bool async = false;
+    // Número de ServerCompletionQueues, uma thread cada (0 = número de núcleos).
+    int cq_count = 0;
+    // Threads do executor de conversões no modo assíncrono (0 = número de núcleos).
+    int workers = 0;
+    // Conversões aguardando executor; acima disso a RPC recebe RESOURCE_EXHAUSTED.
+    int max_queued_jobs = 256;
+
+    // Tamanho padrão dos FileChunks de resposta das RPCs de streaming; o
+    // cliente pode pedir outro valor pelo metadado x-chunk-size.
+    int response_chunk_size = 1024 * 1024;
+    // Maior upload aceito pelas RPCs de streaming (fora do pipeline); acima
+    // disso, ou com total_size maior, RESOURCE_EXHAUSTED. 0 = sem limite.
+    int max_upload_mb = 1024;
+
+    // Modo pipeline: o upload vai direto para o stdin da ferramenta (gs,
+    // pdftotext, convert) e o stdout volta em chunks, sem bufferizar o
+    // arquivo inteiro. Streaming só no servidor síncrono.
+    bool pipeline = false;
+
+    // Cache de resultados por conteúdo. Memória 0 desliga o cache; diretório
+    // vazio desliga a camada em disco. Não se aplica ao modo pipeline.
+    int cache_memory_mb = 256;
+    std::string cache_dir;
+    int cache_disk_mb = 2048;
+
+    // Arquivos temporários do gs (CompressPDF fora do pipeline): até
+    // scratch_memory_mb ficam em memória (memfd), os maiores em scratch_dir.
+    int scratch_memory_mb = 64;
+    std::string scratch_dir = "/tmp";
+
+    // Controle de admissão: execuções simultâneas por RPC, na ordem de Rpc
+    // (metrics.h: CompressPDF, ConvertToTXT, ConvertImageFormat,
+    // ResizeImage); 0 deriva o limite dos núcleos e de admission_memory_mb
+    // (0 = metade da RAM). Acima do limite a requisição espera numa fila de
+    // até admission_queue posições por RPC; com a fila cheia, RESOURCE_EXHAUSTED.
+    bool admission = true;
+    std::array<int, 4> admission_limits{};
+    int admission_queue = 64;
+    int admission_memory_mb = 0;
+    // Jobs com custo estimado a partir de sjf_large_job_ms são "grandes": não
+    // ocupam todas as vagas de admissão e, no modo assíncrono, não entram na
+    // faixa de small_lane_workers threads (0 = workers / 4) reservada aos
+    // pequenos. sjf_large_job_ms = 0 desliga a distinção.
+    int sjf_large_job_ms = 2000;
+    int small_lane_workers = 0;
+
+    // Requisições idênticas simultâneas compartilham uma única execução.
+    bool single_flight = true;
+
+    // Porta local (127.0.0.1) do endpoint Prometheus /metrics (0 = desligado).
+    int metrics_port = 0;
+
+    // Logging assíncrono: registros por thread, política com o ring cheio e
+    // arquivo adicional ao console.
+    int log_buffer = 256;
+    LogOverflow log_overflow = LogOverflow::kDrop;
+    std::string log_file;
+};
+
+// Preenche options a partir de argv. Retorna false e descreve o problema em error.
+bool ParseServerOptions(int argc, char** argv, ServerOptions* options, std::string* error);
+
+// Texto de ajuda com todas as flags suportadas.
+std::string ServerUsage(const char* program);
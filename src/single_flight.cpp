@@ -0,0 +1,96 @@
+#include "src/single_flight.h"
+
+#include <chrono>
+#include <exception>
+
+bool SingleFlight::IsLeaderSpecific(const grpc::Status& status) {
+    switch (status.error_code()) {
+    case grpc::StatusCode::CANCELLED:
+    case grpc::StatusCode::DEADLINE_EXCEEDED:
+    case grpc::StatusCode::RESOURCE_EXHAUSTED:
+    case grpc::StatusCode::ABORTED:
+        return true;
+    default:
+        return false;
+    }
+}
+
+SingleFlight::Result SingleFlight::Do(const std::string& key, const std::function<Result()>& produce,
+                                      const std::function<bool()>& is_cancelled,
+                                      const std::function<void()>& on_wait) {
+    bool retried = false;
+    for (;;) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = calls_.find(key);
+        if (it == calls_.end()) {
+            // Líder.
+            auto call = std::make_shared<Call>();
+            calls_.emplace(key, call);
+            lock.unlock();
+            ++leaders_;
+            if (retried) {
+                ++retries_;
+            }
+
+            Result result;
+            try {
+                result = produce();
+            } catch (const std::exception& e) {
+                result = Result{grpc::Status(grpc::StatusCode::INTERNAL, e.what()), nullptr};
+            }
+
+            lock.lock();
+            call->result = result;
+            call->done = true;
+            calls_.erase(key);
+            std::vector<std::function<void(const Result&)>> joined = std::move(call->joined);
+            lock.unlock();
+            call->done_cv.notify_all();
+            for (const auto& done : joined) {
+                if (!IsLeaderSpecific(result.status)) {
+                    ++followers_;
+                }
+                done(result);
+            }
+            return result;
+        }
+
+        // Seguidor: espera o líder, verificando o próprio cancelamento.
+        std::shared_ptr<Call> call = it->second;
+        if (on_wait) {
+            lock.unlock();
+            on_wait();
+            lock.lock();
+        }
+        while (!call->done) {
+            if (is_cancelled && is_cancelled()) {
+                return Result{grpc::Status(grpc::StatusCode::CANCELLED, "Requisição cancelada"), nullptr};
+            }
+            call->done_cv.wait_for(lock, std::chrono::milliseconds(50));
+        }
+        if (IsLeaderSpecific(call->result.status)) {
+            retried = true;
+            continue;
+        }
+        ++followers_;
+        return call->result;
+    }
+}
+
+bool SingleFlight::Join(const std::string& key, std::function<void(const Result&)> done) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = calls_.find(key);
+    if (it == calls_.end()) {
+        return false;
+    }
+    it->second->joined.push_back(std::move(done));
+    return true;
+}
+
+SingleFlight::Stats SingleFlight::stats() const {
+    Stats stats;
+    stats.leaders = leaders_;
+    stats.followers = followers_;
+    stats.retries = retries_;
+    return stats;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <grpcpp/grpcpp.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Deduplicação de requisições idênticas em andamento ("single flight").
+//
+// A primeira chamada de Do() para uma chave executa produce (líder); as que
+// chegam enquanto ela roda esperam e recebem o mesmo buffer de resultado.
+// Se o líder termina por motivo próprio dele (cancelamento, deadline,
+// rejeição por carga), um dos que esperavam assume e executa de novo; erros
+// de processamento são repassados a todos.
+class SingleFlight {
+public:
+    struct Result {
+        grpc::Status status;
+        std::shared_ptr<const std::string> data;  // nullptr se !status.ok()
+    };
+
+    struct Stats {
+        uint64_t leaders = 0;
+        uint64_t followers = 0;   // requisições que reaproveitaram o resultado
+        uint64_t retries = 0;     // seguidores que viraram líder após falha do líder
+    };
+
+    // is_cancelled (opcional) é consultado enquanto a chamada espera o
+    // líder; se retornar true a espera termina com CANCELLED. on_wait
+    // (opcional) é chamado, sem lock, quando a chamada vai esperar um líder
+    // (ex.: para devolver a vaga no escalonador).
+    Result Do(const std::string& key, const std::function<Result()>& produce,
+              const std::function<bool()>& is_cancelled, const std::function<void()>& on_wait = nullptr);
+
+    // Espera sem thread: se há um líder executando key, done é chamado com
+    // o resultado dele quando ele termina (na thread do líder, sem lock) e
+    // Join retorna true; senão retorna false e done não é chamado. Uma falha
+    // própria do líder (IsLeaderSpecific) chega a done como está; cabe a
+    // quem chamou executar de novo.
+    bool Join(const std::string& key, std::function<void(const Result&)> done);
+
+    // Falhas que dizem respeito só à requisição do líder.
+    static bool IsLeaderSpecific(const grpc::Status& status);
+
+    Stats stats() const;
+
+private:
+    struct Call {
+        std::condition_variable done_cv;
+        bool done = false;
+        Result result;
+        // Esperas de Join, chamadas quando o líder termina.
+        std::vector<std::function<void(const Result&)>> joined;
+    };
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Call>> calls_;
+
+    std::atomic<uint64_t> leaders_{0};
+    std::atomic<uint64_t> followers_{0};
+    std::atomic<uint64_t> retries_{0};
+};
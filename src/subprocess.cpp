@@ -0,0 +1,277 @@
+#include "src/subprocess.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#include "src/abort_stats.h"
+
+namespace {
+
+constexpr size_t kMaxStderr = 4096;
+constexpr auto kCancelPollInterval = std::chrono::milliseconds(50);
+
+// Escrever num pipe cujo leitor morreu gera SIGPIPE, que mataria o servidor.
+// Com o sinal ignorado, write() retorna EPIPE.
+void IgnoreSigpipe() {
+    static std::once_flag once;
+    std::call_once(once, [] { signal(SIGPIPE, SIG_IGN); });
+}
+
+void CloseFd(int* fd) {
+    if (*fd >= 0) {
+        close(*fd);
+        *fd = -1;
+    }
+}
+
+}  // namespace
+
+std::unique_ptr<Subprocess> Subprocess::Start(const std::vector<std::string>& argv, std::string* error) {
+    IgnoreSigpipe();
+    if (argv.empty()) {
+        *error = "Comando vazio";
+        return nullptr;
+    }
+
+    int in_pipe[2], out_pipe[2], err_pipe[2];
+    if (pipe2(in_pipe, O_CLOEXEC) != 0) {
+        *error = std::string("pipe: ") + std::strerror(errno);
+        return nullptr;
+    }
+    if (pipe2(out_pipe, O_CLOEXEC) != 0) {
+        *error = std::string("pipe: ") + std::strerror(errno);
+        close(in_pipe[0]);
+        close(in_pipe[1]);
+        return nullptr;
+    }
+    if (pipe2(err_pipe, O_CLOEXEC) != 0) {
+        *error = std::string("pipe: ") + std::strerror(errno);
+        close(in_pipe[0]);
+        close(in_pipe[1]);
+        close(out_pipe[0]);
+        close(out_pipe[1]);
+        return nullptr;
+    }
+
+    // argv precisa existir antes do fork: entre fork e exec só chamadas
+    // async-signal-safe.
+    std::vector<char*> args;
+    for (const std::string& arg : argv) {
+        args.push_back(const_cast<char*>(arg.c_str()));
+    }
+    args.push_back(nullptr);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        *error = std::string("fork: ") + std::strerror(errno);
+        for (int fd : {in_pipe[0], in_pipe[1], out_pipe[0], out_pipe[1], err_pipe[0], err_pipe[1]}) {
+            close(fd);
+        }
+        return nullptr;
+    }
+    if (pid == 0) {
+        setpgid(0, 0);
+        dup2(in_pipe[0], STDIN_FILENO);
+        dup2(out_pipe[1], STDOUT_FILENO);
+        dup2(err_pipe[1], STDERR_FILENO);
+        signal(SIGPIPE, SIG_DFL);
+        execvp(args[0], args.data());
+        const char msg[] = "exec falhou\n";
+        ssize_t ignored = write(STDERR_FILENO, msg, sizeof(msg) - 1);
+        (void)ignored;
+        _exit(127);
+    }
+
+    // Também no pai, para o grupo existir antes de um Kill() imediato.
+    setpgid(pid, pid);
+    close(in_pipe[0]);
+    close(out_pipe[1]);
+    close(err_pipe[1]);
+
+    std::unique_ptr<Subprocess> process(new Subprocess());
+    process->pid_ = pid;
+    process->program_ = argv[0];
+    process->stdin_fd_ = in_pipe[1];
+    process->stdout_fd_ = out_pipe[0];
+    process->stderr_fd_ = err_pipe[0];
+    Subprocess* self = process.get();
+    process->stderr_reader_ = std::thread([self] {
+        char buffer[1024];
+        for (;;) {
+            ssize_t n = read(self->stderr_fd_, buffer, sizeof(buffer));
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                break;
+            }
+            std::lock_guard<std::mutex> lock(self->stderr_mutex_);
+            if (self->stderr_output_.size() < kMaxStderr) {
+                self->stderr_output_.append(buffer, std::min<size_t>(n, kMaxStderr - self->stderr_output_.size()));
+            }
+        }
+    });
+    return process;
+}
+
+Subprocess::~Subprocess() {
+    CloseStdin();
+    CloseFd(&stdout_fd_);
+    if (!waited_ && pid_ > 0) {
+        Kill();
+        Wait();
+    }
+    if (stderr_reader_.joinable()) {
+        stderr_reader_.join();
+    }
+    CloseFd(&stderr_fd_);
+}
+
+bool Subprocess::WriteStdin(const char* data, size_t size) {
+    while (size > 0) {
+        if (stdin_fd_ < 0) {
+            return false;
+        }
+        ssize_t n = write(stdin_fd_, data, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+void Subprocess::CloseStdin() {
+    CloseFd(&stdin_fd_);
+}
+
+ssize_t Subprocess::ReadStdout(char* buffer, size_t size) {
+    for (;;) {
+        ssize_t n = read(stdout_fd_, buffer, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        return n;
+    }
+}
+
+void Subprocess::Kill() {
+    if (pid_ > 0 && !waited_) {
+        killpg(pid_, SIGKILL);
+    }
+}
+
+void Subprocess::KillWhen(std::function<bool()> is_cancelled) {
+    watcher_ = std::thread([this, is_cancelled = std::move(is_cancelled)] {
+        std::unique_lock<std::mutex> lock(watch_mutex_);
+        while (!watch_stop_) {
+            if (is_cancelled()) {
+                cancelled_ = true;
+                Kill();
+                return;
+            }
+            watch_cv_.wait_for(lock, kCancelPollInterval);
+        }
+    });
+}
+
+int Subprocess::Wait() {
+    if (waited_) {
+        return exit_code_;
+    }
+    // Espera o término sem recolher o filho: enquanto ele não é recolhido o
+    // pid não pode ser reutilizado, então o watcher ainda pode usar killpg.
+    siginfo_t info;
+    while (waitid(P_PID, pid_, &info, WEXITED | WNOWAIT) < 0 && errno == EINTR) {
+    }
+    if (watcher_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(watch_mutex_);
+            watch_stop_ = true;
+        }
+        watch_cv_.notify_all();
+        watcher_.join();
+    }
+
+    int status = 0;
+    struct rusage usage {};
+    pid_t r;
+    do {
+        r = wait4(pid_, &status, 0, &usage);
+    } while (r < 0 && errno == EINTR);
+    waited_ = true;
+    if (r < 0) {
+        exit_code_ = -1;
+    } else if (WIFEXITED(status)) {
+        exit_code_ = WEXITSTATUS(status);
+    } else if (WIFSIGNALED(status)) {
+        exit_code_ = 128 + WTERMSIG(status);
+    }
+    if (r >= 0) {
+        double cpu_seconds = usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+                             (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+        if (cancelled_) {
+            RecordToolAbort(program_, cpu_seconds);
+        } else if (exit_code_ == 0) {
+            RecordToolRun(program_, cpu_seconds);
+        }
+    }
+    // O filho terminou: o stderr chega ao EOF.
+    if (stderr_reader_.joinable()) {
+        stderr_reader_.join();
+    }
+    return exit_code_;
+}
+
+std::string Subprocess::stderr_output() {
+    std::lock_guard<std::mutex> lock(stderr_mutex_);
+    return stderr_output_;
+}
+
+bool RunSubprocess(const std::vector<std::string>& argv, const std::string& input,
+                   std::string* output, std::string* error,
+                   const std::function<bool()>& is_cancelled) {
+    std::unique_ptr<Subprocess> process = Subprocess::Start(argv, error);
+    if (!process) {
+        return false;
+    }
+    if (is_cancelled) {
+        process->KillWhen(is_cancelled);
+    }
+
+    // Escrita e leitura em paralelo: com as duas na mesma thread o filho
+    // pode travar com o pipe de saída cheio.
+    std::thread writer([&process, &input] {
+        process->WriteStdin(input.data(), input.size());
+        process->CloseStdin();
+    });
+
+    char buffer[64 * 1024];
+    ssize_t n;
+    while ((n = process->ReadStdout(buffer, sizeof(buffer))) > 0) {
+        output->append(buffer, n);
+    }
+    writer.join();
+
+    int code = process->Wait();
+    if (process->cancelled()) {
+        *error = argv[0] + " interrompido: requisição cancelada";
+        return false;
+    }
+    if (code != 0) {
+        *error = argv[0] + " retornou código " + std::to_string(code) + ": " + process->stderr_output();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Processo filho com stdin e stdout ligados a pipes. O stderr é lido por uma
+// thread interna (até 4 KiB guardados) para não travar o filho e para compor
+// mensagens de erro.
+//
+// Uso típico: uma thread escreve em WriteStdin/CloseStdin enquanto outra lê
+// ReadStdout até EOF; depois Wait().
+//
+// O filho roda no próprio grupo de processos, de modo que Kill() também
+// alcança os processos que ele tiver criado.
+class Subprocess {
+public:
+    // Executa argv[0] (procurado no PATH). Retorna nullptr e preenche error
+    // se o processo não puder ser criado.
+    static std::unique_ptr<Subprocess> Start(const std::vector<std::string>& argv, std::string* error);
+
+    ~Subprocess();
+
+    Subprocess(const Subprocess&) = delete;
+    Subprocess& operator=(const Subprocess&) = delete;
+
+    // Escreve tudo em stdin. Retorna false se o filho fechou o stdin (ex: terminou).
+    bool WriteStdin(const char* data, size_t size);
+    void CloseStdin();
+
+    // Lê até size bytes do stdout. Retorna 0 no EOF e -1 em erro.
+    ssize_t ReadStdout(char* buffer, size_t size);
+
+    // Espera o filho terminar. Retorna o código de saída, ou 128 + sinal se
+    // foi morto por sinal, ou -1 em erro.
+    int Wait();
+
+    // Mata o grupo de processos do filho (SIGKILL).
+    void Kill();
+
+    // Enquanto o filho roda, consulta is_cancelled a cada 50 ms e chama Kill()
+    // quando ele retornar true. Chamar no máximo uma vez.
+    void KillWhen(std::function<bool()> is_cancelled);
+    // true se o filho foi morto por KillWhen.
+    bool cancelled() const { return cancelled_; }
+
+    pid_t pid() const { return pid_; }
+    // stderr acumulado (válido depois de Wait()).
+    std::string stderr_output();
+
+private:
+    Subprocess() = default;
+
+    pid_t pid_ = -1;
+    int stdin_fd_ = -1;
+    int stdout_fd_ = -1;
+    int stderr_fd_ = -1;
+    std::string program_;
+    bool waited_ = false;
+    int exit_code_ = -1;
+
+    std::thread watcher_;
+    std::mutex watch_mutex_;
+    std::condition_variable watch_cv_;
+    bool watch_stop_ = false;
+    std::atomic<bool> cancelled_{false};
+
+    std::thread stderr_reader_;
+    std::mutex stderr_mutex_;
+    std::string stderr_output_;
+};
+
+// Executa argv passando input no stdin e devolvendo o stdout em output.
+// Retorna false e preenche error se o processo falhar ou sair com código != 0.
+// is_cancelled (opcional) é repassado a KillWhen.
+bool RunSubprocess(const std::vector<std::string>& argv, const std::string& input,
+                   std::string* output, std::string* error,
+                   const std::function<bool()>& is_cancelled = nullptr);
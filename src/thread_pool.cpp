@@ -0,0 +1,90 @@
+#include "src/thread_pool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t threads, size_t max_queued) : max_queued_(max_queued) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    has_work_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+bool ThreadPool::TrySubmit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ || (max_queued_ != 0 && queue_.size() >= max_queued_)) {
+            return false;
+        }
+        queue_.push_back(Task{std::move(task), std::chrono::steady_clock::now(), false});
+    }
+    has_work_.notify_one();
+    return true;
+}
+
+bool ThreadPool::TrySubmit(std::function<void()> task, std::chrono::steady_clock::time_point due) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ || (max_queued_ != 0 && queue_.size() >= max_queued_)) {
+            return false;
+        }
+        queue_.push_back(Task{std::move(task), due, true});
+        ++scheduled_;
+    }
+    has_work_.notify_one();
+    return true;
+}
+
+size_t ThreadPool::idle() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t busy = active_ + queue_.size();
+    return busy < workers_.size() ? workers_.size() - busy : 0;
+}
+
+ThreadPool::Task ThreadPool::PopNextLocked() {
+    auto best = queue_.begin();
+    if (scheduled_ > 0) {
+        for (auto it = queue_.begin(); it != queue_.end(); ++it) {
+            if (it->due < best->due) {
+                best = it;
+            }
+        }
+    }
+    Task task = std::move(*best);
+    queue_.erase(best);
+    if (task.scheduled) {
+        --scheduled_;
+    }
+    return task;
+}
+
+void ThreadPool::WorkerLoop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            has_work_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;
+            }
+            task = PopNextLocked().run;
+            ++active_;
+        }
+        task();
+        std::lock_guard<std::mutex> lock(mutex_);
+        --active_;
+    }
+}
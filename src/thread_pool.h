@@ -0,0 +1,57 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Executor com número fixo de threads e fila limitada.
+// Usado para o trabalho pesado (gs, conversões) fora das threads do gRPC.
+class ThreadPool {
+public:
+    // threads == 0 usa o número de núcleos; max_queued == 0 não limita a fila.
+    ThreadPool(size_t threads, size_t max_queued);
+    // Executa as tarefas já enfileiradas e espera as threads terminarem.
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Enfileira task. Retorna false (sem enfileirar) se a fila estiver cheia.
+    bool TrySubmit(std::function<void()> task);
+    // Variante com prazo (ver JobScheduler::Due): a próxima a rodar é a de
+    // menor prazo. Tarefas enfileiradas sem prazo valem o instante em que
+    // entraram na fila.
+    bool TrySubmit(std::function<void()> task, std::chrono::steady_clock::time_point due);
+
+    size_t size() const { return workers_.size(); }
+    // Threads livres sem tarefa na fila esperando por elas (aproximado: muda
+    // logo depois de retornar).
+    size_t idle();
+
+private:
+    struct Task {
+        std::function<void()> run;
+        std::chrono::steady_clock::time_point due;
+        bool scheduled;
+    };
+
+    void WorkerLoop();
+    // Retira a próxima tarefa de queue_ (não vazia).
+    Task PopNextLocked();
+
+    const size_t max_queued_;
+    std::mutex mutex_;
+    std::condition_variable has_work_;
+    std::deque<Task> queue_;
+    // Tarefas na fila com prazo explícito; sem nenhuma, a ordem é FIFO.
+    size_t scheduled_ = 0;
+    // Threads executando uma tarefa.
+    size_t active_ = 0;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
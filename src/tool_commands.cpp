@@ -0,0 +1,112 @@
+#include "src/tool_commands.h"
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <sstream>
+
+std::vector<std::string> GhostscriptPipeCommand(const std::string& pdf_settings) {
+    // "-" como entrada: o gs copia o PDF do stdin para um arquivo interno.
+    return {"gs", "-sDEVICE=pdfwrite", "-dCompatibilityLevel=1.4", "-dPDFSETTINGS=" + pdf_settings,
+            "-dNOPAUSE", "-dQUIET", "-dBATCH", "-dSAFER", "-q", "-sOutputFile=-", "-"};
+}
+
+std::vector<std::string> GhostscriptFileCommand(const std::string& input_path, const std::string& output_path,
+                                                const std::string& pdf_settings) {
+    return {"gs", "-sDEVICE=pdfwrite", "-dCompatibilityLevel=1.4", "-dPDFSETTINGS=" + pdf_settings,
+            "-dNOPAUSE", "-dQUIET", "-dBATCH", "-sOutputFile=" + output_path, input_path};
+}
+
+std::vector<std::string> PdfToTextPipeCommand() {
+    return {"pdftotext", "fd://0", "-"};
+}
+
+std::vector<std::string> ConvertFormatPipeCommand(const std::string& output_format, int quality) {
+    std::vector<std::string> argv = {"convert", "-"};
+    if (quality > 0) {
+        argv.push_back("-quality");
+        argv.push_back(std::to_string(quality));
+    }
+    argv.push_back(output_format + ":-");
+    return argv;
+}
+
+std::vector<std::string> ResizePipeCommand(int width, int height, int quality) {
+    std::string geometry = std::to_string(width) + "x" + std::to_string(height);
+    // jpeg:size deixa o libjpeg decodificar já reduzido (no mínimo o dobro do
+    // destino, para o -resize ainda filtrar); ignorado para outros formatos.
+    std::vector<std::string> argv = {"convert", "-define",
+                                     "jpeg:size=" + std::to_string(2 * width) + "x" + std::to_string(2 * height),
+                                     "-", "-resize", geometry};
+    if (quality > 0) {
+        argv.push_back("-quality");
+        argv.push_back(std::to_string(quality));
+    }
+    argv.push_back("-");
+    return argv;
+}
+
+std::vector<std::string> GhostscriptRangeCommand(const std::string& input_path, const std::string& output_path,
+                                                 const std::string& pdf_settings, int first_page, int last_page) {
+    return {"gs", "-sDEVICE=pdfwrite", "-dCompatibilityLevel=1.4", "-dPDFSETTINGS=" + pdf_settings,
+            "-dNOPAUSE", "-dQUIET", "-dBATCH", "-dSAFER",
+            "-dFirstPage=" + std::to_string(first_page), "-dLastPage=" + std::to_string(last_page),
+            "-sOutputFile=" + output_path, input_path};
+}
+
+std::vector<std::string> GhostscriptPageCountCommand(const std::string& input_path) {
+    // Só roda para PDFs que o leitor em processo recusa (criptografados,
+    // malformados): com -dSAFER, liberando apenas a leitura da entrada, como
+    // o gsapi_add_control_path do pool gsapi.
+    return {"gs", "-q", "-dNODISPLAY", "-dSAFER", "--permit-file-read=" + input_path, "-dNOPAUSE", "-dBATCH", "-c",
+            PostScriptString(input_path) + " (r) file runpdfbegin pdfpagecount = quit"};
+}
+
+std::vector<std::string> GhostscriptMergeCommand(const std::vector<std::string>& parts,
+                                                 const std::string& output_path) {
+    // As partes já estão comprimidas: sem novo downsampling e JPEGs copiados.
+    std::vector<std::string> argv = {"gs", "-sDEVICE=pdfwrite", "-dCompatibilityLevel=1.4",
+                                     "-dNOPAUSE", "-dQUIET", "-dBATCH", "-dSAFER",
+                                     "-dPassThroughJPEGImages=true",
+                                     "-dDownsampleColorImages=false", "-dDownsampleGrayImages=false",
+                                     "-dDownsampleMonoImages=false",
+                                     "-sOutputFile=" + output_path};
+    argv.insert(argv.end(), parts.begin(), parts.end());
+    return argv;
+}
+
+std::vector<std::string> QpdfMergeCommand(const std::vector<std::string>& parts, const std::string& output_path) {
+    std::vector<std::string> argv = {"qpdf", "--empty", "--pages"};
+    argv.insert(argv.end(), parts.begin(), parts.end());
+    argv.push_back("--");
+    argv.push_back(output_path);
+    return argv;
+}
+
+std::string PostScriptString(const std::string& text) {
+    std::string out = "(";
+    for (char c : text) {
+        if (c == '(' || c == ')' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    out += ')';
+    return out;
+}
+
+bool ProgramInPath(const std::string& program) {
+    const char* path = std::getenv("PATH");
+    if (path == nullptr) {
+        return false;
+    }
+    std::istringstream dirs(path);
+    std::string dir;
+    while (std::getline(dirs, dir, ':')) {
+        std::string candidate = (dir.empty() ? "." : dir) + "/" + program;
+        if (access(candidate.c_str(), X_OK) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
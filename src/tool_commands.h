@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Linhas de comando das ferramentas externas no modo pipeline: entrada pelo
+// stdin e saída pelo stdout, sem arquivos temporários.
+// pdf_settings: valor de -dPDFSETTINGS ("/ebook", "/screen", ...).
+// quality: 0 mantém o padrão do convert.
+std::vector<std::string> GhostscriptPipeCommand(const std::string& pdf_settings);
+// Compressão de arquivo para arquivo (motor "process").
+std::vector<std::string> GhostscriptFileCommand(const std::string& input_path, const std::string& output_path,
+                                                const std::string& pdf_settings);
+std::vector<std::string> PdfToTextPipeCommand();
+std::vector<std::string> ConvertFormatPipeCommand(const std::string& output_format, int quality);
+std::vector<std::string> ResizePipeCommand(int width, int height, int quality);
+
+// Compressão de um intervalo de páginas [first_page, last_page] (modo paralelo).
+std::vector<std::string> GhostscriptRangeCommand(const std::string& input_path, const std::string& output_path,
+                                                 const std::string& pdf_settings, int first_page, int last_page);
+// Imprime o número de páginas do PDF no stdout.
+std::vector<std::string> GhostscriptPageCountCommand(const std::string& input_path);
+// Junta os PDFs de parts (na ordem) em output_path.
+std::vector<std::string> GhostscriptMergeCommand(const std::vector<std::string>& parts,
+                                                 const std::string& output_path);
+std::vector<std::string> QpdfMergeCommand(const std::vector<std::string>& parts, const std::string& output_path);
+
+// Escapa texto para uma string PostScript "(...)".
+std::string PostScriptString(const std::string& text);
+
+// true se program está no PATH.
+bool ProgramInPath(const std::string& program);
@@ -0,0 +1,220 @@
+// Testes do controle de admissão (src/job_scheduler.h), em especial da
+// espera sem thread de AcquireAsync: jobs pequenos e de outras RPCs não
+// podem esperar atrás de jobs grandes parados na fila.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <list>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "src/job_scheduler.h"
+
+namespace {
+
+// Com as vazões iniciais do JobCostModel (CompressPDF a 20 MB/s), um job
+// grande e um pequeno para large_job_seconds = 2.
+constexpr size_t kLargeBytes = size_t{400} << 20;
+constexpr size_t kSmallBytes = size_t{100} << 10;
+
+JobScheduler::Options SchedulerOptions(int limit, size_t max_queued = 64, double large_job_seconds = 2.0) {
+    JobScheduler::Options options;
+    options.limits.fill(limit);
+    options.max_queued = max_queued;
+    options.large_job_seconds = large_job_seconds;
+    return options;
+}
+
+JobInfo Job(Rpc rpc, size_t input_bytes) {
+    return JobInfo{rpc, input_bytes, std::chrono::steady_clock::time_point::max()};
+}
+
+// Resultado de um AcquireAsync.
+struct Grant {
+    bool called = false;
+    grpc::Status status;
+    JobScheduler::Slot slot;
+};
+
+class JobSchedulerTest : public ::testing::Test {
+protected:
+    JobScheduler& MakeScheduler(const JobScheduler::Options& options) {
+        scheduler_ = std::make_unique<JobScheduler>(options);
+        return *scheduler_;
+    }
+
+    // Pede uma vaga sem bloquear. O Grant vive até o fim do teste e é
+    // destruído (liberando a vaga) antes do escalonador.
+    Grant* AcquireAsync(const JobInfo& job, std::function<bool()> is_cancelled = nullptr) {
+        grants_.emplace_back();
+        Grant* grant = &grants_.back();
+        scheduler_->AcquireAsync(job, std::move(is_cancelled), [grant](grpc::Status status, JobScheduler::Slot slot) {
+            EXPECT_FALSE(grant->called);
+            grant->called = true;
+            grant->status = status;
+            grant->slot = std::move(slot);
+        });
+        return grant;
+    }
+
+    std::unique_ptr<JobScheduler> scheduler_;
+    std::list<Grant> grants_;
+};
+
+size_t Queued(const JobScheduler& scheduler, Rpc rpc) { return scheduler.stats().queued[static_cast<size_t>(rpc)]; }
+int Running(const JobScheduler& scheduler, Rpc rpc) { return scheduler.stats().running[static_cast<size_t>(rpc)]; }
+
+TEST_F(JobSchedulerTest, SyncAcquireWaitsForRelease) {
+    JobScheduler& scheduler = MakeScheduler(SchedulerOptions(1));
+    JobScheduler::Slot first;
+    ASSERT_TRUE(scheduler.Acquire(Job(Rpc::kCompressPDF, kSmallBytes), nullptr, &first).ok());
+
+    std::atomic<bool> admitted{false};
+    std::thread waiter([&] {
+        JobScheduler::Slot second;
+        EXPECT_TRUE(scheduler.Acquire(Job(Rpc::kCompressPDF, kSmallBytes), nullptr, &second).ok());
+        admitted = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(admitted);
+    first.Release();
+    waiter.join();
+    EXPECT_TRUE(admitted);
+    EXPECT_EQ(Running(scheduler, Rpc::kCompressPDF), 0);
+}
+
+// Uma rajada de CompressPDF além do limite fica na fila do escalonador; as
+// outras RPCs continuam recebendo vaga na hora.
+TEST_F(JobSchedulerTest, ParkedJobsDoNotBlockOtherRpcs) {
+    JobScheduler& scheduler = MakeScheduler(SchedulerOptions(1));
+    Grant* running = AcquireAsync(Job(Rpc::kCompressPDF, kLargeBytes));
+    ASSERT_TRUE(running->called);
+    ASSERT_TRUE(running->status.ok());
+
+    std::vector<Grant*> parked;
+    for (int i = 0; i < 8; ++i) {
+        parked.push_back(AcquireAsync(Job(Rpc::kCompressPDF, kLargeBytes)));
+        EXPECT_FALSE(parked.back()->called);
+    }
+    EXPECT_EQ(Queued(scheduler, Rpc::kCompressPDF), 8u);
+
+    for (Rpc rpc : {Rpc::kConvertToTXT, Rpc::kResizeImage, Rpc::kConvertImageFormat}) {
+        Grant* other = AcquireAsync(Job(rpc, kSmallBytes));
+        ASSERT_TRUE(other->called) << RpcName(rpc);
+        EXPECT_TRUE(other->status.ok()) << RpcName(rpc);
+        EXPECT_TRUE(other->slot.held()) << RpcName(rpc);
+    }
+
+    // Cada vaga liberada vai para o próximo da fila.
+    running->slot.Release();
+    EXPECT_TRUE(parked[0]->called);
+    EXPECT_TRUE(parked[0]->slot.held());
+    EXPECT_FALSE(parked[1]->called);
+}
+
+// Um job pequeno não espera atrás de um grande bloqueado: com as vagas de
+// jobs grandes ocupadas, ele fica com a vaga reservada na hora, mesmo com
+// grandes na fila há mais tempo.
+TEST_F(JobSchedulerTest, SmallJobNotQueuedBehindBlockedLargeJob) {
+    MakeScheduler(SchedulerOptions(4));
+    std::vector<Grant*> large;
+    for (int i = 0; i < 3; ++i) {
+        large.push_back(AcquireAsync(Job(Rpc::kCompressPDF, kLargeBytes)));
+        ASSERT_TRUE(large.back()->called);
+        ASSERT_TRUE(large.back()->slot.large());
+    }
+    Grant* blocked = AcquireAsync(Job(Rpc::kCompressPDF, kLargeBytes));
+    EXPECT_FALSE(blocked->called);
+
+    Grant* small = AcquireAsync(Job(Rpc::kCompressPDF, kSmallBytes));
+    ASSERT_TRUE(small->called);
+    EXPECT_TRUE(small->status.ok());
+    EXPECT_FALSE(small->slot.large());
+
+    // A vaga reservada não passa para o grande...
+    small->slot.Release();
+    EXPECT_FALSE(blocked->called);
+    // ...mas a de um grande, sim.
+    large[0]->slot.Release();
+    ASSERT_TRUE(blocked->called);
+    EXPECT_TRUE(blocked->status.ok());
+}
+
+// Sem reserva de vagas, a ordem da fila é o menor prazo: o pequeno que
+// chegou depois passa à frente do grande.
+TEST_F(JobSchedulerTest, SmallJobOvertakesQueuedLargeJob) {
+    MakeScheduler(SchedulerOptions(1, 64, 0));
+    Grant* running = AcquireAsync(Job(Rpc::kCompressPDF, kSmallBytes));
+    ASSERT_TRUE(running->called);
+    Grant* large = AcquireAsync(Job(Rpc::kCompressPDF, kLargeBytes));
+    Grant* small = AcquireAsync(Job(Rpc::kCompressPDF, kSmallBytes));
+
+    running->slot.Release();
+    EXPECT_TRUE(small->called);
+    EXPECT_FALSE(large->called);
+    small->slot.Release();
+    EXPECT_TRUE(large->called);
+}
+
+TEST_F(JobSchedulerTest, FullQueueRejectsOnArrival) {
+    JobScheduler& scheduler = MakeScheduler(SchedulerOptions(1, 1));
+    AcquireAsync(Job(Rpc::kCompressPDF, kSmallBytes));
+    Grant* queued = AcquireAsync(Job(Rpc::kCompressPDF, kSmallBytes));
+    EXPECT_FALSE(queued->called);
+
+    Grant* rejected = AcquireAsync(Job(Rpc::kCompressPDF, kSmallBytes));
+    ASSERT_TRUE(rejected->called);
+    EXPECT_EQ(rejected->status.error_code(), grpc::StatusCode::RESOURCE_EXHAUSTED);
+    EXPECT_FALSE(rejected->slot.held());
+    EXPECT_EQ(scheduler.stats().rejected[static_cast<size_t>(Rpc::kCompressPDF)], 1u);
+}
+
+TEST_F(JobSchedulerTest, DoomedJobRejectedOnArrival) {
+    MakeScheduler(SchedulerOptions(1));
+    JobInfo job = Job(Rpc::kCompressPDF, kSmallBytes);
+    job.deadline = std::chrono::steady_clock::now() - std::chrono::seconds(1);
+    Grant* grant = AcquireAsync(job);
+    ASSERT_TRUE(grant->called);
+    EXPECT_EQ(grant->status.error_code(), grpc::StatusCode::DEADLINE_EXCEEDED);
+}
+
+// Cancelada enquanto espera, a requisição sai da fila no Sweep seguinte e
+// não recebe a vaga depois.
+TEST_F(JobSchedulerTest, SweepDropsCancelledWaiter) {
+    JobScheduler& scheduler = MakeScheduler(SchedulerOptions(1));
+    Grant* running = AcquireAsync(Job(Rpc::kCompressPDF, kSmallBytes));
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    Grant* waiting =
+        AcquireAsync(Job(Rpc::kCompressPDF, kSmallBytes), [cancelled] { return cancelled->load(); });
+
+    scheduler.Sweep();
+    EXPECT_FALSE(waiting->called);
+    *cancelled = true;
+    scheduler.Sweep();
+    ASSERT_TRUE(waiting->called);
+    EXPECT_EQ(waiting->status.error_code(), grpc::StatusCode::CANCELLED);
+    EXPECT_EQ(Queued(scheduler, Rpc::kCompressPDF), 0u);
+    EXPECT_EQ(scheduler.stats().abandoned[static_cast<size_t>(Rpc::kCompressPDF)], 1u);
+
+    running->slot.Release();
+    EXPECT_EQ(Running(scheduler, Rpc::kCompressPDF), 0);
+}
+
+TEST_F(JobSchedulerTest, MovedSlotReleasesOnce) {
+    JobScheduler& scheduler = MakeScheduler(SchedulerOptions(2));
+    Grant* grant = AcquireAsync(Job(Rpc::kCompressPDF, kSmallBytes));
+    {
+        JobScheduler::Slot moved(std::move(grant->slot));
+        EXPECT_FALSE(grant->slot.held());
+        EXPECT_EQ(Running(scheduler, Rpc::kCompressPDF), 1);
+    }
+    EXPECT_EQ(Running(scheduler, Rpc::kCompressPDF), 0);
+    grant->slot.Release();
+    EXPECT_EQ(Running(scheduler, Rpc::kCompressPDF), 0);
+}
+
+}  // namespace
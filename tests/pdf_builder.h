@@ -0,0 +1,73 @@
+#pragma once
+
+// Monta PDFs pequenos à mão para os testes de src/pdf_document.h e
+// src/pdf_text.h: os objetos são numerados a partir de 1, na ordem em que
+// são adicionados, e Build grava uma xref em tabela com os offsets reais.
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class PdfBuilder {
+public:
+    // Adiciona um objeto (o texto entre "N 0 obj" e "endobj") e retorna o número dele.
+    int Add(const std::string& body) {
+        objects_.push_back(body);
+        return static_cast<int>(objects_.size());
+    }
+
+    // Stream com /Length calculado; extra entra no dicionário (ex.: "/Filter /FlateDecode").
+    int AddStream(const std::string& extra, const std::string& data) { return Add(Stream(extra, data)); }
+
+    static std::string Stream(const std::string& extra, const std::string& data) {
+        return "<< /Length " + std::to_string(data.size()) + " " + extra + " >>\nstream\n" + data + "\nendstream";
+    }
+
+    // Offset de cada objeto no último Build (índice = número - 1).
+    const std::vector<size_t>& offsets() const { return offsets_; }
+
+    // Arquivo completo com xref em tabela; trailer recebe /Size e o que vier em trailer_extra.
+    std::string Build(const std::string& trailer_extra) {
+        std::string pdf = Body();
+        size_t xref = pdf.size();
+        pdf += "xref\n0 " + std::to_string(objects_.size() + 1) + "\n0000000000 65535 f \n";
+        for (size_t offset : offsets_) {
+            char entry[32];
+            std::snprintf(entry, sizeof entry, "%010zu 00000 n \n", offset);
+            pdf += entry;
+        }
+        pdf += "trailer\n<< /Size " + std::to_string(objects_.size() + 1) + " " + trailer_extra + " >>\n";
+        pdf += "startxref\n" + std::to_string(xref) + "\n%%EOF\n";
+        return pdf;
+    }
+
+    // Cabeçalho e objetos, sem xref nem trailer (preenche offsets()).
+    std::string Body() {
+        std::string pdf = "%PDF-1.5\n";
+        offsets_.clear();
+        for (size_t i = 0; i < objects_.size(); ++i) {
+            offsets_.push_back(pdf.size());
+            pdf += std::to_string(i + 1) + " 0 obj\n" + objects_[i] + "\nendobj\n";
+        }
+        return pdf;
+    }
+
+    // Documento de uma página com o content stream content e os recursos resources.
+    static std::string OnePage(const std::string& resources, const std::string& content,
+                               const std::vector<std::string>& extra_objects = {}) {
+        PdfBuilder builder;
+        builder.Add("<< /Type /Catalog /Pages 2 0 R >>");
+        builder.Add("<< /Type /Pages /Kids [3 0 R] /Count 1 >>");
+        builder.Add("<< /Type /Page /Parent 2 0 R /MediaBox [0 0 612 792] /Resources " + resources +
+                    " /Contents 4 0 R >>");
+        builder.AddStream("", content);
+        for (const std::string& object : extra_objects) {
+            builder.Add(object);
+        }
+        return builder.Build("/Root 1 0 R");
+    }
+
+private:
+    std::vector<std::string> objects_;
+    std::vector<size_t> offsets_;
+};
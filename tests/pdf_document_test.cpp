@@ -0,0 +1,344 @@
+// Testes do leitor de PDF (src/pdf_document.h): filtros de stream (com os
+// dados codificados aqui mesmo, por codificadores independentes do
+// decodificador) e as três formas de achar objetos — xref em tabela, xref
+// stream com object streams e reconstrução por varredura.
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "src/pdf_document.h"
+#include "tests/pdf_builder.h"
+
+namespace {
+
+// Dados pouco repetitivos: as tabelas do LZW passam de 512, 1024 e 2048
+// códigos e chegam ao reset.
+std::string SampleData(size_t size) {
+    std::string data;
+    uint32_t state = 12345;
+    for (size_t i = 0; i < size; ++i) {
+        state = state * 1103515245 + 12345;
+        data.push_back(static_cast<char>('a' + (state >> 16) % 23));
+    }
+    return data;
+}
+
+std::string ZlibCompress(const std::string& data) {
+    uLongf size = compressBound(data.size());
+    std::string out(size, '\0');
+    EXPECT_EQ(compress2(reinterpret_cast<Bytef*>(&out[0]), &size, reinterpret_cast<const Bytef*>(data.data()),
+                        data.size(), Z_BEST_COMPRESSION),
+              Z_OK);
+    out.resize(size);
+    return out;
+}
+
+// Codificador LZW no estilo da libtiff (EarlyChange 1): começa com clear,
+// cresce a largura quando o próximo código livre passa do maior da largura
+// atual e recomeça a tabela em 4094.
+std::string LzwEncode(const std::string& data) {
+    std::string out;
+    uint32_t buffer = 0;
+    int bits = 0;
+    int width = 9;
+    auto put = [&](int code) {
+        buffer = (buffer << width) | static_cast<uint32_t>(code);
+        bits += width;
+        while (bits >= 8) {
+            out.push_back(static_cast<char>(buffer >> (bits - 8)));
+            bits -= 8;
+        }
+    };
+    std::map<std::string, int> table;
+    int next = 258;
+    auto grow = [&] {
+        if (++next == 4094) {
+            put(256);
+            table.clear();
+            next = 258;
+            width = 9;
+        } else if (next > (1 << width) - 1) {
+            ++width;
+        }
+    };
+    put(256);
+    std::string current;
+    for (char c : data) {
+        std::string extended = current + c;
+        if (extended.size() == 1 || table.count(extended)) {
+            current = extended;
+            continue;
+        }
+        put(current.size() == 1 ? static_cast<uint8_t>(current[0]) : table[current]);
+        table[extended] = next;
+        grow();
+        current.assign(1, c);
+    }
+    if (!current.empty()) {
+        put(current.size() == 1 ? static_cast<uint8_t>(current[0]) : table[current]);
+        grow();
+    }
+    put(257);
+    if (bits > 0) {
+        out.push_back(static_cast<char>(buffer << (8 - bits)));
+    }
+    return out;
+}
+
+// Aplica o preditor PNG de cada linha (filtro = linha % 5), o inverso do que o leitor faz.
+std::string PngPredict(const std::string& data, size_t row_bytes, size_t bpp) {
+    std::string out;
+    std::string previous(row_bytes, '\0');
+    for (size_t row = 0; row * row_bytes < data.size(); ++row) {
+        std::string current = data.substr(row * row_bytes, row_bytes);
+        int filter = static_cast<int>(row % 5);
+        out.push_back(static_cast<char>(filter));
+        for (size_t i = 0; i < row_bytes; ++i) {
+            int left = i >= bpp ? static_cast<uint8_t>(current[i - bpp]) : 0;
+            int up = static_cast<uint8_t>(previous[i]);
+            int up_left = i >= bpp ? static_cast<uint8_t>(previous[i - bpp]) : 0;
+            int predicted = 0;
+            if (filter == 1) {
+                predicted = left;
+            } else if (filter == 2) {
+                predicted = up;
+            } else if (filter == 3) {
+                predicted = (left + up) / 2;
+            } else if (filter == 4) {
+                int p = left + up - up_left;
+                int pa = std::abs(p - left), pb = std::abs(p - up), pc = std::abs(p - up_left);
+                predicted = (pa <= pb && pa <= pc) ? left : (pb <= pc ? up : up_left);
+            }
+            out.push_back(static_cast<char>(static_cast<uint8_t>(current[i]) - predicted));
+        }
+        previous = current;
+    }
+    return out;
+}
+
+// Decodifica o stream do objeto 1 de um documento com só esse objeto.
+bool DecodeOnly(const std::string& stream, std::string* out, std::string* error) {
+    PdfBuilder builder;
+    builder.Add(stream);
+    builder.Add("<< /Type /Catalog /Pages 3 0 R >>");
+    builder.Add("<< /Type /Pages /Kids [] /Count 0 >>");
+    std::string pdf = builder.Build("/Root 2 0 R");
+    PdfDocument document(pdf.data(), pdf.size());
+    if (!document.Open(error)) {
+        return false;
+    }
+    return document.DecodeStream(document.GetObject(1), out, error);
+}
+
+std::string Decode(const std::string& extra, const std::string& data) {
+    std::string out, error;
+    EXPECT_TRUE(DecodeOnly(PdfBuilder::Stream(extra, data), &out, &error)) << error;
+    return out;
+}
+
+TEST(PdfDocumentTest, FlateDecode) {
+    std::string data = SampleData(100000);
+    EXPECT_EQ(Decode("/Filter /FlateDecode", ZlibCompress(data)), data);
+    EXPECT_EQ(Decode("/Filter /FlateDecode /DL 100000", ZlibCompress(data)), data);
+}
+
+TEST(PdfDocumentTest, FlateCorruptedFails) {
+    std::string out, error;
+    EXPECT_FALSE(DecodeOnly(PdfBuilder::Stream("/Filter /FlateDecode", "não é zlib"), &out, &error));
+    EXPECT_FALSE(error.empty());
+}
+
+// 18 KB passam dos 512 códigos (e de 1024, 2048 e do reset em 4094): a
+// troca de largura precisa acontecer no mesmo código que no codificador.
+TEST(PdfDocumentTest, LzwDecodePastCodeWidthChanges) {
+    for (size_t size : {size_t{10}, size_t{600}, size_t{18000}, size_t{200000}}) {
+        std::string data = SampleData(size);
+        EXPECT_EQ(Decode("/Filter /LZWDecode", LzwEncode(data)), data) << size;
+    }
+}
+
+TEST(PdfDocumentTest, AsciiHexDecode) {
+    EXPECT_EQ(Decode("/Filter /ASCIIHexDecode", "48 65 6c6C\n6f>"), "Hello");
+    // Dígito sobrando vale como seguido de 0.
+    EXPECT_EQ(Decode("/Filter /ASCIIHexDecode", "414>"), "A@");
+}
+
+TEST(PdfDocumentTest, Ascii85Decode) {
+    EXPECT_EQ(Decode("/Filter /ASCII85Decode", "87cURD]j7BEbo8;\n+AbHq+T~>"), "Hello world, PDF!");
+    EXPECT_EQ(Decode("/Filter /ASCII85Decode", "z~>"), std::string(4, '\0'));
+}
+
+TEST(PdfDocumentTest, RunLengthDecode) {
+    EXPECT_EQ(Decode("/Filter /RunLengthDecode", std::string("\x04Hello\xfd!\x80", 8)), "Hello!!!!");
+}
+
+TEST(PdfDocumentTest, FilterChain) {
+    std::string data = SampleData(5000);
+    std::string flate = ZlibCompress(data);
+    std::string hex;
+    for (unsigned char c : flate) {
+        static const char kDigits[] = "0123456789ABCDEF";
+        hex += kDigits[c >> 4];
+        hex += kDigits[c & 15];
+    }
+    EXPECT_EQ(Decode("/Filter [/ASCIIHexDecode /FlateDecode]", hex + ">"), data);
+}
+
+TEST(PdfDocumentTest, PngPredictors) {
+    // 3 componentes de 8 bits, 50 colunas: todos os filtros PNG, um por linha.
+    std::string data = SampleData(150 * 40);
+    std::string encoded = ZlibCompress(PngPredict(data, 150, 3));
+    EXPECT_EQ(Decode("/Filter /FlateDecode /DecodeParms << /Predictor 15 /Colors 3 /Columns 50 >>", encoded),
+              data);
+    EXPECT_EQ(Decode("/Filter /FlateDecode /DL 6000 /DecodeParms << /Predictor 12 /Colors 3 /Columns 50 >>",
+                     encoded),
+              data);
+}
+
+TEST(PdfDocumentTest, TiffPredictor) {
+    std::string data = SampleData(4 * 30);
+    std::string encoded = data;
+    for (size_t row = 0; row < 30; ++row) {
+        for (size_t i = 3; i > 0; --i) {
+            encoded[row * 4 + i] = static_cast<char>(data[row * 4 + i] - data[row * 4 + i - 1]);
+        }
+    }
+    EXPECT_EQ(Decode("/Filter /FlateDecode /DecodeParms << /Predictor 2 /Columns 4 >>", ZlibCompress(encoded)),
+              data);
+}
+
+TEST(PdfDocumentTest, ImageFilterFails) {
+    std::string out, error;
+    EXPECT_FALSE(DecodeOnly(PdfBuilder::Stream("/Filter /DCTDecode", "jpeg"), &out, &error));
+}
+
+TEST(PdfDocumentTest, XrefTable) {
+    PdfBuilder builder;
+    builder.Add("<< /Type /Catalog /Pages 2 0 R >>");
+    builder.Add("<< /Type /Pages /Kids [3 0 R] /Count 1 >>");
+    builder.Add("<< /Type /Page /Parent 2 0 R /Contents 4 0 R >>");
+    builder.AddStream("", "BT ET");
+    std::string pdf = builder.Build("/Root 1 0 R");
+
+    PdfDocument document(pdf.data(), pdf.size());
+    std::string error;
+    ASSERT_TRUE(document.Open(&error)) << error;
+    EXPECT_EQ(document.object_limit(), 5);
+    EXPECT_EQ(document.page_count(), 1);
+    ASSERT_EQ(document.pages().size(), 1u);
+
+    PdfDocument::Location location;
+    ASSERT_TRUE(document.Locate(4, &location));
+    EXPECT_TRUE(location.in_file);
+    EXPECT_TRUE(location.stream);
+    EXPECT_EQ(location.begin, builder.offsets()[3]);
+    std::string content;
+    ASSERT_TRUE(document.PageContent(document.pages()[0], &content));
+    EXPECT_EQ(content, "BT ET\n");
+    EXPECT_FALSE(document.Locate(0, &location));
+    EXPECT_FALSE(document.Locate(9, &location));
+}
+
+// Atualização incremental: a seção nova (/Prev para a antiga) prevalece.
+TEST(PdfDocumentTest, IncrementalUpdateOverridesObject) {
+    PdfBuilder builder;
+    builder.Add("<< /Type /Catalog /Pages 2 0 R >>");
+    builder.Add("<< /Type /Pages /Kids [] /Count 0 >>");
+    builder.Add("(antigo)");
+    std::string pdf = builder.Build("/Root 1 0 R");
+    size_t first_xref = pdf.rfind("xref\n0 4");
+
+    size_t offset = pdf.size();
+    pdf += "3 0 obj\n(novo)\nendobj\n";
+    size_t xref = pdf.size();
+    char entry[32];
+    std::snprintf(entry, sizeof entry, "%010zu 00000 n \n", offset);
+    pdf += "xref\n3 1\n" + std::string(entry) + "trailer\n<< /Size 4 /Root 1 0 R /Prev " +
+           std::to_string(first_xref) + " >>\nstartxref\n" + std::to_string(xref) + "\n%%EOF\n";
+
+    PdfDocument document(pdf.data(), pdf.size());
+    std::string error;
+    ASSERT_TRUE(document.Open(&error)) << error;
+    EXPECT_EQ(document.GetObject(3).text, "novo");
+    EXPECT_TRUE(document.GetObject(2).Get("Kids") != nullptr);
+}
+
+// Xref stream (sem filtro, /W [1 4 2]) com os objetos 2 e 3 no object stream 4.
+TEST(PdfDocumentTest, XrefStreamAndObjectStream) {
+    std::string pages = "<< /Type /Pages /Kids [] /Count 0 >>";
+    std::string header = "2 0 3 " + std::to_string(pages.size() + 1) + " ";
+    std::string pdf = "%PDF-1.5\n";
+    size_t catalog = pdf.size();
+    pdf += "1 0 obj\n<< /Type /Catalog /Pages 2 0 R >>\nendobj\n";
+    size_t object_stream = pdf.size();
+    pdf += "4 0 obj\n" +
+           PdfBuilder::Stream("/Type /ObjStm /N 2 /First " + std::to_string(header.size()),
+                              header + pages + " (no object stream)") +
+           "\nendobj\n";
+
+    auto entry = [](int type, size_t field2, uint16_t field3) {
+        return std::string{static_cast<char>(type),         static_cast<char>(field2 >> 24),
+                           static_cast<char>(field2 >> 16), static_cast<char>(field2 >> 8),
+                           static_cast<char>(field2),       static_cast<char>(field3 >> 8),
+                           static_cast<char>(field3)};
+    };
+    size_t xref = pdf.size();
+    std::string rows = entry(0, 0, 65535) + entry(1, catalog, 0) + entry(2, 4, 0) + entry(2, 4, 1) +
+                       entry(1, object_stream, 0) + entry(1, xref, 0);
+    pdf += "5 0 obj\n" + PdfBuilder::Stream("/Type /XRef /Size 6 /W [1 4 2] /Root 1 0 R", rows) + "\nendobj\n";
+    pdf += "startxref\n" + std::to_string(xref) + "\n%%EOF\n";
+
+    PdfDocument document(pdf.data(), pdf.size());
+    std::string error;
+    ASSERT_TRUE(document.Open(&error)) << error;
+    EXPECT_EQ(document.object_limit(), 6);
+    EXPECT_EQ(document.page_count(), 0);
+    EXPECT_EQ(document.GetObject(3).text, "no object stream");
+
+    PdfDocument::Location location;
+    ASSERT_TRUE(document.Locate(3, &location));
+    EXPECT_FALSE(location.in_file);
+    EXPECT_EQ(location.object_stream, 4);
+    EXPECT_EQ(location.index, 1);
+    ASSERT_TRUE(document.Locate(1, &location));
+    EXPECT_TRUE(location.in_file);
+    EXPECT_EQ(location.begin, catalog);
+}
+
+// startxref apontando para lixo e um objeto fora da xref: o documento é
+// reconstruído por varredura e o limite de objetos passa do /Size.
+TEST(PdfDocumentTest, ReconstructsBrokenXref) {
+    PdfBuilder builder;
+    builder.Add("<< /Type /Catalog /Pages 2 0 R >>");
+    builder.Add("<< /Type /Pages /Kids [3 0 R] /Count 1 >>");
+    builder.Add("<< /Type /Page /Parent 2 0 R /Contents 9 0 R >>");
+    std::string pdf = builder.Body();
+    pdf += "9 0 obj\n" + PdfBuilder::Stream("", "(x) Tj") + "\nendobj\n";
+    pdf += "trailer\n<< /Size 4 /Root 1 0 R >>\nstartxref\n" + std::to_string(pdf.size() + 1000) + "\n%%EOF\n";
+
+    PdfDocument document(pdf.data(), pdf.size());
+    std::string error;
+    ASSERT_TRUE(document.Open(&error)) << error;
+    EXPECT_EQ(document.object_limit(), 10);
+    ASSERT_EQ(document.pages().size(), 1u);
+    std::string content;
+    ASSERT_TRUE(document.PageContent(document.pages()[0], &content));
+    EXPECT_EQ(content, "(x) Tj\n");
+}
+
+TEST(PdfDocumentTest, RejectsNonPdf) {
+    std::string data = "isto não é um PDF";
+    PdfDocument document(data.data(), data.size());
+    std::string error;
+    EXPECT_FALSE(document.Open(&error));
+    EXPECT_FALSE(error.empty());
+}
+
+}  // namespace
@@ -0,0 +1,119 @@
+// Testes da extração de texto em processo (src/pdf_text.h): decodificação
+// pela ToUnicode, incluindo faixas nos limites do espaço de códigos, e a
+// reconstrução de linhas e espaços pela posição do texto.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "src/pdf_text.h"
+#include "tests/pdf_builder.h"
+
+namespace {
+
+// Texto de todas as páginas de pdf, concatenado (vazio se a extração falhar).
+std::string ExtractText(const std::string& pdf) {
+    PdfTextExtractor::Options options;
+    options.threads = 1;
+    PdfTextExtractor extractor(options);
+    std::string text, error;
+    bool ok = extractor.Extract(
+        pdf.data(), pdf.size(),
+        [&](int, std::string page) {
+            text += page;
+            return true;
+        },
+        nullptr, &error);
+    EXPECT_TRUE(ok) << error;
+    return text;
+}
+
+// Página com a fonte /F1 no objeto 5 (font) e a ToUnicode no objeto 6.
+std::string PageWithFont(const std::string& font, const std::string& cmap, const std::string& content) {
+    return PdfBuilder::OnePage("<< /Font << /F1 5 0 R >> >>", content, {font, PdfBuilder::Stream("", cmap)});
+}
+
+std::string CMap(const std::string& mappings) {
+    return "/CIDInit /ProcSet findresource begin\n12 dict begin\nbegincmap\n"
+           "1 begincodespacerange\n<0000> <FFFF>\nendcodespacerange\n" +
+           mappings + "\nendcmap\nend\nend\n";
+}
+
+const char kType0Font[] =
+    "<< /Type /Font /Subtype /Type0 /BaseFont /Test /Encoding /Identity-H /ToUnicode 6 0 R >>";
+const char kSimpleFont[] = "<< /Type /Font /Subtype /TrueType /BaseFont /Test /ToUnicode 6 0 R >>";
+
+TEST(PdfTextTest, SimpleFontWinAnsi) {
+    std::string pdf = PdfBuilder::OnePage("<< /Font << /F1 5 0 R >> >>", "BT /F1 12 Tf 72 700 Td (Ol\\341) Tj ET",
+                                          {"<< /Type /Font /Subtype /TrueType /BaseFont /Arial >>"});
+    EXPECT_EQ(ExtractText(pdf), "Olá\n\f");
+}
+
+TEST(PdfTextTest, ToUnicodeBfcharAndBfrange) {
+    std::string cmap = CMap(
+        "1 beginbfchar\n<0001> <0041>\nendbfchar\n"
+        "2 beginbfrange\n<0010> <0012> <0061>\n<0020> <0021> [<0058> <00E9>]\nendbfrange");
+    std::string pdf = PageWithFont(kType0Font, cmap, "BT /F1 12 Tf 72 700 Td <0001001000110012 00200021> Tj ET");
+    EXPECT_EQ(ExtractText(pdf), "AabcXé\n\f");
+}
+
+// Faixas que terminam no maior código do tipo: o laço precisa parar e o
+// que passa do espaço de códigos da fonte (2 bytes na Type0) é ignorado.
+TEST(PdfTextTest, ToUnicodeRangeAtCodeLimits) {
+    std::string cmap = CMap(
+        "1 beginbfchar\n<FFFFFFFF> <0051>\nendbfchar\n"
+        "3 beginbfrange\n<FFFFFFF0> <FFFFFFFF> <0041>\n<FFFE> <FFFFFFFF> <0079>\n"
+        "<0000> <0000> <0030>\nendbfrange");
+    std::string pdf = PageWithFont(kType0Font, cmap, "BT /F1 12 Tf 72 700 Td <0000FFFEFFFF> Tj ET");
+    EXPECT_EQ(ExtractText(pdf), "0yz\n\f");
+}
+
+TEST(PdfTextTest, ToUnicodeRangeAtSimpleFontLimit) {
+    std::string cmap = CMap("1 beginbfrange\n<FE> <FFFFFFFF> <0061>\nendbfrange");
+    std::string pdf = PageWithFont(kSimpleFont, cmap, "BT /F1 12 Tf 72 700 Td <FEFF> Tj ET");
+    EXPECT_EQ(ExtractText(pdf), "ab\n\f");
+}
+
+// Palavras posicionadas com Td e TJ viram espaço; kerning pequeno não;
+// mudança de linha de base vira quebra de linha.
+TEST(PdfTextTest, RebuildsSpacesAndLines) {
+    std::string content =
+        "BT /F1 10 Tf 72 700 Td (Hello) Tj 40 0 Td (world) Tj ET\n"
+        "BT /F1 10 Tf 72 680 Td [(Ke) 20 (rn) -1000 (next)] TJ ET\n"
+        "BT /F1 10 Tf 14 TL 72 600 Td (one) Tj T* (two) Tj ET";
+    std::string pdf = PdfBuilder::OnePage("<< /Font << /F1 5 0 R >> >>", content,
+                                          {"<< /Type /Font /Subtype /TrueType /BaseFont /Arial >>"});
+    EXPECT_EQ(ExtractText(pdf), "Hello world\nKern next\none\ntwo\n\f");
+}
+
+TEST(PdfTextTest, PagesInOrderWithFormFeeds) {
+    PdfBuilder builder;
+    builder.Add("<< /Type /Catalog /Pages 2 0 R >>");
+    builder.Add("<< /Type /Pages /Kids [3 0 R 4 0 R 5 0 R] /Count 3 >>");
+    for (int page = 0; page < 3; ++page) {
+        builder.Add("<< /Type /Page /Parent 2 0 R /Resources << /Font << /F1 9 0 R >> >> /Contents " +
+                    std::to_string(6 + page) + " 0 R >>");
+    }
+    for (const char* text : {"um", "dois", "tres"}) {
+        builder.AddStream("", std::string("BT /F1 12 Tf 72 700 Td (") + text + ") Tj ET");
+    }
+    builder.Add("<< /Type /Font /Subtype /TrueType /BaseFont /Arial >>");
+    std::string pdf = builder.Build("/Root 1 0 R");
+
+    PdfTextExtractor extractor(PdfTextExtractor::Options{});
+    std::vector<std::string> pages;
+    std::string error;
+    ASSERT_TRUE(extractor.Extract(
+        pdf.data(), pdf.size(),
+        [&](int page, std::string text) {
+            EXPECT_EQ(page, static_cast<int>(pages.size()));
+            pages.push_back(std::move(text));
+            return true;
+        },
+        nullptr, &error))
+        << error;
+    EXPECT_EQ(pages, (std::vector<std::string>{"um\n\f", "dois\n\f", "tres\n\f"}));
+}
+
+}  // namespace